@@ -1,7 +1,8 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
-#include <M5CoreS3.h>
+#include <stddef.h>
+#include <stdint.h>
 
 // ────────────────────── 設定 ──────────────────────
 // デバッグ用メッセージ表示の有無
@@ -45,9 +46,6 @@ constexpr float MAX_OIL_PRESSURE_DISPLAY = 15.0f;
 constexpr float MAX_OIL_PRESSURE_METER = 10.0f;
 // 0.25bar 以下なら接続エラーとして扱う閾値
 constexpr float OIL_PRESSURE_DISCONNECT_THRESHOLD = 0.25f;
-// 油圧の平滑化係数
-// レスポンス向上のため平滑化係数を大きめに
-constexpr float OIL_PRESSURE_SMOOTHING_ALPHA = 0.3f;
 
 // ── 水温メーター設定 ──
 // 水温メーター下限と上限を80℃〜105℃に設定
@@ -57,6 +55,8 @@ constexpr float WATER_TEMP_METER_MAX = 105.0f;
 // ── 画面サイズ ──
 constexpr int LCD_WIDTH = 320;
 constexpr int LCD_HEIGHT = 240;
+// LCD の SPI 書き込み速度 [byte/us]（40MHz）。DMA 転送が終わる時刻の見積もりに使う
+constexpr uint32_t LCD_DMA_BYTES_PER_US = 5;
 
 // ── ALS/輝度自動制御 ──
 enum class BrightnessMode
@@ -83,10 +83,133 @@ constexpr unsigned long FPS_INTERVAL_MS = 1000UL;
 constexpr uint8_t ADC_CH_WATER_TEMP = 1;
 constexpr uint8_t ADC_CH_OIL_PRESSURE = 2;
 constexpr uint8_t ADC_CH_OIL_TEMP = 0;
+// ADS1015 の ALERT/RDY を接続した GPIO（未接続なら -1 で変換時間経過後に完了確認）
+constexpr int ADS_ALERT_PIN = -1;
+// スキャン表で油圧を何回変換するごとに温度を 1 チャンネル挟むか（3 なら P,P,P,WT,P,P,P,OT）
+constexpr uint8_t ADC_SCAN_PRIMARY_RUN = 3;
+
+// ── 実行レート ──
+// 油圧と温度は ADS1015 の変換スケジュール、描画は loop() のスケジューラがこの周期で回す
+constexpr uint32_t OIL_PRESSURE_SAMPLE_RATE_HZ = 500;
+constexpr uint32_t TEMP_SAMPLE_RATE_HZ = 2;
+// 取得する生サンプルの合計（油圧＋温度 2ch = 504SPS）。リング・ログの容量はこのレートで見積もる
+constexpr uint32_t RAW_SAMPLE_RATE_HZ = OIL_PRESSURE_SAMPLE_RATE_HZ + 2 * TEMP_SAMPLE_RATE_HZ;
+constexpr uint32_t RENDER_RATE_HZ = 60;
+constexpr uint32_t RENDER_PERIOD_US = 1000000UL / RENDER_RATE_HZ;
+
+// ── 省電力（フレームの間隔制御） ──
+// loop() は締め切りのタスクを回したら次の締め切りまで眠る。描画中だけ CPU を最高周波数にし、
+// 眠っている間は ESP-IDF の電源管理で最低周波数へ下げる（SDK が電源管理を含まなければ、
+// 描画が止まった・再開したときだけ周波数を直接切り替える）
+constexpr bool POWER_SAVE_ENABLED = true;
+constexpr uint32_t CPU_FREQ_MAX_MHZ = 240;
+constexpr uint32_t CPU_FREQ_MIN_MHZ = 80;
+// 眠っている間の自動ライトスリープ。入っている間は USB シリアルが止まり、シリアルコマンド (t/s/p/m/v/z…) も
+// 受け付けなくなるため既定は無効（周波数を下げるだけ）。テレメトリ・デバッグ出力の有効時は true でも使わない
+constexpr bool POWER_LIGHT_SLEEP_ENABLED = false;
+// 次の締め切りまでこれ未満なら眠らずに待つ [us]（タイマで起きる手間と周波数の戻りに見合わない待ち）
+constexpr uint32_t PACING_MIN_SLEEP_US = 1000;
+// 電源管理が無いとき、描画を飛ばしたフレームがこれだけ続いたら最低周波数へ落とす（描画したら戻す）
+constexpr uint32_t PACING_IDLE_AFTER_SKIPPED_FRAMES = 30;
+// 消費電力の見積もりに使う目安 [mW]（ESP32-S3、無線停止時の 240MHz 動作と 80MHz 待機。実測ではない）
+constexpr uint32_t POWER_BUSY_MW = 150;
+constexpr uint32_t POWER_IDLE_MW = 60;
+
+// ── センサタスク ──
+// 取得はコア0、描画 (Arduino loop) はコア1 で動かす
+constexpr int SENSOR_TASK_CORE = 0;
+constexpr uint32_t SENSOR_TASK_STACK_SIZE = 4096;
+constexpr unsigned SENSOR_TASK_PRIORITY = 2;
+// 504SPS で約 0.5 秒分を保持できるリング容量（2 のべき乗）
+constexpr size_t SENSOR_RING_CAPACITY = 256;
+
+// ── セッションログ (LittleFS) ──
+// 全生サンプルをフラッシュへ記録する。504SPS×4B で約 2KB/s（1MB の上限まで約 8.7 分）書き込むため既定は無効
+constexpr bool SESSION_LOG_ENABLED = false;
+// 取得タスク→ログタスクのレコードリング（4B/件、504SPS で約 8 秒分）
+constexpr size_t SESSION_LOG_RING_CAPACITY = 4096;
+// この単位でまとめてファイルへ書く（LittleFS のブロックサイズ）
+constexpr size_t SESSION_LOG_PAGE_SIZE = 4096;
+// 1 セッションの上限。超えたら以降は記録しない
+constexpr uint32_t SESSION_LOG_MAX_BYTES = 1024UL * 1024UL;
+constexpr uint32_t SESSION_LOG_SERVICE_INTERVAL_MS = 50;
+constexpr uint32_t SESSION_LOG_TASK_STACK_SIZE = 4096;
+// 取得タスクより低い優先度で書き込む
+constexpr unsigned SESSION_LOG_TASK_PRIORITY = 1;
+
+// ── 油圧バーストキャプチャ ──
+// 油圧の生サンプルを常にリングへ残し、油圧低下・急変を検出したら前後を RAM に凍結する
+constexpr bool BURST_CAPTURE_ENABLED = true;
+// 油圧のみ 4B/件。500SPS で約 8.2 秒分を保持し、前後 2 秒ずつ（計 2000 件）が確実に収まる（2 のべき乗）
+constexpr size_t BURST_CAPTURE_CAPACITY = 4096;
+constexpr uint32_t BURST_CAPTURE_PRE_MS = 2000;
+constexpr uint32_t BURST_CAPTURE_POST_MS = 2000;
+// この油圧を下回った状態が続いたら油切れとしてトリガする
+constexpr float BURST_TRIGGER_LOW_BAR = 1.0f;
+constexpr uint32_t BURST_TRIGGER_LOW_HOLD_MS = 50;
+// 上の油圧以上が続いてからトリガを有効にする（エンジン停止中に掛からないように）
+constexpr uint32_t BURST_TRIGGER_ARM_MS = 1000;
+// これを超える変化率 [bar/s] でもトリガする
+constexpr float BURST_TRIGGER_SLOPE_BAR_PER_S = 100.0f;
+
+// ── バイナリテレメトリ (USB シリアル) ──
+// 全生サンプルとフレームごとの所要時間を COBS フレームで送る。有効時はテキストのデバッグ出力を止める
+constexpr bool TELEMETRY_ENABLED = false;
+// 送信待ちのバイトリング（2 のべき乗）。500SPS×18B と 60fps×27B で約 0.8 秒分
+constexpr size_t TELEMETRY_TX_RING_CAPACITY = 8192;
+// loop() のスケジューラがこの周期でリングを USB へ移す
+constexpr uint32_t TELEMETRY_SERVICE_INTERVAL_MS = 5;
+
+// ── 走行記録 (NVS) ──
+// セッション・通算の最高値とレッドゾーンにいた時間を NVS に残す。描画ごとの更新は RAM だけで行い、
+// 一定時間ごと・最高値が大きく伸びたとき・電源電圧が落ちたときにまとめて書く
+constexpr bool RECORDS_ENABLED = true;
+constexpr uint32_t RECORDS_SERVICE_INTERVAL_MS = 100;
+// 変化があればこの間隔で書く
+constexpr uint32_t RECORDS_FLUSH_INTERVAL_MS = 60000;
+// 最高値が伸びたときでも、書き込みの間隔はこれ以上空ける
+constexpr uint32_t RECORDS_MIN_FLUSH_INTERVAL_MS = 5000;
+// VBUS がこれを下回ったら（イグニッションオフ）間隔によらずすぐ書く
+constexpr uint32_t RECORDS_BROWNOUT_MV = 4400;
+
+// ── 走行統計 ──
+// 取得タスク（コア0）が換算直後・フィルタ前の全サンプルで、チャンネルごとの最小・最大・平均・分散と
+// p1/p50/p99、油圧×油温のヒストグラムを逐次更新する（固定メモリ、1 サンプル O(1)）。
+// リングの取りこぼしやフィルタで油圧の瞬間的な落ち込みが均されることはない
+constexpr bool SESSION_STATS_ENABLED = true;
+// この件数ごとに統計ページ・シリアル出力向けの写しを更新する（504SPS で約 0.13 秒）
+constexpr uint32_t STATS_PUBLISH_SAMPLES = 64;
+// ヒストグラムの区切り。範囲外は端の区間に入れる
+constexpr int STATS_PRESSURE_BINS = 20;
+constexpr float STATS_PRESSURE_BIN_BAR = 0.5f;  // 0〜10bar
+constexpr int STATS_OIL_TEMP_BINS = 16;
+constexpr float STATS_OIL_TEMP_MIN_C = 60.0f;  // 60〜140℃
+constexpr float STATS_OIL_TEMP_BIN_C = 5.0f;
+
+// ── 信号フィルタ ──
+// 取得タスクがサンプルごとに「前段→後段」の順で通し、描画側は結果を読むだけにする
+enum class FilterKind : uint8_t
+{
+  None,           // 素通し
+  MovingAverage,  // 窓内の平均
+  Median,         // 窓内の中央値（スパイク除去）
+  SinglePole,     // 1 次 IIR（timeConstantMs で指定）
+  BiquadLowPass,  // 2 次バターワース低域通過（cutoffHz で指定）
+};
+
+struct ChannelFilterConfig
+{
+  FilterKind prefilter;  // MovingAverage / Median / None
+  uint8_t window;        // 前段の窓長 [サンプル]（中央値の更新は O(窓長) なので 16 まで）
+  FilterKind smoothing;  // SinglePole / BiquadLowPass / None
+  float timeConstantMs;
+  float cutoffHz;
+};
 
-// サンプリング数設定
-constexpr int PRESSURE_SAMPLE_SIZE = 5;
-constexpr int WATER_TEMP_SAMPLE_SIZE = 2;  // 500ms間隔×2サンプルで約1秒平均
-constexpr int OIL_TEMP_SAMPLE_SIZE = 2;    // 500ms間隔×2サンプルで約1秒平均
+// 油圧: 5 点中央値でスパイクを除き、時定数 47ms で平滑化（60fps で係数 0.3 の EMA 相当）
+constexpr ChannelFilterConfig OIL_PRESSURE_FILTER = {FilterKind::Median, 5, FilterKind::SinglePole, 47.0f, 0.0f};
+// 温度: 500ms 間隔×2 サンプルで約 1 秒平均し、時定数 160ms で平滑化
+constexpr ChannelFilterConfig WATER_TEMP_FILTER = {FilterKind::MovingAverage, 2, FilterKind::SinglePole, 160.0f, 0.0f};
+constexpr ChannelFilterConfig OIL_TEMP_FILTER = {FilterKind::MovingAverage, 2, FilterKind::SinglePole, 160.0f, 0.0f};
 
 #endif  // CONFIG_H
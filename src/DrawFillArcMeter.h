@@ -1,13 +1,24 @@
 #ifndef DRAW_FILL_ARC_METER_H
 #define DRAW_FILL_ARC_METER_H
 
-#include <M5GFX.h>  // 必要なライブラリをインクルード
-
 #include <algorithm>
 #include <cmath>
-#include <cstring>
+#include <cstdio>
 #include <limits>
 
+#include "hal/gauge_canvas.h"
+#include "modules/arc_span_cache.h"
+#include "modules/digit_atlas.h"
+#include "modules/gauge_background.h"
+#include "modules/gauge_layout.h"
+
+constexpr int GAUGE_ARC_RADIUS = 70;  // 半円メーターの半径
+constexpr int GAUGE_ARC_WIDTH = 10;   // 弧の幅
+
+// 両ゲージは同じ半径なので、メーターの弧のスパンは 1 つのキャッシュを共有する
+using GaugeArcSpanCache = ArcSpanCache<GAUGE_ARC_RADIUS - GAUGE_ARC_WIDTH, GAUGE_ARC_RADIUS>;
+inline GaugeArcSpanCache gaugeArcSpans;
+
 // std::clamp が利用できない環境向けの簡易版
 template <typename T>
 static inline T clampValue(T val, T low, T high)
@@ -17,82 +28,165 @@ static inline T clampValue(T val, T low, T high)
   return val;
 }
 
-void drawFillArcMeter(M5Canvas /*unused*/ &canvas, float value, float minValue, float maxValue, float threshold,
-                      uint16_t overThresholdColor, const char *unit, const char *label, float &maxRecordedValue,
-                      float &previousValue,  // 前回描画した値
-                      float tickStep,        // 目盛の間隔（細かい目盛り）
-                      bool useDecimal,       // 小数点を表示するかどうか
-                      int x, int y, bool drawStatic,
-                      float majorTickStep = -1.0f,  // 数字を表示する目盛間隔（負なら旧仕様）
-                      float labelStart = 0.0f)      // ラベル描画を開始する値
+// ────────────────────── 静的部分（背景レイヤー用） ──────────────────────
+// 弧の下地・レッドゾーン・目盛・ラベルを描く。起動時に背景画像へ 1 度だけ描画する
+inline void drawFillArcMeterBackground(GaugeCanvas &canvas, const GaugeSpec &spec)
 {
-  // 左端を 1px 固定しつつ数値表示位置は従来通りに保つ
-  const int GAUGE_LEFT = x + 1;                    // 円メーターの左端
-  const int CENTER_X_CORRECTED = GAUGE_LEFT + 70;  // 半径 70px を考慮した中心X座標
-  const int VALUE_BASE_X = x + 160;                // 数値表示位置
-  const int CENTER_Y_CORRECTED = y + 90 - 10;      // スプライト内の中心Y座標
-  const int RADIUS = 70;                           // 半円メーターの半径
-  const int ARC_WIDTH = 10;                        // 弧の幅
+  const float minValue = spec.minValue;
+  const float maxValue = spec.maxValue;
+  const float tickStep = spec.tickStep;                    // 目盛の間隔（細かい目盛り）
+  const float majorTickStep = spec.majorTickStep;          // 数字を表示する目盛間隔（負なら旧仕様）
+  const float labelStart = spec.labelStart;                // ラベル描画を開始する値
+  const int GAUGE_LEFT = spec.region.x + 1;                // 円メーターの左端
+  const int CENTER_X_CORRECTED = GAUGE_LEFT + 70;          // 半径 70px を考慮した中心X座標
+  const int CENTER_Y_CORRECTED = spec.region.y + 90 - 10;  // スプライト内の中心Y座標
+  const int RADIUS = GAUGE_ARC_RADIUS;
+  const int ARC_WIDTH = GAUGE_ARC_WIDTH;
 
   const uint16_t BACKGROUND_COLOR = COLOR_BLACK;  // 背景色
-  const uint16_t ACTIVE_COLOR = COLOR_WHITE;      // 現在の値の色
   const uint16_t INACTIVE_COLOR = 0x18E3;         // メーター全体の背景色
   const uint16_t TEXT_COLOR = COLOR_WHITE;        // テキストの色
 
+  if (!gaugeArcSpans.built())
+  {
+    gaugeArcSpans.build();
+  }
+  gaugeArcSpans.fill(canvas, CENTER_X_CORRECTED, CENTER_Y_CORRECTED, 0, GaugeArcSpanCache::STEPS, INACTIVE_COLOR);
+
+  // レッドゾーンの背景を描画
+  // 背景グレーと 1px の隙間を空け常に赤で表示する
+  float redZoneStartAngle = -270 + ((spec.threshold - minValue) / (maxValue - minValue) * 270.0);
+  canvas.fillArc(CENTER_X_CORRECTED, CENTER_Y_CORRECTED,
+                 RADIUS - ARC_WIDTH - 9,  // 内側半径
+                 RADIUS - ARC_WIDTH - 4,  // 外側半径
+                 redZoneStartAngle, 0,
+                 COLOR_RED);  // レッドゾーンは常に赤表示
+
+  // 目盛ラベルと目盛り線を描画
+  int tickCount = static_cast<int>((maxValue - minValue) / tickStep) + 1;
+  for (float i = 0; i <= tickCount - 1; i += 1)
+  {
+    float scaledValue = minValue + (tickStep * i);
+    float angle = 270 - ((270.0 / (tickCount - 1)) * i);  // 開始位置のロジックを維持
+    float rad = angle * (static_cast<float>(M_PI) / 180.0F);
+
+    // 主要目盛かどうかを判定（majorTickStep が負なら従来と同じ判定）
+    bool isMajorTick;
+    if (majorTickStep < 0)
+    {
+      isMajorTick = (fmod(scaledValue, 1.0f) == 0.0f);
+    }
+    else
+    {
+      float diff = fmod(scaledValue - labelStart, majorTickStep);
+      isMajorTick = (scaledValue >= labelStart) && (fabsf(diff) < 0.01f || fabsf(diff - majorTickStep) < 0.01f);
+    }
+
+    // 主要目盛は長めの線、細かい目盛は短めの線を描画
+    int innerRadius = isMajorTick ? (RADIUS - ARC_WIDTH - 10) : (RADIUS - ARC_WIDTH - 8);
+    int outerRadius = isMajorTick ? (RADIUS - ARC_WIDTH - 5) : (RADIUS - ARC_WIDTH - 7);
+
+    int lineX1 = CENTER_X_CORRECTED + (cosf(rad) * innerRadius);
+    int lineY1 = CENTER_Y_CORRECTED - (sinf(rad) * innerRadius);
+    int lineX2 = CENTER_X_CORRECTED + (cosf(rad) * outerRadius);
+    int lineY2 = CENTER_Y_CORRECTED - (sinf(rad) * outerRadius);
+
+    canvas.drawLine(lineX1, lineY1, lineX2, lineY2, COLOR_WHITE);
+
+    bool drawLabel = isMajorTick;
+
+    if (drawLabel)
+    {
+      int labelX = CENTER_X_CORRECTED + (cosf(rad) * (RADIUS - ARC_WIDTH - 15));
+      int labelY = CENTER_Y_CORRECTED - (sinf(rad) * (RADIUS - ARC_WIDTH - 15));
+
+      char labelText[6];
+      snprintf(labelText, sizeof(labelText), "%.0f", scaledValue);
+
+      canvas.setTextFont(1);
+      canvas.setFont(&fonts::Font0);
+      canvas.setTextColor(TEXT_COLOR, BACKGROUND_COLOR);
+      canvas.setCursor(labelX - (canvas.textWidth(labelText) / 2), labelY - 4);
+      canvas.print(labelText);
+    }
+  }
+
+  // 単位とメーター名を表示
+  char combinedLabel[30];
+  snprintf(combinedLabel, sizeof(combinedLabel), "%s / %s", spec.label, spec.unit);
+  canvas.setFont(&fonts::Font0);
+  int labelX = CENTER_X_CORRECTED;
+  int labelY = CENTER_Y_CORRECTED + RADIUS + 15;
+  canvas.setCursor(labelX - (canvas.textWidth(combinedLabel) / 2), labelY);
+  canvas.print(combinedLabel);
+}
+
+// ────────────────────── 動的部分 ──────────────────────
+// 値のバーと数値だけを描く。目盛などは背景レイヤー側にある。
+// 配置表の I 番目のゲージ専用に展開され、範囲・しきい値・エラー表示の判定は定数になる
+template <size_t I>
+void drawFillArcMeter(GaugeCanvas &canvas, float value,
+                      float &previousValue,  // 前回描画した値
+                      bool drawStatic)       // 背景から復元した直後（バーが空の状態から描く）
+{
+  constexpr const GaugeSpec &SPEC = GAUGE_LAYOUT[I];
+  static_assert(SPEC.kind == GaugeKind::Arc, "not an arc gauge");
+  static_assert(SPEC.maxValue > SPEC.minValue, "empty gauge range");
+
+  // 左端を 1px 固定しつつ数値表示位置は従来通りに保つ
+  constexpr int GAUGE_LEFT = SPEC.region.x + 1;                // 円メーターの左端
+  constexpr int CENTER_X_CORRECTED = GAUGE_LEFT + 70;          // 半径 70px を考慮した中心X座標
+  constexpr int VALUE_BASE_X = SPEC.region.x + SPEC.region.w;  // 数値表示位置
+  constexpr int CENTER_Y_CORRECTED = SPEC.region.y + 90 - 10;  // スプライト内の中心Y座標
+  constexpr int RADIUS = GAUGE_ARC_RADIUS;
+  constexpr float minValue = SPEC.minValue;
+  constexpr float maxValue = SPEC.maxValue;
+
+  const uint16_t ACTIVE_COLOR = COLOR_WHITE;  // 現在の値の色
+  const uint16_t INACTIVE_COLOR = 0x18E3;     // メーター全体の背景色
+
   // 値を範囲内に収める
-  float clampedValue = value;
-  if (clampedValue < minValue)
-    clampedValue = minValue;
-  else if (clampedValue > maxValue)
-    clampedValue = maxValue;
+  float clampedValue = clampValue(value, minValue, maxValue);
 
-  // 初回は全体を描画してキャッシュを初期化
-  if (drawStatic || std::isnan(previousValue))
+  if (!gaugeArcSpans.built())
   {
-    canvas.fillArc(CENTER_X_CORRECTED, CENTER_Y_CORRECTED, RADIUS - ARC_WIDTH, RADIUS, -270, 0, INACTIVE_COLOR);
-    previousValue = clampedValue;
+    gaugeArcSpans.build();
   }
+  auto fillBar = [&](int fromStep, int toStep, uint16_t color)
+  { gaugeArcSpans.fill(canvas, CENTER_X_CORRECTED, CENTER_Y_CORRECTED, fromStep, toStep, color); };
 
-  if (drawStatic)
+  // 背景から復元した直後は弧が下地色だけなので、最小値から描き直す
+  if (drawStatic || std::isnan(previousValue))
   {
-    // レッドゾーンの背景を描画
-    // 背景グレーと 1px の隙間を空け常に赤で表示する
-    float redZoneStartAngle = -270 + ((threshold - minValue) / (maxValue - minValue) * 270.0);
-    canvas.fillArc(CENTER_X_CORRECTED, CENTER_Y_CORRECTED,
-                   RADIUS - ARC_WIDTH - 9,  // 内側半径
-                   RADIUS - ARC_WIDTH - 4,  // 外側半径
-                   redZoneStartAngle, 0,
-                   COLOR_RED);  // レッドゾーンは常に赤表示
+    previousValue = minValue;
   }
 
-  // 前回値との比較で変更部分のみ更新
+  // 前回値との比較で変更部分のみ更新（角度は 0.5° 刻みのステップで扱う）
   float prevValue = std::isnan(previousValue) ? minValue : clampValue(previousValue, minValue, maxValue);
   float prevAngle = -270 + ((prevValue - minValue) / (maxValue - minValue) * 270.0);
   float currAngle = -270 + ((clampedValue - minValue) / (maxValue - minValue) * 270.0);
-  float thresholdAngle = -270 + ((threshold - minValue) / (maxValue - minValue) * 270.0);
+  int prevStep = GaugeArcSpanCache::stepForAngle(prevAngle);
+  int currStep = GaugeArcSpanCache::stepForAngle(currAngle);
 
-  bool prevOver = prevValue >= threshold;
-  bool currOver = clampedValue >= threshold;
+  bool prevOver = prevValue >= SPEC.threshold;
+  bool currOver = clampedValue >= SPEC.threshold;
 
   if (currOver)
   {
     if (!prevOver)
     {
       // レッドゾーンに入ったのでバー全体を赤く塗り替える
-      canvas.fillArc(CENTER_X_CORRECTED, CENTER_Y_CORRECTED, RADIUS - ARC_WIDTH, RADIUS, -270, currAngle,
-                     overThresholdColor);
+      fillBar(0, currStep, SPEC.alertColor);
     }
-    else if (currAngle > prevAngle)
+    else if (currStep > prevStep)
     {
       // 増加分のみ赤で更新
-      canvas.fillArc(CENTER_X_CORRECTED, CENTER_Y_CORRECTED, RADIUS - ARC_WIDTH, RADIUS, prevAngle, currAngle,
-                     overThresholdColor);
+      fillBar(prevStep, currStep, SPEC.alertColor);
     }
-    else if (currAngle < prevAngle)
+    else if (currStep < prevStep)
     {
       // 減少分を消去
-      canvas.fillArc(CENTER_X_CORRECTED, CENTER_Y_CORRECTED, RADIUS - ARC_WIDTH, RADIUS, currAngle, prevAngle,
-                     INACTIVE_COLOR);
+      fillBar(currStep, prevStep, INACTIVE_COLOR);
     }
   }
   else
@@ -100,119 +194,43 @@ void drawFillArcMeter(M5Canvas /*unused*/ &canvas, float value, float minValue,
     if (prevOver)
     {
       // レッドゾーンから戻ったので白色で描き直す
-      canvas.fillArc(CENTER_X_CORRECTED, CENTER_Y_CORRECTED, RADIUS - ARC_WIDTH, RADIUS, -270, currAngle, ACTIVE_COLOR);
-      if (prevAngle > currAngle)
+      fillBar(0, currStep, ACTIVE_COLOR);
+      if (prevStep > currStep)
       {
-        canvas.fillArc(CENTER_X_CORRECTED, CENTER_Y_CORRECTED, RADIUS - ARC_WIDTH, RADIUS, currAngle, prevAngle,
-                       INACTIVE_COLOR);
+        fillBar(currStep, prevStep, INACTIVE_COLOR);
       }
     }
     else
     {
-      if (currAngle > prevAngle)
+      if (currStep > prevStep)
       {
-        canvas.fillArc(CENTER_X_CORRECTED, CENTER_Y_CORRECTED, RADIUS - ARC_WIDTH, RADIUS, prevAngle, currAngle,
-                       ACTIVE_COLOR);
+        fillBar(prevStep, currStep, ACTIVE_COLOR);
       }
-      else if (currAngle < prevAngle)
+      else if (currStep < prevStep)
       {
-        canvas.fillArc(CENTER_X_CORRECTED, CENTER_Y_CORRECTED, RADIUS - ARC_WIDTH, RADIUS, currAngle, prevAngle,
-                       INACTIVE_COLOR);
+        fillBar(currStep, prevStep, INACTIVE_COLOR);
       }
     }
   }
 
   previousValue = clampedValue;
 
-  if (drawStatic)
-  {
-    // 目盛ラベルと目盛り線を描画
-    int tickCount = static_cast<int>((maxValue - minValue) / tickStep) + 1;
-    for (float i = 0; i <= tickCount - 1; i += 1)
-    {
-      float scaledValue = minValue + (tickStep * i);
-      float angle = 270 - ((270.0 / (tickCount - 1)) * i);  // 開始位置のロジックを維持
-      float rad = radians(angle);
-
-      // 主要目盛かどうかを判定（majorTickStep が負なら従来と同じ判定）
-      bool isMajorTick;
-      if (majorTickStep < 0)
-      {
-        isMajorTick = (fmod(scaledValue, 1.0f) == 0.0f);
-      }
-      else
-      {
-        float diff = fmod(scaledValue - labelStart, majorTickStep);
-        isMajorTick = (scaledValue >= labelStart) && (fabsf(diff) < 0.01f || fabsf(diff - majorTickStep) < 0.01f);
-      }
-
-      // 主要目盛は長めの線、細かい目盛は短めの線を描画
-      int innerRadius = isMajorTick ? (RADIUS - ARC_WIDTH - 10) : (RADIUS - ARC_WIDTH - 8);
-      int outerRadius = isMajorTick ? (RADIUS - ARC_WIDTH - 5) : (RADIUS - ARC_WIDTH - 7);
-
-      int lineX1 = CENTER_X_CORRECTED + (cosf(rad) * innerRadius);
-      int lineY1 = CENTER_Y_CORRECTED - (sinf(rad) * innerRadius);
-      int lineX2 = CENTER_X_CORRECTED + (cosf(rad) * outerRadius);
-      int lineY2 = CENTER_Y_CORRECTED - (sinf(rad) * outerRadius);
-
-      canvas.drawLine(lineX1, lineY1, lineX2, lineY2, COLOR_WHITE);
-
-      bool drawLabel = isMajorTick;
-
-      if (drawLabel)
-      {
-        int labelX = CENTER_X_CORRECTED + (cosf(rad) * (RADIUS - ARC_WIDTH - 15));
-        int labelY = CENTER_Y_CORRECTED - (sinf(rad) * (RADIUS - ARC_WIDTH - 15));
-
-        char labelText[6];
-        snprintf(labelText, sizeof(labelText), "%.0f", scaledValue);
-
-        canvas.setTextFont(1);
-        canvas.setFont(&fonts::Font0);
-        canvas.setTextColor(TEXT_COLOR, BACKGROUND_COLOR);
-        canvas.setCursor(labelX - (canvas.textWidth(labelText) / 2), labelY - 4);
-        canvas.print(labelText);
-      }
-    }
-
-    // 単位とメーター名を表示
-    char combinedLabel[30];
-    snprintf(combinedLabel, sizeof(combinedLabel), "%s / %s", label, unit);
-    canvas.setFont(&fonts::Font0);
-    int labelX = CENTER_X_CORRECTED;
-    int labelY = CENTER_Y_CORRECTED + RADIUS + 15;
-    canvas.setCursor(labelX - (canvas.textWidth(combinedLabel) / 2), labelY);
-    canvas.print(combinedLabel);
-  }
-
-  // 値を右下に表示
-  char valueText[10];
-  char errorLine1[20];
-  char errorLine2[8];
+  // 値を右下に表示。エラー表示の有無と文言はゲージごとに決まっている
+  constexpr const char *ERROR_LINE1 = gaugeErrorText(SPEC.error);
+  constexpr const char *ERROR_LINE2 = "Error";
   bool isErrorText = false;
-  // 文字列比較は strcmp を使用する
-  if (strcmp(unit, "x100kPa") == 0 && value >= 11.0f)
-  {
-    // 12bar 以上のショートエラー表示
-    // "Short circuit\nError" を表示
-    snprintf(errorLine1, sizeof(errorLine1), "Short circuit");
-    snprintf(errorLine2, sizeof(errorLine2), "Error");
-    isErrorText = true;
-  }
-  else if (strcmp(unit, "Celsius") == 0 && value >= 199.0f)
+  if constexpr (SPEC.error != GaugeError::None)
   {
-    // 199℃以上は "Disconnection\nError" を表示
-    snprintf(errorLine1, sizeof(errorLine1), "Disconnection");
-    snprintf(errorLine2, sizeof(errorLine2), "Error");
-    isErrorText = true;
+    isErrorText = value >= SPEC.errorAbove;
   }
-  else if (useDecimal)
-  {
-    snprintf(valueText, sizeof(valueText), "%.1f", value);
-  }
-  else
+
+  // 小さい値だけ小数 1 桁で出す。整形は整数演算で行う
+  char valueText[DECIMAL_TEXT_SIZE];
+  size_t valueLength = 0;
+  if (!isErrorText)
   {
-    snprintf(valueText, sizeof(valueText), "%.0f", round(value));
+    int decimals = (SPEC.decimalBelow > 0.0F && value < SPEC.decimalBelow) ? 1 : 0;
+    valueLength = formatDecimal(scaleToDecimal(value, decimals), decimals, valueText);
   }
 
   int valueX = VALUE_BASE_X;  // 数字は固定位置に表示
@@ -223,21 +241,20 @@ void drawFillArcMeter(M5Canvas /*unused*/ &canvas, float value, float minValue,
     // エラー表示用フォントを小さく設定
     canvas.setFont(&fonts::Font0);
     int rectHeight = canvas.fontHeight() * 2 + 4;
-    canvas.fillRect(valueX - 75, valueY - canvas.fontHeight() - 2, 75, rectHeight, BACKGROUND_COLOR);
+    restoreGaugeBackground(canvas, valueX - 75, valueY - canvas.fontHeight() - 2, 75, rectHeight);
     int line1Y = valueY - canvas.fontHeight();
-    canvas.setCursor(valueX - canvas.textWidth(errorLine1), line1Y);
-    canvas.print(errorLine1);
+    canvas.setCursor(valueX - canvas.textWidth(ERROR_LINE1), line1Y);
+    canvas.print(ERROR_LINE1);
     int line2Y = line1Y + canvas.fontHeight();
-    canvas.setCursor(valueX - canvas.textWidth(errorLine2), line2Y);
-    canvas.print(errorLine2);
+    canvas.setCursor(valueX - canvas.textWidth(ERROR_LINE2), line2Y);
+    canvas.print(ERROR_LINE2);
   }
   else
   {
-    canvas.setFont(&FreeSansBold24pt7b);
-    // 数字描画領域のみを毎回黒で塗りつぶす
-    canvas.fillRect(valueX - 75, valueY - canvas.fontHeight() / 2 - 2, 75, canvas.fontHeight() + 4, BACKGROUND_COLOR);
-    canvas.setCursor(valueX - canvas.textWidth(valueText), valueY - (canvas.fontHeight() / 2));
-    canvas.print(valueText);
+    // 数字描画領域のみを背景から復元し、数字はアトラスから描く
+    const int valueHeight = valueDigitAtlas().height();
+    restoreGaugeBackground(canvas, valueX - 75, valueY - valueHeight / 2 - 2, 75, valueHeight + 4);
+    drawValueText(canvas, valueText, valueLength, valueX, valueY - valueHeight / 2, COLOR_WHITE);
   }
 }
 
@@ -0,0 +1,73 @@
+#include <Wire.h>
+
+#include "config.h"
+#include "hal/hal_ads.h"
+
+// ADS1015 の I2C アドレス (ADDR ピン = GND)
+constexpr uint8_t ADS1015_I2C_ADDRESS = 0x48;
+
+// ────────────────────── I2C バス ──────────────────────
+// ADS1015 のレジスタへ Wire で直接アクセスする
+class AdsWireBus : public AdsBus
+{
+ public:
+  AdsWireBus(TwoWire &wire, uint8_t address, int alertPin) : wire_(wire), address_(address), alertPin_(alertPin) {}
+
+  auto writeRegister(uint8_t reg, uint16_t value) -> bool override
+  {
+    wire_.beginTransmission(address_);
+    wire_.write(reg);
+    wire_.write(static_cast<uint8_t>(value >> 8));
+    wire_.write(static_cast<uint8_t>(value & 0xFF));
+    return wire_.endTransmission() == 0;
+  }
+
+  auto readRegister(uint8_t reg, uint16_t &value) -> bool override
+  {
+    wire_.beginTransmission(address_);
+    wire_.write(reg);
+    if (wire_.endTransmission() != 0 || wire_.requestFrom(address_, static_cast<uint8_t>(2)) != 2)
+    {
+      return false;
+    }
+    value = static_cast<uint16_t>(wire_.read() << 8);
+    value |= static_cast<uint16_t>(wire_.read());
+    return true;
+  }
+
+  auto hasAlertPin() const -> bool override { return alertPin_ >= 0; }
+  // ALERT/RDY はアクティブ Low
+  auto alertAsserted() -> bool override { return digitalRead(alertPin_) == LOW; }
+
+ private:
+  TwoWire &wire_;
+  uint8_t address_;
+  int alertPin_;
+};
+
+auto halAdsBus() -> AdsBus &
+{
+  static AdsWireBus bus(Wire, ADS1015_I2C_ADDRESS, ADS_ALERT_PIN);
+  return bus;
+}
+
+auto halAdsBegin() -> bool
+{
+  if (ADS_ALERT_PIN >= 0)
+  {
+    pinMode(ADS_ALERT_PIN, INPUT_PULLUP);
+  }
+  // Config レジスタが読めればデバイスありと判断する
+  uint16_t config = 0;
+  return halAdsBus().readRegister(ADS1015_REG_CONFIG, config);
+}
+
+auto halAdsAttachAlertInterrupt(void (*handler)()) -> bool
+{
+  if (ADS_ALERT_PIN < 0)
+  {
+    return false;
+  }
+  attachInterrupt(digitalPinToInterrupt(ADS_ALERT_PIN), handler, FALLING);
+  return true;
+}
@@ -0,0 +1,136 @@
+#include <Arduino.h>
+#include <M5Unified.h>
+#include <esp_idf_version.h>
+#include <esp_pm.h>
+#include <esp_timer.h>
+#include <sdkconfig.h>
+
+#include "hal/hal_power.h"
+
+// ────────────────────── ESP-IDF の電源管理 ──────────────────────
+// 電源管理が有効な SDK では、描画中だけ CPU_FREQ_MAX のロックを持ち、待機中は idle タスクに任せて
+// 最低周波数へ落とす（ロックが無く両コアが待機していれば自動ライトスリープに入る）。
+// 電源管理を含まない SDK では setCpuFrequencyMhz() で直接切り替える（切り替えは重いので、
+// 呼び出し側はフレームごとではなく描画が止まった・再開したときだけ呼ぶ）。
+// ESP32-S3 は 80MHz 以上なら APB が 80MHz のままなので、取得タスクの I2C には影響しない。
+static uint32_t boostMhz = 0;
+static uint32_t idleMhz = 0;
+static bool pmActive = false;
+static bool boosted = false;
+#if CONFIG_PM_ENABLE
+static esp_pm_lock_handle_t cpuMaxLock = nullptr;
+// LCD の DMA 転送中に持つ。LovyanGFX は自分ではロックを取らない
+static esp_pm_lock_handle_t noSleepLock = nullptr;
+static bool awakeHeld = false;
+#endif
+// halIdleUs() の待ちの終わりを知らせる
+static SemaphoreHandle_t idleWake = nullptr;
+static esp_timer_handle_t idleTimer = nullptr;
+
+auto halBeginPowerManagement(uint32_t maxMhz, uint32_t minMhz, bool lightSleep) -> bool
+{
+  boostMhz = maxMhz;
+  idleMhz = minMhz;
+#if CONFIG_PM_ENABLE
+#if ESP_IDF_VERSION_MAJOR >= 5
+  esp_pm_config_t config = {};
+#else
+  esp_pm_config_esp32s3_t config = {};
+#endif
+  config.max_freq_mhz = static_cast<int>(maxMhz);
+  config.min_freq_mhz = static_cast<int>(minMhz);
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+  config.light_sleep_enable = lightSleep;
+#else
+  // tickless idle を含まない SDK ではライトスリープできない（周波数の切り替えだけ行う）
+  (void)lightSleep;
+  config.light_sleep_enable = false;
+#endif
+  pmActive = esp_pm_configure(&config) == ESP_OK &&
+             esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "render", &cpuMaxLock) == ESP_OK &&
+             esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "lcd_dma", &noSleepLock) == ESP_OK;
+#else
+  (void)lightSleep;
+#endif
+  return pmActive;
+}
+
+void halSetCpuBoost(bool boost)
+{
+  if (boost == boosted || boostMhz == 0)
+  {
+    return;
+  }
+  boosted = boost;
+#if CONFIG_PM_ENABLE
+  if (pmActive)
+  {
+    if (boost)
+    {
+      esp_pm_lock_acquire(cpuMaxLock);
+    }
+    else
+    {
+      esp_pm_lock_release(cpuMaxLock);
+    }
+    return;
+  }
+#endif
+  setCpuFrequencyMhz(boost ? boostMhz : idleMhz);
+}
+
+void halHoldAwake(bool hold)
+{
+#if CONFIG_PM_ENABLE
+  // 電源管理の開始前に始まった転送の終わりでは、取っていないロックを返さない
+  if (!pmActive || hold == awakeHeld)
+  {
+    return;
+  }
+  awakeHeld = hold;
+  if (hold)
+  {
+    esp_pm_lock_acquire(noSleepLock);
+  }
+  else
+  {
+    esp_pm_lock_release(noSleepLock);
+  }
+#else
+  (void)hold;
+#endif
+}
+
+static void wakeIdleWaiter(void * /*unused*/) { xSemaphoreGive(idleWake); }
+
+void halIdleUs(uint32_t us)
+{
+  static bool timerCreated = false;
+  if (!timerCreated)
+  {
+    timerCreated = true;
+    idleWake = xSemaphoreCreateBinary();
+    const esp_timer_create_args_t timerArgs = {wakeIdleWaiter, nullptr, ESP_TIMER_TASK, "idle", false};
+    if (idleWake == nullptr || esp_timer_create(&timerArgs, &idleTimer) != ESP_OK)
+    {
+      idleTimer = nullptr;
+    }
+  }
+  if (idleTimer == nullptr)
+  {
+    // タイマを作れなければ tick 単位で譲り、端数だけその場で待つ
+    delay(us / 1000);
+    delayMicroseconds(us % 1000);
+    return;
+  }
+  // tick に丸めず esp_timer で起きる。待つ間は idle タスクへ譲り、両コアが待てば自動ライトスリープに入れる
+  esp_timer_start_once(idleTimer, us);
+  xSemaphoreTake(idleWake, portMAX_DELAY);
+}
+
+auto halSupplyMillivolts() -> uint32_t
+{
+  // AXP2101 の VBUS 電圧。対応していない電源 IC では負が返る
+  int16_t mv = M5.Power.getVBUSVoltage();
+  return (mv > 0) ? static_cast<uint32_t>(mv) : 0;
+}
@@ -0,0 +1,46 @@
+#include <esp_timer.h>
+
+#include "hal/hal_lcd.h"
+
+// ────────────────────── LCD 転送の完了通知 ──────────────────────
+// 転送を始めるたびにワンショットの esp_timer を完了予定時刻へ掛け直す。
+// タイマを作れなければ通知は来ず、転送は描画側の service() とフェンスで進む
+static void (*transferDoneHandler)() = nullptr;
+static esp_timer_handle_t transferTimer = nullptr;
+
+static void onTransferTimer(void * /*unused*/)
+{
+  void (*handler)() = transferDoneHandler;
+  if (handler != nullptr)
+  {
+    handler();
+  }
+}
+
+void halLcdSetTransferDoneHandler(void (*handler)())
+{
+  if (transferTimer == nullptr)
+  {
+    const esp_timer_create_args_t timerArgs = {onTransferTimer, nullptr, ESP_TIMER_TASK, "lcd_dma", false};
+    if (esp_timer_create(&timerArgs, &transferTimer) != ESP_OK)
+    {
+      transferTimer = nullptr;
+    }
+  }
+  transferDoneHandler = handler;
+  if (handler == nullptr && transferTimer != nullptr)
+  {
+    esp_timer_stop(transferTimer);
+  }
+}
+
+void halLcdNotifyAfterUs(uint32_t us)
+{
+  if (transferTimer == nullptr || transferDoneHandler == nullptr)
+  {
+    return;
+  }
+  // 動いていなければ失敗するだけなので、結果は見ない
+  esp_timer_stop(transferTimer);
+  esp_timer_start_once(transferTimer, us);
+}
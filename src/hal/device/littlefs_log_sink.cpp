@@ -0,0 +1,43 @@
+#include <LittleFS.h>
+
+#include "hal/hal_log_fs.h"
+
+// ────────────────────── LittleFS ──────────────────────
+class LittleFsLogSink : public LogFileSink
+{
+ public:
+  auto exists(const char *path) -> bool override { return LittleFS.exists(path); }
+
+  auto open(const char *path) -> bool override
+  {
+    file_ = LittleFS.open(path, FILE_WRITE);
+    return static_cast<bool>(file_);
+  }
+
+  auto write(const uint8_t *data, size_t length) -> size_t override { return file_ ? file_.write(data, length) : 0; }
+
+  void flush() override
+  {
+    if (file_) file_.flush();
+  }
+
+  void close() override
+  {
+    if (file_) file_.close();
+  }
+
+ private:
+  File file_;
+};
+
+auto halLogFs() -> LogFileSink &
+{
+  static LittleFsLogSink sink;
+  return sink;
+}
+
+auto halLogFsBegin() -> bool
+{
+  // マウントできなければフォーマットしてやり直す
+  return LittleFS.begin(true);
+}
@@ -0,0 +1,40 @@
+#include <Preferences.h>
+
+#include "hal/hal_nvs.h"
+
+// ────────────────────── NVS (Preferences) ──────────────────────
+class PreferencesNvsStore : public NvsStore
+{
+ public:
+  auto begin() -> bool
+  {
+    open_ = prefs_.begin("gauge", false);
+    return open_;
+  }
+
+  auto read(const char *key, void *data, size_t length) -> bool override
+  {
+    if (!open_ || prefs_.getBytesLength(key) != length)
+    {
+      return false;
+    }
+    return prefs_.getBytes(key, data, length) == length;
+  }
+
+  auto write(const char *key, const void *data, size_t length) -> bool override
+  {
+    return open_ && prefs_.putBytes(key, data, length) == length;
+  }
+
+  auto erase(const char *key) -> bool override { return open_ && prefs_.remove(key); }
+
+ private:
+  Preferences prefs_;
+  bool open_ = false;
+};
+
+static PreferencesNvsStore nvsStore;
+
+auto halNvs() -> NvsStore & { return nvsStore; }
+
+auto halNvsBegin() -> bool { return nvsStore.begin(); }
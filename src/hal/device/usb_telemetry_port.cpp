@@ -0,0 +1,26 @@
+#include <Arduino.h>
+
+#include "hal/hal_telemetry.h"
+
+// ────────────────────── USB シリアル ──────────────────────
+// 送信バッファの空きだけを書き、USB の転送完了は待たない
+class UsbTelemetryPort : public TelemetryPort
+{
+ public:
+  auto write(const uint8_t *data, size_t length) -> size_t override
+  {
+    int room = Serial.availableForWrite();
+    if (room <= 0)
+    {
+      return 0;
+    }
+    size_t chunk = (length < static_cast<size_t>(room)) ? length : static_cast<size_t>(room);
+    return Serial.write(data, chunk);
+  }
+};
+
+auto halTelemetryPort() -> TelemetryPort &
+{
+  static UsbTelemetryPort port;
+  return port;
+}
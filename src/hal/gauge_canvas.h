@@ -0,0 +1,267 @@
+#ifndef GAUGE_CANVAS_H
+#define GAUGE_CANVAS_H
+
+// ────────────────────── 描画先の抽象 ──────────────────────
+// 描画コードは GaugeCanvas / GaugeDisplay / GaugeFont だけを参照する。
+// 実機は M5GFX をそのまま使い、ホストは RGB565 のメモリフレームバッファで代替する。
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+#include "modules/damage_tracker.h"
+
+#ifdef ARDUINO
+#include <M5GFX.h>
+
+using GaugeDisplay = M5GFX;
+using GaugeCanvasBackend = M5Canvas;
+using GaugeFont = lgfx::IFont;
+// スプライトのメモリはバイトスワップ済み RGB565
+using GaugePixel = lgfx::swap565_t;
+#else
+#include "host/host_canvas.h"
+
+using GaugeDisplay = HostDisplay;
+using GaugeCanvasBackend = HostCanvas;
+using GaugeFont = HostFont;
+using GaugePixel = uint16_t;
+#endif
+
+// ────────────────────── 更新領域付きキャンバス ──────────────────────
+// 描画 API を同名で覆い、描いた範囲を DamageTracker に記録する。
+// pushDamage() は記録された矩形だけを LCD のクリップ範囲として転送する。
+template <typename Backend, typename Display>
+class DamageTrackingCanvas : public Backend
+{
+ public:
+  explicit DamageTrackingCanvas(Display *display) : Backend(display), display_(display) {}
+
+  auto createSprite(int width, int height) -> void *
+  {
+    damage_.setBounds(width, height);
+    damage_.addAll();
+    return Backend::createSprite(width, height);
+  }
+
+  // 外部で確保したバッファを描画先にする（中身は呼び出し側が初期化する）
+  void attachBuffer(void *buffer, int width, int height)
+  {
+    damage_.setBounds(width, height);
+    damage_.addAll();
+    Backend::setBuffer(buffer, width, height);
+  }
+
+  // ── 図形 ──
+  void drawPixel(int x, int y, uint16_t color)
+  {
+    damage_.add(x, y, 1, 1);
+    Backend::drawPixel(x, y, color);
+  }
+
+  void fillRect(int x, int y, int w, int h, uint16_t color)
+  {
+    damage_.add(x, y, w, h);
+    Backend::fillRect(x, y, w, h, color);
+  }
+
+  void fillScreen(uint16_t color)
+  {
+    damage_.addAll();
+    Backend::fillScreen(color);
+  }
+
+  void drawLine(int x0, int y0, int x1, int y1, uint16_t color)
+  {
+    damage_.add(std::min(x0, x1), std::min(y0, y1), std::abs(x1 - x0) + 1, std::abs(y1 - y0) + 1);
+    Backend::drawLine(x0, y0, x1, y1, color);
+  }
+
+  void fillArc(int x, int y, int r0, int r1, float angle0, float angle1, uint16_t color)
+  {
+    addArcDamage(x, y, std::max(r0, r1), std::min(r0, r1), angle0, angle1);
+    Backend::fillArc(x, y, r0, r1, angle0, angle1, color);
+  }
+
+  // 同じ大きさの画像から矩形を行単位でコピーする（背景レイヤーからの復元用）
+  template <typename Pixel>
+  void restoreRect(const Pixel *image, int x, int y, int w, int h)
+  {
+    int left = std::max(x, 0);
+    int top = std::max(y, 0);
+    int right = std::min(x + w, static_cast<int>(Backend::width()));
+    int bottom = std::min(y + h, static_cast<int>(Backend::height()));
+    if (right <= left || bottom <= top) return;
+
+    auto *pixels = static_cast<Pixel *>(static_cast<void *>(Backend::getBuffer()));
+    const size_t stride = Backend::width();
+    for (int row = top; row < bottom; ++row)
+    {
+      size_t offset = row * stride + left;
+      std::memcpy(pixels + offset, image + offset, (right - left) * sizeof(Pixel));
+    }
+    damage_.add(left, top, right - left, bottom - top);
+  }
+
+  // 更新領域の記録を伴わない書き込み（writeFastHLine など）の後で、まとめて範囲を登録する
+  void addDamage(int x, int y, int w, int h) { damage_.add(x, y, w, h); }
+
+  // 1 行 32bit のビットマスク rows[rowCount] を左上 (x, y) に置き、1 のビットだけを color で書く。
+  // クリップと色の変換はセル 1 つにつき 1 度だけ行う。更新領域は記録しない（後で addDamage() する）
+  void writeMaskCell(int x, int y, const uint32_t *rows, int rowCount, uint16_t color)
+  {
+    const int width = static_cast<int>(Backend::width());
+    const int firstRow = std::max(0, -y);
+    const int lastRow = std::min(rowCount, static_cast<int>(Backend::height()) - y);
+    // 画面の左右からはみ出す列をマスクで落とす
+    uint32_t columns = ~0U;
+    if (x < 0) columns = (x <= -32) ? 0U : columns << -x;
+    if (x + 32 > width) columns &= (x >= width) ? 0U : ~0U >> (x + 32 - width);
+    if (columns == 0 || firstRow >= lastRow) return;
+
+    const uint16_t pixel = bufferColor(color);
+    auto *line = static_cast<uint16_t *>(static_cast<void *>(Backend::getBuffer())) +
+                 static_cast<size_t>(y + firstRow) * width;
+    for (int row = firstRow; row < lastRow; ++row, line += width)
+    {
+      // 立っているビットを下位から 1 つずつ書く（並びの長さを数えるより、細切れの行で速い）
+      for (uint32_t bits = rows[row] & columns; bits != 0; bits &= bits - 1)
+      {
+        line[x + __builtin_ctz(bits)] = pixel;
+      }
+    }
+  }
+
+  // ── 文字 ──
+  auto print(const char *text) -> size_t
+  {
+    addTextDamage(this->getCursorX(), this->getCursorY(), text);
+    return Backend::print(text);
+  }
+
+  auto println(const char *text) -> size_t
+  {
+    addTextDamage(this->getCursorX(), this->getCursorY(), text);
+    return Backend::println(text);
+  }
+
+  auto printf(const char *format, ...) -> size_t __attribute__((format(printf, 2, 3)))
+  {
+    char buffer[64];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    return print(buffer);
+  }
+
+  void drawRightString(const char *text, int x, int y)
+  {
+    addTextDamage(x - this->textWidth(text), y, text);
+    Backend::drawRightString(text, x, y);
+  }
+
+  // ── 転送 ──
+  // 変更のあった矩形だけを LCD へ送る
+  void pushDamage()
+  {
+    uint32_t pushedBytes = 0;
+    for (size_t i = 0; i < damage_.count(); ++i)
+    {
+      const DamageRect &rect = damage_[i];
+      display_->setClipRect(rect.x, rect.y, rect.w, rect.h);
+      Backend::pushSprite(0, 0);
+      pushedBytes += rect.area() * sizeof(uint16_t);
+    }
+    display_->clearClipRect();
+    markPushed(pushedBytes);
+  }
+
+  // 転送せずに記録済みの矩形を捨てる（画面へ出さない描画の後始末）
+  void discardDamage() { damage_.clear(); }
+
+  // 記録済みの矩形を転送済みとして破棄し、転送量を計上する
+  void markPushed(uint32_t pushedBytes)
+  {
+    damage_.clear();
+    lastPushBytes_ = pushedBytes;
+    totalPushBytes_ += pushedBytes;
+  }
+
+  auto damage() const -> const DamageTracker & { return damage_; }
+  // 直近の pushDamage() で送ったバイト数
+  auto lastPushBytes() const -> uint32_t { return lastPushBytes_; }
+  auto totalPushBytes() const -> uint64_t { return totalPushBytes_; }
+
+ private:
+  // バッファ上の画素の表現（実機のスプライトはバイトスワップ済み）
+  static constexpr auto bufferColor(uint16_t color) -> uint16_t
+  {
+#ifdef ARDUINO
+    return static_cast<uint16_t>((color >> 8) | (color << 8));
+#else
+    return color;
+#endif
+  }
+
+  // 文字は送り幅と行高の箱に、フォントのはみ出し分を少し足して記録する
+  void addTextDamage(int x, int y, const char *text)
+  {
+    constexpr int GLYPH_OVERHANG = 2;
+    damage_.add(x - GLYPH_OVERHANG, y - GLYPH_OVERHANG, this->textWidth(text) + GLYPH_OVERHANG * 2,
+                this->fontHeight() + GLYPH_OVERHANG * 2);
+  }
+
+  // 始点・終点と、範囲内に含まれる上下左右の極点から弧の外接矩形を求める
+  void addArcDamage(int x, int y, int outer, int inner, float angle0, float angle1)
+  {
+    if (angle1 < angle0) std::swap(angle0, angle1);
+    if (angle1 - angle0 >= 360.0F)
+    {
+      damage_.add(x - outer, y - outer, outer * 2 + 1, outer * 2 + 1);
+      return;
+    }
+
+    constexpr float DEG_TO_RADIAN = static_cast<float>(M_PI) / 180.0F;
+    float left = x + std::cos(angle0 * DEG_TO_RADIAN) * inner;
+    float right = left;
+    float top = y + std::sin(angle0 * DEG_TO_RADIAN) * inner;
+    float bottom = top;
+    auto include = [&](float angle, int radius)
+    {
+      float px = x + std::cos(angle * DEG_TO_RADIAN) * radius;
+      float py = y + std::sin(angle * DEG_TO_RADIAN) * radius;
+      left = std::min(left, px);
+      right = std::max(right, px);
+      top = std::min(top, py);
+      bottom = std::max(bottom, py);
+    };
+
+    include(angle0, outer);
+    include(angle1, inner);
+    include(angle1, outer);
+    for (float axis = std::ceil(angle0 / 90.0F) * 90.0F; axis <= angle1; axis += 90.0F)
+    {
+      include(axis, outer);
+    }
+
+    int l = static_cast<int>(std::floor(left)) - 1;
+    int t = static_cast<int>(std::floor(top)) - 1;
+    int r = static_cast<int>(std::ceil(right)) + 1;
+    int b = static_cast<int>(std::ceil(bottom)) + 1;
+    damage_.add(l, t, r - l + 1, b - t + 1);
+  }
+
+  Display *display_;
+  DamageTracker damage_;
+  uint32_t lastPushBytes_ = 0;
+  uint64_t totalPushBytes_ = 0;
+};
+
+using GaugeCanvas = DamageTrackingCanvas<GaugeCanvasBackend, GaugeDisplay>;
+
+#endif  // GAUGE_CANVAS_H
@@ -0,0 +1,94 @@
+#ifndef HAL_H
+#define HAL_H
+
+// ────────────────────── ハードウェア抽象 ──────────────────────
+// 実機 (ARDUINO) とホスト (g++) で差し替える最小限の API。
+// 時刻・ログ・フレームバッファ・ADC バス・キャンバスだけをここに集約する。
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <esp_idf_version.h>
+#if ESP_IDF_VERSION_MAJOR >= 5
+#include <esp_cpu.h>
+#endif
+#else
+#include <cstdio>
+#include <cstdlib>
+#endif
+
+// ── 時刻 ──
+#ifdef ARDUINO
+inline auto halMillis() -> uint32_t { return millis(); }
+inline auto halMicros() -> uint32_t { return micros(); }
+inline void halDelayMicroseconds(uint32_t us) { delayMicroseconds(us); }
+#else
+// ホストは仮想時計で動かし、テストやリプレイから時刻を進める
+auto halMillis() -> uint32_t;
+auto halMicros() -> uint32_t;
+void halDelayMicroseconds(uint32_t us);
+void hostClockSetUs(uint64_t us);
+void hostClockAdvanceUs(uint64_t us);
+auto hostClockNowUs() -> uint64_t;
+// 別コアで動くタスクの代わりに、時計が進む間その予定時刻ごとに task を回す。
+// task は 1 回分の処理をして、次に回すまでの時間 [us] を返す（nullptr で解除）
+void hostClockSetBackgroundTask(uint32_t (*task)());
+// 実機の esp_timer の代わり。時計が dueUs に差し掛かったら alarm を 1 度だけ呼ぶ（掛け直すと前の予約は消える）
+void hostClockSetAlarm(uint64_t dueUs, void (*alarm)());
+#endif
+
+// ── 計測用カウンタ ──
+// ベンチマークの差分計測専用。実機は CPU サイクル（32bit で折り返す）、ホストは実時間 [ns] を数える
+#ifdef ARDUINO
+using HalTicks = uint32_t;
+constexpr bool HAL_TICKS_ARE_CYCLES = true;
+#if ESP_IDF_VERSION_MAJOR >= 5
+inline auto halTicks() -> HalTicks { return esp_cpu_get_cycle_count(); }
+#else
+inline auto halTicks() -> HalTicks { return ESP.getCycleCount(); }
+#endif
+inline auto halTicksToNs(HalTicks ticks) -> double { return ticks * 1000.0 / getCpuFrequencyMhz(); }
+#else
+using HalTicks = uint64_t;
+constexpr bool HAL_TICKS_ARE_CYCLES = false;
+auto halTicks() -> HalTicks;
+inline auto halTicksToNs(HalTicks ticks) -> double { return static_cast<double>(ticks); }
+#endif
+
+// ── フレームバッファ ──
+// LCD へ DMA で送るバッファは DMA 可能な内部 RAM から確保する（失敗時は nullptr）
+#ifdef ARDUINO
+inline auto halAllocFrameBuffer(size_t bytes) -> void *
+{
+  return heap_caps_calloc(1, bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+}
+inline void halFreeFrameBuffer(void *buffer) { heap_caps_free(buffer); }
+#else
+inline auto halAllocFrameBuffer(size_t bytes) -> void * { return std::calloc(1, bytes); }
+inline void halFreeFrameBuffer(void *buffer) { std::free(buffer); }
+#endif
+
+// 背景画像など CPU だけが読む大きなバッファ。実機は PSRAM に置く
+#ifdef ARDUINO
+inline auto halAllocLargeBuffer(size_t bytes) -> void * { return heap_caps_calloc(1, bytes, MALLOC_CAP_SPIRAM); }
+inline void halFreeLargeBuffer(void *buffer) { heap_caps_free(buffer); }
+#else
+inline auto halAllocLargeBuffer(size_t bytes) -> void * { return std::calloc(1, bytes); }
+inline void halFreeLargeBuffer(void *buffer) { std::free(buffer); }
+#endif
+
+// ── ログ出力 ──
+template <typename... Args>
+inline void halLogf(const char *format, Args... args)
+{
+#ifdef ARDUINO
+  Serial.printf(format, args...);
+#else
+  std::printf(format, args...);
+#endif
+}
+
+#endif  // HAL_H
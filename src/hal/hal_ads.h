@@ -0,0 +1,14 @@
+#ifndef HAL_ADS_H
+#define HAL_ADS_H
+
+#include "modules/ads_acquisition.h"
+
+// ADS1015 へのレジスタアクセス
+// 実機は Wire、ホストは仮想時計で動く ADS1015 シミュレータを返す
+auto halAdsBus() -> AdsBus &;
+// デバイスの応答を確認し、ALERT/RDY ピンを設定する
+auto halAdsBegin() -> bool;
+// ALERT/RDY の立ち下がり（変換完了）で handler を割り込み文脈から呼ぶ。ピンが無ければ false
+auto halAdsAttachAlertInterrupt(void (*handler)()) -> bool;
+
+#endif  // HAL_ADS_H
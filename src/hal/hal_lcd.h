@@ -0,0 +1,15 @@
+#ifndef HAL_LCD_H
+#define HAL_LCD_H
+
+#include <stdint.h>
+
+// ────────────────────── LCD 転送の完了通知 ──────────────────────
+// LovyanGFX は DMA 完了の割り込みを出さないので、転送量と LCD_DMA_BYTES_PER_US から求めた完了予定時刻に知らせる。
+// 実機は esp_timer のタスク（割り込み文脈ではないので LovyanGFX を呼べる）、ホストは仮想時計のアラームで呼ぶ。
+
+// 完了予定時刻に呼ぶ関数を登録する（nullptr で解除）
+void halLcdSetTransferDoneHandler(void (*handler)());
+// us 後に handler を呼ばせる（前の予約は取り消す）。handler が無ければ何もしない
+void halLcdNotifyAfterUs(uint32_t us);
+
+#endif  // HAL_LCD_H
@@ -0,0 +1,27 @@
+#ifndef HAL_LOG_FS_H
+#define HAL_LOG_FS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ────────────────────── ログファイルの書き込み先 ──────────────────────
+// 実機は LittleFS、ホストはメモリ上のファイルに差し替える。
+// 同時に開くファイルは 1 つだけで、追記しかしない。
+class LogFileSink
+{
+ public:
+  virtual ~LogFileSink() = default;
+  virtual auto exists(const char *path) -> bool = 0;
+  // 新規作成（既存なら空にする）
+  virtual auto open(const char *path) -> bool = 0;
+  // 書けたバイト数を返す
+  virtual auto write(const uint8_t *data, size_t length) -> size_t = 0;
+  virtual void flush() = 0;
+  virtual void close() = 0;
+};
+
+auto halLogFs() -> LogFileSink &;
+// ファイルシステムをマウントする（初回はフォーマットする）
+auto halLogFsBegin() -> bool;
+
+#endif  // HAL_LOG_FS_H
@@ -0,0 +1,24 @@
+#ifndef HAL_NVS_H
+#define HAL_NVS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ────────────────────── 不揮発の設定領域 ──────────────────────
+// 実機は ESP32 の NVS（Preferences）、ホストはメモリ上の表に差し替える。
+// 値はキーごとの固定長の blob で、書き込みはその場でフラッシュへ確定する。
+class NvsStore
+{
+ public:
+  virtual ~NvsStore() = default;
+  // key の blob を data へ読む。無いか長さが違えば false
+  virtual auto read(const char *key, void *data, size_t length) -> bool = 0;
+  virtual auto write(const char *key, const void *data, size_t length) -> bool = 0;
+  virtual auto erase(const char *key) -> bool = 0;
+};
+
+auto halNvs() -> NvsStore &;
+// 名前空間を開く（失敗時は false、読み書きはすべて失敗する）
+auto halNvsBegin() -> bool;
+
+#endif  // HAL_NVS_H
@@ -0,0 +1,22 @@
+#ifndef HAL_POWER_H
+#define HAL_POWER_H
+
+#include <stdint.h>
+
+// ────────────────────── 電源管理 ──────────────────────
+// 実機は ESP-IDF の電源管理（周波数の自動切り替えと自動ライトスリープ）、ホストは仮想時計に差し替える。
+
+// 待機中は minMhz へ下げ、lightSleep なら待機中に自動ライトスリープさせる。
+// 電源管理を使えなければ false（実機は halSetCpuBoost() で周波数を直接切り替える）
+auto halBeginPowerManagement(uint32_t maxMhz, uint32_t minMhz, bool lightSleep) -> bool;
+// true の間は CPU を最高周波数に保ち、ライトスリープにも入らない
+void halSetCpuBoost(bool boost);
+// true の間はライトスリープにだけ入らない（周波数は下げてよい）。LCD の DMA 転送中に SPI/GDMA のクロックを
+// 止めないために使う。どのタスク・タイマの文脈から呼んでもよい
+void halHoldAwake(bool hold);
+// us だけ CPU を譲って待つ。実機は esp_timer で起きるので tick に丸めない
+void halIdleUs(uint32_t us);
+// 電源（USB の VBUS）の電圧 [mV]。測れなければ 0
+auto halSupplyMillivolts() -> uint32_t;
+
+#endif  // HAL_POWER_H
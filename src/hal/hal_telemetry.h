@@ -0,0 +1,19 @@
+#ifndef HAL_TELEMETRY_H
+#define HAL_TELEMETRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ────────────────────── テレメトリの送信先 ──────────────────────
+// 実機は USB シリアル、ホストはファイル記述子（pty やファイル）に差し替える。
+// write() は待たずに、今すぐ送れる分だけを受け取ってそのバイト数を返す。
+class TelemetryPort
+{
+ public:
+  virtual ~TelemetryPort() = default;
+  virtual auto write(const uint8_t *data, size_t length) -> size_t = 0;
+};
+
+auto halTelemetryPort() -> TelemetryPort &;
+
+#endif  // HAL_TELEMETRY_H
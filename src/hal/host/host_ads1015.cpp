@@ -0,0 +1,109 @@
+#include "host_ads1015.h"
+
+#include <algorithm>
+
+#include "hal/hal.h"
+
+auto HostAds1015::writeRegister(uint8_t reg, uint16_t value) -> bool
+{
+  transactions++;
+  if (failNext)
+  {
+    failNext = false;
+    return false;
+  }
+  if (reg == ADS1015_REG_CONFIG)
+  {
+    config = value;
+    uint8_t channel = static_cast<uint8_t>((value >> 12) & 0x03);
+    if (muxKnown_ && channel != muxChannel_)
+    {
+      muxSwitched_ = true;
+      muxSwitchUs_ = halMicros();
+    }
+    muxKnown_ = true;
+    muxChannel_ = channel;
+    if (value & ADS1015_CONFIG_OS_SINGLE)
+    {
+      if (muxSwitched_)
+      {
+        muxSwitched_ = false;
+        shortestSettleUs = std::min(shortestSettleUs, halMicros() - muxSwitchUs_);
+      }
+      convertingChannel = channel;
+      conversionStartUs = halMicros();
+      converting = true;
+      conversionsStarted++;
+    }
+  }
+  else if (reg == ADS1015_REG_HI_THRESH)
+  {
+    hiThresh = value;
+  }
+  else if (reg == ADS1015_REG_LO_THRESH)
+  {
+    loThresh = value;
+  }
+  return true;
+}
+
+auto HostAds1015::readRegister(uint8_t reg, uint16_t &value) -> bool
+{
+  transactions++;
+  if (failNext)
+  {
+    failNext = false;
+    return false;
+  }
+  updateConversion();
+  if (reg == ADS1015_REG_CONFIG)
+  {
+    configReads++;
+    value = static_cast<uint16_t>((config & ~ADS1015_CONFIG_OS_SINGLE) | (converting ? 0 : ADS1015_CONFIG_OS_SINGLE));
+  }
+  else
+  {
+    value = static_cast<uint16_t>(conversionResult << 4);
+    alertLatched = false;
+  }
+  return true;
+}
+
+auto HostAds1015::alertAsserted() -> bool
+{
+  updateConversion();
+  return alertLatched;
+}
+
+void HostAds1015::setChannelVoltage(uint8_t channel, float volts)
+{
+  float code = volts * 2047.0F / 6.144F;
+  code = (code > 2047.0F) ? 2047.0F : (code < -2048.0F) ? -2048.0F : code;
+  channelCode[channel & 0x03] = static_cast<int16_t>(code);
+}
+
+void HostAds1015::updateConversion()
+{
+  if (converting && halMicros() - conversionStartUs >= conversionTimeUs)
+  {
+    converting = false;
+    conversionResult = channelCode[convertingChannel];
+    // Hi_thresh MSB=1 / Lo_thresh MSB=0 かつコンパレータ有効で RDY 動作
+    bool rdyMode = (hiThresh & 0x8000) && !(loThresh & 0x8000) &&
+                   (config & ADS1015_CONFIG_CQUE_NONE) != ADS1015_CONFIG_CQUE_NONE;
+    alertLatched = rdyMode;
+  }
+}
+
+auto hostAds1015() -> HostAds1015 &
+{
+  static HostAds1015 ads;
+  return ads;
+}
+
+auto halAdsBus() -> AdsBus & { return hostAds1015(); }
+
+auto halAdsBegin() -> bool { return true; }
+
+// シミュレータの完了はポーリングで見る（取得タスクは仮想時計の予定時刻で起きる）
+auto halAdsAttachAlertInterrupt(void (* /*handler*/)()) -> bool { return false; }
@@ -0,0 +1,56 @@
+#ifndef HOST_ADS1015_H
+#define HOST_ADS1015_H
+
+#include <stdint.h>
+
+#include "hal/hal_ads.h"
+
+// ────────────────────── ADS1015 シミュレータ ──────────────────────
+// レジスタ書込みで変換を開始し、仮想時計で変換時間が経過したら完了とする
+class HostAds1015 : public AdsBus
+{
+ public:
+  explicit HostAds1015(bool alertPin = false) : alertPin_(alertPin) {}
+
+  auto writeRegister(uint8_t reg, uint16_t value) -> bool override;
+  auto readRegister(uint8_t reg, uint16_t &value) -> bool override;
+  auto hasAlertPin() const -> bool override { return alertPin_; }
+  auto alertAsserted() -> bool override;
+
+  // ±6.144V レンジでの入力電圧をコードに換算して設定する
+  void setChannelVoltage(uint8_t channel, float volts);
+
+  // チャンネルごとの入力コード
+  int16_t channelCode[4] = {};
+  // 次の I2C トランザクションを失敗させる
+  bool failNext = false;
+
+  uint16_t config = 0;
+  uint16_t hiThresh = 0;
+  uint16_t loThresh = 0;
+  uint8_t convertingChannel = 0;
+  uint32_t conversionStartUs = 0;
+  bool converting = false;
+  bool alertLatched = false;
+  int16_t conversionResult = 0;
+  uint32_t conversionsStarted = 0;
+  // MUX を切り替えてから変換を始めるまでの最短時間（起動後最初の設定は切替に数えない）
+  uint32_t shortestSettleUs = UINT32_MAX;
+  uint32_t configReads = 0;
+  uint32_t transactions = 0;
+  uint32_t conversionTimeUs = 625;
+
+ private:
+  void updateConversion();
+
+  bool alertPin_;
+  bool muxKnown_ = false;
+  bool muxSwitched_ = false;  // 切り替えてからまだ変換していない
+  uint8_t muxChannel_ = 0;
+  uint32_t muxSwitchUs_ = 0;
+};
+
+// ホストビルドで halAdsBus() が返すインスタンス
+auto hostAds1015() -> HostAds1015 &;
+
+#endif  // HOST_ADS1015_H
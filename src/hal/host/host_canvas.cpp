@@ -0,0 +1,287 @@
+#include "host_canvas.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+#include "hal/hal.h"
+#include "hal/hal_lcd.h"
+
+// Font0 (6x8) と FreeSansBold24pt7b の数字幅・行高に合わせる
+namespace fonts
+{
+const HostFont Font0 = {6, 8, 5, 7};
+}  // namespace fonts
+const HostFont FreeSansBold24pt7b = {27, 56, 24, 34};
+
+// ────────────────────── HostDisplay ──────────────────────
+HostDisplay::HostDisplay(int width, int height)
+    : width_(width), height_(height), pixels_(static_cast<size_t>(width) * height, 0)
+{
+  clearClipRect();
+}
+
+void HostDisplay::setClipRect(int x, int y, int w, int h)
+{
+  clipLeft_ = std::max(x, 0);
+  clipTop_ = std::max(y, 0);
+  clipRight_ = std::min(x + w, width_);
+  clipBottom_ = std::min(y + h, height_);
+}
+
+void HostDisplay::fillScreen(uint16_t color) { std::fill(pixels_.begin(), pixels_.end(), color); }
+
+void HostDisplay::pushImage(int x, int y, int w, int h, const uint16_t *data)
+{
+  for (int row = 0; row < h; ++row)
+  {
+    int dy = y + row;
+    if (dy < clipTop_ || dy >= clipBottom_) continue;
+    for (int col = 0; col < w; ++col)
+    {
+      int dx = x + col;
+      if (dx < clipLeft_ || dx >= clipRight_) continue;
+      pixels_[static_cast<size_t>(dy) * width_ + dx] = data[static_cast<size_t>(row) * w + col];
+    }
+  }
+}
+
+void HostDisplay::pushImageDMA(int x, int y, int w, int h, const uint16_t *data)
+{
+  // 実機と同様に、前の転送が終わるまで次の転送は始まらない
+  waitDMA();
+  size_t pixels = static_cast<size_t>(w) * h;
+  if (dmaSourceBegin_ != nullptr && (data < dmaSourceBegin_ || data + pixels > dmaSourceEnd_))
+  {
+    invalidDmaSources_++;
+  }
+  uint64_t bytes = pixels * sizeof(uint16_t);
+  transfer_ = {x, y, w, h, data, hostClockNowUs() + (bytes + HOST_DMA_BYTES_PER_US - 1) / HOST_DMA_BYTES_PER_US};
+  transferPending_ = true;
+}
+
+auto HostDisplay::dmaBusy() -> bool
+{
+  if (transferPending_ && hostClockNowUs() >= transfer_.completeUs)
+  {
+    transferPending_ = false;
+    pushImage(transfer_.x, transfer_.y, transfer_.w, transfer_.h, transfer_.data);
+  }
+  return transferPending_;
+}
+
+void HostDisplay::waitDMA()
+{
+  if (transferPending_ && hostClockNowUs() < transfer_.completeUs)
+  {
+    // 完了まで待ったものとして仮想時計を進める（その間も取得タスクは動く）
+    hostClockAdvanceUs(transfer_.completeUs - hostClockNowUs());
+  }
+  dmaBusy();
+}
+
+// ── 転送完了の通知 ──
+// 実機の esp_timer の代わりに仮想時計のアラームで呼ぶ
+static void (*transferDoneHandler)() = nullptr;
+
+void halLcdSetTransferDoneHandler(void (*handler)())
+{
+  transferDoneHandler = handler;
+  if (handler == nullptr)
+  {
+    hostClockSetAlarm(0, nullptr);
+  }
+}
+
+void halLcdNotifyAfterUs(uint32_t us)
+{
+  if (transferDoneHandler != nullptr)
+  {
+    hostClockSetAlarm(hostClockNowUs() + us, transferDoneHandler);
+  }
+}
+
+auto HostDisplay::frameHash() const -> uint32_t
+{
+  uint32_t hash = 2166136261U;
+  for (uint16_t px : pixels_)
+  {
+    hash = (hash ^ (px & 0xFF)) * 16777619U;
+    hash = (hash ^ (px >> 8)) * 16777619U;
+  }
+  return hash;
+}
+
+// ────────────────────── HostCanvas ──────────────────────
+auto HostCanvas::createSprite(int width, int height) -> void *
+{
+  width_ = width;
+  height_ = height;
+  storage_.assign(static_cast<size_t>(width) * height, 0);
+  pixels_ = storage_.data();
+  return pixels_;
+}
+
+void HostCanvas::setBuffer(void *buffer, int width, int height, uint8_t /*unused*/)
+{
+  width_ = width;
+  height_ = height;
+  pixels_ = static_cast<uint16_t *>(buffer);
+}
+
+void HostCanvas::drawPixel(int x, int y, uint16_t color)
+{
+  if (x < 0 || y < 0 || x >= width_ || y >= height_) return;
+  pixels_[static_cast<size_t>(y) * width_ + x] = color;
+}
+
+void HostCanvas::fillRect(int x, int y, int w, int h, uint16_t color)
+{
+  int x0 = std::max(x, 0);
+  int y0 = std::max(y, 0);
+  int x1 = std::min(x + w, width_);
+  int y1 = std::min(y + h, height_);
+  for (int py = y0; py < y1; ++py)
+  {
+    std::fill_n(&pixels_[static_cast<size_t>(py) * width_ + x0], std::max(x1 - x0, 0), color);
+  }
+}
+
+void HostCanvas::drawLine(int x0, int y0, int x1, int y1, uint16_t color)
+{
+  // Bresenham
+  int dx = std::abs(x1 - x0);
+  int sx = (x0 < x1) ? 1 : -1;
+  int dy = -std::abs(y1 - y0);
+  int sy = (y0 < y1) ? 1 : -1;
+  int err = dx + dy;
+  for (;;)
+  {
+    drawPixel(x0, y0, color);
+    if (x0 == x1 && y0 == y1) break;
+    int e2 = 2 * err;
+    if (e2 >= dy)
+    {
+      err += dy;
+      x0 += sx;
+    }
+    if (e2 <= dx)
+    {
+      err += dx;
+      y0 += sy;
+    }
+  }
+}
+
+void HostCanvas::fillArc(int x, int y, int r0, int r1, float angle0, float angle1, uint16_t color)
+{
+  if (r0 > r1) std::swap(r0, r1);
+  float span = angle1 - angle0;
+  if (span < 0.0F)
+  {
+    std::swap(angle0, angle1);
+    span = -span;
+  }
+  float start = std::fmod(angle0, 360.0F);
+  if (start < 0.0F) start += 360.0F;
+
+  const int inner2 = r0 * r0;
+  const int outer2 = r1 * r1;
+  for (int dy = -r1; dy <= r1; ++dy)
+  {
+    for (int dx = -r1; dx <= r1; ++dx)
+    {
+      int d2 = dx * dx + dy * dy;
+      if (d2 < inner2 || d2 > outer2) continue;
+      // 画面座標は y が下向きなので atan2 の結果がそのまま時計回りの角度になる
+      float angle = std::atan2(static_cast<float>(dy), static_cast<float>(dx)) * (180.0F / static_cast<float>(M_PI));
+      float offset = angle - start;
+      while (offset < 0.0F) offset += 360.0F;
+      if (span >= 360.0F || offset <= span)
+      {
+        drawPixel(x + dx, y + dy, color);
+      }
+    }
+  }
+}
+
+auto HostCanvas::textWidth(const char *text) const -> int
+{
+  return static_cast<int>(std::strlen(text)) * font_->advance * textSize_;
+}
+
+void HostCanvas::drawGlyph(char ch)
+{
+  const int cellW = font_->advance * textSize_;
+  if (textBackground_ != textColor_)
+  {
+    fillRect(cursorX_, cursorY_, cellW, fontHeight(), textBackground_);
+  }
+  if (ch != ' ')
+  {
+    // 文字コードで模様を変え、値が変われば画素も変わるようにする
+    const int gw = font_->glyphWidth * textSize_;
+    const int gh = font_->glyphHeight * textSize_;
+    for (int row = 0; row < gh; ++row)
+    {
+      for (int col = 0; col < gw; ++col)
+      {
+        if (((col * 7 + row * 3 + static_cast<unsigned char>(ch)) % 5) < 2)
+        {
+          drawPixel(cursorX_ + col, cursorY_ + row, textColor_);
+        }
+      }
+    }
+  }
+  cursorX_ += cellW;
+}
+
+auto HostCanvas::print(const char *text) -> size_t
+{
+  size_t count = 0;
+  for (const char *p = text; *p != '\0'; ++p, ++count)
+  {
+    if (*p == '\n')
+    {
+      cursorX_ = 0;
+      cursorY_ += fontHeight();
+      continue;
+    }
+    drawGlyph(*p);
+  }
+  return count;
+}
+
+auto HostCanvas::println(const char *text) -> size_t
+{
+  size_t count = print(text);
+  cursorX_ = 0;
+  cursorY_ += fontHeight();
+  return count + 1;
+}
+
+auto HostCanvas::printf(const char *format, ...) -> size_t
+{
+  char buffer[64];
+  va_list args;
+  va_start(args, format);
+  std::vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  return print(buffer);
+}
+
+void HostCanvas::drawRightString(const char *text, int x, int y)
+{
+  setCursor(x - textWidth(text), y);
+  print(text);
+}
+
+void HostCanvas::pushSprite(int x, int y)
+{
+  if (parent_ != nullptr)
+  {
+    parent_->pushImage(x, y, width_, height_, pixels_);
+  }
+}
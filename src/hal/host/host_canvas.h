@@ -0,0 +1,177 @@
+#ifndef HOST_CANVAS_H
+#define HOST_CANVAS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "config.h"
+
+// ────────────────────── ホスト用フォント ──────────────────────
+// 実フォントは持たず、文字送りと高さだけを再現した矩形グリフで描く
+struct HostFont
+{
+  uint8_t advance;  // 1 文字の送り幅 [px]
+  uint8_t height;   // fontHeight() が返す行高 [px]
+  uint8_t glyphWidth;
+  uint8_t glyphHeight;
+};
+
+namespace fonts
+{
+extern const HostFont Font0;
+}  // namespace fonts
+extern const HostFont FreeSansBold24pt7b;
+
+// ────────────────────── ホスト用ディスプレイ ──────────────────────
+// LCD と同じ大きさの RGB565 フレームバッファ
+class HostDisplay
+{
+ public:
+  HostDisplay(int width = 320, int height = 240);
+
+  void init() {}
+  void initDMA() {}
+  void setRotation(int /*unused*/) {}
+  void setColorDepth(int /*unused*/) {}
+  void setBrightness(uint8_t brightness) { brightness_ = brightness; }
+  auto getBrightness() const -> uint8_t { return brightness_; }
+  void fillScreen(uint16_t color);
+
+  // pushImage はクリップ範囲内だけを書き込む
+  void setClipRect(int x, int y, int w, int h);
+  void clearClipRect() { setClipRect(0, 0, width_, height_); }
+  void pushImage(int x, int y, int w, int h, const uint16_t *data);
+
+  // ── DMA 転送の模擬 ──
+  // 転送は仮想時計で HOST_DMA_BYTES_PER_US の速度で進み、完了時にまとめて反映する。
+  // 完了前に転送元を書き換えると LCD に反映される内容も変わるため、フェンス漏れを検出できる。
+  // LovyanGFX と同じく入れ子を数え、最も外側の endWrite() で転送完了を待ってバスを手放す
+  void startWrite() { writeDepth_++; }
+  void endWrite()
+  {
+    waitDMA();
+    if (writeDepth_ > 0) writeDepth_--;
+  }
+  auto writeDepth() const -> int { return writeDepth_; }
+  void pushImageDMA(int x, int y, int w, int h, const uint16_t *data);
+  auto dmaBusy() -> bool;
+  void waitDMA();
+  // 実機の DMA は内部 RAM しか読めない。転送元をこの範囲に限り、外れた転送の数を数える
+  void restrictDmaSource(const uint16_t *begin, size_t pixels)
+  {
+    dmaSourceBegin_ = begin;
+    dmaSourceEnd_ = begin + pixels;
+  }
+  auto invalidDmaSources() const -> uint32_t { return invalidDmaSources_; }
+
+  auto width() const -> int { return width_; }
+  auto height() const -> int { return height_; }
+  auto framebuffer() const -> const uint16_t * { return pixels_.data(); }
+  auto readPixel(int x, int y) const -> uint16_t { return pixels_[static_cast<size_t>(y) * width_ + x]; }
+  // FNV-1a によるフレームバッファのハッシュ
+  auto frameHash() const -> uint32_t;
+
+ private:
+  int width_;
+  int height_;
+  uint8_t brightness_ = 0;
+  int writeDepth_ = 0;
+  int clipLeft_ = 0;
+  int clipTop_ = 0;
+  int clipRight_ = 0;  // 含まない
+  int clipBottom_ = 0;
+  std::vector<uint16_t> pixels_;
+
+  struct PendingTransfer
+  {
+    int x, y, w, h;
+    const uint16_t *data;
+    uint64_t completeUs;
+  };
+  bool transferPending_ = false;
+  PendingTransfer transfer_ = {};
+  const uint16_t *dmaSourceBegin_ = nullptr;  // nullptr なら制限しない
+  const uint16_t *dmaSourceEnd_ = nullptr;
+  uint32_t invalidDmaSources_ = 0;
+};
+
+// 実機の LCD と同じ SPI 40MHz 相当の転送速度 [byte/us]
+constexpr uint32_t HOST_DMA_BYTES_PER_US = LCD_DMA_BYTES_PER_US;
+
+// ────────────────────── ホスト用キャンバス ──────────────────────
+// 描画コードが使う M5Canvas の API だけを同じ名前で実装する
+class HostCanvas
+{
+ public:
+  explicit HostCanvas(HostDisplay *parent = nullptr) : parent_(parent) {}
+
+  auto createSprite(int width, int height) -> void *;
+  // 外部で確保したバッファへ描画先を切り替える
+  void setBuffer(void *buffer, int width, int height, uint8_t /*unused*/ bpp = 16);
+  void setColorDepth(int /*unused*/) {}
+  void setPsram(bool /*unused*/) {}
+  void initDMA() {}
+
+  auto width() const -> int { return width_; }
+  auto height() const -> int { return height_; }
+  auto getBuffer() -> uint16_t * { return pixels_; }
+  auto getBuffer() const -> const uint16_t * { return pixels_; }
+  auto readPixel(int x, int y) const -> uint16_t { return pixels_[static_cast<size_t>(y) * width_ + x]; }
+
+  // ── 図形 ──
+  void drawPixel(int x, int y, uint16_t color);
+  void fillRect(int x, int y, int w, int h, uint16_t color);
+  void fillScreen(uint16_t color) { fillRect(0, 0, width_, height_, color); }
+  void writeFastHLine(int x, int y, int w, uint16_t color) { fillRect(x, y, w, 1, color); }
+  void drawLine(int x0, int y0, int x1, int y1, uint16_t color);
+  // LovyanGFX と同じく 0° を右、時計回りを正とする角度 [deg]
+  void fillArc(int x, int y, int r0, int r1, float angle0, float angle1, uint16_t color);
+
+  // ── 文字 ──
+  void setFont(const HostFont *font) { font_ = font; }
+  void setTextFont(int /*unused*/) { font_ = &fonts::Font0; }
+  void setTextSize(float size) { textSize_ = (size < 1.0F) ? 1 : static_cast<int>(size); }
+  void setTextColor(uint16_t color) { setTextColor(color, color); }
+  void setTextColor(uint16_t color, uint16_t background)
+  {
+    textColor_ = color;
+    textBackground_ = background;
+  }
+  void setCursor(int x, int y)
+  {
+    cursorX_ = x;
+    cursorY_ = y;
+  }
+  auto getCursorX() const -> int { return cursorX_; }
+  auto getCursorY() const -> int { return cursorY_; }
+  auto textWidth(const char *text) const -> int;
+  auto fontHeight() const -> int { return font_->height * textSize_; }
+
+  auto print(const char *text) -> size_t;
+  auto println(const char *text) -> size_t;
+  auto printf(const char *format, ...) -> size_t __attribute__((format(printf, 2, 3)));
+  void drawRightString(const char *text, int x, int y);
+
+  // ── 転送 ──
+  void pushSprite(int x, int y);
+
+ private:
+  void drawGlyph(char ch);
+
+  HostDisplay *parent_;
+  int width_ = 0;
+  int height_ = 0;
+  std::vector<uint16_t> storage_;
+  uint16_t *pixels_ = nullptr;
+
+  const HostFont *font_ = &fonts::Font0;
+  int textSize_ = 1;
+  uint16_t textColor_ = 0xFFFF;
+  uint16_t textBackground_ = 0xFFFF;
+  int cursorX_ = 0;
+  int cursorY_ = 0;
+};
+
+#endif  // HOST_CANVAS_H
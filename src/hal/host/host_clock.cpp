@@ -0,0 +1,72 @@
+#include "hal/hal.h"
+
+#include <chrono>
+
+// ────────────────────── 仮想時計 ──────────────────────
+// 実時間とは無関係に、呼び出し側が進めた分だけ時刻が進む
+static uint64_t virtualNowUs = 0;
+
+// 別コアのタスク（ホストでは取得タスク）。時計を進める途中で予定時刻に差し掛かったら、その時刻で回す
+static uint32_t (*backgroundTask)() = nullptr;
+static uint64_t backgroundDueUs = 0;
+static bool inBackgroundTask = false;
+
+// ワンショットのアラーム（実機の esp_timer）
+static void (*alarmHandler)() = nullptr;
+static uint64_t alarmDueUs = 0;
+static bool inAlarm = false;
+
+static void advanceTo(uint64_t targetUs)
+{
+  for (;;)
+  {
+    bool taskDue = backgroundTask != nullptr && !inBackgroundTask && backgroundDueUs <= targetUs;
+    bool alarmDue = alarmHandler != nullptr && !inAlarm && alarmDueUs <= targetUs;
+    if (!taskDue && !alarmDue)
+    {
+      break;
+    }
+    // 予定時刻の早い方から回す
+    if (alarmDue && (!taskDue || alarmDueUs <= backgroundDueUs))
+    {
+      if (alarmDueUs > virtualNowUs) virtualNowUs = alarmDueUs;
+      void (*alarm)() = alarmHandler;
+      alarmHandler = nullptr;
+      inAlarm = true;
+      alarm();
+      inAlarm = false;
+      continue;
+    }
+    if (backgroundDueUs > virtualNowUs) virtualNowUs = backgroundDueUs;
+    inBackgroundTask = true;
+    uint32_t waitUs = backgroundTask();
+    inBackgroundTask = false;
+    backgroundDueUs = virtualNowUs + ((waitUs > 0) ? waitUs : 1);
+  }
+  if (targetUs > virtualNowUs) virtualNowUs = targetUs;
+}
+
+auto halMillis() -> uint32_t { return static_cast<uint32_t>(virtualNowUs / 1000U); }
+auto halMicros() -> uint32_t { return static_cast<uint32_t>(virtualNowUs); }
+void halDelayMicroseconds(uint32_t us) { advanceTo(virtualNowUs + us); }
+
+void hostClockSetUs(uint64_t us) { virtualNowUs = us; }
+void hostClockAdvanceUs(uint64_t us) { advanceTo(virtualNowUs + us); }
+void hostClockSetBackgroundTask(uint32_t (*task)())
+{
+  backgroundTask = task;
+  backgroundDueUs = virtualNowUs;
+}
+void hostClockSetAlarm(uint64_t dueUs, void (*alarm)())
+{
+  alarmHandler = alarm;
+  alarmDueUs = dueUs;
+}
+auto hostClockNowUs() -> uint64_t { return virtualNowUs; }
+
+// 計測用カウンタは仮想時計ではなく実時間で数える
+auto halTicks() -> HalTicks
+{
+  return static_cast<HalTicks>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
@@ -0,0 +1,56 @@
+#include "host_log_fs.h"
+
+#include "hal/hal.h"
+
+auto HostLogFs::open(const char *path) -> bool
+{
+  current_ = &files[path];
+  current_->clear();
+  return true;
+}
+
+auto HostLogFs::write(const uint8_t *data, size_t length) -> size_t
+{
+  if (current_ == nullptr)
+  {
+    return 0;
+  }
+  if (capacityBytes != 0 && totalBytes() + length > capacityBytes)
+  {
+    return 0;
+  }
+  current_->insert(current_->end(), data, data + length);
+  writeSizes.push_back(length);
+  hostClockAdvanceUs(writeLatencyUs);
+  return length;
+}
+
+void HostLogFs::reset()
+{
+  files.clear();
+  writeSizes.clear();
+  flushCount = 0;
+  writeLatencyUs = 0;
+  capacityBytes = 0;
+  current_ = nullptr;
+}
+
+auto HostLogFs::totalBytes() const -> size_t
+{
+  size_t total = 0;
+  for (const auto &file : files)
+  {
+    total += file.second.size();
+  }
+  return total;
+}
+
+auto hostLogFs() -> HostLogFs &
+{
+  static HostLogFs fs;
+  return fs;
+}
+
+auto halLogFs() -> LogFileSink & { return hostLogFs(); }
+
+auto halLogFsBegin() -> bool { return true; }
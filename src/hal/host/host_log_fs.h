@@ -0,0 +1,41 @@
+#ifndef HOST_LOG_FS_H
+#define HOST_LOG_FS_H
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "hal/hal_log_fs.h"
+
+// ────────────────────── LittleFS の代替 ──────────────────────
+// ファイルをメモリ上に保持し、書き込み回数とサイズを記録する。
+// writeLatencyUs を設定すると 1 回の書き込みごとに仮想時計を進め、フラッシュの遅さを模擬する。
+class HostLogFs : public LogFileSink
+{
+ public:
+  auto exists(const char *path) -> bool override { return files.count(path) != 0; }
+  auto open(const char *path) -> bool override;
+  auto write(const uint8_t *data, size_t length) -> size_t override;
+  void flush() override { flushCount++; }
+  void close() override { current_ = nullptr; }
+
+  void reset();
+
+  std::map<std::string, std::vector<uint8_t>> files;
+  std::vector<size_t> writeSizes;
+  uint32_t flushCount = 0;
+  uint32_t writeLatencyUs = 0;
+  // 0 以外なら総容量を超えた分の書き込みを失敗させる
+  size_t capacityBytes = 0;
+
+ private:
+  auto totalBytes() const -> size_t;
+
+  std::vector<uint8_t> *current_ = nullptr;
+};
+
+auto hostLogFs() -> HostLogFs &;
+
+#endif  // HOST_LOG_FS_H
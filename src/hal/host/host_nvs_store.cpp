@@ -0,0 +1,59 @@
+#include "host_nvs_store.h"
+
+#include <cstring>
+
+auto HostNvsStore::read(const char *key, void *data, size_t length) -> bool
+{
+  auto found = blobs.find(key);
+  if (found == blobs.end() || found->second.size() != length)
+  {
+    return false;
+  }
+  std::memcpy(data, found->second.data(), length);
+  return true;
+}
+
+auto HostNvsStore::write(const char *key, const void *data, size_t length) -> bool
+{
+  if (failWrites)
+  {
+    return false;
+  }
+  const auto *bytes = static_cast<const uint8_t *>(data);
+  blobs[key].assign(bytes, bytes + length);
+  writeCount++;
+  requestedBytes += length;
+  flashBytes += flashBytesFor(length);
+  return true;
+}
+
+auto HostNvsStore::erase(const char *key) -> bool { return blobs.erase(key) != 0; }
+
+void HostNvsStore::reset()
+{
+  blobs.clear();
+  writeCount = 0;
+  requestedBytes = 0;
+  flashBytes = 0;
+  failWrites = false;
+}
+
+auto HostNvsStore::flashBytesFor(size_t length) -> size_t
+{
+  return (2 + (length + ENTRY_BYTES - 1) / ENTRY_BYTES) * ENTRY_BYTES;
+}
+
+auto HostNvsStore::writeAmplification() const -> float
+{
+  return (requestedBytes == 0) ? 0.0F : static_cast<float>(flashBytes) / static_cast<float>(requestedBytes);
+}
+
+auto hostNvsStore() -> HostNvsStore &
+{
+  static HostNvsStore store;
+  return store;
+}
+
+auto halNvs() -> NvsStore & { return hostNvsStore(); }
+
+auto halNvsBegin() -> bool { return true; }
@@ -0,0 +1,41 @@
+#ifndef HOST_NVS_STORE_H
+#define HOST_NVS_STORE_H
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "hal/hal_nvs.h"
+
+// ────────────────────── NVS の代替 ──────────────────────
+// blob をメモリ上に保持し、書き込み回数と実際にフラッシュへ書かれるバイト数を数える。
+// ESP-IDF の NVS は 32B のエントリ単位で追記し、blob 1 つに
+// ヘッダ 1 エントリ＋データ ceil(n/32) エントリ＋索引 1 エントリを使う。
+class HostNvsStore : public NvsStore
+{
+ public:
+  static constexpr size_t ENTRY_BYTES = 32;
+
+  auto read(const char *key, void *data, size_t length) -> bool override;
+  auto write(const char *key, const void *data, size_t length) -> bool override;
+  auto erase(const char *key) -> bool override;
+
+  void reset();
+  // blob の長さ length を 1 回書くときにフラッシュへ書かれるバイト数
+  static auto flashBytesFor(size_t length) -> size_t;
+  // 書き込みを頼まれたバイト数に対する、フラッシュへ書いたバイト数の比
+  auto writeAmplification() const -> float;
+
+  std::map<std::string, std::vector<uint8_t>> blobs;
+  uint32_t writeCount = 0;
+  uint64_t requestedBytes = 0;
+  uint64_t flashBytes = 0;
+  // true の間は書き込みを失敗させる
+  bool failWrites = false;
+};
+
+auto hostNvsStore() -> HostNvsStore &;
+
+#endif  // HOST_NVS_STORE_H
@@ -0,0 +1,42 @@
+#include "host_power.h"
+
+#include "hal/hal.h"
+
+static HostPowerState powerState = {};
+static uint32_t supplyMillivolts = 5000;
+static bool powerManagementAvailable = true;
+
+auto hostPowerState() -> HostPowerState & { return powerState; }
+
+auto halBeginPowerManagement(uint32_t maxMhz, uint32_t minMhz, bool lightSleep) -> bool
+{
+  powerState = {};
+  powerState.maxMhz = maxMhz;
+  powerState.minMhz = minMhz;
+  powerState.lightSleep = lightSleep;
+  return powerManagementAvailable;
+}
+
+void hostSetPowerManagementAvailable(bool available) { powerManagementAvailable = available; }
+
+void halSetCpuBoost(bool boost)
+{
+  if (boost && !powerState.boosted)
+  {
+    powerState.boostCount++;
+  }
+  powerState.boosted = boost;
+}
+
+void halHoldAwake(bool hold) { powerState.awakeHeld = hold; }
+
+void halIdleUs(uint32_t us)
+{
+  powerState.idleCount++;
+  powerState.idleUs += us;
+  hostClockAdvanceUs(us);
+}
+
+void hostSetSupplyMillivolts(uint32_t mv) { supplyMillivolts = mv; }
+
+auto halSupplyMillivolts() -> uint32_t { return supplyMillivolts; }
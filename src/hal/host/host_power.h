@@ -0,0 +1,28 @@
+#ifndef HOST_POWER_H
+#define HOST_POWER_H
+
+#include <stdint.h>
+
+#include "hal/hal_power.h"
+
+// ────────────────────── 電源管理の代替 ──────────────────────
+// 設定と切り替えの回数を記録し、待機は仮想時計を進めるだけにする
+struct HostPowerState
+{
+  uint32_t maxMhz;
+  uint32_t minMhz;
+  bool lightSleep;
+  bool boosted;
+  bool awakeHeld;       // halHoldAwake(true) の間
+  uint32_t boostCount;  // 最高周波数へ上げた回数
+  uint32_t idleCount;
+  uint64_t idleUs;
+};
+
+auto hostPowerState() -> HostPowerState &;
+// false なら halBeginPowerManagement() が失敗し、周波数を直接切り替える経路を試せる（既定 true）
+void hostSetPowerManagementAvailable(bool available);
+// halSupplyMillivolts() が返す電圧（既定 5000mV）
+void hostSetSupplyMillivolts(uint32_t mv);
+
+#endif  // HOST_POWER_H
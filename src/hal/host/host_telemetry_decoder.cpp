@@ -0,0 +1,140 @@
+#include "host_telemetry_decoder.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <string>
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "columnar output is written in host byte order");
+
+// ────────────────────── 受信 ──────────────────────
+void TelemetryCapture::feed(const uint8_t *data, size_t length)
+{
+  TelemetryRecord record = {};
+  for (size_t i = 0; i < length; ++i)
+  {
+    if (!decoder_.push(data[i], record))
+    {
+      continue;
+    }
+    if (record.type == TelemetryType::Sample)
+    {
+      samples.push_back(record);
+    }
+    else
+    {
+      frames.push_back(record);
+    }
+  }
+}
+
+auto TelemetryCapture::read(int fd, int timeoutMs) -> long
+{
+  pollfd target = {fd, POLLIN, 0};
+  int ready = ::poll(&target, 1, timeoutMs);
+  if (ready < 0)
+  {
+    return -1;
+  }
+  if (ready == 0)
+  {
+    return 0;
+  }
+  // 相手側の pty が閉じられると POLLHUP と共に EIO が返るので、どちらも終端として扱う
+  uint8_t buffer[4096];
+  ssize_t length = ::read(fd, buffer, sizeof(buffer));
+  if (length <= 0)
+  {
+    return -1;
+  }
+  feed(buffer, static_cast<size_t>(length));
+  return static_cast<long>(length);
+}
+
+auto openTelemetryInput(const char *path) -> int
+{
+  int fd = ::open(path, O_RDONLY | O_NOCTTY);
+  if (fd < 0 || !::isatty(fd))
+  {
+    return fd;
+  }
+  termios tty = {};
+  if (::tcgetattr(fd, &tty) == 0)
+  {
+    ::cfmakeraw(&tty);
+    ::tcsetattr(fd, TCSANOW, &tty);
+  }
+  return fd;
+}
+
+// ────────────────────── CSV ──────────────────────
+auto TelemetryCapture::writeCsv(const char *prefix) const -> bool
+{
+  std::string base = prefix;
+  FILE *file = std::fopen((base + "_samples.csv").c_str(), "w");
+  if (file == nullptr)
+  {
+    return false;
+  }
+  std::fprintf(file, "seq,t_us,channel,raw,value\n");
+  for (const TelemetryRecord &record : samples)
+  {
+    std::fprintf(file, "%u,%u,%u,%d,%d\n", record.sequence, static_cast<unsigned>(record.sample.timestampUs),
+                 record.sample.channel, record.sample.raw, static_cast<int>(record.sample.value));
+  }
+  bool ok = std::fclose(file) == 0;
+
+  file = std::fopen((base + "_frames.csv").c_str(), "w");
+  if (file == nullptr)
+  {
+    return false;
+  }
+  std::fprintf(file, "seq,frame,start_us,frame_us,fence_us,push_bytes\n");
+  for (const TelemetryRecord &record : frames)
+  {
+    const TelemetryFrame &frame = record.frame;
+    std::fprintf(file, "%u,%u,%u,%u,%u,%u\n", record.sequence, static_cast<unsigned>(frame.index),
+                 static_cast<unsigned>(frame.startUs), static_cast<unsigned>(frame.frameUs),
+                 static_cast<unsigned>(frame.fenceWaitUs), static_cast<unsigned>(frame.pushBytes));
+  }
+  return (std::fclose(file) == 0) && ok;
+}
+
+// ────────────────────── 列形式 ──────────────────────
+template <typename T, typename F>
+static auto writeColumn(const std::string &path, const std::vector<TelemetryRecord> &records, F field) -> bool
+{
+  FILE *file = std::fopen(path.c_str(), "wb");
+  if (file == nullptr)
+  {
+    return false;
+  }
+  for (const TelemetryRecord &record : records)
+  {
+    T value = static_cast<T>(field(record));
+    std::fwrite(&value, sizeof(value), 1, file);
+  }
+  return std::fclose(file) == 0;
+}
+
+auto TelemetryCapture::writeColumns(const char *prefix) const -> bool
+{
+  std::string s = std::string(prefix) + ".samples.";
+  std::string f = std::string(prefix) + ".frames.";
+  using R = const TelemetryRecord &;
+  bool ok = writeColumn<uint16_t>(s + "seq.u16", samples, [](R r) { return r.sequence; });
+  ok = writeColumn<uint32_t>(s + "t_us.u32", samples, [](R r) { return r.sample.timestampUs; }) && ok;
+  ok = writeColumn<uint8_t>(s + "channel.u8", samples, [](R r) { return r.sample.channel; }) && ok;
+  ok = writeColumn<int16_t>(s + "raw.i16", samples, [](R r) { return r.sample.raw; }) && ok;
+  ok = writeColumn<int32_t>(s + "value.i32", samples, [](R r) { return r.sample.value; }) && ok;
+  ok = writeColumn<uint16_t>(f + "seq.u16", frames, [](R r) { return r.sequence; }) && ok;
+  ok = writeColumn<uint32_t>(f + "frame.u32", frames, [](R r) { return r.frame.index; }) && ok;
+  ok = writeColumn<uint32_t>(f + "start_us.u32", frames, [](R r) { return r.frame.startUs; }) && ok;
+  ok = writeColumn<uint32_t>(f + "frame_us.u32", frames, [](R r) { return r.frame.frameUs; }) && ok;
+  ok = writeColumn<uint32_t>(f + "fence_us.u32", frames, [](R r) { return r.frame.fenceWaitUs; }) && ok;
+  ok = writeColumn<uint32_t>(f + "push_bytes.u32", frames, [](R r) { return r.frame.pushBytes; }) && ok;
+  return ok;
+}
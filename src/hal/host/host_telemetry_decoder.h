@@ -0,0 +1,42 @@
+#ifndef HOST_TELEMETRY_DECODER_H
+#define HOST_TELEMETRY_DECODER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "modules/telemetry.h"
+
+// ────────────────────── テレメトリの受信と書き出し ──────────────────────
+// USB シリアル (/dev/ttyACM0 など)・pty・保存済みのファイルから COBS フレームを読んで復号し、
+// CSV か列ごとのバイナリファイルへ書き出す。
+//   CSV   : <prefix>_samples.csv … seq,t_us,channel,raw,value
+//           <prefix>_frames.csv  … seq,frame,start_us,frame_us,fence_us,push_bytes
+//   列形式: <prefix>.samples.<列名>.<型> と <prefix>.frames.<列名>.<型>。
+//           型 (u8/u16/i16/i32/u32) のリトルエンディアン配列で、numpy.fromfile(path, "<u4") などでそのまま読める
+
+class TelemetryCapture
+{
+ public:
+  void feed(const uint8_t *data, size_t length);
+  // fd から今読める分を読んで復号する。
+  // 読んだバイト数を返す。timeoutMs 待っても届かなければ 0、終端・エラーなら -1
+  auto read(int fd, int timeoutMs) -> long;
+
+  auto writeCsv(const char *prefix) const -> bool;
+  auto writeColumns(const char *prefix) const -> bool;
+
+  auto decoder() const -> const TelemetryDecoder & { return decoder_; }
+
+  std::vector<TelemetryRecord> samples;
+  std::vector<TelemetryRecord> frames;
+
+ private:
+  TelemetryDecoder decoder_;
+};
+
+// 端末ならエコーや改行変換をしない raw モードにして読み出し用に開く。失敗したら -1
+auto openTelemetryInput(const char *path) -> int;
+
+#endif  // HOST_TELEMETRY_DECODER_H
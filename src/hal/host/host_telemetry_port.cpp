@@ -0,0 +1,46 @@
+#include "host_telemetry_port.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+auto HostTelemetryPort::write(const uint8_t *data, size_t length) -> size_t
+{
+  if (fd_ < 0 || length == 0)
+  {
+    return 0;
+  }
+  ssize_t written = ::write(fd_, data, length);
+  if (written < 0)
+  {
+    // EAGAIN は相手の受信バッファが一杯なだけなので、次の service() で送り直す
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+    {
+      shortWrites++;
+    }
+    return 0;
+  }
+  if (static_cast<size_t>(written) < length)
+  {
+    shortWrites++;
+  }
+  bytesWritten += static_cast<uint64_t>(written);
+  return static_cast<size_t>(written);
+}
+
+void HostTelemetryPort::setFd(int fd)
+{
+  fd_ = fd;
+  if (fd_ >= 0)
+  {
+    ::fcntl(fd_, F_SETFL, ::fcntl(fd_, F_GETFL) | O_NONBLOCK);
+  }
+}
+
+auto hostTelemetryPort() -> HostTelemetryPort &
+{
+  static HostTelemetryPort port;
+  return port;
+}
+
+auto halTelemetryPort() -> TelemetryPort & { return hostTelemetryPort(); }
@@ -0,0 +1,30 @@
+#ifndef HOST_TELEMETRY_PORT_H
+#define HOST_TELEMETRY_PORT_H
+
+#include <stdint.h>
+
+#include "hal/hal_telemetry.h"
+
+// ────────────────────── USB シリアルの代替 ──────────────────────
+// 非ブロッキングにしたファイル記述子へ書く。相手が詰まっていれば (EAGAIN) 0 を返す。
+// 記述子を設定していない間は何も送らない。
+class HostTelemetryPort : public TelemetryPort
+{
+ public:
+  auto write(const uint8_t *data, size_t length) -> size_t override;
+
+  // fd を非ブロッキングにして送信先にする（-1 で外す）。所有権は呼び出し側に残る
+  void setFd(int fd);
+  auto fd() const -> int { return fd_; }
+
+  uint64_t bytesWritten = 0;
+  // 要求より少なくしか書けなかった回数（受信側が詰まっていた回数）
+  uint32_t shortWrites = 0;
+
+ private:
+  int fd_ = -1;
+};
+
+auto hostTelemetryPort() -> HostTelemetryPort &;
+
+#endif  // HOST_TELEMETRY_PORT_H
@@ -0,0 +1,190 @@
+#include "host_trace_replay.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "config.h"
+#include "hal/hal.h"
+#include "modules/display.h"
+#include "modules/rate_scheduler.h"
+#include "modules/sensor.h"
+#include "modules/session_log.h"
+
+// ────────────────────── 読み込み ──────────────────────
+auto parseTraceCsv(const char *text, size_t length, std::vector<TraceSample> &samples) -> bool
+{
+  samples.clear();
+  const char *end = text + length;
+  const char *line = text;
+  while (line < end)
+  {
+    const char *lineEnd = static_cast<const char *>(std::memchr(line, '\n', end - line));
+    if (lineEnd == nullptr) lineEnd = end;
+
+    if (std::isdigit(static_cast<unsigned char>(*line)))
+    {
+      // strtoull などが行末を越えて読まないよう、1 行を NUL 終端の一時領域へ写す
+      char buffer[64];
+      size_t n = std::min<size_t>(lineEnd - line, sizeof(buffer) - 1);
+      std::memcpy(buffer, line, n);
+      buffer[n] = '\0';
+
+      char *cursor = nullptr;
+      uint64_t timeUs = std::strtoull(buffer, &cursor, 10);
+      if (*cursor != ',') return false;
+      long channel = std::strtol(cursor + 1, &cursor, 10);
+      if (*cursor != ',') return false;
+      long raw = std::strtol(cursor + 1, &cursor, 10);
+      if (channel < 0 || channel > 3 || raw < INT16_MIN || raw > INT16_MAX) return false;
+      samples.push_back({timeUs, static_cast<uint8_t>(channel), static_cast<int16_t>(raw)});
+    }
+    line = lineEnd + 1;
+  }
+  if (samples.empty()) return false;
+
+  // 時刻順に並べ、先頭を 0 に揃える
+  std::stable_sort(samples.begin(), samples.end(),
+                   [](const TraceSample &a, const TraceSample &b) { return a.timeUs < b.timeUs; });
+  uint64_t firstUs = samples.front().timeUs;
+  for (TraceSample &sample : samples)
+  {
+    sample.timeUs -= firstUs;
+  }
+  return true;
+}
+
+auto parseTraceLog(const uint8_t *data, size_t size, std::vector<TraceSample> &samples) -> bool
+{
+  samples.clear();
+  SessionLogReader reader;
+  if (!reader.open(data, size))
+  {
+    return false;
+  }
+  SessionLogEntry entry;
+  uint64_t elapsedUs = 0;
+  uint32_t lastUs = 0;
+  while (reader.next(entry))
+  {
+    if (!samples.empty())
+    {
+      elapsedUs += entry.timestampUs - lastUs;
+    }
+    lastUs = entry.timestampUs;
+    samples.push_back({elapsedUs, entry.channel, entry.raw});
+  }
+  return !samples.empty();
+}
+
+auto loadTraceFile(const char *path, std::vector<TraceSample> &samples) -> bool
+{
+  FILE *file = std::fopen(path, "rb");
+  if (file == nullptr)
+  {
+    return false;
+  }
+  std::vector<uint8_t> data;
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+  {
+    data.insert(data.end(), chunk, chunk + n);
+  }
+  std::fclose(file);
+
+  if (data.size() >= sizeof(SESSION_LOG_MAGIC) &&
+      std::memcmp(data.data(), SESSION_LOG_MAGIC, sizeof(SESSION_LOG_MAGIC)) == 0)
+  {
+    return parseTraceLog(data.data(), data.size(), samples);
+  }
+  return parseTraceCsv(reinterpret_cast<const char *>(data.data()), data.size(), samples);
+}
+
+// ────────────────────── 再生 ──────────────────────
+auto defaultTraceReplayOptions() -> TraceReplayOptions
+{
+  // 取得は実機のセンサタスクの 1tick 待ちより細かく回す
+  return {100, 1000000UL / RENDER_RATE_HZ, nullptr};
+}
+
+// スケジューラのタスクは引数を取らないので、再生中の状態はここに置く
+static const TraceReplayOptions *replayOptions = nullptr;
+static TraceReplayResult *replayResult = nullptr;
+static uint64_t replayStartUs = 0;
+
+static void replayRenderTask()
+{
+  uint64_t pushBefore = mainCanvas.totalPushBytes();
+  auto start = std::chrono::steady_clock::now();
+  updateGauges();
+  auto end = std::chrono::steady_clock::now();
+  auto renderNs = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+  replayResult->frameNs.record(renderNs);
+
+  if (replayOptions->onFrame != nullptr)
+  {
+    ReplayFrame frame = {replayResult->frames,
+                         hostClockNowUs() - replayStartUs,
+                         displayCache[GaugeSource::OilPressure],
+                         displayCache[GaugeSource::WaterTemp],
+                         displayCache[GaugeSource::OilTemp],
+                         renderNs,
+                         static_cast<uint32_t>(mainCanvas.totalPushBytes() - pushBefore)};
+    replayOptions->onFrame(frame);
+  }
+  replayResult->frames++;
+}
+
+auto runTraceReplay(const std::vector<TraceSample> &samples, const TraceReplayOptions &options, HostAds1015 &ads)
+    -> TraceReplayResult
+{
+  TraceReplayResult result = {};
+  if (samples.empty())
+  {
+    return result;
+  }
+  replayOptions = &options;
+  replayResult = &result;
+  replayStartUs = hostClockNowUs();
+
+  RateScheduler scheduler;
+  uint32_t now = halMicros();
+  scheduler.addTask("acquire", options.acquireStepUs, acquireSensorData, now + options.acquireStepUs);
+  scheduler.addTask("render", options.frameIntervalUs, replayRenderTask, now + options.frameIntervalUs);
+
+  auto wallStart = std::chrono::steady_clock::now();
+  size_t next = 0;
+  for (;;)
+  {
+    // 到達したサンプルを ADS の入力へ反映する（次のサンプルまでは同じ値を保持）
+    uint64_t elapsedUs = hostClockNowUs() - replayStartUs;
+    while (next < samples.size() && samples[next].timeUs <= elapsedUs)
+    {
+      ads.channelCode[samples[next].channel & 0x03] = samples[next].raw;
+      next++;
+    }
+    scheduler.runDue();
+    if (next >= samples.size())
+    {
+      break;
+    }
+
+    // 次のサンプルか次の締め切りの早いほうまで時計を進める
+    elapsedUs = hostClockNowUs() - replayStartUs;
+    uint64_t untilSampleUs = (samples[next].timeUs > elapsedUs) ? samples[next].timeUs - elapsedUs : 0;
+    hostClockAdvanceUs(std::min<uint64_t>(scheduler.untilNextDeadlineUs(halMicros()), untilSampleUs));
+  }
+  finishFrameTransfer();
+  auto wallEnd = std::chrono::steady_clock::now();
+
+  result.traceUs = hostClockNowUs() - replayStartUs;
+  result.wallSeconds = std::chrono::duration<double>(wallEnd - wallStart).count();
+  result.frameHash = display.frameHash();
+  replayOptions = nullptr;
+  replayResult = nullptr;
+  return result;
+}
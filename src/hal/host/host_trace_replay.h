@@ -0,0 +1,71 @@
+#ifndef HOST_TRACE_REPLAY_H
+#define HOST_TRACE_REPLAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "host_ads1015.h"
+#include "modules/stage_timing.h"
+
+// ────────────────────── 記録済みトレースの再生 ──────────────────────
+// 走行中に記録した生の ADC コードを ADS1015 シミュレータの入力として時刻どおりに与え、
+// 実機と同じ acquireSensorData() → updateGauges() → renderDisplayAndLog() を仮想時計で回す。
+// 仮想時計は次のサンプルか次の締め切りまで一気に進めるので、CPU が許す限り実時間より速く回る。
+//
+// 入力は次のどちらか（先頭 4B がセッションログのマジックならバイナリとして読む）
+//   ・セッションログ (/session_NNNN.bin)
+//   ・CSV: 1 行 1 サンプルの "t_us,channel,raw"。数字で始まらない行（見出し・# コメント）は読み飛ばす
+
+struct TraceSample
+{
+  uint64_t timeUs;  // トレース先頭からの経過時間
+  uint8_t channel;
+  int16_t raw;
+};
+
+auto parseTraceCsv(const char *text, size_t length, std::vector<TraceSample> &samples) -> bool;
+// uint32 の時刻の折り返し（約 71 分）を畳み込んで 64bit の経過時間にする
+auto parseTraceLog(const uint8_t *data, size_t size, std::vector<TraceSample> &samples) -> bool;
+auto loadTraceFile(const char *path, std::vector<TraceSample> &samples) -> bool;
+
+// 1 フレーム描いた直後の状態
+struct ReplayFrame
+{
+  uint32_t index;
+  uint64_t timeUs;  // トレース先頭からの経過時間
+  float pressure;   // 画面に出ている値 [bar]
+  float waterTemp;  // [℃]
+  float oilTemp;    // [℃]
+  uint32_t renderNs;   // updateGauges() の実時間
+  uint32_t pushBytes;  // このフレームで LCD へ送ったバイト数
+};
+
+using ReplayFrameFn = void (*)(const ReplayFrame &frame);
+
+struct TraceReplayOptions
+{
+  uint32_t acquireStepUs;  // acquireSensorData() を回す間隔
+  uint32_t frameIntervalUs;
+  ReplayFrameFn onFrame;   // nullptr なら呼ばない
+};
+
+auto defaultTraceReplayOptions() -> TraceReplayOptions;
+
+struct TraceReplayResult
+{
+  uint32_t frames;
+  uint64_t traceUs;
+  double wallSeconds;
+  uint32_t frameHash;  // LCD 側フレームバッファのハッシュ
+  LogHistogram frameNs;
+
+  auto speedup() const -> double { return (wallSeconds > 0.0) ? traceUs / 1e6 / wallSeconds : 0.0; }
+};
+
+// 表示・取得を初期化済みの状態から、トレースの最後のサンプルまで再生する
+auto runTraceReplay(const std::vector<TraceSample> &samples, const TraceReplayOptions &options, HostAds1015 &ads)
+    -> TraceReplayResult;
+
+#endif  // HOST_TRACE_REPLAY_H
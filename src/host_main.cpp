@@ -0,0 +1,244 @@
+// ────────────────────── ホスト実行用エントリ ──────────────────────
+// pio run -e native で生成されるプログラム。実機の loop() の代わりに
+// 仮想時計を進めながら 取得→平滑化→描画 のパイプラインを回す。
+//   program [frames]                     … 入力電圧を三角波で動かして frames 枚描く
+//   program --replay trace [frames.csv]  … 記録済みトレースを再生する（フレームごとの値と時間を CSV へ）
+//   program --bench                      … 換算・描画のマイクロベンチマークを JSON で出力する
+//   program --telemetry out [frames]     … 三角波の実行中のテレメトリを out（ファイルや pty）へ送る
+//   program --decode in prefix [--columnar]
+//                                        … テレメトリを読んで prefix_samples.csv / prefix_frames.csv
+//                                          （--columnar なら列ごとのバイナリ）へ書き出す
+#if !defined(ARDUINO) && !defined(PIO_UNIT_TESTING)
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "config.h"
+#include "hal/hal.h"
+#include "hal/hal_power.h"
+#include "hal/host/host_ads1015.h"
+#include "hal/host/host_nvs_store.h"
+#include "hal/host/host_telemetry_decoder.h"
+#include "hal/host/host_telemetry_port.h"
+#include "hal/host/host_trace_replay.h"
+#include "modules/display.h"
+#include "modules/frame_pacer.h"
+#include "modules/gauge_benchmarks.h"
+#include "modules/rate_scheduler.h"
+#include "modules/sensor.h"
+#include "modules/session_records.h"
+#include "modules/session_stats.h"
+#include "modules/stage_timing.h"
+#include "modules/telemetry.h"
+
+// 受信側でこの時間何も届かなければ送信が終わったとみなす [ms]
+constexpr int TELEMETRY_IDLE_TIMEOUT_MS = 2000;
+
+static int renderedFrames = 0;
+static FramePacer framePacer;
+
+// 0→1→0 と往復する三角波
+static auto triangle(float phase) -> float
+{
+  float p = phase - static_cast<float>(static_cast<int>(phase));
+  return (p < 0.5F) ? p * 2.0F : 2.0F - p * 2.0F;
+}
+
+// 入力電圧を動かしてから 1 フレーム描く
+static void renderTask()
+{
+  float sweep = triangle(static_cast<float>(renderedFrames) / 300.0F);
+  // 油圧は 0.5→4.5V、温度は約 60→110℃ の範囲で動かす
+  HostAds1015 &ads = hostAds1015();
+  ads.setChannelVoltage(ADC_CH_OIL_PRESSURE, 0.5F + 4.0F * sweep);
+  ads.setChannelVoltage(ADC_CH_WATER_TEMP, 1.2F - 0.75F * sweep);
+  ads.setChannelVoltage(ADC_CH_OIL_TEMP, 1.2F - 0.8F * sweep);
+  framePacer.countFrame(updateGauges());
+  renderedFrames++;
+}
+
+static void recordsTask() { sessionRecords().service(halMillis(), halSupplyMillivolts()); }
+
+// コア0 の取得タスクの代わり。実機と同じく次に状態が進む時刻まで眠る
+static auto sensorCoreTask() -> uint32_t
+{
+  acquireSensorData();
+  return sensorTaskWaitUs(halMicros());
+}
+
+// ────────────────────── トレース再生 ──────────────────────
+static FILE *frameCsv = nullptr;
+
+static void writeFrameCsv(const ReplayFrame &frame)
+{
+  std::fprintf(frameCsv, "%u,%.3f,%.2f,%.1f,%.1f,%.1f,%u\n", static_cast<unsigned>(frame.index), frame.timeUs / 1000.0,
+               frame.pressure, frame.waterTemp, frame.oilTemp, frame.renderNs / 1000.0F,
+               static_cast<unsigned>(frame.pushBytes));
+}
+
+static auto replayTrace(const char *tracePath, const char *framesPath) -> int
+{
+  std::vector<TraceSample> samples;
+  if (!loadTraceFile(tracePath, samples))
+  {
+    std::fprintf(stderr, "cannot read trace: %s\n", tracePath);
+    return 1;
+  }
+
+  TraceReplayOptions options = defaultTraceReplayOptions();
+  if (framesPath != nullptr)
+  {
+    frameCsv = std::fopen(framesPath, "w");
+    if (frameCsv == nullptr)
+    {
+      std::fprintf(stderr, "cannot write: %s\n", framesPath);
+      return 1;
+    }
+    std::fprintf(frameCsv, "frame,t_ms,oil_bar,water_c,oil_c,render_us,push_bytes\n");
+    options.onFrame = writeFrameCsv;
+  }
+
+  TraceReplayResult result = runTraceReplay(samples, options, hostAds1015());
+  if (frameCsv != nullptr)
+  {
+    std::fclose(frameCsv);
+  }
+
+  std::printf("samples=%zu trace=%.1fs wall=%.2fs (x%.0f)\n", samples.size(), result.traceUs / 1e6, result.wallSeconds,
+              result.speedup());
+  std::printf("frames=%u hash=%08x\n", static_cast<unsigned>(result.frames), static_cast<unsigned>(result.frameHash));
+  std::printf("display oil=%.2fbar water=%.1fC oil_temp=%.1fC\n", displayCache[GaugeSource::OilPressure],
+              displayCache[GaugeSource::WaterTemp], displayCache[GaugeSource::OilTemp]);
+  std::printf("frame render p50=%luns p99=%luns max=%luns\n",
+              static_cast<unsigned long>(result.frameNs.percentile(50.0F)),
+              static_cast<unsigned long>(result.frameNs.percentile(99.0F)),
+              static_cast<unsigned long>(result.frameNs.max()));
+  dumpAcquisitionRates();
+  return 0;
+}
+
+// ────────────────────── テレメトリの復号 ──────────────────────
+static auto decodeTelemetry(const char *inputPath, const char *prefix, bool columnar) -> int
+{
+  int fd = openTelemetryInput(inputPath);
+  if (fd < 0)
+  {
+    std::fprintf(stderr, "cannot open: %s\n", inputPath);
+    return 1;
+  }
+  TelemetryCapture capture;
+  while (capture.read(fd, TELEMETRY_IDLE_TIMEOUT_MS) > 0)
+  {
+  }
+  ::close(fd);
+
+  bool ok = columnar ? capture.writeColumns(prefix) : capture.writeCsv(prefix);
+  if (!ok)
+  {
+    std::fprintf(stderr, "cannot write: %s\n", prefix);
+    return 1;
+  }
+  const TelemetryDecoder &decoder = capture.decoder();
+  std::printf("records=%u samples=%zu frames=%zu lost=%u crc_errors=%u framing_errors=%u\n",
+              static_cast<unsigned>(decoder.recordCount()), capture.samples.size(), capture.frames.size(),
+              static_cast<unsigned>(decoder.lostCount()), static_cast<unsigned>(decoder.crcErrorCount()),
+              static_cast<unsigned>(decoder.framingErrorCount()));
+  return 0;
+}
+
+auto main(int argc, char **argv) -> int
+{
+  display.init();
+  mainCanvas.setColorDepth(DISPLAY_COLOR_DEPTH);
+  beginFramePipeline();
+  beginDisplayLayers();
+  beginSensorAcquisition();
+  halNvsBegin();
+  sessionRecords().begin(halMillis());
+
+  if (argc > 2 && std::strcmp(argv[1], "--replay") == 0)
+  {
+    return replayTrace(argv[2], (argc > 3) ? argv[3] : nullptr);
+  }
+  if (argc > 1 && std::strcmp(argv[1], "--bench") == 0)
+  {
+    runAllBenchmarks();
+    return 0;
+  }
+  if (argc > 3 && std::strcmp(argv[1], "--decode") == 0)
+  {
+    return decodeTelemetry(argv[2], argv[3], argc > 4 && std::strcmp(argv[4], "--columnar") == 0);
+  }
+  int telemetryFd = -1;
+  if (argc > 2 && std::strcmp(argv[1], "--telemetry") == 0)
+  {
+    telemetryFd = ::open(argv[2], O_WRONLY | O_CREAT | O_TRUNC | O_NOCTTY, 0644);
+    if (telemetryFd < 0)
+    {
+      std::fprintf(stderr, "cannot write: %s\n", argv[2]);
+      return 1;
+    }
+    hostTelemetryPort().setFd(telemetryFd);
+    setTelemetryActive(true);
+    argc -= 2;
+    argv += 2;
+  }
+  int frames = (argc > 1) ? std::atoi(argv[1]) : 600;
+
+  // 実機と同じスケジューラと間隔制御を仮想時計で回す（眠る間は時計を進めるだけ）。
+  // 取得は別コアのタスクとして、時計が進む間に予定時刻ごとに回す
+  RateScheduler scheduler;
+  uint32_t now = halMicros();
+  hostClockSetBackgroundTask(sensorCoreTask);
+  scheduler.addTask("render", 1000000UL / RENDER_RATE_HZ, renderTask, now + 1000000UL / RENDER_RATE_HZ);
+  if (telemetryActive())
+  {
+    scheduler.addTask("telemetry", TELEMETRY_SERVICE_INTERVAL_MS * 1000UL, serviceTelemetry, now);
+  }
+  if (RECORDS_ENABLED)
+  {
+    scheduler.addTask("records", RECORDS_SERVICE_INTERVAL_MS * 1000UL, recordsTask, now);
+  }
+  framePacer.begin(false);
+  while (renderedFrames < frames)
+  {
+    framePacer.runOnce(scheduler);
+  }
+  finishFrameTransfer();
+  if (telemetryFd >= 0)
+  {
+    // 受信側が読み終えるまで送り切る（ファイルなら 1 回で済む）
+    while (telemetry().queuedBytes() > 0)
+    {
+      if (telemetry().service() == 0) ::usleep(1000);
+    }
+    ::close(telemetryFd);
+    const TelemetryEncoder &encoder = telemetry();
+    std::printf("telemetry records=%u dropped=%u bytes=%u ring_high_water=%zu\n",
+                static_cast<unsigned>(encoder.recordCount()), static_cast<unsigned>(encoder.droppedCount()),
+                static_cast<unsigned>(encoder.bytesSent()), encoder.ringHighWater());
+  }
+
+  std::printf("frames=%d hash=%08x push=%llu bytes/frame\n", frames, static_cast<unsigned>(display.frameHash()),
+              static_cast<unsigned long long>(mainCanvas.totalPushBytes() / (frames > 0 ? frames : 1)));
+  const FramePipelineStats &pipeline = framePipelineStats();
+  std::printf("pipeline frames=%u overlap=%.1f%% fence_wait=%lluus\n", static_cast<unsigned>(pipeline.frames),
+              pipeline.overlapPercent(), static_cast<unsigned long long>(pipeline.fenceWaitUs));
+  dumpAcquisitionRates();
+  dumpStageTimings();
+  scheduler.dump();
+  framePacer.dump();
+  sessionRecords().dump();
+  sessionStats().dumpSnapshot();
+  const HostNvsStore &nvs = hostNvsStore();
+  std::printf("nvs writes=%u requested=%lluB flash=%lluB amplification=%.2f\n", static_cast<unsigned>(nvs.writeCount),
+              static_cast<unsigned long long>(nvs.requestedBytes), static_cast<unsigned long long>(nvs.flashBytes),
+              nvs.writeAmplification());
+  return 0;
+}
+
+#endif  // !ARDUINO && !PIO_UNIT_TESTING
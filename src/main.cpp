@@ -1,25 +1,176 @@
 #include <M5CoreS3.h>
 #include <WiFi.h>  // WiFi 無効化用
 #include <Wire.h>
+#include <esp_heap_caps.h>
 
 #include "config.h"
+#include "hal/hal_nvs.h"
+#include "hal/hal_power.h"
 #include "modules/backlight.h"
+#include "modules/burst_capture.h"
+#include "modules/debug_page.h"
 #include "modules/display.h"
+#include "modules/frame_pacer.h"
+#include "modules/gauge_benchmarks.h"
+#include "modules/rate_scheduler.h"
 #include "modules/sensor.h"
+#include "modules/sensor_conversion.h"
+#include "modules/session_log.h"
+#include "modules/session_records.h"
+#include "modules/session_stats.h"
+#include "modules/stage_timing.h"
+#include "modules/telemetry.h"
 
 // ── FPS 計測用 ──
-unsigned long lastFpsSecond = 0;  // 直近1秒判定用
 int fpsFrameCounter = 0;
-int currentFps = 0;
-unsigned long lastDebugPrint = 0;  // デバッグ表示用タイマー
+
+// loop() の周期処理はすべてこのスケジューラに登録する
+static RateScheduler loopScheduler;
+// 締め切りの合間は CPU を譲って眠る
+static FramePacer framePacer;
 
 // ────────────────────── デバッグ情報表示 ──────────────────────
 static void printSensorDebugInfo()
 {
-  float pressure = calculateAverage(oilPressureSamples);
-  float water = calculateAverage(waterTemperatureSamples);
-  float oil = calculateAverage(oilTemperatureSamples);
+  float pressure = pressureQ16ToBar(sensorReadings[ADC_CH_OIL_PRESSURE]);
+  float water = centiToCelsius(sensorReadings[ADC_CH_WATER_TEMP]);
+  float oil = centiToCelsius(sensorReadings[ADC_CH_OIL_TEMP]);
   Serial.printf("Oil.P: %.2f bar, Water.T: %.1f C, Oil.T: %.1f C\n", pressure, water, oil);
+  dumpAcquisitionRates();
+  if (SESSION_LOG_ENABLED)
+  {
+    const SessionLogWriter &log = sessionLogWriter();
+    Serial.printf("Log: %lu rec, %lu dropped, %lu B, max write %lu us\n", static_cast<unsigned long>(log.recordCount()),
+                  static_cast<unsigned long>(log.droppedCount()), static_cast<unsigned long>(log.bytesWritten()),
+                  static_cast<unsigned long>(log.maxWriteUs()));
+  }
+}
+
+// ────────────────────── シリアルコマンド ──────────────────────
+// t: 区間計測の表を出力 / s: スケジューラと省電力の統計を出力 / p: 計測ページの表示切替 / r: 計測をリセット
+// b: バーストキャプチャを CSV で出力 / g: キャプチャ波形ページの表示切替 / c: キャプチャを破棄して再度待つ
+// m: マイクロベンチマークを回して JSON で出力（計測中は描画が止まる）
+// v: 走行記録を出力 / z: 今回のセッションの記録と統計を消す / Z: 通算の記録も消す
+// a: 走行統計を出力 / h: 走行統計ページの表示切替
+static void handleSerialCommands()
+{
+  while (Serial.available() > 0)
+  {
+    switch (Serial.read())
+    {
+      case 't':
+        dumpStageTimings();
+        break;
+      case 's':
+        loopScheduler.dump();
+        framePacer.dump();
+        break;
+      case 'p':
+        toggleDebugPage(DebugPage::Timing);
+        break;
+      case 'b':
+        dumpBurstCapture();
+        break;
+      case 'g':
+        toggleDebugPage(DebugPage::Capture);
+        break;
+      case 'c':
+        burstCapture().rearm();
+        Serial.println("[Capture] rearmed");
+        break;
+      case 'm':
+        runAllBenchmarks();
+        break;
+      case 'v':
+        sessionRecords().dump();
+        break;
+      case 'z':
+        sessionRecords().resetSession(millis());
+        sessionStats().requestReset();
+        Serial.println("[Records] session reset");
+        break;
+      case 'Z':
+        sessionRecords().resetAllTime(millis());
+        Serial.println("[Records] all-time reset");
+        break;
+      case 'a':
+        sessionStats().dumpSnapshot();
+        break;
+      case 'h':
+        toggleDebugPage(DebugPage::Stats);
+        break;
+      case 'r':
+        resetStageTimings();
+        loopScheduler.resetStats();
+        framePacer.resetStats();
+        Serial.println("[Timing] reset");
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+// ────────────────────── 周期タスク ──────────────────────
+static void renderTask()
+{
+  handleSerialCommands();
+  framePacer.countFrame(updateGauges());
+  fpsFrameCounter++;
+}
+
+static void fpsTask()
+{
+  currentFps = fpsFrameCounter;
+  fpsFrameCounter = 0;
+  // テレメトリ送信中はテキストを混ぜない
+  if (DEBUG_MODE_ENABLED && !telemetryActive())
+  {
+    // 直近 1 秒で LCD へ転送したバイト数も併せて出す
+    static uint64_t lastTotalPushBytes = 0;
+    uint64_t totalPushBytes = mainCanvas.totalPushBytes();
+    const FramePipelineStats &pipeline = framePipelineStats();
+    Serial.printf("FPS:%d push:%luB/s overlap:%.0f%% fence:%lums busy:%.0f%% skipped:%.0f%%\n", currentFps,
+                  static_cast<unsigned long>(totalPushBytes - lastTotalPushBytes), pipeline.overlapPercent(),
+                  static_cast<unsigned long>(pipeline.fenceWaitUs / 1000), framePacer.stats().busyPercent(),
+                  framePacer.stats().skippedPercent());
+    lastTotalPushBytes = totalPushBytes;
+    // FPS更新とは別のデータも1秒ごとに出力
+    printSensorDebugInfo();
+  }
+}
+
+static void alsStartTask() { beginAlsMeasurement(); }
+
+static void alsReadTask() { finishAlsMeasurement(); }
+
+static void backlightFadeTask() { serviceBacklightFade(); }
+
+static void telemetryTask() { serviceTelemetry(); }
+
+static void recordsTask() { sessionRecords().service(millis(), halSupplyMillivolts()); }
+
+static void beginLoopScheduler()
+{
+  uint32_t now = micros();
+  loopScheduler.addTask("render", RENDER_PERIOD_US, renderTask, now);
+  loopScheduler.addTask("fps", FPS_INTERVAL_MS * 1000UL, fpsTask, now + FPS_INTERVAL_MS * 1000UL);
+  if (SENSOR_AMBIENT_LIGHT_PRESENT)
+  {
+    // 消灯と読み出しは描画の半フレーム後に、ALS_BLANK_US だけ離して同じ周期で回す
+    uint32_t alsStart = alsBlankDeadlineUs(now);
+    loopScheduler.addTask("als_start", ALS_MEASUREMENT_PERIOD_US, alsStartTask, alsStart);
+    loopScheduler.addTask("als_read", ALS_MEASUREMENT_PERIOD_US, alsReadTask, alsStart + ALS_BLANK_US);
+    loopScheduler.addTask("fade", BACKLIGHT_FADE_INTERVAL_MS * 1000UL, backlightFadeTask, now);
+  }
+  if (telemetryActive())
+  {
+    loopScheduler.addTask("telemetry", TELEMETRY_SERVICE_INTERVAL_MS * 1000UL, telemetryTask, now);
+  }
+  if (RECORDS_ENABLED)
+  {
+    loopScheduler.addTask("records", RECORDS_SERVICE_INTERVAL_MS * 1000UL, recordsTask, now);
+  }
 }
 
 // ────────────────────── setup() ──────────────────────
@@ -51,11 +202,25 @@ void setup()
   mainCanvas.setPsram(false);
   // スプライト用の DMA を初期化
   mainCanvas.initDMA();
-  mainCanvas.createSprite(LCD_WIDTH, LCD_HEIGHT);
 
   M5.Lcd.clear();
   M5.Lcd.fillScreen(COLOR_BLACK);
 
+  // 描画バッファを 2 枚にして、転送中に次のフレームを描く
+  if (!beginFramePipeline())
+  {
+    Serial.println("[Display] double buffer alloc failed… falling back to synchronous push");
+  }
+  // 描画バッファを確保した後の内部 RAM の残り（Wi-Fi や各タスクのスタックはここから取る）
+  Serial.printf("[Display] internal heap free=%u largest=%u\n",
+                static_cast<unsigned>(heap_caps_get_free_size(MALLOC_CAP_INTERNAL)),
+                static_cast<unsigned>(heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL)));
+  // 目盛などの静的部分は起動時に背景画像へ 1 度だけ描く
+  if (!beginDisplayLayers())
+  {
+    Serial.println("[Display] background alloc failed… static gauge parts will not be drawn");
+  }
+
   // M5.Speaker.begin();  // スピーカーを使用しないため無効化
   // M5.Imu.begin();      // IMU を使用しないため無効化
   btStop();
@@ -64,11 +229,10 @@ void setup()
   pinMode(8, INPUT_PULLUP);
   Wire.begin(9, 8);
 
-  if (!adsConverter.begin())
+  if (!beginSensorAcquisition())
   {
     Serial.println("[ADS1015] init failed… all analog values will be 0");
   }
-  adsConverter.setDataRate(RATE_ADS1015_1600SPS);
 
   if (SENSOR_AMBIENT_LIGHT_PRESENT)
   {
@@ -79,39 +243,36 @@ void setup()
     CoreS3.Ltr553.begin(&ltr553Params);
     CoreS3.Ltr553.setAlsMode(LTR5XX_ALS_ACTIVE_MODE);
   }
-}
 
-// ────────────────────── loop() ──────────────────────
-void loop()
-{
-  static unsigned long lastAlsMeasurementTime = 0;
-  unsigned long now = millis();
-
-  if (now - lastAlsMeasurementTime >= ALS_MEASUREMENT_INTERVAL_MS)
+  if (SESSION_LOG_ENABLED && !beginSessionLog())
   {
-    updateBacklightLevel();
-    lastAlsMeasurementTime = now;
+    Serial.println("[SessionLog] LittleFS unavailable… logging disabled");
   }
 
-  acquireSensorData();
-  updateGauges();
+  beginTelemetry();
 
-  fpsFrameCounter++;
-  if (now - lastFpsSecond >= FPS_INTERVAL_MS)
+  // 前回までの走行記録を読む（NVS が使えなければ記録は RAM だけで持つ）
+  if (RECORDS_ENABLED && !halNvsBegin())
   {
-    currentFps = fpsFrameCounter;
-    if (DEBUG_MODE_ENABLED)
-    {
-      Serial.printf("FPS:%d\n", currentFps);
-    }
-    fpsFrameCounter = 0;
-    lastFpsSecond = now;
+    Serial.println("[Records] NVS unavailable… records will not be kept");
   }
+  sessionRecords().begin(millis());
 
-  if (DEBUG_MODE_ENABLED && now - lastDebugPrint >= 1000UL)
+  // テレメトリとデバッグ出力は USB シリアルを使い続けるので、そのときはライトスリープさせない
+  if (POWER_SAVE_ENABLED && !framePacer.begin(!telemetryActive() && !DEBUG_MODE_ENABLED))
   {
-    // FPS更新とは別に1秒ごとにデータを出力
-    printSensorDebugInfo();
-    lastDebugPrint = now;
+    Serial.println("[Power] ESP-IDF power management unavailable… switching CPU frequency directly");
   }
+
+  // センサ取得はコア0 のタスクへ分離し、loop() はコア1 で描画に専念させる
+  startSensorTask();
+  startSessionLogTask();
+  beginLoopScheduler();
+}
+
+// ────────────────────── loop() ──────────────────────
+void loop()
+{
+  // 締め切りのタスクを回し、次の締め切りまで 1tick 以上あれば CPU を譲って眠る
+  framePacer.runOnce(loopScheduler);
 }
@@ -0,0 +1,403 @@
+#include "ads_acquisition.h"
+
+// ────────────────────── 設定 ──────────────────────
+auto AdsAcquisition::addChannel(uint8_t channel, uint32_t intervalUs, bool settleAfterSwitch) -> bool
+{
+  if (slotCount_ >= MAX_CHANNELS || channel > 3)
+  {
+    return false;
+  }
+  slots_[slotCount_++] = {channel, intervalUs, settleAfterSwitch, false, 0, 0, 0.0F};
+  return true;
+}
+
+auto AdsAcquisition::begin(uint8_t primaryRun) -> bool
+{
+  state_ = State::Idle;
+  currentSlot_ = -1;
+  lastMuxSlot_ = -1;
+  muxSettling_ = false;
+  primaryStarted_ = false;
+  rateWindowStarted_ = false;
+  buildScanTable(primaryRun);
+
+  if (!bus_.hasAlertPin())
+  {
+    return true;
+  }
+  // Hi_thresh の MSB=1, Lo_thresh の MSB=0 で ALERT/RDY を変換完了通知に使う
+  bool ok = bus_.writeRegister(ADS1015_REG_HI_THRESH, 0x8000) && bus_.writeRegister(ADS1015_REG_LO_THRESH, 0x0000);
+  if (!ok)
+  {
+    busErrorCount_++;
+  }
+  return ok;
+}
+
+// ────────────────────── スキャン表 ──────────────────────
+// 最も周期の短いチャンネル（同じなら先に登録したもの）を主チャンネルにし、
+// 残りを登録順に主チャンネル primaryRun 回ごとに 1 つずつ挟む
+void AdsAcquisition::buildScanTable(uint8_t primaryRun)
+{
+  scanLength_ = 0;
+  scanCursor_ = 0;
+  primarySlot_ = -1;
+  guaranteedPrimarySps_ = 0.0F;
+  if (slotCount_ == 0)
+  {
+    return;
+  }
+
+  for (size_t i = 0; i < slotCount_; ++i)
+  {
+    if (primarySlot_ < 0 || slots_[i].intervalUs < slots_[primarySlot_].intervalUs)
+    {
+      primarySlot_ = static_cast<int>(i);
+    }
+  }
+
+  size_t secondaries = slotCount_ - 1;
+  if (primaryRun == 0) primaryRun = 1;
+  if (secondaries > 0 && secondaries * (primaryRun + 1) > MAX_SCAN_ENTRIES)
+  {
+    primaryRun = static_cast<uint8_t>(MAX_SCAN_ENTRIES / secondaries - 1);
+  }
+  if (secondaries == 0)
+  {
+    scanTable_[scanLength_++] = static_cast<uint8_t>(primarySlot_);
+  }
+  for (size_t i = 0; i < slotCount_; ++i)
+  {
+    if (static_cast<int>(i) == primarySlot_) continue;
+    for (uint8_t run = 0; run < primaryRun; ++run)
+    {
+      scanTable_[scanLength_++] = static_cast<uint8_t>(primarySlot_);
+    }
+    scanTable_[scanLength_++] = static_cast<uint8_t>(i);
+  }
+
+  // 1 周で主チャンネルが変換できる回数と、副チャンネルに押し出された場合も含めた 1 周の長さ
+  uint32_t primaryInterval = slots_[primarySlot_].intervalUs;
+  uint32_t primaryEntries = 0;
+  uint32_t cycleUs = 0;
+  for (size_t i = 0; i < scanLength_; ++i)
+  {
+    if (scanTable_[i] != primarySlot_) continue;
+    int following = scanTable_[(i + 1) % scanLength_];
+    uint32_t busyUs = ADS1015_CONVERSION_TIME_US + ((following != primarySlot_) ? conversionCostUs(following) : 0);
+    cycleUs += (busyUs > primaryInterval) ? busyUs : primaryInterval;
+    primaryEntries++;
+  }
+  guaranteedPrimarySps_ = static_cast<float>(primaryEntries) * 1e6F / static_cast<float>(cycleUs);
+}
+
+// fromSlot から toSlot へ MUX を切り替えるとき整定が要るか（fromSlot < 0 は切替前が不明）
+auto AdsAcquisition::switchNeedsSettle(int fromSlot, int toSlot) const -> bool
+{
+  if (fromSlot == toSlot)
+  {
+    return false;
+  }
+  return slots_[toSlot].settleAfterSwitch || (fromSlot >= 0 && slots_[fromSlot].settleAfterSwitch);
+}
+
+// 副チャンネル 1 回分の所要時間（主チャンネルからの切替と、主チャンネルへ戻す切替の整定を含む）
+auto AdsAcquisition::conversionCostUs(int slot) const -> uint32_t
+{
+  return ADS1015_CONVERSION_TIME_US + (switchNeedsSettle(primarySlot_, slot) ? ADS1015_MUX_SETTLE_US : 0) +
+         (switchNeedsSettle(slot, primarySlot_) ? ADS1015_MUX_SETTLE_US : 0);
+}
+
+// ────────────────────── チャンネル選択 ──────────────────────
+auto AdsAcquisition::primaryDue(uint32_t nowUs) const -> bool
+{
+  if (slots_[primarySlot_].intervalUs == 0 || !primaryStarted_)
+  {
+    return true;
+  }
+  return static_cast<int32_t>(nowUs - primaryDeadlineUs_) >= 0;
+}
+
+// costUs かかる処理を今始めても主チャンネルの次の締め切りに間に合うか
+auto AdsAcquisition::fitsBeforePrimary(uint32_t costUs, uint32_t nowUs) const -> bool
+{
+  uint32_t primaryInterval = slots_[primarySlot_].intervalUs;
+  if (primaryInterval == 0 || !primaryStarted_)
+  {
+    return true;
+  }
+  // 主チャンネルの隙間にそもそも収まらないものは、締め切りを遅らせてでも取得する
+  if (costUs + ADS1015_CONVERSION_TIME_US > primaryInterval)
+  {
+    return true;
+  }
+  return static_cast<int32_t>(primaryDeadlineUs_ - nowUs) >= static_cast<int32_t>(costUs);
+}
+
+auto AdsAcquisition::secondaryReady(int slot, uint32_t nowUs) const -> bool
+{
+  const ChannelSlot &target = slots_[slot];
+  if (target.sampled && target.intervalUs != 0 && nowUs - target.lastSampleUs < target.intervalUs)
+  {
+    return false;
+  }
+  return fitsBeforePrimary(conversionCostUs(slot), nowUs);
+}
+
+// 表を先へ進め、今変換すべきスロットを返す（主チャンネルの締め切り待ちなら -1）
+auto AdsAcquisition::nextScanSlot(uint32_t nowUs) -> int
+{
+  for (size_t step = 0; step < scanLength_; ++step)
+  {
+    int slot = scanTable_[scanCursor_];
+    if (slot == primarySlot_)
+    {
+      if (!primaryDue(nowUs))
+      {
+        return -1;
+      }
+      scanCursor_ = (scanCursor_ + 1) % scanLength_;
+
+      // 締め切りは開始時刻ではなく前回の締め切りから進め、ポーリングの遅れを積み上げない
+      uint32_t interval = slots_[slot].intervalUs;
+      if (!primaryStarted_)
+      {
+        primaryStarted_ = true;
+        primaryDeadlineUs_ = nowUs;
+      }
+      primaryDeadlineUs_ += interval;
+      if (interval != 0 && static_cast<int32_t>(nowUs - primaryDeadlineUs_) >= 0)
+      {
+        primaryMissCount_++;
+        primaryDeadlineUs_ = nowUs + interval;
+      }
+      return slot;
+    }
+
+    // 期限前や隙間に収まらない副チャンネルは飛ばし、次の周で改めて判定する
+    scanCursor_ = (scanCursor_ + 1) % scanLength_;
+    if (secondaryReady(slot, nowUs))
+    {
+      return slot;
+    }
+  }
+  return -1;
+}
+
+// ────────────────────── 変換開始 ──────────────────────
+auto AdsAcquisition::writeConfig(uint16_t config) -> bool
+{
+  if (!bus_.writeRegister(ADS1015_REG_CONFIG, config))
+  {
+    busErrorCount_++;
+    state_ = State::Idle;
+    lastMuxSlot_ = -1;
+    muxSettling_ = false;
+    return false;
+  }
+  return true;
+}
+
+auto AdsAcquisition::channelConfig(int slot) const -> uint16_t
+{
+  return static_cast<uint16_t>(ADS1015_CONFIG_MUX_SINGLE_0 + (slots_[slot].channel << 12)) |
+         ADS1015_CONFIG_PGA_6_144V | ADS1015_CONFIG_MODE_SINGLE | ADS1015_CONFIG_DR_1600SPS |
+         (bus_.hasAlertPin() ? ADS1015_CONFIG_CQUE_1CONV : ADS1015_CONFIG_CQUE_NONE);
+}
+
+auto AdsAcquisition::startConversion(int slot, uint32_t nowUs) -> bool
+{
+  uint16_t config = channelConfig(slot);
+  currentSlot_ = slot;
+
+  // 捨て変換の代わりに、変換を始めずに MUX だけ切り替え、入力が落ち着くのを後の poll() で待つ
+  if (switchNeedsSettle(lastMuxSlot_, slot))
+  {
+    if (!writeConfig(config)) return false;
+    lastMuxSlot_ = slot;
+    muxSettling_ = true;
+    settleStartUs_ = nowUs;
+  }
+  // 先に切り替えておいた MUX の整定がまだ終わっていなければ、残りを待つ
+  if (muxSettling_ && nowUs - settleStartUs_ < ADS1015_MUX_SETTLE_US)
+  {
+    pendingConfig_ = config;
+    state_ = State::Settling;
+    return true;
+  }
+
+  muxSettling_ = false;
+  if (!writeConfig(ADS1015_CONFIG_OS_SINGLE | config)) return false;
+  lastMuxSlot_ = slot;
+  conversionStartUs_ = nowUs;
+  state_ = State::Converting;
+  return true;
+}
+
+// 表の次のチャンネルの変換を始める。主チャンネルの締め切り待ちなら、その間に MUX を主チャンネルへ戻しておく
+void AdsAcquisition::startNext(uint32_t nowUs)
+{
+  int slot = nextScanSlot(nowUs);
+  if (slot >= 0)
+  {
+    startConversion(slot, nowUs);
+    return;
+  }
+  preselectPrimary(nowUs);
+}
+
+void AdsAcquisition::preselectPrimary(uint32_t nowUs)
+{
+  if (primarySlot_ < 0 || !switchNeedsSettle(lastMuxSlot_, primarySlot_))
+  {
+    return;
+  }
+  if (!writeConfig(channelConfig(primarySlot_))) return;
+  lastMuxSlot_ = primarySlot_;
+  muxSettling_ = true;
+  settleStartUs_ = nowUs;
+}
+
+// 整定時間が過ぎていれば変換を始める。副チャンネルは、主チャンネルへ戻す整定まで含めて
+// 隙間を使い切っていたら今回は見送り、MUX を主チャンネルへ戻す
+auto AdsAcquisition::finishSettling(uint32_t nowUs) -> bool
+{
+  if (nowUs - settleStartUs_ < ADS1015_MUX_SETTLE_US)
+  {
+    return false;
+  }
+  uint32_t returnUs = switchNeedsSettle(currentSlot_, primarySlot_) ? ADS1015_MUX_SETTLE_US : 0;
+  if (currentSlot_ != primarySlot_ && !fitsBeforePrimary(ADS1015_CONVERSION_TIME_US + returnUs, nowUs))
+  {
+    state_ = State::Idle;
+    preselectPrimary(nowUs);
+    return false;
+  }
+  muxSettling_ = false;
+  if (!writeConfig(ADS1015_CONFIG_OS_SINGLE | pendingConfig_)) return false;
+  conversionStartUs_ = nowUs;
+  state_ = State::Converting;
+  return true;
+}
+
+auto AdsAcquisition::nextPollUs(uint32_t nowUs) const -> uint32_t
+{
+  switch (state_)
+  {
+    case State::Settling:
+      return settleStartUs_ + ADS1015_MUX_SETTLE_US;
+    case State::Converting:
+      return conversionStartUs_ + ADS1015_CONVERSION_TIME_US;
+    case State::Idle:
+    default:
+      break;
+  }
+  if (primarySlot_ < 0 || !primaryStarted_ || slots_[primarySlot_].intervalUs == 0)
+  {
+    return nowUs;
+  }
+  // 副チャンネルは主チャンネルの読出し直後に始めるので、Idle で待つのは主チャンネルの締め切りだけ
+  return primaryDeadlineUs_;
+}
+
+// ────────────────────── 完了判定 ──────────────────────
+auto AdsAcquisition::conversionFinished(uint32_t nowUs) -> bool
+{
+  if (bus_.hasAlertPin())
+  {
+    return bus_.alertAsserted();
+  }
+
+  if (nowUs - conversionStartUs_ < ADS1015_CONVERSION_TIME_US)
+  {
+    return false;
+  }
+
+  // 変換時間を過ぎたら OS ビットで完了を確認する
+  uint16_t config = 0;
+  if (!bus_.readRegister(ADS1015_REG_CONFIG, config))
+  {
+    busErrorCount_++;
+    state_ = State::Idle;
+    return false;
+  }
+  return (config & ADS1015_CONFIG_OS_SINGLE) != 0;
+}
+
+// ────────────────────── 実測レート ──────────────────────
+void AdsAcquisition::updateRates(uint32_t nowUs)
+{
+  if (!rateWindowStarted_)
+  {
+    rateWindowStarted_ = true;
+    rateWindowStartUs_ = nowUs;
+    return;
+  }
+  uint32_t elapsedUs = nowUs - rateWindowStartUs_;
+  if (elapsedUs < RATE_WINDOW_US)
+  {
+    return;
+  }
+  for (size_t i = 0; i < slotCount_; ++i)
+  {
+    slots_[i].samplesPerSecond = static_cast<float>(slots_[i].windowSamples) * 1e6F / static_cast<float>(elapsedUs);
+    slots_[i].windowSamples = 0;
+  }
+  rateWindowStartUs_ = nowUs;
+}
+
+auto AdsAcquisition::samplesPerSecond(uint8_t channel) const -> float
+{
+  for (size_t i = 0; i < slotCount_; ++i)
+  {
+    if (slots_[i].channel == channel)
+    {
+      return slots_[i].samplesPerSecond;
+    }
+  }
+  return 0.0F;
+}
+
+// ────────────────────── ポーリング ──────────────────────
+auto AdsAcquisition::poll(uint32_t nowUs, AdsSample &sample) -> bool
+{
+  if (state_ == State::Settling)
+  {
+    finishSettling(nowUs);
+    return false;
+  }
+
+  if (state_ == State::Idle)
+  {
+    startNext(nowUs);
+    return false;
+  }
+
+  if (!conversionFinished(nowUs))
+  {
+    return false;
+  }
+
+  uint16_t value = 0;
+  if (!bus_.readRegister(ADS1015_REG_CONVERSION, value))
+  {
+    busErrorCount_++;
+    state_ = State::Idle;
+    return false;
+  }
+  conversionCount_++;
+
+  // 12bit 左詰めの値を符号付きで右シフト
+  int16_t raw = static_cast<int16_t>(static_cast<int16_t>(value) >> 4);
+  ChannelSlot &slot = slots_[currentSlot_];
+  slot.sampled = true;
+  slot.lastSampleUs = conversionStartUs_;
+  slot.windowSamples++;
+  sample = {slot.channel, raw, conversionStartUs_};
+  updateRates(nowUs);
+
+  // 読出し直後に次の変換を始めてバスの空き時間を作らない
+  state_ = State::Idle;
+  startNext(nowUs);
+  return true;
+}
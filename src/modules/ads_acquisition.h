@@ -0,0 +1,159 @@
+#ifndef ADS_ACQUISITION_H
+#define ADS_ACQUISITION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ────────────────────── ADS1015 レジスタ定義 ──────────────────────
+constexpr uint8_t ADS1015_REG_CONVERSION = 0x00;
+constexpr uint8_t ADS1015_REG_CONFIG = 0x01;
+constexpr uint8_t ADS1015_REG_LO_THRESH = 0x02;
+constexpr uint8_t ADS1015_REG_HI_THRESH = 0x03;
+
+constexpr uint16_t ADS1015_CONFIG_OS_SINGLE = 0x8000;  // 書込み:変換開始 / 読出し:1 で待機中
+constexpr uint16_t ADS1015_CONFIG_MUX_SINGLE_0 = 0x4000;
+constexpr uint16_t ADS1015_CONFIG_PGA_6_144V = 0x0000;
+constexpr uint16_t ADS1015_CONFIG_MODE_SINGLE = 0x0100;
+constexpr uint16_t ADS1015_CONFIG_DR_1600SPS = 0x0080;
+constexpr uint16_t ADS1015_CONFIG_CQUE_1CONV = 0x0000;  // 1 変換ごとに ALERT/RDY をアサート
+constexpr uint16_t ADS1015_CONFIG_CQUE_NONE = 0x0003;   // コンパレータ無効
+
+// 1600SPS の変換時間 625us に内部発振器の誤差 10% と起動時間を足した待ち時間
+constexpr uint32_t ADS1015_CONVERSION_TIME_US = 625 + 63 + 25;
+// MUX だけを先に切り替えてから変換を始めるまでの整定時間（開始の書込み自体にも約 90us かかる）
+constexpr uint32_t ADS1015_MUX_SETTLE_US = 50;
+
+// ────────────────────── I2C アクセス抽象 ──────────────────────
+// 実機では Wire、ホストではモックに差し替える
+class AdsBus
+{
+ public:
+  virtual ~AdsBus() = default;
+  virtual auto writeRegister(uint8_t reg, uint16_t value) -> bool = 0;
+  virtual auto readRegister(uint8_t reg, uint16_t &value) -> bool = 0;
+  // ALERT/RDY ピンが接続されている場合のみ true を返す
+  virtual auto hasAlertPin() const -> bool { return false; }
+  virtual auto alertAsserted() -> bool { return false; }
+};
+
+// 変換結果 1 件分
+struct AdsSample
+{
+  uint8_t channel;
+  int16_t raw;           // 12bit 符号付きコード
+  uint32_t timestampUs;  // 変換を開始した時刻
+};
+
+// ────────────────────── 変換ステートマシン ──────────────────────
+// 変換開始→完了確認→読出し→次チャンネルへ切替を poll() ごとに 1 段ずつ進める。
+// poll() の中では待たない。MUX 切替後の整定 (ADS1015_MUX_SETTLE_US) も Settling 状態として後の poll() で
+// 経過を確認してから変換を始める。I2C トランザクションは 1 回あたり最大 3 回。
+//
+// 変換順は begin() で作るスキャン表に従う。最も周期の短いチャンネルを主チャンネルとし、
+// 主チャンネル primaryRun 回ごとに副チャンネルを 1 つずつ挟む（例: P,P,P,WT,P,P,P,OT）。
+// 主チャンネルは締め切り時刻どおりに変換し、副チャンネルは期限が来ていて次の締め切りまでに
+// 整定と変換、主チャンネルへ戻す整定が終わる場合だけ隙間で変換する。これで主チャンネルのレートが
+// 副チャンネルに削られない。整定中に隙間が足りなくなったら（ポーリングが遅れた場合）その副チャンネルは次の周へ回す。
+//
+// 整定は整定が必要なチャンネルへ切り替えるときだけでなく、そこから他へ切り替えるときにも行う
+// （サンプリング容量に残った前のチャンネルの電荷を抜く）。副チャンネルを読み出したら、主チャンネルの
+// 締め切りを待つ間に MUX だけ主チャンネルへ戻しておき、締め切りには整定を終えて変換を始められるようにする。
+class AdsAcquisition
+{
+ public:
+  static constexpr size_t MAX_CHANNELS = 4;
+  static constexpr size_t MAX_SCAN_ENTRIES = 32;
+  // 実測レートを集計する窓
+  static constexpr uint32_t RATE_WINDOW_US = 1000000;
+
+  explicit AdsAcquisition(AdsBus &bus) : bus_(bus) {}
+
+  // intervalUs = 0 のチャンネルは表の順番が来るたびに変換する
+  // settleAfterSwitch = true なら、このチャンネルへの MUX 切替とこのチャンネルからの切替の両方で
+  // MUX を先に切り替え、整定を待ってから変換を始める
+  auto addChannel(uint8_t channel, uint32_t intervalUs, bool settleAfterSwitch) -> bool;
+  auto begin(uint8_t primaryRun = 1) -> bool;
+
+  // 変換結果が揃ったら sample に格納して true を返す
+  auto poll(uint32_t nowUs, AdsSample &sample) -> bool;
+
+  auto isConverting() const -> bool { return state_ == State::Converting; }
+  auto isSettling() const -> bool { return state_ == State::Settling; }
+  // 次に poll() すると状態が進む時刻（整定明け・変換完了予定・主チャンネルの締め切り）
+  auto nextPollUs(uint32_t nowUs) const -> uint32_t;
+  auto conversionCount() const -> uint32_t { return conversionCount_; }
+  auto busErrorCount() const -> uint32_t { return busErrorCount_; }
+  // 主チャンネルの締め切りを 1 周期以上過ぎてから変換した回数
+  auto primaryMissCount() const -> uint32_t { return primaryMissCount_; }
+
+  auto scanLength() const -> size_t { return scanLength_; }
+  auto scanChannel(size_t index) const -> uint8_t { return slots_[scanTable_[index]].channel; }
+  // スキャン表から求めた主チャンネルの最低保証レート [SPS]
+  auto guaranteedPrimarySps() const -> float { return guaranteedPrimarySps_; }
+  // 直近の集計窓で実際に取得できたレート [SPS]（未登録・未集計なら 0）
+  auto samplesPerSecond(uint8_t channel) const -> float;
+
+ private:
+  enum class State : uint8_t
+  {
+    Idle,
+    Settling,  // MUX を切り替え済みで、整定を待って変換を始める
+    Converting
+  };
+
+  struct ChannelSlot
+  {
+    uint8_t channel;
+    uint32_t intervalUs;
+    bool settleAfterSwitch;
+    bool sampled;  // 一度でも取得したか
+    uint32_t lastSampleUs;
+    uint32_t windowSamples;  // 集計窓内の取得数
+    float samplesPerSecond;
+  };
+
+  void buildScanTable(uint8_t primaryRun);
+  auto switchNeedsSettle(int fromSlot, int toSlot) const -> bool;
+  auto conversionCostUs(int slot) const -> uint32_t;
+  auto primaryDue(uint32_t nowUs) const -> bool;
+  auto fitsBeforePrimary(uint32_t costUs, uint32_t nowUs) const -> bool;
+  auto secondaryReady(int slot, uint32_t nowUs) const -> bool;
+  auto nextScanSlot(uint32_t nowUs) -> int;
+  auto channelConfig(int slot) const -> uint16_t;
+  auto startConversion(int slot, uint32_t nowUs) -> bool;
+  void startNext(uint32_t nowUs);
+  void preselectPrimary(uint32_t nowUs);
+  auto writeConfig(uint16_t config) -> bool;
+  auto finishSettling(uint32_t nowUs) -> bool;
+  auto conversionFinished(uint32_t nowUs) -> bool;
+  void updateRates(uint32_t nowUs);
+
+  AdsBus &bus_;
+  ChannelSlot slots_[MAX_CHANNELS] = {};
+  size_t slotCount_ = 0;
+
+  uint8_t scanTable_[MAX_SCAN_ENTRIES] = {};
+  size_t scanLength_ = 0;
+  size_t scanCursor_ = 0;
+  int primarySlot_ = -1;
+  bool primaryStarted_ = false;
+  uint32_t primaryDeadlineUs_ = 0;  // 主チャンネルの次の変換開始時刻
+  float guaranteedPrimarySps_ = 0.0F;
+
+  State state_ = State::Idle;
+  int currentSlot_ = -1;
+  int lastMuxSlot_ = -1;  // 最後に MUX を切り替えたスロット
+  uint32_t conversionStartUs_ = 0;
+  uint32_t settleStartUs_ = 0;
+  bool muxSettling_ = false;  // 変換を始めずに MUX を切り替え、まだ整定時間が過ぎたと確かめていない
+  uint16_t pendingConfig_ = 0;  // 整定後に OS ビットを立てて書く設定値
+
+  bool rateWindowStarted_ = false;
+  uint32_t rateWindowStartUs_ = 0;
+
+  uint32_t conversionCount_ = 0;
+  uint32_t busErrorCount_ = 0;
+  uint32_t primaryMissCount_ = 0;
+};
+
+#endif  // ADS_ACQUISITION_H
@@ -0,0 +1,156 @@
+#ifndef ARC_SPAN_CACHE_H
+#define ARC_SPAN_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cmath>
+
+// ────────────────────── 円弧メーターのスパンキャッシュ ──────────────────────
+// 半径 INNER〜OUTER のリングを、-270°（真下）から時計回りに 0°（右）までの 270° について
+// 0.5° 刻みのステップへ分け、各ステップに属する画素を水平スパンとして保持する。
+// 値の変化は「前回ステップ〜今回ステップ」のスパンを書くだけになり、
+// 描画時の三角関数や外接矩形全体の角度判定が不要になる。
+// スパンは中心からの相対座標なので、同じ半径のゲージで 1 つを共有できる。
+
+constexpr int ARC_SWEEP_DEG = 270;
+constexpr int ARC_STEPS_PER_DEGREE = 2;
+
+struct ArcSpan
+{
+  int8_t dx;  // 左端の中心からの相対座標
+  int8_t dy;
+  uint8_t length;
+};
+
+// リング内（r0² ≦ d² ≦ r1²）の画素数。スパン数の上限として使う
+constexpr auto countRingPixels(int inner, int outer) -> size_t
+{
+  size_t count = 0;
+  for (int dy = -outer; dy <= outer; ++dy)
+  {
+    for (int dx = -outer; dx <= outer; ++dx)
+    {
+      int d2 = dx * dx + dy * dy;
+      if (d2 >= inner * inner && d2 <= outer * outer) ++count;
+    }
+  }
+  return count;
+}
+
+template <int INNER, int OUTER>
+class ArcSpanCache
+{
+  static_assert(OUTER < 128, "spans are stored as int8 offsets");
+
+ public:
+  static constexpr int STEPS = ARC_SWEEP_DEG * ARC_STEPS_PER_DEGREE;
+  static constexpr size_t MAX_SPANS = countRingPixels(INNER, OUTER);
+
+  // 起動時に 1 度だけ呼ぶ。画素ごとの atan2 はここでしか行わない
+  void build()
+  {
+    // 1 パス目: ステップごとの画素数を数えて、バケットの開始位置を決める
+    uint16_t pixelCount[STEPS] = {};
+    forEachPixel([&](int, int, int step) { pixelCount[step]++; });
+    uint16_t bucket[STEPS + 1] = {};
+    for (int step = 0; step < STEPS; ++step)
+    {
+      bucket[step + 1] = bucket[step] + pixelCount[step];
+    }
+
+    // 2 パス目: 行ごとに左から走査し、同じステップで隣接する画素は 1 本のスパンに伸ばす
+    uint16_t used[STEPS] = {};
+    forEachPixel(
+        [&](int dx, int dy, int step)
+        {
+          ArcSpan *spans = &spans_[bucket[step]];
+          uint16_t &n = used[step];
+          if (n > 0 && spans[n - 1].dy == dy && spans[n - 1].dx + spans[n - 1].length == dx)
+          {
+            spans[n - 1].length++;
+          }
+          else
+          {
+            spans[n++] = {static_cast<int8_t>(dx), static_cast<int8_t>(dy), 1};
+          }
+        });
+
+    // バケットの空きを詰める
+    size_t total = 0;
+    for (int step = 0; step < STEPS; ++step)
+    {
+      stepBegin_[step] = static_cast<uint16_t>(total);
+      std::copy(&spans_[bucket[step]], &spans_[bucket[step]] + used[step], &spans_[total]);
+      total += used[step];
+    }
+    stepBegin_[STEPS] = static_cast<uint16_t>(total);
+    built_ = true;
+  }
+
+  auto built() const -> bool { return built_; }
+  auto spanCount() const -> size_t { return stepBegin_[STEPS]; }
+
+  // メーター角度（-270〜0°）を最も近いステップ境界へ丸める
+  static auto stepForAngle(float angle) -> int
+  {
+    int step = static_cast<int>(std::lround((angle + ARC_SWEEP_DEG) * ARC_STEPS_PER_DEGREE));
+    return std::max(0, std::min(step, STEPS));
+  }
+
+  // ステップ [fromStep, toStep) のスパンを塗り、その外接矩形を更新領域に加える
+  template <typename Canvas>
+  void fill(Canvas &canvas, int cx, int cy, int fromStep, int toStep, uint16_t color) const
+  {
+    fromStep = std::max(fromStep, 0);
+    toStep = std::min(toStep, STEPS);
+    if (fromStep >= toStep) return;
+
+    int left = OUTER;
+    int right = -OUTER;
+    int top = OUTER;
+    int bottom = -OUTER;
+    for (uint16_t i = stepBegin_[fromStep]; i < stepBegin_[toStep]; ++i)
+    {
+      const ArcSpan &span = spans_[i];
+      canvas.writeFastHLine(cx + span.dx, cy + span.dy, span.length, color);
+      left = std::min<int>(left, span.dx);
+      right = std::max<int>(right, span.dx + span.length);
+      top = std::min<int>(top, span.dy);
+      bottom = std::max<int>(bottom, span.dy + 1);
+    }
+    if (left < right)
+    {
+      canvas.addDamage(cx + left, cy + top, right - left, bottom - top);
+    }
+  }
+
+ private:
+  // リング内かつ 270° の掃引範囲内の画素について、行優先・左から順に (dx, dy, step) を渡す
+  template <typename F>
+  static void forEachPixel(F visit)
+  {
+    constexpr float RAD_TO_DEG = 180.0F / static_cast<float>(M_PI);
+    for (int dy = -OUTER; dy <= OUTER; ++dy)
+    {
+      for (int dx = -OUTER; dx <= OUTER; ++dx)
+      {
+        int d2 = dx * dx + dy * dy;
+        if (d2 < INNER * INNER || d2 > OUTER * OUTER) continue;
+        // y 下向きの画面座標では atan2 がそのまま時計回りの角度になる。真下 (90°) を 0 とする
+        float offset = std::atan2(static_cast<float>(dy), static_cast<float>(dx)) * RAD_TO_DEG - 90.0F;
+        if (offset < 0.0F) offset += 360.0F;
+        if (offset > ARC_SWEEP_DEG) continue;
+        int step = std::min(static_cast<int>(offset * ARC_STEPS_PER_DEGREE), STEPS - 1);
+        visit(dx, dy, step);
+      }
+    }
+  }
+
+  ArcSpan spans_[MAX_SPANS] = {};
+  uint16_t stepBegin_[STEPS + 1] = {};
+  bool built_ = false;
+};
+
+#endif  // ARC_SPAN_CACHE_H
@@ -1,70 +1,55 @@
 #include "backlight.h"
 
-#include <algorithm>
-#include <cstring>
+#include <M5CoreS3.h>
 
 #include "display.h"
 
 // ────────────────────── グローバル変数 ──────────────────────
 // 現在の輝度モード
 BrightnessMode currentBrightnessMode = BrightnessMode::Day;
-// ALS サンプルバッファ
-uint16_t luxSamples[MEDIAN_BUFFER_SIZE] = {};
-int luxSampleIndex = 0;  // 次に書き込むインデックス
+static LuxMedian luxMedian;
+static BacklightFade backlightFade(BACKLIGHT_DAY);
+// 消灯中か（後半で点け直すまで）
+static bool alsBlanked = false;
 
 // ────────────────────── 輝度測定 ──────────────────────
-// バックライトを消して輝度を測定
-static auto measureLuxWithoutBacklight() -> uint16_t
+// 2 つの周期タスクに分け、消灯から読み出しまでの ALS_BLANK_US は待たずにスケジューラへ戻る。
+// どちらもフレームの合間に呼ばれるので、描画と転送を止めない
+void beginAlsMeasurement()
 {
-  uint8_t prevBrightness = display.getBrightness();
+  if (!SENSOR_AMBIENT_LIGHT_PRESENT)
+  {
+    return;
+  }
   display.setBrightness(0);
-  delayMicroseconds(500);
-  uint16_t lux = CoreS3.Ltr553.getAlsValue();
-  display.setBrightness(prevBrightness);
-  return lux;
+  alsBlanked = true;
 }
 
-// ────────────────────── 中央値計算 ──────────────────────
-// サンプル配列から中央値を計算する
-static auto calculateMedian(const uint16_t *samples) -> uint16_t
+void finishAlsMeasurement()
 {
-  uint16_t sortedSamples[MEDIAN_BUFFER_SIZE];
-  memcpy(sortedSamples, samples, sizeof(sortedSamples));
-  std::nth_element(sortedSamples, sortedSamples + MEDIAN_BUFFER_SIZE / 2, sortedSamples + MEDIAN_BUFFER_SIZE);
-  return sortedSamples[MEDIAN_BUFFER_SIZE / 2];
-}
-
-// ────────────────────── 輝度更新 ──────────────────────
-void updateBacklightLevel()
-{
-  if (!SENSOR_AMBIENT_LIGHT_PRESENT)
+  if (!SENSOR_AMBIENT_LIGHT_PRESENT || !alsBlanked)
   {
-    if (currentBrightnessMode != BrightnessMode::Day)
-    {
-      currentBrightnessMode = BrightnessMode::Day;
-      display.setBrightness(BACKLIGHT_DAY);
-    }
     return;
   }
+  uint16_t lux = CoreS3.Ltr553.getAlsValue();
+  // フェードの途中でも、消す前の輝度へそのまま戻す
+  display.setBrightness(backlightFade.level());
+  alsBlanked = false;
 
-  uint16_t measuredLux = measureLuxWithoutBacklight();
-
-  // サンプルをリングバッファへ格納
-  luxSamples[luxSampleIndex] = measuredLux;
-  luxSampleIndex = (luxSampleIndex + 1) % MEDIAN_BUFFER_SIZE;
-
-  uint16_t medianLux = calculateMedian(luxSamples);
-
-  BrightnessMode newMode = (medianLux >= LUX_THRESHOLD_DAY)    ? BrightnessMode::Day
-                           : (medianLux >= LUX_THRESHOLD_DUSK) ? BrightnessMode::Dusk
-                                                               : BrightnessMode::Night;
-
+  BrightnessMode newMode = brightnessModeForLux(luxMedian.add(lux));
   if (newMode != currentBrightnessMode)
   {
     currentBrightnessMode = newMode;
-    uint8_t targetBrightness = (newMode == BrightnessMode::Day)    ? BACKLIGHT_DAY
-                               : (newMode == BrightnessMode::Dusk) ? BACKLIGHT_DUSK
-                                                                   : BACKLIGHT_NIGHT;
-    display.setBrightness(targetBrightness);
+    backlightFade.start(backlightLevelFor(newMode));
+  }
+}
+
+// ────────────────────── 輝度のフェード ──────────────────────
+void serviceBacklightFade()
+{
+  // 消灯中は点け直すときに今の段の輝度を使うので、段だけ進める
+  if (backlightFade.step() && !alsBlanked)
+  {
+    display.setBrightness(backlightFade.level());
   }
 }
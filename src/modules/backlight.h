@@ -1,13 +1,16 @@
 #ifndef BACKLIGHT_H
 #define BACKLIGHT_H
 
+#include "backlight_control.h"
 #include "config.h"
 
 extern BrightnessMode currentBrightnessMode;
 
-// ALS 測定間隔 [ms]
-constexpr uint16_t ALS_MEASUREMENT_INTERVAL_MS = 8000;
-
-void updateBacklightLevel();
+// ALS の測定の前半。今の輝度を覚えてバックライトを消す（待たずに戻る）
+void beginAlsMeasurement();
+// ALS の測定の後半。ALS を読んで点け直し、モードが変われば新しい輝度へのフェードを始める
+void finishAlsMeasurement();
+// フェード中なら輝度を 1 段進める
+void serviceBacklightFade();
 
 #endif  // BACKLIGHT_H
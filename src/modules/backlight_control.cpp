@@ -0,0 +1,62 @@
+#include "backlight_control.h"
+
+#include <algorithm>
+#include <cstring>
+
+// ────────────────────── 輝度モード ──────────────────────
+auto LuxMedian::add(uint16_t lux) -> uint16_t
+{
+  samples_[next_] = lux;
+  next_ = (next_ + 1) % MEDIAN_BUFFER_SIZE;
+
+  uint16_t sorted[MEDIAN_BUFFER_SIZE];
+  std::memcpy(sorted, samples_, sizeof(sorted));
+  std::nth_element(sorted, sorted + MEDIAN_BUFFER_SIZE / 2, sorted + MEDIAN_BUFFER_SIZE);
+  return sorted[MEDIAN_BUFFER_SIZE / 2];
+}
+
+auto brightnessModeForLux(uint16_t medianLux) -> BrightnessMode
+{
+  if (medianLux >= LUX_THRESHOLD_DAY) return BrightnessMode::Day;
+  if (medianLux >= LUX_THRESHOLD_DUSK) return BrightnessMode::Dusk;
+  return BrightnessMode::Night;
+}
+
+auto backlightLevelFor(BrightnessMode mode) -> uint8_t
+{
+  switch (mode)
+  {
+    case BrightnessMode::Day:
+      return BACKLIGHT_DAY;
+    case BrightnessMode::Dusk:
+      return BACKLIGHT_DUSK;
+    default:
+      return BACKLIGHT_NIGHT;
+  }
+}
+
+// ────────────────────── 輝度のフェード ──────────────────────
+void BacklightFade::start(uint8_t target)
+{
+  if (target == target_ && (active() || level_ == target))
+  {
+    return;
+  }
+  from_ = level_;
+  target_ = target;
+  step_ = (level_ == target) ? BACKLIGHT_FADE_STEPS : 0;
+}
+
+auto BacklightFade::step() -> bool
+{
+  if (!active())
+  {
+    return false;
+  }
+  step_++;
+  int32_t span = static_cast<int32_t>(target_) - from_;
+  uint8_t next = static_cast<uint8_t>(from_ + span * BACKLIGHT_FADE_CURVE[step_] / 256);
+  bool changed = next != level_;
+  level_ = next;
+  return changed;
+}
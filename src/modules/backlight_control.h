@@ -0,0 +1,84 @@
+#ifndef BACKLIGHT_CONTROL_H
+#define BACKLIGHT_CONTROL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+
+#include "config.h"
+
+// ────────────────────── ALS の測定周期 ──────────────────────
+// 測定は「消灯して ALS の読み出しを始める」と「ALS_BLANK_US 後に読んで点け直す」の 2 つの周期タスクに分ける。
+// 周期を描画の整数倍にし、消灯は描画の締め切りの半フレーム後（描画と転送の合間）に置くので、
+// 位相がずれずに毎回フレームの合間で測る。
+constexpr uint16_t ALS_MEASUREMENT_INTERVAL_MS = 8000;
+constexpr uint32_t ALS_MEASUREMENT_PERIOD_US = ALS_MEASUREMENT_INTERVAL_MS * 1000UL / RENDER_PERIOD_US * RENDER_PERIOD_US;
+// バックライトを消してから ALS を読むまで [us]
+constexpr uint32_t ALS_BLANK_US = 500;
+
+// 描画の締め切り renderDeadlineUs に対して消灯を始める時刻
+constexpr auto alsBlankDeadlineUs(uint32_t renderDeadlineUs) -> uint32_t
+{
+  return renderDeadlineUs + RENDER_PERIOD_US / 2;
+}
+
+static_assert(ALS_MEASUREMENT_PERIOD_US % RENDER_PERIOD_US == 0, "ALS period must be a whole number of frames");
+static_assert(ALS_BLANK_US < RENDER_PERIOD_US / 2, "blanking must end before the next frame");
+
+// ────────────────────── 輝度モード ──────────────────────
+// 直近 MEDIAN_BUFFER_SIZE 回の測定の中央値で昼・夕・夜を選ぶ（未測定の枠は 0 として数える）
+class LuxMedian
+{
+ public:
+  // 測定値を 1 つ加えて中央値を返す
+  auto add(uint16_t lux) -> uint16_t;
+
+ private:
+  uint16_t samples_[MEDIAN_BUFFER_SIZE] = {};
+  size_t next_ = 0;
+};
+
+auto brightnessModeForLux(uint16_t medianLux) -> BrightnessMode;
+auto backlightLevelFor(BrightnessMode mode) -> uint8_t;
+
+// ────────────────────── 輝度のフェード ──────────────────────
+// モードが変わったら、BACKLIGHT_FADE_INTERVAL_MS ごとに 1 段ずつ、表の曲線に沿って目標の輝度へ近づける。
+// 曲線は両端がなだらかな smoothstep で、重みは 0〜256 の固定小数
+constexpr int BACKLIGHT_FADE_STEPS = 16;
+constexpr uint32_t BACKLIGHT_FADE_INTERVAL_MS = 20;
+
+constexpr auto makeBacklightFadeCurve() -> std::array<uint16_t, BACKLIGHT_FADE_STEPS + 1>
+{
+  std::array<uint16_t, BACKLIGHT_FADE_STEPS + 1> curve = {};
+  constexpr int32_t N = BACKLIGHT_FADE_STEPS;
+  for (int32_t i = 0; i <= N; ++i)
+  {
+    curve[i] = static_cast<uint16_t>(256 * i * i * (3 * N - 2 * i) / (N * N * N));
+  }
+  return curve;
+}
+inline constexpr std::array<uint16_t, BACKLIGHT_FADE_STEPS + 1> BACKLIGHT_FADE_CURVE = makeBacklightFadeCurve();
+
+class BacklightFade
+{
+ public:
+  explicit BacklightFade(uint8_t level) : from_(level), target_(level), level_(level) {}
+
+  // 今の輝度から target へのフェードを始める（フェード中なら途中の輝度から引き継ぐ）
+  void start(uint8_t target);
+  // 1 段進める。輝度が変わったら true を返し、level() が新しい輝度になる
+  auto step() -> bool;
+
+  auto level() const -> uint8_t { return level_; }
+  auto target() const -> uint8_t { return target_; }
+  auto active() const -> bool { return step_ < BACKLIGHT_FADE_STEPS; }
+
+ private:
+  uint8_t from_;
+  uint8_t target_;
+  uint8_t level_;
+  int step_ = BACKLIGHT_FADE_STEPS;
+};
+
+#endif  // BACKLIGHT_CONTROL_H
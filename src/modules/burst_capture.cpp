@@ -0,0 +1,182 @@
+#include "burst_capture.h"
+
+#include <algorithm>
+
+#include "hal/hal.h"
+#include "sensor_conversion.h"
+
+auto defaultBurstCaptureConfig() -> BurstCaptureConfig
+{
+  BurstCaptureConfig config = {};
+  config.lowPressureQ16 = barToPressureQ16(BURST_TRIGGER_LOW_BAR);
+  config.lowHoldUs = BURST_TRIGGER_LOW_HOLD_MS * 1000UL;
+  config.armUs = BURST_TRIGGER_ARM_MS * 1000UL;
+  config.slopeLimitQ16PerSecond = static_cast<int64_t>(BURST_TRIGGER_SLOPE_BAR_PER_S * 1000.0F) * PRESSURE_Q16_PER_MBAR;
+  config.preUs = BURST_CAPTURE_PRE_MS * 1000UL;
+  config.postUs = BURST_CAPTURE_POST_MS * 1000UL;
+  return config;
+}
+
+// ────────────────────── 記録 ──────────────────────
+void BurstCapture::reset()
+{
+  written_ = 0;
+  slopeCount_ = 0;
+  armed_ = false;
+  aboveLow_ = false;
+  belowLow_ = false;
+  trigger_ = BurstTrigger::None;
+  count_ = 0;
+  rearmRequested_.store(false, std::memory_order_relaxed);
+  state_.store(State::Recording, std::memory_order_release);
+}
+
+void BurstCapture::record(uint32_t timestampUs, int16_t raw, int32_t pressureQ16)
+{
+  State current = state_.load(std::memory_order_acquire);
+  if (current == State::Frozen)
+  {
+    if (!rearmRequested_.load(std::memory_order_acquire))
+    {
+      return;
+    }
+    reset();
+    current = State::Recording;
+  }
+
+  uint32_t deltaUs = (written_ == 0) ? 0 : timestampUs - lastTimestampUs_;
+  entries_[written_ & (CAPACITY - 1)] = {static_cast<uint16_t>(std::min<uint32_t>(deltaUs, UINT16_MAX)), raw};
+  lastTimestampUs_ = timestampUs;
+  written_++;
+
+  if (current == State::Recording)
+  {
+    BurstTrigger trigger = checkTrigger(timestampUs, pressureQ16);
+    if (trigger != BurstTrigger::None)
+    {
+      trigger_ = trigger;
+      triggerWritten_ = written_ - 1;
+      triggerUs_ = timestampUs;
+      state_.store(State::Triggered, std::memory_order_release);
+    }
+    return;
+  }
+
+  // トリガ後は指定時間が経つか、トリガ前の分を食い潰す手前で凍結する
+  size_t postCount = written_ - triggerWritten_;
+  if (timestampUs - triggerUs_ >= config_.postUs || postCount >= CAPACITY / 2)
+  {
+    freeze();
+  }
+}
+
+// ────────────────────── トリガ判定 ──────────────────────
+auto BurstCapture::checkTrigger(uint32_t timestampUs, int32_t pressureQ16) -> BurstTrigger
+{
+  // SLOPE_SPAN 件前のサンプルと入れ替える
+  SlopePoint &slot = slope_[slopeCount_ % SLOPE_SPAN];
+  SlopePoint past = slot;
+  bool hasPast = slopeCount_ >= SLOPE_SPAN;
+  slot = {timestampUs, pressureQ16};
+  slopeCount_++;
+
+  if (pressureQ16 >= config_.lowPressureQ16)
+  {
+    belowLow_ = false;
+    if (!aboveLow_)
+    {
+      aboveLow_ = true;
+      aboveSinceUs_ = timestampUs;
+    }
+    if (timestampUs - aboveSinceUs_ >= config_.armUs)
+    {
+      armed_ = true;
+    }
+  }
+  else
+  {
+    aboveLow_ = false;
+    if (!belowLow_)
+    {
+      belowLow_ = true;
+      belowSinceUs_ = timestampUs;
+    }
+    if (armed_ && timestampUs - belowSinceUs_ >= config_.lowHoldUs)
+    {
+      return BurstTrigger::LowPressure;
+    }
+  }
+
+  if (armed_ && hasPast)
+  {
+    // |ΔP| / Δt > limit を割り算なしで比べる
+    int64_t change = static_cast<int64_t>(pressureQ16) - past.pressureQ16;
+    if (change < 0) change = -change;
+    int64_t elapsedUs = static_cast<int64_t>(timestampUs - past.timestampUs);
+    if (elapsedUs > 0 && change * 1000000 > config_.slopeLimitQ16PerSecond * elapsedUs)
+    {
+      return BurstTrigger::PressureSlope;
+    }
+  }
+  return BurstTrigger::None;
+}
+
+// ────────────────────── 凍結 ──────────────────────
+void BurstCapture::freeze()
+{
+  size_t postCount = written_ - triggerWritten_;  // トリガのサンプルを含む
+  size_t maxPre = std::min(triggerWritten_, CAPACITY - postCount);
+
+  // トリガから遡り、preUs に収まる分だけ前のサンプルを含める
+  uint32_t elapsedUs = 0;
+  size_t pre = 0;
+  while (pre < maxPre)
+  {
+    uint32_t deltaUs = entries_[(triggerWritten_ - pre) & (CAPACITY - 1)].deltaUs;
+    if (elapsedUs + deltaUs > config_.preUs) break;
+    elapsedUs += deltaUs;
+    pre++;
+  }
+
+  start_ = (triggerWritten_ - pre) & (CAPACITY - 1);
+  count_ = pre + postCount;
+  triggerIndex_ = pre;
+  startOffsetUs_ = -static_cast<int32_t>(elapsedUs);
+
+  minPressureQ16_ = INT32_MAX;
+  maxPressureQ16_ = INT32_MIN;
+  forEachSample(
+      [&](int32_t, int16_t raw)
+      {
+        int32_t pressure = convertAdcToPressureQ16(raw);
+        minPressureQ16_ = std::min(minPressureQ16_, pressure);
+        maxPressureQ16_ = std::max(maxPressureQ16_, pressure);
+      });
+
+  captureCount_.fetch_add(1, std::memory_order_relaxed);
+  state_.store(State::Frozen, std::memory_order_release);
+}
+
+// ────────────────────── 共有インスタンス ──────────────────────
+auto burstCapture() -> BurstCapture &
+{
+  static BurstCapture capture(defaultBurstCaptureConfig());
+  return capture;
+}
+
+void dumpBurstCapture()
+{
+  const BurstCapture &capture = burstCapture();
+  if (!capture.frozen())
+  {
+    halLogf("# no burst capture (captures so far: %lu)\n", static_cast<unsigned long>(capture.captureCount()));
+    return;
+  }
+  const char *kind = (capture.trigger() == BurstTrigger::LowPressure) ? "low_pressure" : "pressure_slope";
+  halLogf("# trigger=%s samples=%u min=%.2fbar max=%.2fbar\n", kind, static_cast<unsigned>(capture.count()),
+          pressureQ16ToBar(capture.minPressureQ16()), pressureQ16ToBar(capture.maxPressureQ16()));
+  halLogf("t_ms,raw,bar\n");
+  capture.forEachSample(
+      [](int32_t offsetUs, int16_t raw)
+      { halLogf("%.3f,%d,%.3f\n", offsetUs / 1000.0F, raw, pressureQ16ToBar(convertAdcToPressureQ16(raw))); });
+}
@@ -0,0 +1,141 @@
+#ifndef BURST_CAPTURE_H
+#define BURST_CAPTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#include "config.h"
+
+// ────────────────────── 油圧のバーストキャプチャ ──────────────────────
+// 油圧の生サンプルを常にリングへ書き続け、トリガが掛かったら前後を残して凍結する。
+//   ・油圧が lowPressure 未満のまま lowHold 続いた（油切れ）
+//   ・油圧の変化率が slopeLimit を超えた（急上昇・急低下）
+// トリガは油圧が lowPressure 以上で arm 続いてから有効にし、エンジン停止中は掛からない。
+// record() は取得タスク、凍結後の読出しと rearm() は描画ループから呼ぶ。
+// 凍結中は取得タスクがバッファに触れないので、読出し側はロック無しで読める。
+
+enum class BurstTrigger : uint8_t
+{
+  None,
+  LowPressure,
+  PressureSlope
+};
+
+struct BurstCaptureConfig
+{
+  int32_t lowPressureQ16;          // [mbar, Q16]
+  uint32_t lowHoldUs;
+  uint32_t armUs;
+  int64_t slopeLimitQ16PerSecond;  // [mbar/s, Q16]
+  uint32_t preUs;
+  uint32_t postUs;
+};
+
+// config.h の設定から作る
+auto defaultBurstCaptureConfig() -> BurstCaptureConfig;
+
+class BurstCapture
+{
+ public:
+  static constexpr size_t CAPACITY = BURST_CAPTURE_CAPACITY;
+  static_assert((CAPACITY & (CAPACITY - 1)) == 0, "capacity must be a power of two");
+  static_assert(CAPACITY >= (BURST_CAPTURE_PRE_MS + BURST_CAPTURE_POST_MS) * OIL_PRESSURE_SAMPLE_RATE_HZ / 1000,
+                "capacity must hold the pre and post windows at the oil pressure rate");
+  // 変化率は SLOPE_SPAN 件前のサンプルとの差で見る（単発のノイズで掛からないように）
+  static constexpr size_t SLOPE_SPAN = 8;
+
+  enum class State : uint8_t
+  {
+    Recording,  // トリガ待ち
+    Triggered,  // トリガ後のサンプルを集めている
+    Frozen      // 読出し可能
+  };
+
+  explicit BurstCapture(const BurstCaptureConfig &config) : config_(config) {}
+
+  // ── 取得タスク側 ──
+  void record(uint32_t timestampUs, int16_t raw, int32_t pressureQ16);
+
+  // ── 読出し側 ──
+  auto state() const -> State { return state_.load(std::memory_order_acquire); }
+  auto frozen() const -> bool { return state() == State::Frozen; }
+  // 以下は凍結中のみ有効
+  auto trigger() const -> BurstTrigger { return trigger_; }
+  auto count() const -> size_t { return count_; }
+  auto triggerIndex() const -> size_t { return triggerIndex_; }
+  auto minPressureQ16() const -> int32_t { return minPressureQ16_; }
+  auto maxPressureQ16() const -> int32_t { return maxPressureQ16_; }
+  // 古い順に (トリガからの時刻 [us], 生コード) を渡す
+  template <typename F>
+  void forEachSample(F visit) const
+  {
+    int32_t offsetUs = startOffsetUs_;
+    for (size_t i = 0; i < count_; ++i)
+    {
+      const Entry &entry = entries_[(start_ + i) & (CAPACITY - 1)];
+      if (i > 0) offsetUs += entry.deltaUs;
+      visit(offsetUs, entry.raw);
+    }
+  }
+  // 凍結を解いて次のトリガを待つ（実際の再開は次の record() で行う）
+  void rearm() { rearmRequested_.store(true, std::memory_order_release); }
+  auto captureCount() const -> uint32_t { return captureCount_.load(std::memory_order_relaxed); }
+
+ private:
+  // 直前のサンプルからの経過時間と生コードだけを持ち、1 件 4B に収める
+  struct Entry
+  {
+    uint16_t deltaUs;  // 65535us で飽和
+    int16_t raw;
+  };
+
+  struct SlopePoint
+  {
+    uint32_t timestampUs;
+    int32_t pressureQ16;
+  };
+
+  void reset();
+  auto checkTrigger(uint32_t timestampUs, int32_t pressureQ16) -> BurstTrigger;
+  void freeze();
+
+  BurstCaptureConfig config_;
+  Entry entries_[CAPACITY] = {};
+  size_t written_ = 0;  // 通算の書込み数
+  uint32_t lastTimestampUs_ = 0;
+
+  // トリガ判定
+  SlopePoint slope_[SLOPE_SPAN] = {};
+  size_t slopeCount_ = 0;
+  bool armed_ = false;
+  bool aboveLow_ = false;
+  uint32_t aboveSinceUs_ = 0;
+  bool belowLow_ = false;
+  uint32_t belowSinceUs_ = 0;
+
+  // トリガ後
+  size_t triggerWritten_ = 0;  // トリガを掛けたサンプルの通算番号
+  uint32_t triggerUs_ = 0;
+  BurstTrigger trigger_ = BurstTrigger::None;
+
+  // 凍結後の読出し範囲
+  size_t start_ = 0;
+  size_t count_ = 0;
+  size_t triggerIndex_ = 0;
+  int32_t startOffsetUs_ = 0;
+  int32_t minPressureQ16_ = 0;
+  int32_t maxPressureQ16_ = 0;
+
+  std::atomic<State> state_{State::Recording};
+  std::atomic<bool> rearmRequested_{false};
+  std::atomic<uint32_t> captureCount_{0};
+};
+
+// 取得経路から使う共有インスタンス
+auto burstCapture() -> BurstCapture &;
+// 凍結中のキャプチャを CSV（トリガからの時刻 ms, 生コード, bar）で halLogf へ出す
+void dumpBurstCapture();
+
+#endif  // BURST_CAPTURE_H
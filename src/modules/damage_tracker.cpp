@@ -0,0 +1,90 @@
+#include "damage_tracker.h"
+
+#include <algorithm>
+
+// ────────────────────── 矩形演算 ──────────────────────
+auto DamageTracker::unite(const DamageRect &a, const DamageRect &b) -> DamageRect
+{
+  int left = std::min(a.x, b.x);
+  int top = std::min(a.y, b.y);
+  int right = std::max(a.x + a.w, b.x + b.w);
+  int bottom = std::max(a.y + a.h, b.y + b.h);
+  return {static_cast<int16_t>(left), static_cast<int16_t>(top), static_cast<int16_t>(right - left),
+          static_cast<int16_t>(bottom - top)};
+}
+
+// 重なっているか、まとめても無駄な転送が少なければ併合する
+auto DamageTracker::shouldMerge(const DamageRect &a, const DamageRect &b) -> bool
+{
+  uint32_t merged = unite(a, b).area();
+  return merged <= a.area() + b.area() + MERGE_SLACK_PX;
+}
+
+void DamageTracker::removeAt(size_t index)
+{
+  rects_[index] = rects_[count_ - 1];
+  count_--;
+}
+
+auto DamageTracker::area() const -> uint32_t
+{
+  uint32_t total = 0;
+  for (size_t i = 0; i < count_; ++i)
+  {
+    total += rects_[i].area();
+  }
+  return total;
+}
+
+// ────────────────────── 追加 ──────────────────────
+void DamageTracker::add(int x, int y, int w, int h)
+{
+  // キャンバス外を切り捨てる
+  int left = std::max(x, 0);
+  int top = std::max(y, 0);
+  int right = std::min(x + w, width_);
+  int bottom = std::min(y + h, height_);
+  if (right <= left || bottom <= top)
+  {
+    return;
+  }
+  DamageRect rect = {static_cast<int16_t>(left), static_cast<int16_t>(top), static_cast<int16_t>(right - left),
+                     static_cast<int16_t>(bottom - top)};
+
+  // 併合できる矩形があれば吸収し、広がった結果で再度まとめ直す
+  bool merged = true;
+  while (merged)
+  {
+    merged = false;
+    for (size_t i = 0; i < count_; ++i)
+    {
+      if (shouldMerge(rects_[i], rect))
+      {
+        rect = unite(rects_[i], rect);
+        removeAt(i);
+        merged = true;
+        break;
+      }
+    }
+  }
+
+  if (count_ < MAX_RECTS)
+  {
+    rects_[count_++] = rect;
+    return;
+  }
+
+  // 空きが無ければ面積の増加が最小になる相手とまとめる
+  size_t best = 0;
+  uint32_t bestGrowth = UINT32_MAX;
+  for (size_t i = 0; i < count_; ++i)
+  {
+    uint32_t growth = unite(rects_[i], rect).area() - rects_[i].area();
+    if (growth < bestGrowth)
+    {
+      best = i;
+      bestGrowth = growth;
+    }
+  }
+  rects_[best] = unite(rects_[best], rect);
+}
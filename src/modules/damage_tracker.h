@@ -0,0 +1,53 @@
+#ifndef DAMAGE_TRACKER_H
+#define DAMAGE_TRACKER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ────────────────────── 描画更新領域の管理 ──────────────────────
+// 描画呼び出しごとの矩形を受け取り、近いもの同士を併合して保持する。
+// 転送時はここに残った矩形だけを LCD へ送る。
+
+struct DamageRect
+{
+  int16_t x;
+  int16_t y;
+  int16_t w;
+  int16_t h;
+
+  auto area() const -> uint32_t { return static_cast<uint32_t>(w) * static_cast<uint32_t>(h); }
+};
+
+class DamageTracker
+{
+ public:
+  static constexpr size_t MAX_RECTS = 8;
+  // 併合で増える面積がこれ以下なら 1 回の転送にまとめる [px]
+  static constexpr uint32_t MERGE_SLACK_PX = 1024;
+
+  void setBounds(int width, int height)
+  {
+    width_ = width;
+    height_ = height;
+  }
+
+  void add(int x, int y, int w, int h);
+  void addAll() { add(0, 0, width_, height_); }
+  void clear() { count_ = 0; }
+
+  auto count() const -> size_t { return count_; }
+  auto operator[](size_t index) const -> const DamageRect & { return rects_[index]; }
+  auto area() const -> uint32_t;
+
+ private:
+  static auto unite(const DamageRect &a, const DamageRect &b) -> DamageRect;
+  static auto shouldMerge(const DamageRect &a, const DamageRect &b) -> bool;
+  void removeAt(size_t index);
+
+  DamageRect rects_[MAX_RECTS] = {};
+  size_t count_ = 0;
+  int width_ = 0;
+  int height_ = 0;
+};
+
+#endif  // DAMAGE_TRACKER_H
@@ -0,0 +1,193 @@
+#include "debug_page.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "burst_capture.h"
+#include "config.h"
+#include "hal/hal.h"
+#include "sensor_conversion.h"
+#include "session_stats.h"
+#include "stage_timing.h"
+
+// ページを描き直す間隔 [ms]
+constexpr uint32_t DEBUG_PAGE_REFRESH_MS = 500;
+
+static DebugPage activePage = DebugPage::None;
+static bool pageDrawn = false;
+static uint32_t lastDrawMs = 0;
+
+auto activeDebugPage() -> DebugPage { return activePage; }
+
+void toggleDebugPage(DebugPage page)
+{
+  activePage = (activePage == page) ? DebugPage::None : page;
+  pageDrawn = false;
+}
+
+// ────────────────────── 区間計測 ──────────────────────
+static void drawTimingPage(GaugeCanvas &canvas)
+{
+  constexpr int LINE_H = 12;
+  canvas.setCursor(4, 4);
+  canvas.print("STAGE TIMING [us]   count    p50    p99    max");
+
+  for (size_t i = 0; i < TIMING_STAGE_COUNT; ++i)
+  {
+    const LogHistogram &h = stageHistogram(static_cast<TimingStage>(i));
+    canvas.setCursor(4, 4 + LINE_H * static_cast<int>(i + 2));
+    canvas.printf("%-18s %7lu %6lu %6lu %6lu", stageName(static_cast<TimingStage>(i)),
+                  static_cast<unsigned long>(h.count()), static_cast<unsigned long>(h.percentile(50.0F)),
+                  static_cast<unsigned long>(h.percentile(99.0F)), static_cast<unsigned long>(h.max()));
+  }
+}
+
+// ────────────────────── バーストキャプチャ ──────────────────────
+// 横軸は時間、縦軸は 0〜MAX_OIL_PRESSURE_METER bar。列ごとの最小〜最大を縦線で描く
+static void drawCapturePage(GaugeCanvas &canvas)
+{
+  const BurstCapture &capture = burstCapture();
+  canvas.setCursor(4, 4);
+  if (!capture.frozen())
+  {
+    canvas.printf("BURST CAPTURE: waiting (%lu so far)", static_cast<unsigned long>(capture.captureCount()));
+    return;
+  }
+  const char *kind = (capture.trigger() == BurstTrigger::LowPressure) ? "low" : "slope";
+  canvas.printf("BURST %s  min %.2f  max %.2f bar", kind, pressureQ16ToBar(capture.minPressureQ16()),
+                pressureQ16ToBar(capture.maxPressureQ16()));
+
+  constexpr int PLOT_X = 0;
+  constexpr int PLOT_Y = 20;
+  constexpr int PLOT_W = LCD_WIDTH;
+  constexpr int PLOT_H = LCD_HEIGHT - PLOT_Y;
+  constexpr int32_t FULL_SCALE_Q16 = static_cast<int32_t>(MAX_OIL_PRESSURE_METER * 1000.0F) * PRESSURE_Q16_PER_MBAR;
+  const int32_t spanUs = static_cast<int32_t>((BURST_CAPTURE_PRE_MS + BURST_CAPTURE_POST_MS) * 1000UL);
+  const int32_t startUs = -static_cast<int32_t>(BURST_CAPTURE_PRE_MS * 1000UL);
+
+  auto toY = [&](int32_t pressureQ16)
+  {
+    int64_t scaled = static_cast<int64_t>(std::min(std::max(pressureQ16, 0), FULL_SCALE_Q16)) * (PLOT_H - 1);
+    return PLOT_Y + PLOT_H - 1 - static_cast<int>(scaled / FULL_SCALE_Q16);
+  };
+
+  // トリガ時刻と閾値の目安線
+  int triggerX = PLOT_X + static_cast<int>(static_cast<int64_t>(-startUs) * PLOT_W / spanUs);
+  canvas.drawLine(triggerX, PLOT_Y, triggerX, PLOT_Y + PLOT_H - 1, COLOR_GRAY);
+  int lowY = toY(barToPressureQ16(BURST_TRIGGER_LOW_BAR));
+  canvas.drawLine(PLOT_X, lowY, PLOT_X + PLOT_W - 1, lowY, COLOR_RED);
+
+  int column = -1;
+  int columnTop = 0;
+  int columnBottom = 0;
+  auto flush = [&]()
+  {
+    if (column >= 0) canvas.drawLine(PLOT_X + column, columnTop, PLOT_X + column, columnBottom, COLOR_WHITE);
+  };
+  capture.forEachSample(
+      [&](int32_t offsetUs, int16_t raw)
+      {
+        int x = static_cast<int>(static_cast<int64_t>(offsetUs - startUs) * PLOT_W / spanUs);
+        if (x < 0 || x >= PLOT_W) return;
+        int y = toY(convertAdcToPressureQ16(raw));
+        if (x != column)
+        {
+          flush();
+          column = x;
+          columnTop = columnBottom = y;
+        }
+        columnTop = std::min(columnTop, y);
+        columnBottom = std::max(columnBottom, y);
+      });
+  flush();
+}
+
+// ────────────────────── 走行統計 ──────────────────────
+// 上に出どころごとの表、下に油圧（横）×油温（縦、上ほど高温）のヒストグラムを対数の濃淡で描く
+static void drawStatsPage(GaugeCanvas &canvas)
+{
+  constexpr int LINE_H = 12;
+  // 取得タスクが更新中の集計は読まず、公開された写しを手元へ写してから描く
+  static SessionStats stats;
+  if (!sessionStats().readSnapshot(stats))
+  {
+    canvas.setCursor(4, 4);
+    canvas.print("STATS updating...");
+    return;
+  }
+  canvas.setCursor(4, 4);
+  canvas.print("STATS     min    p1   p50   p99   max  mean    sd");
+  for (size_t i = 0; i < GAUGE_SOURCE_COUNT; ++i)
+  {
+    const ChannelStats &channel = stats.channel(static_cast<GaugeSource>(i));
+    const RunningStats &m = channel.moments;
+    canvas.setCursor(4, 4 + LINE_H * static_cast<int>(i + 1));
+    canvas.printf("%-7s%6.1f%6.1f%6.1f%6.1f%6.1f%6.1f%6.2f", gaugeSpecFor(static_cast<GaugeSource>(i)).label, m.min(),
+                  channel.p1.value(), channel.p50.value(), channel.p99.value(), m.max(), m.mean(), m.stddev());
+  }
+
+  const PressureTempHistogram &histogram = stats.histogram();
+  constexpr int GRID_X = 28;
+  constexpr int GRID_Y = 66;
+  constexpr int CELL_W = (LCD_WIDTH - GRID_X - 4) / PressureTempHistogram::PRESSURE_BINS;
+  constexpr int CELL_H = 9;
+  constexpr int LABEL_EVERY = 4;
+  canvas.setCursor(4, GRID_Y - LINE_H);
+  canvas.printf("OIL.P x OIL.T  %lu s", static_cast<unsigned long>(histogram.total() / OIL_PRESSURE_SAMPLE_RATE_HZ));
+
+  float scale = (histogram.maxCount() > 0) ? 1.0F / std::log1p(static_cast<float>(histogram.maxCount())) : 0.0F;
+  for (int t = 0; t < PressureTempHistogram::TEMP_BINS; ++t)
+  {
+    int y = GRID_Y + (PressureTempHistogram::TEMP_BINS - 1 - t) * CELL_H;
+    if (t % LABEL_EVERY == 0)
+    {
+      canvas.setCursor(2, y + 1);
+      canvas.printf("%3.0f", STATS_OIL_TEMP_MIN_C + t * STATS_OIL_TEMP_BIN_C);
+    }
+    for (int p = 0; p < PressureTempHistogram::PRESSURE_BINS; ++p)
+    {
+      uint32_t count = histogram.count(p, t);
+      if (count == 0) continue;
+      float level = std::log1p(static_cast<float>(count)) * scale;
+      uint16_t color = rgb565(static_cast<uint8_t>(80.0F + 175.0F * level), static_cast<uint8_t>(230.0F * level * level),
+                              static_cast<uint8_t>(120.0F * (1.0F - level)));
+      canvas.fillRect(GRID_X + p * CELL_W, y, CELL_W - 1, CELL_H - 1, color);
+    }
+  }
+  int axisY = GRID_Y + PressureTempHistogram::TEMP_BINS * CELL_H + 2;
+  for (int p = 0; p < PressureTempHistogram::PRESSURE_BINS; p += LABEL_EVERY)
+  {
+    canvas.setCursor(GRID_X + p * CELL_W, axisY);
+    canvas.printf("%.0f", p * STATS_PRESSURE_BIN_BAR);
+  }
+}
+
+// ────────────────────── 描画 ──────────────────────
+auto drawDebugPage(GaugeCanvas &canvas) -> bool
+{
+  uint32_t now = halMillis();
+  if (pageDrawn && now - lastDrawMs < DEBUG_PAGE_REFRESH_MS)
+  {
+    return false;
+  }
+  lastDrawMs = now;
+  pageDrawn = true;
+
+  canvas.fillScreen(COLOR_BLACK);
+  canvas.setFont(&fonts::Font0);
+  canvas.setTextSize(1);
+  canvas.setTextColor(COLOR_WHITE);
+  if (activePage == DebugPage::Timing)
+  {
+    drawTimingPage(canvas);
+  }
+  else if (activePage == DebugPage::Capture)
+  {
+    drawCapturePage(canvas);
+  }
+  else if (activePage == DebugPage::Stats)
+  {
+    drawStatsPage(canvas);
+  }
+  return true;
+}
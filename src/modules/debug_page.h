@@ -0,0 +1,24 @@
+#ifndef DEBUG_PAGE_H
+#define DEBUG_PAGE_H
+
+#include <stdint.h>
+
+#include "hal/gauge_canvas.h"
+
+// ────────────────────── デバッグページ ──────────────────────
+// メーターの代わりに全画面で表示する診断用ページ
+enum class DebugPage : uint8_t
+{
+  None,
+  Timing,  // 区間ごとの p50/p99/最大
+  Capture,  // 凍結した油圧バーストキャプチャの波形
+  Stats     // 走行統計の表と油圧×油温のヒストグラム
+};
+
+auto activeDebugPage() -> DebugPage;
+// 表示中のページを指定すると閉じ、別のページなら切り替える
+void toggleDebugPage(DebugPage page);
+// 表示中は一定間隔で描き直し、描いたら true を返す
+auto drawDebugPage(GaugeCanvas &canvas) -> bool;
+
+#endif  // DEBUG_PAGE_H
@@ -0,0 +1,145 @@
+#include "digit_atlas.h"
+
+#include <cmath>
+
+#include "config.h"
+
+// ────────────────────── 数値の整形 ──────────────────────
+auto scaleToDecimal(float value, int decimals) -> int32_t
+{
+  float scale = 1.0F;
+  for (int i = 0; i < decimals; ++i)
+  {
+    scale *= 10.0F;
+  }
+  return static_cast<int32_t>(std::lround(value * scale));
+}
+
+auto formatDecimal(int32_t scaled, int decimals, char *out) -> size_t
+{
+  // 下の桁から逆順に取り出す。小数点の前に最低 1 桁を残す
+  char digits[12];
+  size_t count = 0;
+  uint32_t magnitude = (scaled < 0) ? 0U - static_cast<uint32_t>(scaled) : static_cast<uint32_t>(scaled);
+  do
+  {
+    digits[count++] = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude != 0 || count <= static_cast<size_t>(decimals));
+
+  size_t length = 0;
+  if (scaled < 0)
+  {
+    out[length++] = '-';
+  }
+  while (count > 0)
+  {
+    if (count == static_cast<size_t>(decimals))
+    {
+      out[length++] = '.';
+    }
+    out[length++] = digits[--count];
+  }
+  out[length] = '\0';
+  return length;
+}
+
+// ────────────────────── アトラスの組み立て ──────────────────────
+auto DigitAtlas::build(const GaugeFont *font) -> bool
+{
+  built_ = false;
+  font_ = font;
+
+  // LCD へは送らないので親ディスプレイ無しのキャンバスに 1 文字ずつ描いて読み取る
+  GaugeCanvas scratch(nullptr);
+  scratch.setColorDepth(DISPLAY_COLOR_DEPTH);
+  scratch.setFont(font);
+  scratch.setTextSize(1);
+  height_ = scratch.fontHeight();
+  rows_ = height_ + CELL_MARGIN * 2;
+
+  int widest = 0;
+  for (size_t glyph = 0; glyph < DIGIT_ATLAS_GLYPH_COUNT; ++glyph)
+  {
+    const char text[2] = {DIGIT_ATLAS_GLYPHS[glyph], '\0'};
+    advance_[glyph] = static_cast<uint8_t>(scratch.textWidth(text));
+    widest = std::max(widest, static_cast<int>(advance_[glyph]));
+  }
+  if (widest + CELL_MARGIN * 2 > CELL_BITS || rows_ > MAX_CELL_ROWS)
+  {
+    return false;
+  }
+  if (scratch.createSprite(CELL_BITS, rows_) == nullptr)
+  {
+    return false;
+  }
+
+  for (size_t glyph = 0; glyph < DIGIT_ATLAS_GLYPH_COUNT; ++glyph)
+  {
+    const char text[2] = {DIGIT_ATLAS_GLYPHS[glyph], '\0'};
+    scratch.fillScreen(COLOR_BLACK);
+    scratch.setTextColor(COLOR_WHITE);
+    scratch.setCursor(CELL_MARGIN, CELL_MARGIN);
+    scratch.print(text);
+    InkBounds ink = {CELL_BITS, 0, static_cast<uint8_t>(rows_), 0};
+    for (int row = 0; row < rows_; ++row)
+    {
+      uint32_t bits = 0;
+      for (int col = 0; col < CELL_BITS; ++col)
+      {
+        if (scratch.readPixel(col, row) != COLOR_BLACK)
+        {
+          bits |= 1U << col;
+        }
+      }
+      cells_[glyph][row] = bits;
+      if (bits != 0)
+      {
+        ink.left = std::min<uint8_t>(ink.left, __builtin_ctz(bits));
+        ink.right = std::max<uint8_t>(ink.right, CELL_BITS - __builtin_clz(bits));
+        ink.top = std::min<uint8_t>(ink.top, row);
+        ink.bottom = row + 1;
+      }
+    }
+    ink_[glyph] = (ink.left < ink.right) ? ink : InkBounds{};
+  }
+  built_ = true;
+  return true;
+}
+
+auto DigitAtlas::textWidth(const char *text, size_t length) const -> int
+{
+  int width = 0;
+  for (size_t i = 0; i < length; ++i)
+  {
+    int glyph = glyphIndex(text[i]);
+    if (glyph < 0) return -1;
+    width += advance_[glyph];
+  }
+  return width;
+}
+
+// ────────────────────── 数値表示 ──────────────────────
+auto valueDigitAtlas() -> const DigitAtlas &
+{
+  static DigitAtlas atlas;
+  static bool attempted = false;
+  if (!attempted)
+  {
+    attempted = true;
+    atlas.build(&FreeSansBold24pt7b);
+  }
+  return atlas;
+}
+
+void drawValueText(GaugeCanvas &canvas, const char *text, size_t length, int rightX, int y, uint16_t color)
+{
+  const DigitAtlas &atlas = valueDigitAtlas();
+  if (atlas.built() && atlas.drawRight(canvas, text, length, rightX, y, color))
+  {
+    return;
+  }
+  canvas.setFont(&FreeSansBold24pt7b);
+  canvas.setTextColor(color);
+  canvas.drawRightString(text, rightX, y);
+}
@@ -0,0 +1,116 @@
+#ifndef DIGIT_ATLAS_H
+#define DIGIT_ATLAS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+
+#include "hal/gauge_canvas.h"
+
+// ────────────────────── 数値の整形 ──────────────────────
+// 浮動小数点の printf を使わず、整数演算だけで数値を文字列にする
+
+// value を小数点以下 decimals 桁の固定小数（10^decimals 倍の整数）へ四捨五入する（0.5 は 0 から遠い方へ）
+auto scaleToDecimal(float value, int decimals) -> int32_t;
+// 10^decimals 倍の整数 scaled を "-12.3" の形で out に書いて NUL 終端し、文字数を返す。
+// out には DECIMAL_TEXT_SIZE バイト必要
+constexpr size_t DECIMAL_TEXT_SIZE = 16;
+auto formatDecimal(int32_t scaled, int decimals, char *out) -> size_t;
+
+// ────────────────────── 数字グリフアトラス ──────────────────────
+// 大きな数値表示に使う "0123456789.-" の 12 文字を、起動時に 1 度だけフォントから
+// ラスタライズして固定セルのビットマップに持つ。セルは 1 行 32bit（左右 2px の余白込み）で、
+// 描画は文字ごとに 1 回、セルのビットをバッファへ直接書くだけになる（クリップと色の変換もセル単位）。
+// 文字の送り幅と描く画素の外接矩形も組み立て時に表へ写すので、描画中にフォントの切り替えや
+// 幅の問い合わせ、画素ごとの範囲計算は行わない。
+constexpr char DIGIT_ATLAS_GLYPHS[] = "0123456789.-";
+constexpr size_t DIGIT_ATLAS_GLYPH_COUNT = sizeof(DIGIT_ATLAS_GLYPHS) - 1;
+
+class DigitAtlas
+{
+ public:
+  static constexpr int CELL_MARGIN = 2;  // 送り幅の外へはみ出す画素のための余白
+  static constexpr int CELL_BITS = 32;
+  static constexpr int MAX_CELL_ROWS = 64;
+
+  // font の 12 文字をラスタライズする。セルに収まらなければ false（描画側はフォントで描く）
+  auto build(const GaugeFont *font) -> bool;
+  auto built() const -> bool { return built_; }
+  auto font() const -> const GaugeFont * { return font_; }
+  // フォントの行高（描画の上端からの高さ）
+  auto height() const -> int { return height_; }
+
+  // アトラスの文字だけからなる text の幅。含まない文字があれば -1
+  auto textWidth(const char *text, size_t length) const -> int;
+
+  // text の右端を rightX、上端を y に揃えて描き、描いた画素の外接矩形を更新領域に加える。
+  // アトラスに無い文字があれば何も描かずに false を返す
+  template <typename Canvas>
+  auto drawRight(Canvas &canvas, const char *text, size_t length, int rightX, int y, uint16_t color) const -> bool
+  {
+    int width = textWidth(text, length);
+    if (width < 0) return false;
+
+    int penX = rightX - width;
+    int left = rightX;
+    int right = penX;
+    int top = y + height_;
+    int bottom = y;
+    const int cellY = y - CELL_MARGIN;
+    for (size_t i = 0; i < length; ++i)
+    {
+      int glyph = glyphIndex(text[i]);
+      int cellX = penX - CELL_MARGIN;
+      const InkBounds &ink = ink_[glyph];
+      if (ink.left < ink.right)
+      {
+        canvas.writeMaskCell(cellX, cellY + ink.top, cells_[glyph] + ink.top, ink.bottom - ink.top, color);
+        left = std::min(left, cellX + ink.left);
+        right = std::max(right, cellX + ink.right);
+        top = std::min(top, cellY + ink.top);
+        bottom = std::max(bottom, cellY + ink.bottom);
+      }
+      penX += advance_[glyph];
+    }
+    if (left < right)
+    {
+      canvas.addDamage(left, top, right - left, bottom - top);
+    }
+    return true;
+  }
+
+ private:
+  static constexpr auto glyphIndex(char ch) -> int
+  {
+    if (ch >= '0' && ch <= '9') return ch - '0';
+    if (ch == '.') return 10;
+    if (ch == '-') return 11;
+    return -1;
+  }
+
+  // セル内で 1 のビットがある範囲（右・下は含まない）。何も描かない文字は left == right
+  struct InkBounds
+  {
+    uint8_t left;
+    uint8_t right;
+    uint8_t top;
+    uint8_t bottom;
+  };
+
+  uint32_t cells_[DIGIT_ATLAS_GLYPH_COUNT][MAX_CELL_ROWS] = {};
+  uint8_t advance_[DIGIT_ATLAS_GLYPH_COUNT] = {};
+  InkBounds ink_[DIGIT_ATLAS_GLYPH_COUNT] = {};
+  const GaugeFont *font_ = nullptr;
+  int height_ = 0;
+  int rows_ = 0;
+  bool built_ = false;
+};
+
+// 24pt の大きな数値表示用のアトラス（初回の呼び出しで組み立てる）
+auto valueDigitAtlas() -> const DigitAtlas &;
+
+// 数値を右端 rightX・上端 y に揃えて 24pt で描く。アトラスを組み立てられなかったときはフォントで描く
+void drawValueText(GaugeCanvas &canvas, const char *text, size_t length, int rightX, int y, uint16_t color);
+
+#endif  // DIGIT_ATLAS_H
@@ -1,202 +1,475 @@
 #include "display.h"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstdio>
 #include <limits>
+#include <utility>
 
 #include "DrawFillArcMeter.h"
+#include "debug_page.h"
+#include "digit_atlas.h"
 #include "fps_display.h"
+#include "frame_pipeline.h"
+#include "gauge_background.h"
+#include "gauge_benchmarks.h"
+#include "hal/hal.h"
+#include "hal/hal_lcd.h"
+#include "session_records.h"
+#include "stage_timing.h"
+#include "telemetry.h"
 
 // ────────────────────── グローバル変数 ──────────────────────
-M5GFX display;
-M5Canvas mainCanvas(&display);
+GaugeDisplay display;
+GaugeCanvas mainCanvas(&display);
+static FramePipeline<GaugeCanvas, GaugeDisplay, GaugePixel> framePipeline(mainCanvas, display);
 
-static bool pressureGaugeInitialized = false;
-static bool waterGaugeInitialized = false;
+// 出どころの数に合わせて、すべて未描画 (NaN) で始める
+static auto makeUndrawnDisplayCache() -> DisplayCache
+{
+  DisplayCache cache;
+  std::fill(std::begin(cache.value), std::end(cache.value), std::numeric_limits<float>::quiet_NaN());
+  return cache;
+}
+DisplayCache displayCache = makeUndrawnDisplayCache();
+
+// ────────────────────── 転送パイプライン ──────────────────────
+// DMA が読む詰め替え領域 [px]。半分ずつ交互に使い、片方を送る間にもう片方へ front から詰める
+constexpr size_t FRAME_STAGING_PIXELS = static_cast<size_t>(LCD_WIDTH) * LCD_HEIGHT / 4;
+
+auto beginFramePipeline() -> bool
+{
+  size_t bytes = static_cast<size_t>(LCD_WIDTH) * LCD_HEIGHT * sizeof(GaugePixel);
+  // 内部 RAM には描画先 (back) と staging だけを置き、DMA が直接読まない front は PSRAM に置く。
+  // staging が取れなければ front を DMA で直接読むので、front も内部 RAM から取る
+  auto *back = static_cast<GaugePixel *>(halAllocFrameBuffer(bytes));
+  auto *staging = static_cast<GaugePixel *>(halAllocFrameBuffer(FRAME_STAGING_PIXELS * sizeof(GaugePixel)));
+  bool frontInPsram = staging != nullptr;
+  auto *front = static_cast<GaugePixel *>(frontInPsram ? halAllocLargeBuffer(bytes) : halAllocFrameBuffer(bytes));
+  if (back == nullptr || front == nullptr)
+  {
+    // 2 枚確保できなければ 1 枚のスプライトで同期転送する
+    halFreeFrameBuffer(back);
+    halFreeFrameBuffer(staging);
+    if (frontInPsram)
+    {
+      halFreeLargeBuffer(front);
+    }
+    else
+    {
+      halFreeFrameBuffer(front);
+    }
+    mainCanvas.createSprite(LCD_WIDTH, LCD_HEIGHT);
+    return false;
+  }
+  mainCanvas.attachBuffer(back, LCD_WIDTH, LCD_HEIGHT);
+  if (!framePipeline.begin(back, front, LCD_WIDTH, LCD_HEIGHT, staging, FRAME_STAGING_PIXELS))
+  {
+    return false;
+  }
+  // 転送の完了予定時刻ごとに次の転送を積む（描画やフレーム間の待機を待たない）
+  halLcdSetTransferDoneHandler([] { framePipeline.onTransferDone(); });
+  return true;
+}
 
-float recordedMaxOilPressure = 0.0F;
-float recordedMaxWaterTemp = 0.0F;
-int recordedMaxOilTempTop = 0;
+void finishFrameTransfer() { framePipeline.finish(); }
 
-// 前回描画したゲージ値
-static float prevPressureValue = std::numeric_limits<float>::quiet_NaN();
-static float prevWaterTempValue = std::numeric_limits<float>::quiet_NaN();
+auto framePipelineStats() -> const FramePipelineStats & { return framePipeline.stats(); }
 
-struct DisplayCache
+// ────────────────────── 横バー描画 ──────────────────────
+constexpr uint16_t TOP_BAR_BASE_COLOR = 0x18E3;
+// 右上の数値の領域の高さ（バーの右端から画面右端まで）
+constexpr int TOP_BAR_VALUE_H = 50;
+
+static auto topBarMarkX(const GaugeSpec &spec, float value) -> int
 {
-  float pressureAvg;
-  float waterTempAvg;
-  float oilTemp;
-  int16_t maxOilTemp;
-} displayCache = {std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::quiet_NaN(),
-                  std::numeric_limits<float>::quiet_NaN(), INT16_MIN};
+  return spec.region.x + static_cast<int>(spec.region.w * (value - spec.minValue) / (spec.maxValue - spec.minValue));
+}
 
-// ────────────────────── 油温バー描画 ──────────────────────
-void drawOilTemperatureTopBar(M5Canvas& canvas, float oilTemp, int maxOilTemp)
+// "OIL.T / Celsius,  MAX:" のようなキャプション（最高値はこの後ろに出す）
+template <size_t I>
+static auto topBarCaption() -> const char *
 {
-  constexpr int MIN_TEMP = 80;
-  constexpr int MAX_TEMP = 130;
-  constexpr int ALERT_TEMP = 120;
+  static char caption[32] = {};
+  if (caption[0] == '\0')
+  {
+    snprintf(caption, sizeof(caption), "%s / %s,  MAX:", GAUGE_LAYOUT[I].label, GAUGE_LAYOUT[I].unit);
+  }
+  return caption;
+}
 
-  constexpr int X = 20;
-  constexpr int Y = 15;
-  constexpr int W = 210;
-  constexpr int H = 20;
-  constexpr float RANGE = MAX_TEMP - MIN_TEMP;
+// 目盛・目盛ラベル・バーの下地・キャプションを背景レイヤーへ描く
+template <size_t I>
+static void drawTopBarBackground(GaugeCanvas& canvas)
+{
+  constexpr const GaugeSpec &SPEC = GAUGE_LAYOUT[I];
+  constexpr GaugeRegion BAR = SPEC.region;
+  canvas.fillRect(BAR.x + 1, BAR.y + 1, BAR.w - 2, BAR.h - 2, TOP_BAR_BASE_COLOR);
 
-  canvas.fillRect(X + 1, Y + 1, W - 2, H - 2, 0x18E3);
+  canvas.setTextSize(1);
+  canvas.setTextColor(COLOR_WHITE);
+  canvas.setFont(&fonts::Font0);
 
-  float drawTemp = oilTemp;
-  if (drawTemp >= 199.0F)
+  for (float mark = SPEC.minValue; mark <= SPEC.maxValue; mark += SPEC.majorTickStep)
   {
-    // 異常値の場合はバーを 0 として扱う
-    drawTemp = 0.0F;
+    int tx = topBarMarkX(SPEC, mark);
+    canvas.drawPixel(tx, BAR.y - 2, COLOR_WHITE);
+    canvas.setCursor(tx - 10, BAR.y - 14);
+    canvas.printf("%d", static_cast<int>(mark));
   }
+  int alertX = topBarMarkX(SPEC, SPEC.threshold);
+  canvas.drawLine(alertX, BAR.y, alertX, BAR.y + BAR.h - 2, COLOR_GRAY);
 
-  if (drawTemp >= MIN_TEMP)
+  canvas.setCursor(BAR.x, BAR.y + BAR.h + 4);
+  canvas.print(topBarCaption<I>());
+}
+
+// バー・最高値・現在値を、前回描いた内容（state）との差分だけ描く。
+// バーは増えた列を塗り、減った列を背景から戻す。警告値をまたいだときだけ塗りの全体を描き直す。
+// 数値は整数の表示が変わったときだけ描き直す
+template <size_t I>
+static void drawTopBar(GaugeCanvas& canvas, float value, int peak, GaugeDrawState& state, bool drawStatic)
+{
+  constexpr const GaugeSpec &SPEC = GAUGE_LAYOUT[I];
+  static_assert(SPEC.kind == GaugeKind::TopBar, "not a top bar gauge");
+  constexpr GaugeRegion BAR = SPEC.region;
+  constexpr int VALUE_X = BAR.x + BAR.w + 2;
+
+  if (drawStatic)
   {
-    int barWidth = static_cast<int>(W * (drawTemp - MIN_TEMP) / RANGE);
-    uint16_t barColor = (drawTemp >= ALERT_TEMP) ? COLOR_RED : COLOR_WHITE;
-    canvas.fillRect(X, Y, barWidth, H, barColor);
+    // 画面全体を背景から起こした直後。バーは空で、数値は描かれていない
+    state.barWidth = 0;
+    state.shownValue = INT32_MIN;
+    state.shownPeak = INT32_MIN;
+  }
+  if (state.barWidth < 0)
+  {
+    restoreGaugeBackground(canvas, BAR.x, BAR.y, BAR.w, BAR.h);
+    state.barWidth = 0;
   }
 
-  const int marks[] = {80, 90, 100, 110, 120, 130};
+  bool isError = false;
+  if constexpr (SPEC.error != GaugeError::None)
+  {
+    isError = value >= SPEC.errorAbove;
+  }
+
+  // 異常値の場合はバーを 0 として扱う。最大値を超えてもバーは枠内に収める
+  float barValue = isError ? 0.0F : value;
+  int barWidth = (barValue >= SPEC.minValue) ? std::min(topBarMarkX(SPEC, barValue) - BAR.x, BAR.w) : 0;
+  uint16_t barColor = (barValue >= SPEC.threshold) ? SPEC.alertColor : COLOR_WHITE;
+
+  // 塗った列の範囲 [paintFrom, paintTo)
+  int paintFrom = 0;
+  int paintTo = 0;
+  if (barColor != state.barColor)
+  {
+    // 警告値をまたいだので塗りの全体を新しい色で描き直す
+    paintTo = barWidth;
+  }
+  else if (barWidth > state.barWidth)
+  {
+    paintFrom = state.barWidth;
+    paintTo = barWidth;
+  }
+  if (paintTo > paintFrom)
+  {
+    canvas.fillRect(BAR.x + paintFrom, BAR.y, paintTo - paintFrom, BAR.h, barColor);
+    // 警告値の線はバーの上に重ねる（背景にも同じ線があるので、戻した列には描かなくてよい）
+    constexpr int ALERT_COLUMN = static_cast<int>(BAR.w * (SPEC.threshold - SPEC.minValue) /
+                                                  (SPEC.maxValue - SPEC.minValue));
+    if (ALERT_COLUMN >= paintFrom && ALERT_COLUMN < paintTo)
+    {
+      canvas.drawLine(BAR.x + ALERT_COLUMN, BAR.y, BAR.x + ALERT_COLUMN, BAR.y + BAR.h - 2, COLOR_GRAY);
+    }
+  }
+  if (state.barWidth > barWidth)
+  {
+    restoreGaugeBackground(canvas, BAR.x + barWidth, BAR.y, state.barWidth - barWidth, BAR.h);
+  }
+  state.barWidth = barWidth;
+  state.barColor = barColor;
+
   canvas.setTextSize(1);
   canvas.setTextColor(COLOR_WHITE);
   canvas.setFont(&fonts::Font0);
-
-  for (int m : marks)
+  if (peak != state.shownPeak)
   {
-    int tx = X + static_cast<int>(W * (m - MIN_TEMP) / RANGE);
-    canvas.drawPixel(tx, Y - 2, COLOR_WHITE);
-    canvas.setCursor(tx - 10, Y - 14);
-    canvas.printf("%d", m);
-    if (m == ALERT_TEMP) canvas.drawLine(tx, Y, tx, Y + H - 2, COLOR_GRAY);
+    int peakX = BAR.x + canvas.textWidth(topBarCaption<I>());
+    int peakY = BAR.y + BAR.h + 4;
+    restoreGaugeBackground(canvas, peakX, peakY, canvas.textWidth("000"), canvas.fontHeight());
+    canvas.setCursor(peakX, peakY);
+    canvas.printf("%03d", peak);
+    state.shownPeak = peak;
   }
 
-  canvas.setCursor(X, Y + H + 4);
-  canvas.printf("OIL.T / Celsius,  MAX:%03d", maxOilTemp);
-  // snprintf でバッファサイズを指定し、
-  // 安全に文字列化する
-  if (oilTemp >= 199.0F)
+  int32_t shownValue = isError ? 0 : static_cast<int32_t>(value);
+  if (isError == state.shownError && shownValue == state.shownValue)
+  {
+    return;
+  }
+  restoreGaugeBackground(canvas, VALUE_X, 0, LCD_WIDTH - VALUE_X, TOP_BAR_VALUE_H);
+  if (isError)
   {
-    // 199℃以上は "Disconnection" と "Error" を小さなフォントで表示
-    canvas.setFont(&fonts::Font0);
-    canvas.drawRightString("Disconnection", LCD_WIDTH - 1, 2);
+    // エラーは 2 行を小さなフォントで表示
+    canvas.drawRightString(gaugeErrorText(SPEC.error), LCD_WIDTH - 1, 2);
     canvas.drawRightString("Error", LCD_WIDTH - 1, 2 + canvas.fontHeight());
   }
   else
   {
-    char tempStr[8];
-    snprintf(tempStr, sizeof(tempStr), "%d", static_cast<int>(oilTemp));
-    canvas.setFont(&FreeSansBold24pt7b);
-    canvas.drawRightString(tempStr, LCD_WIDTH - 1, 2);
+    char valueText[DECIMAL_TEXT_SIZE];
+    size_t valueLength = formatDecimal(shownValue, 0, valueText);
+    drawValueText(canvas, valueText, valueLength, LCD_WIDTH - 1, 2, COLOR_WHITE);
   }
+  state.shownError = isError;
+  state.shownValue = shownValue;
 }
 
-// ────────────────────── 画面更新＋ログ ──────────────────────
-void renderDisplayAndLog(float pressureAvg, float waterTempAvg, float oilTemp, int16_t maxOilTemp)
+// ────────────────────── ゲージの展開 ──────────────────────
+// 表の I 番目のゲージの値の部分を、前回描いた内容 state との差分だけ描く
+template <size_t I>
+static void drawGaugeValueAt(GaugeCanvas& canvas, float value, float peak, GaugeDrawState& state, bool drawStatic)
 {
-  const int TOPBAR_Y = 0;
-  const int TOPBAR_H = 50;
-  const int GAUGE_H = 170;
+  if constexpr (GAUGE_LAYOUT[I].kind == GaugeKind::Arc)
+  {
+    drawFillArcMeter<I>(canvas, value, state.arcValue, drawStatic);
+  }
+  else
+  {
+    drawTopBar<I>(canvas, value, static_cast<int>(peak), state, drawStatic);
+  }
+}
 
-  // 温度は0.1度以上、油圧は0.05以上変化したら更新する
-  bool oilChanged = std::isnan(displayCache.oilTemp) || fabs(oilTemp - displayCache.oilTemp) >= 0.1F ||
-                    (maxOilTemp != displayCache.maxOilTemp);
-  bool pressureChanged = std::isnan(displayCache.pressureAvg) || fabs(pressureAvg - displayCache.pressureAvg) >= 0.05F;
-  bool waterChanged = std::isnan(displayCache.waterTempAvg) || fabs(waterTempAvg - displayCache.waterTempAvg) >= 0.1F;
+template <size_t I>
+static void drawGaugeBackgroundAt(GaugeCanvas& canvas)
+{
+  if constexpr (GAUGE_LAYOUT[I].kind == GaugeKind::Arc)
+  {
+    drawFillArcMeterBackground(canvas, GAUGE_LAYOUT[I]);
+  }
+  else
+  {
+    drawTopBarBackground<I>(canvas);
+  }
+}
 
-  mainCanvas.setTextColor(COLOR_WHITE);
+// ゲージごとの描画状態
+struct GaugeState
+{
+  bool initialized;  // 背景から起こして 1 度描いたか
+  float drawn;       // 最後に描いた値
+  int peak;          // 最後に描いた最高値（横バーのみ）
+  GaugeDrawState draw;
+};
+static GaugeState gaugeStates[GAUGE_COUNT] = {};
+
+// 表示する最高値（現在値も含める）。1 単位の切り捨てで出す
+template <size_t I>
+static auto gaugePeak(const GaugeValues& values) -> int
+{
+  constexpr size_t SOURCE = static_cast<size_t>(GAUGE_LAYOUT[I].source);
+  return static_cast<int>(std::floor(std::max(values.current[SOURCE], values.peak[SOURCE])));
+}
 
-  if (oilChanged)
+// 前回描いた値から表の更新幅以上に変わったか（横バーは最高値の変化も見る）
+template <size_t I>
+static auto gaugeNeedsRedraw(const GaugeValues& values) -> bool
+{
+  constexpr const GaugeSpec &SPEC = GAUGE_LAYOUT[I];
+  const GaugeState &state = gaugeStates[I];
+  float value = values.current[static_cast<size_t>(SPEC.source)];
+  bool changed = !state.initialized || fabs(value - state.drawn) >= SPEC.redrawDelta;
+  if constexpr (SPEC.kind == GaugeKind::TopBar)
   {
-    mainCanvas.fillRect(0, TOPBAR_Y, LCD_WIDTH, TOPBAR_H, COLOR_BLACK);
-    maxOilTemp = std::max<float>(oilTemp, maxOilTemp);
-    drawOilTemperatureTopBar(mainCanvas, oilTemp, maxOilTemp);
-    displayCache.oilTemp = oilTemp;
-    displayCache.maxOilTemp = maxOilTemp;
+    changed = changed || gaugePeak<I>(values) != state.peak;
   }
+  return changed;
+}
 
-  if (pressureChanged || !pressureGaugeInitialized)
+template <size_t I>
+static auto renderGauge(const GaugeValues& values) -> bool
+{
+  constexpr const GaugeSpec &SPEC = GAUGE_LAYOUT[I];
+  constexpr size_t SOURCE = static_cast<size_t>(SPEC.source);
+  if (!gaugeNeedsRedraw<I>(values))
   {
-    if (!pressureGaugeInitialized)
-    {
-      mainCanvas.fillRect(0, 60, 160, GAUGE_H, COLOR_BLACK);
-    }
-    bool useDecimal = pressureAvg < 9.95F;
-    drawFillArcMeter(mainCanvas, pressureAvg, 0.0f, MAX_OIL_PRESSURE_METER, 8.0f, COLOR_RED, "x100kPa", "OIL.P",
-                     recordedMaxOilPressure, prevPressureValue, 0.5f, useDecimal, 0, 60, !pressureGaugeInitialized);
-    pressureGaugeInitialized = true;
-    displayCache.pressureAvg = pressureAvg;
+    return false;
   }
+  GaugeState &state = gaugeStates[I];
+  float value = values.current[SOURCE];
+  int peak = gaugePeak<I>(values);
 
-  if (waterChanged || !waterGaugeInitialized)
+  ScopedStageTimer timer(SPEC.stage);
+  if (!state.initialized && SPEC.kind == GaugeKind::Arc)
   {
-    if (!waterGaugeInitialized)
-    {
-      mainCanvas.fillRect(160, 60, 160, GAUGE_H, COLOR_BLACK);
-    }
-    drawFillArcMeter(mainCanvas, waterTempAvg, WATER_TEMP_METER_MIN, WATER_TEMP_METER_MAX, 98.0f, COLOR_RED, "Celsius",
-                     "WATER.T", recordedMaxWaterTemp, prevWaterTempValue, 1.0f, false, 160, 60, !waterGaugeInitialized,
-                     5.0f, WATER_TEMP_METER_MIN);
-    waterGaugeInitialized = true;
-    displayCache.waterTempAvg = waterTempAvg;
+    restoreGaugeBackground(mainCanvas, SPEC.region.x, SPEC.region.y, SPEC.region.w, SPEC.region.h);
   }
+  drawGaugeValueAt<I>(mainCanvas, value, static_cast<float>(peak), state.draw, !state.initialized);
+  state.initialized = true;
+  state.drawn = value;
+  state.peak = peak;
+  displayCache.value[SOURCE] = value;
+  return true;
+}
 
-  bool fpsChanged = drawFpsOverlay();
+template <size_t... I>
+static auto renderGauges(const GaugeValues& values, std::index_sequence<I...> /*unused*/) -> bool
+{
+  bool changed = false;
+  // 転送は完了通知でつながるが、通知が遅れたときのために 1 つ描くごとにも確かめる
+  ((changed |= renderGauge<I>(values), framePipeline.service()), ...);
+  return changed;
+}
+
+template <size_t... I>
+static auto anyGaugeNeedsRedraw(const GaugeValues& values, std::index_sequence<I...> /*unused*/) -> bool
+{
+  return (gaugeNeedsRedraw<I>(values) || ...);
+}
+
+template <size_t... I>
+static void drawGaugeBackgrounds(GaugeCanvas& canvas, std::index_sequence<I...> /*unused*/)
+{
+  (drawGaugeBackgroundAt<I>(canvas), ...);
+}
+
+using GaugeDrawFn = void (*)(GaugeCanvas&, float, float, GaugeDrawState&, bool);
+
+template <size_t... I>
+constexpr auto makeGaugeDrawTable(std::index_sequence<I...> /*unused*/) -> std::array<GaugeDrawFn, GAUGE_COUNT>
+{
+  return {&drawGaugeValueAt<I>...};
+}
+
+void drawGaugeValue(GaugeCanvas& canvas, size_t index, float value, float peak, GaugeDrawState& state)
+{
+  static constexpr std::array<GaugeDrawFn, GAUGE_COUNT> DRAW = makeGaugeDrawTable(std::make_index_sequence<GAUGE_COUNT>{});
+  DRAW[index](canvas, value, peak, state, false);
+}
+
+// ────────────────────── 背景レイヤー ──────────────────────
+static void drawStaticLayer(GaugeCanvas& canvas)
+{
+  drawGaugeBackgrounds(canvas, std::make_index_sequence<GAUGE_COUNT>{});
+}
 
-  // 値が更新されたときのみスプライトを転送する
-  if (oilChanged || pressureChanged || waterChanged || fpsChanged)
+auto beginDisplayLayers() -> bool
+{
+  // 数値表示のアトラスは背景と同じく起動時に 1 度だけ組み立てる
+  valueDigitAtlas();
+  if (!beginGaugeBackground(drawStaticLayer))
   {
-    mainCanvas.pushSprite(0, 0);
+    return false;
   }
+  // 初回フレームは画面全体を背景から起こす
+  restoreGaugeBackground(mainCanvas, 0, 0, LCD_WIDTH, LCD_HEIGHT);
+  return true;
 }
 
-// ────────────────────── メーター描画更新 ──────────────────────
-void updateGauges()
+// 画面全体を背景から起こし直し、次の描画で全項目を描かせる
+static void invalidateGauges()
 {
-  static float smoothWaterTemp = std::numeric_limits<float>::quiet_NaN();
-  static float smoothOilTemp = std::numeric_limits<float>::quiet_NaN();
-  static float smoothOilPressure = std::numeric_limits<float>::quiet_NaN();
-
-  float pressureAvg = calculateAverage(oilPressureSamples);
-  pressureAvg = std::min(pressureAvg, MAX_OIL_PRESSURE_DISPLAY);
-  float targetWaterTemp = calculateAverage(waterTemperatureSamples);
-  float targetOilTemp = calculateAverage(oilTemperatureSamples);
+  restoreGaugeBackground(mainCanvas, 0, 0, LCD_WIDTH, LCD_HEIGHT);
+  for (GaugeState &state : gaugeStates)
+  {
+    state.initialized = false;
+  }
+  invalidateFpsOverlay();
+}
 
-  if (std::isnan(smoothWaterTemp))
+// ────────────────────── 画面更新＋ログ ──────────────────────
+auto renderDisplayAndLog(const GaugeValues& values) -> bool
+{
+  // デバッグページの表示中はメーターを描かず、戻ったときに全体を描き直す
+  static bool debugPageShown = false;
+  if (activeDebugPage() != DebugPage::None)
   {
-    smoothWaterTemp = targetWaterTemp;
+    debugPageShown = true;
+    framePipeline.beginFrame();
+    if (drawDebugPage(mainCanvas))
+    {
+      framePipeline.present();
+      return true;
+    }
+    return false;
   }
-  if (std::isnan(smoothOilTemp))
+  if (debugPageShown)
+  {
+    debugPageShown = false;
+    invalidateGauges();
+  }
+
+  // どのゲージも更新幅を超えて変わらず、FPS 表示も据え置きならフレームを丸ごと飛ばす
+  if (!anyGaugeNeedsRedraw(values, std::make_index_sequence<GAUGE_COUNT>{}) && !fpsOverlayDue())
   {
-    smoothOilTemp = targetOilTemp;
+    framePipeline.service();
+    return false;
   }
-  if (std::isnan(smoothOilPressure))
+
+  framePipeline.beginFrame();
+  mainCanvas.setTextColor(COLOR_WHITE);
+
+  // ゲージごとに、表の更新幅以上に変わったものだけを描く
+  bool gaugesChanged = renderGauges(values, std::make_index_sequence<GAUGE_COUNT>{});
+
+  bool fpsChanged = drawFpsOverlay();
+
+  // 値が更新されたときのみ、描き換えた矩形だけを転送する。
+  // 非同期転送時は DMA を起動して戻り、次フレームの描画と並行させる
+  if (!gaugesChanged && !fpsChanged)
   {
-    smoothOilPressure = pressureAvg;
+    return false;
   }
+  ScopedStageTimer timer(TimingStage::Push);
+  framePipeline.present();
+  return true;
+}
 
-  smoothWaterTemp += 0.1F * (targetWaterTemp - smoothWaterTemp);
-  smoothOilTemp += 0.1F * (targetOilTemp - smoothOilTemp);
-  smoothOilPressure += OIL_PRESSURE_SMOOTHING_ALPHA * (pressureAvg - smoothOilPressure);
+// ────────────────────── メーター描画更新 ──────────────────────
+auto updateGauges() -> bool
+{
+  ScopedStageTimer timer(TimingStage::Frame);
+  uint32_t frameStartUs = halMicros();
+  uint32_t pipelineFrames = framePipeline.stats().frames;
+  uint64_t pushBytesBefore = mainCanvas.totalPushBytes();
+
+  // 平均・平滑化は取得タスクのフィルタで済んでいる。float へは描画に渡す直前で変換する
+  drainSensorSamples();
 
-  float oilTempValue = smoothOilTemp;
-  float pressureValue = smoothOilPressure;
-  if (!SENSOR_OIL_TEMP_PRESENT)
+  // 各ゲージの入力チャンネルの最新値を、表の換算で表示単位にする
+  GaugeValues values = {};
+  for (const GaugeSpec &spec : GAUGE_LAYOUT)
   {
-    // センサーが無い場合は常に 0 表示
-    oilTempValue = 0.0F;
+    values.current[static_cast<size_t>(spec.source)] =
+        gaugeInputValue(spec.input, sensorReadings[spec.input.adcChannel]);
   }
 
-  recordedMaxOilPressure = std::max(recordedMaxOilPressure, pressureAvg);
-  recordedMaxWaterTemp = std::max(recordedMaxWaterTemp, smoothWaterTemp);
-  if (targetOilTemp < 199.0F)
+  // 最高値はセッションの記録から取る（エラー表示の値は記録に入らない）
+  SessionRecords &records = sessionRecords();
+  records.update(values, halMillis());
+  for (size_t i = 0; i < GAUGE_SOURCE_COUNT; ++i)
   {
-    recordedMaxOilTempTop = std::max(recordedMaxOilTempTop, static_cast<int>(targetOilTemp));
+    values.peak[i] = records.sessionPeak(static_cast<GaugeSource>(i));
   }
+  bool rendered = renderDisplayAndLog(values);
 
-  renderDisplayAndLog(pressureValue, smoothWaterTemp, oilTempValue, recordedMaxOilTempTop);
+  // フレームごとの所要時間をテレメトリへ流す（無効時は何もしない）
+  if (telemetryActive())
+  {
+    static uint32_t telemetryFrameIndex = 0;
+    bool presented = framePipeline.stats().frames != pipelineFrames;
+    sendTelemetryFrame({telemetryFrameIndex++, frameStartUs, halMicros() - frameStartUs,
+                        presented ? static_cast<uint32_t>(framePipeline.lastFrame().fenceWaitUs) : 0U,
+                        static_cast<uint32_t>(mainCanvas.totalPushBytes() - pushBytesBefore)});
+  }
+  return rendered;
+}
+
+// ────────────────────── ベンチマーク ──────────────────────
+void runDisplayBenchmarks(MicroBench &bench)
+{
+  runGaugeBenchmarks(bench, mainCanvas);
+  // 計測で描いた内容は捨て、次のフレームで全体を描き直す
+  invalidateGauges();
 }
@@ -1,17 +1,54 @@
 #ifndef DISPLAY_H
 #define DISPLAY_H
 
-#include <M5GFX.h>
-
 #include "config.h"
+#include "frame_pipeline.h"
+#include "gauge_layout.h"
+#include "hal/gauge_canvas.h"
+#include "microbench.h"
 #include "sensor.h"
 
-extern M5GFX display;
-extern M5Canvas mainCanvas;
+extern GaugeDisplay display;
+extern GaugeCanvas mainCanvas;
 extern int currentFps;
 
-void drawOilTemperatureTopBar(M5Canvas& canvas, float oilTemp, int maxOilTemp);
-void renderDisplayAndLog(float pressureAvg, float waterTempAvg, float oilTemp, int16_t maxOilTemp);
-void updateGauges();
+// 出どころごとに最後に画面へ描いた値（未描画は NaN）
+struct DisplayCache
+{
+  float value[GAUGE_SOURCE_COUNT];
+
+  auto operator[](GaugeSource source) const -> float { return value[static_cast<size_t>(source)]; }
+};
+extern DisplayCache displayCache;
+
+// ゲージの差分描画のために、前回描いた内容を覚えておく
+struct GaugeDrawState
+{
+  float arcValue = 0.0F;  // 円弧のバーの前回値
+  // 横バー。幅が負なら画面の内容は不明で、次の描画でバーを背景から起こす
+  int barWidth = -1;
+  uint16_t barColor = COLOR_WHITE;
+  // 右上の数値と最高値。INT32_MIN は未描画（次の描画で必ず描く）
+  int32_t shownValue = INT32_MIN;
+  int32_t shownPeak = INT32_MIN;
+  bool shownError = false;
+};
+
+// 描画バッファを 2 枚確保して非同期 DMA 転送を有効にする（確保できなければ同期転送で false）
+auto beginFramePipeline() -> bool;
+// 送信中のフレームを LCD へ送り切る
+void finishFrameTransfer();
+auto framePipelineStats() -> const FramePipelineStats &;
+
+// 静的部分を背景レイヤーへ描き、画面全体をそこから初期化する（確保できなければ false）
+auto beginDisplayLayers() -> bool;
+// 配置表の index 番目のゲージの値の部分を、state との差分だけ描く（ベンチマーク用）
+void drawGaugeValue(GaugeCanvas& canvas, size_t index, float value, float peak, GaugeDrawState& state);
+// 更新幅を超えて変わったゲージだけを描いて転送する。何も変わらなければ描かずに false
+auto renderDisplayAndLog(const GaugeValues& values) -> bool;
+// 取得タスクの結果を読んで 1 フレーム描く（描いて転送したら true）
+auto updateGauges() -> bool;
+// 描画系のベンチマークを画面用キャンバスで回す。終わった後のフレームは全体を描き直す
+void runDisplayBenchmarks(MicroBench& bench);
 
 #endif  // DISPLAY_H
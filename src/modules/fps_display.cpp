@@ -1,8 +1,10 @@
 #include "fps_display.h"
 
-#include <M5CoreS3.h>
-
 #include "display.h"
+#include "hal/hal.h"
+
+// 直近 1 秒間のフレーム数（main.cpp が更新）
+int currentFps = 0;
 
 // FPSラベルが描画済みかどうかを保持
 static bool fpsLabelDrawn = false;
@@ -16,7 +18,7 @@ auto drawFpsOverlay() -> bool
 
   // ラベルがメーターに重ならないよう画面最下部へ配置
   constexpr int FPS_Y = LCD_HEIGHT - 16;  // 下端に合わせる
-  unsigned long now = millis();
+  unsigned long now = halMillis();
   if (!fpsLabelDrawn)
   {
     // 表示領域を初期化してラベルを描画
@@ -38,3 +40,7 @@ auto drawFpsOverlay() -> bool
   }
   return false;
 }
+
+auto fpsOverlayDue() -> bool { return !fpsLabelDrawn || halMillis() - lastFpsDrawTime >= 1000UL; }
+
+void invalidateFpsOverlay() { fpsLabelDrawn = false; }
@@ -3,5 +3,9 @@
 
 // FPS表示を更新したかどうかを返す
 auto drawFpsOverlay() -> bool;
+// 次の drawFpsOverlay() で描き換えるか（ラベルが未描画か、前回の更新から 1 秒経った）
+auto fpsOverlayDue() -> bool;
+// 画面を描き直した後にラベルから描かせる
+void invalidateFpsOverlay();
 
 #endif  // FPS_DISPLAY_H
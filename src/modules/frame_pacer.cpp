@@ -0,0 +1,124 @@
+#include "frame_pacer.h"
+
+#include "config.h"
+#include "hal/hal.h"
+#include "hal/hal_power.h"
+
+// ────────────────────── 集計 ──────────────────────
+auto PacingStats::busyPercent() const -> float
+{
+  uint64_t total = busyUs + idleUs;
+  return (total == 0) ? 0.0F : 100.0F * static_cast<float>(busyUs) / static_cast<float>(total);
+}
+
+auto PacingStats::skippedPercent() const -> float
+{
+  uint32_t frames = renderedFrames + skippedFrames;
+  return (frames == 0) ? 0.0F : 100.0F * static_cast<float>(skippedFrames) / static_cast<float>(frames);
+}
+
+auto PacingStats::estimatedPowerMw() const -> float
+{
+  uint64_t total = busyUs + idleUs;
+  if (total == 0)
+  {
+    return 0.0F;
+  }
+  return (static_cast<float>(busyUs) * POWER_BUSY_MW + static_cast<float>(idleUs) * POWER_IDLE_MW) /
+         static_cast<float>(total);
+}
+
+// ────────────────────── 待ち方 ──────────────────────
+auto FramePacer::begin(bool allowLightSleep) -> bool
+{
+  if (!POWER_SAVE_ENABLED)
+  {
+    return false;
+  }
+  managed_ = halBeginPowerManagement(CPU_FREQ_MAX_MHZ, CPU_FREQ_MIN_MHZ, POWER_LIGHT_SLEEP_ENABLED && allowLightSleep);
+  if (!managed_)
+  {
+    // 描画している状態から始め、周波数はフレームの状態が変わったときだけ切り替える
+    active_ = true;
+    skippedRun_ = 0;
+    halSetCpuBoost(true);
+  }
+  return managed_;
+}
+
+auto FramePacer::sleepBudgetUs(uint32_t waitUs) -> uint32_t { return (waitUs >= PACING_MIN_SLEEP_US) ? waitUs : 0; }
+
+void FramePacer::runOnce(RateScheduler &scheduler)
+{
+  uint32_t wakeUs = halMicros();
+  // 電源管理のロックの出し入れは軽いので、起きるたびに取る
+  bool boostPerRun = POWER_SAVE_ENABLED && managed_;
+  if (boostPerRun)
+  {
+    halSetCpuBoost(true);
+  }
+  scheduler.runDue();
+
+  uint32_t nowUs = halMicros();
+  uint32_t waitUs = scheduler.untilNextDeadlineUs(nowUs);
+  uint32_t sleepUs = sleepBudgetUs(waitUs);
+  stats_.loops++;
+  if (sleepUs == 0)
+  {
+    // 眠るほどでもない待ちは、周波数を変えずにその場で待つ
+    halDelayMicroseconds(waitUs);
+    stats_.shortWaits++;
+    stats_.busyUs += halMicros() - wakeUs;
+    return;
+  }
+  stats_.busyUs += nowUs - wakeUs;
+
+  if (boostPerRun)
+  {
+    halSetCpuBoost(false);
+  }
+  halIdleUs(sleepUs);
+  stats_.sleeps++;
+  stats_.idleUs += halMicros() - nowUs;
+}
+
+void FramePacer::countFrame(bool rendered)
+{
+  if (rendered)
+  {
+    stats_.renderedFrames++;
+    skippedRun_ = 0;
+  }
+  else
+  {
+    stats_.skippedFrames++;
+    skippedRun_++;
+  }
+
+  // 電源管理が無ければ、描画が止まったら最低周波数へ落とし、再び描いたら戻す
+  if (!POWER_SAVE_ENABLED || managed_)
+  {
+    return;
+  }
+  bool active = skippedRun_ < PACING_IDLE_AFTER_SKIPPED_FRAMES;
+  if (active != active_)
+  {
+    active_ = active;
+    halSetCpuBoost(active);
+    stats_.cpuSwitches++;
+  }
+}
+
+// ────────────────────── 統計出力 ──────────────────────
+void FramePacer::dump() const
+{
+  halLogf("pacing loops=%lu sleeps=%lu short=%lu busy=%.1f%% frames=%lu skipped=%.1f%% cpu_switches=%lu\n",
+          static_cast<unsigned long>(stats_.loops), static_cast<unsigned long>(stats_.sleeps),
+          static_cast<unsigned long>(stats_.shortWaits), stats_.busyPercent(),
+          static_cast<unsigned long>(stats_.renderedFrames + stats_.skippedFrames), stats_.skippedPercent(),
+          static_cast<unsigned long>(stats_.cpuSwitches));
+  // 実測ではなく、起きていた割合で目安の 2 値を按分しただけの値
+  halLogf("power estimate=%.0fmW (not measured: busy %lumW / idle %lumW weighted by busy time)\n",
+          stats_.estimatedPowerMw(), static_cast<unsigned long>(POWER_BUSY_MW),
+          static_cast<unsigned long>(POWER_IDLE_MW));
+}
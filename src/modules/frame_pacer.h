@@ -0,0 +1,60 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rate_scheduler.h"
+
+// ────────────────────── フレームの間隔制御 ──────────────────────
+// loop() の 1 周を「締め切りを過ぎたタスクを回す → 次の締め切りまで待つ」にする。
+// 待ちが PACING_MIN_SLEEP_US 以上なら CPU を譲って眠り（実機は低い周波数かライトスリープ）、
+// それより短ければその場で待つ。電源管理があればタスクを回している間だけ最高周波数のロックを持つ。
+// 電源管理が無ければ周波数の切り替え自体が重いので、描画が止まった・再開したときだけ切り替える。
+// 時刻は halMicros()、待ち方は HAL に任せるので、ホストでは仮想時計のまま試験できる。
+
+struct PacingStats
+{
+  uint32_t loops;
+  uint32_t sleeps;          // CPU を譲って眠った回数
+  uint32_t shortWaits;      // 締め切りが近く、眠らずに待った回数
+  uint32_t renderedFrames;  // 描画して転送したフレーム
+  uint32_t skippedFrames;   // どの値も更新幅を超えず、描画を飛ばしたフレーム
+  uint64_t busyUs;          // タスクの実行と短い待ちの時間
+  uint64_t idleUs;          // 眠っていた時間
+  uint32_t cpuSwitches;     // 電源管理が無いときに周波数を直接切り替えた回数
+
+  auto busyPercent() const -> float;
+  auto skippedPercent() const -> float;
+  // 起きていた時間と眠っていた時間の割合で POWER_BUSY_MW / POWER_IDLE_MW を按分した見積もり [mW]（実測ではない）
+  auto estimatedPowerMw() const -> float;
+};
+
+class FramePacer
+{
+ public:
+  // 周波数の範囲とライトスリープの可否を HAL へ設定する（電源管理を使えなければ false）
+  auto begin(bool allowLightSleep) -> bool;
+  // 締め切りのタスクを回し、次の締め切りまで待つ（loop() の 1 周分）
+  void runOnce(RateScheduler &scheduler);
+  // 描画タスクがフレームごとに、描画したか飛ばしたかを知らせる
+  void countFrame(bool rendered);
+
+  // 次の締め切りまで waitUs あるときに眠る長さ（0 なら眠らずに待つ）
+  static auto sleepBudgetUs(uint32_t waitUs) -> uint32_t;
+
+  auto stats() const -> const PacingStats & { return stats_; }
+  void resetStats() { stats_ = {}; }
+  // 電源管理が無い場合に、描画が続いていて最高周波数にしているか
+  auto isActive() const -> bool { return active_; }
+  // 起きていた割合・飛ばしたフレーム・消費電力の見積もりを halLogf で出力する
+  void dump() const;
+
+ private:
+  PacingStats stats_ = {};
+  bool managed_ = false;  // ESP-IDF の電源管理が使える
+  bool active_ = true;
+  uint32_t skippedRun_ = 0;  // 続けて描画を飛ばしたフレーム数
+};
+
+#endif  // FRAME_PACER_H
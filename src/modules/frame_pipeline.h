@@ -0,0 +1,388 @@
+#ifndef FRAME_PIPELINE_H
+#define FRAME_PIPELINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include "config.h"
+#include "damage_tracker.h"
+#include "hal/hal.h"
+#include "hal/hal_lcd.h"
+#include "hal/hal_power.h"
+
+// ────────────────────── ダブルバッファ DMA 転送 ──────────────────────
+// キャンバスの描画先 (back) と転送する内容の写し (front) を 2 枚のバッファで分け、
+// フレーム N を DMA で送っている間にフレーム N+1 を back へ描く。
+//
+//   beginFrame()     … 描画開始。前フレームの転送を進める
+//   onTransferDone() … DMA の完了通知 (hal_lcd.h) から呼ばれ、次の転送を積む
+//   service()        … 描画の合間にも確かめる（通知が遅れたときの保険）
+//   present()        … フェンス（前フレームの転送完了待ち）→ 更新矩形を front へ写す → 転送開始
+//
+// 転送は完了通知の文脈（実機は esp_timer のタスク）でつなぐので、描画中もフレーム間の待機中も止まらない。
+// 積む処理は描画側と通知側のどちらか一方だけが行うよう、kicking_ で排他する。
+//
+// back は入れ替えず描画先のままにし、present() で更新矩形だけを front へ写す。
+// DMA は内部 RAM の連続した転送元しか読めないので、転送は詰め替え領域 (staging) を半分ずつ使って送る。
+// 片方を DMA で送っている間に、もう片方へ front から次の行の束（矩形は w 幅、帯は全幅）を詰めておく。
+// DMA が front を直接読まないので、front は PSRAM に置ける（内部 RAM は back と staging だけ）。
+// staging が無ければ front を内部 RAM に置き、全幅の帯を front から直接送る。
+// 縦に重なる矩形の組は、全幅の帯 1 本の方が転送 1 回ぶんの手間込みで安いときだけ帯にまとめる。
+// SPI バスはフレームの転送を始めるときに握り、最後の転送が終わったら手放す。
+// 自動ライトスリープは SPI/GDMA のクロックを止めて転送を壊すので、バスを握っている間は入らせない。
+
+struct FramePipelineStats
+{
+  uint32_t frames;
+  uint64_t renderUs;       // beginFrame() から present() までの描画時間の合計
+  uint64_t overlapUs;      // そのうち前フレームの転送と並行していた時間
+  uint64_t fenceWaitUs;    // 前フレームの転送完了を待って止まった時間
+  uint64_t transferBytes;  // DMA で送ったバイト数
+
+  // 描画時間のうち転送と重なっていた割合 [%]
+  auto overlapPercent() const -> float
+  {
+    return (renderUs == 0) ? 0.0F : 100.0F * static_cast<float>(overlapUs) / static_cast<float>(renderUs);
+  }
+};
+
+template <typename Canvas, typename Display, typename Pixel>
+class FramePipeline
+{
+ public:
+  FramePipeline(Canvas &canvas, Display &display) : canvas_(canvas), display_(display) {}
+
+  // canvas が描いている buffer (back) と同じ大きさの 2 枚目 (front) を受け取り、非同期転送を有効にする。
+  // 2 枚目が無ければ false を返し、present() は従来どおり同期転送になる。
+  // staging は DMA が読む詰め替え領域（stagingPixels 画素、2 行分以上）。無ければ front を DMA で直接読むので、
+  // front は DMA 可能なメモリに置き、転送は常に全幅の帯になる
+  auto begin(Pixel *back, Pixel *front, int width, int height, Pixel *staging = nullptr, size_t stagingPixels = 0)
+      -> bool
+  {
+    if (back == nullptr || front == nullptr)
+    {
+      return false;
+    }
+    back_ = back;
+    front_ = front;
+    width_ = width;
+    height_ = height;
+    bool staged = staging != nullptr && stagingPixels >= 2 * static_cast<size_t>(width);
+    staging_ = staged ? staging : nullptr;
+    chunkPixels_ = staged ? stagingPixels / 2 : 0;
+    std::memcpy(front_, back_, static_cast<size_t>(width_) * height_ * sizeof(Pixel));
+    active_ = true;
+    return true;
+  }
+
+  auto active() const -> bool { return active_; }
+
+  void beginFrame()
+  {
+    service();
+    renderStartUs_ = halMicros();
+  }
+
+  // DMA が空いていれば次の転送を始める
+  void service() { advanceTransfers(); }
+
+  // 完了予定時刻の通知から呼ぶ。まだ送信中か描画側が積んでいる最中なら、少し後に確かめ直す
+  void onTransferDone()
+  {
+    if (!advanceTransfers())
+    {
+      halLcdNotifyAfterUs(TRANSFER_RECHECK_US);
+    }
+  }
+
+  void present()
+  {
+    if (!active_)
+    {
+      canvas_.pushDamage();
+      return;
+    }
+
+    // ── フェンス: 前フレームの転送をすべて終えるまで front と staging を書き換えない ──
+    uint32_t renderEndUs = halMicros();
+    while (transferActive_)
+    {
+      display_.waitDMA();
+      advanceTransfers();
+    }
+    // ここからは転送が無いので通知側は何もしないが、写しと計画の間は念のため握っておく
+    lockTransfers();
+    uint32_t fenceEndUs = halMicros();
+    recordFrameTiming(renderEndUs, fenceEndUs);
+
+    // ── 描き終えた更新矩形を front へ写し、転送を始める ──
+    const DamageTracker &damage = canvas_.damage();
+    for (size_t i = 0; i < damage.count(); ++i)
+    {
+      copyRect(damage[i]);
+    }
+    planTransfers(damage);
+    uint32_t pushedBytes = 0;
+    for (size_t i = 0; i < transferCount_; ++i)
+    {
+      pushedBytes += static_cast<uint32_t>(transfers_[i].w) * transfers_[i].h * sizeof(Pixel);
+    }
+    nextTransfer_ = 0;
+    nextRow_ = 0;
+    transferStartUs_ = halMicros();
+    if (transferCount_ > 0)
+    {
+      // 転送の間だけバスを握る。DMA 転送それぞれの内側の endWrite() はこれで完了待ちをしなくなる
+      halHoldAwake(true);
+      display_.startWrite();
+      transferActive_ = true;
+      prepareChunk();
+    }
+    kickNextTransfer();
+    kicking_.store(false, std::memory_order_release);
+    canvas_.markPushed(pushedBytes);
+    stats_.transferBytes += pushedBytes;
+  }
+
+  // 送信中の転送をすべて送り切る（終了時やテストでの比較前に使う）
+  void finish()
+  {
+    while (transferActive_)
+    {
+      display_.waitDMA();
+      advanceTransfers();
+    }
+    display_.waitDMA();
+  }
+
+  auto stats() const -> const FramePipelineStats & { return stats_; }
+  auto lastFrame() const -> const FramePipelineStats & { return lastFrame_; }
+
+ private:
+  // 転送 1 回ぶんの固定の手間（ウィンドウ設定のコマンドと DMA の起動）をバイト数に換算した目安
+  static constexpr uint32_t TRANSFER_OVERHEAD_BYTES = 128;
+  // 完了予定時刻に DMA がまだ終わっていなかったときに確かめ直す間隔 [us]
+  static constexpr uint32_t TRANSFER_RECHECK_US = 50;
+
+  // front 上の送る範囲
+  struct Transfer
+  {
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+  };
+
+  // DMA 1 回分。source は w×h の連続領域（staging の半分か、staging が無ければ front の全幅の行）
+  struct Chunk
+  {
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+    const Pixel *source;
+  };
+
+  // 更新矩形を y 順に並べ、縦に重なる・接する組ごとに「矩形のまま送る」か「全幅の帯 1 本で送る」かを選ぶ
+  void planTransfers(const DamageTracker &damage)
+  {
+    DamageRect rects[DamageTracker::MAX_RECTS];
+    size_t count = 0;
+    for (size_t i = 0; i < damage.count(); ++i)
+    {
+      size_t pos = count++;
+      while (pos > 0 && rects[pos - 1].y > damage[i].y)
+      {
+        rects[pos] = rects[pos - 1];
+        --pos;
+      }
+      rects[pos] = damage[i];
+    }
+
+    transferCount_ = 0;
+    for (size_t first = 0; first < count;)
+    {
+      int top = rects[first].y;
+      int bottom = top + rects[first].h;
+      size_t last = first + 1;
+      while (last < count && rects[last].y <= bottom)
+      {
+        bottom = std::max(bottom, rects[last].y + rects[last].h);
+        ++last;
+      }
+
+      uint32_t rectBytes = 0;
+      bool allFullWidth = true;
+      for (size_t i = first; i < last; ++i)
+      {
+        rectBytes += rects[i].area() * sizeof(Pixel) + TRANSFER_OVERHEAD_BYTES;
+        allFullWidth = allFullWidth && isFullWidth(rects[i]);
+      }
+      uint32_t bandBytes = static_cast<uint32_t>(width_) * (bottom - top) * sizeof(Pixel) + TRANSFER_OVERHEAD_BYTES;
+      // staging が無ければ、front から直接送れる全幅の矩形しか矩形のまま送れない
+      if (rectBytes < bandBytes && (staging_ != nullptr || allFullWidth))
+      {
+        for (size_t i = first; i < last; ++i)
+        {
+          transfers_[transferCount_++] = {rects[i].x, rects[i].y, rects[i].w, rects[i].h};
+        }
+      }
+      else
+      {
+        transfers_[transferCount_++] = {0, static_cast<int16_t>(top), static_cast<int16_t>(width_),
+                                         static_cast<int16_t>(bottom - top)};
+      }
+      first = last;
+    }
+  }
+
+  auto isFullWidth(const DamageRect &rect) const -> bool { return rect.x == 0 && rect.w == width_; }
+
+  auto rowStart(Pixel *buffer, int row) const -> Pixel * { return buffer + static_cast<size_t>(row) * width_; }
+
+  // 次に送る行の束を chunk_ に用意する。staging があれば DMA が読んでいない方の半分へ front から詰める
+  void prepareChunk()
+  {
+    if (nextTransfer_ >= transferCount_)
+    {
+      chunkReady_ = false;
+      return;
+    }
+    const Transfer &transfer = transfers_[nextTransfer_];
+    int top = transfer.y + nextRow_;
+    int rows = transfer.h - nextRow_;
+    const Pixel *source = rowStart(front_, top);
+    if (staging_ != nullptr)
+    {
+      rows = std::min(rows, static_cast<int>(chunkPixels_ / transfer.w));
+      Pixel *packed = staging_ + chunkHalf_ * chunkPixels_;
+      chunkHalf_ ^= 1U;
+      for (int row = 0; row < rows; ++row)
+      {
+        std::memcpy(packed + static_cast<size_t>(row) * transfer.w, rowStart(front_, top + row) + transfer.x,
+                    transfer.w * sizeof(Pixel));
+      }
+      source = packed;
+    }
+    chunk_ = {transfer.x, static_cast<int16_t>(top), transfer.w, static_cast<int16_t>(rows), source};
+    chunkReady_ = true;
+    nextRow_ += rows;
+    if (nextRow_ >= transfer.h)
+    {
+      nextTransfer_++;
+      nextRow_ = 0;
+    }
+  }
+
+  void lockTransfers()
+  {
+    while (kicking_.exchange(true, std::memory_order_acquire))
+    {
+    }
+  }
+
+  // DMA が空いていれば次を積む。積めたか積む物が無ければ true、送信中か他方が積んでいる最中なら false
+  auto advanceTransfers() -> bool
+  {
+    if (kicking_.exchange(true, std::memory_order_acquire))
+    {
+      return false;
+    }
+    bool idle = !transferActive_ || !display_.dmaBusy();
+    if (idle)
+    {
+      kickNextTransfer();
+    }
+    kicking_.store(false, std::memory_order_release);
+    return idle;
+  }
+
+  // kicking_ を握った状態で、DMA が空いているときだけ呼ぶ
+  void kickNextTransfer()
+  {
+    if (!chunkReady_)
+    {
+      if (transferActive_)
+      {
+        // DMA は空いているので、ここでの endWrite() は待たない
+        transferEndUs_ = halMicros();
+        display_.endWrite();
+        halHoldAwake(false);
+        transferActive_ = false;
+      }
+      return;
+    }
+    display_.pushImageDMA(chunk_.x, chunk_.y, chunk_.w, chunk_.h, chunk_.source);
+    // 送り終える頃に次を積めるよう通知を予約し、送っている間にもう半分へ次の束を詰めておく
+    uint32_t bytes = static_cast<uint32_t>(chunk_.w) * chunk_.h * sizeof(Pixel);
+    halLcdNotifyAfterUs((bytes + LCD_DMA_BYTES_PER_US - 1) / LCD_DMA_BYTES_PER_US);
+    prepareChunk();
+  }
+
+  void copyRect(const DamageRect &rect)
+  {
+    for (int row = rect.y; row < rect.y + rect.h; ++row)
+    {
+      size_t offset = static_cast<size_t>(row) * width_ + rect.x;
+      std::memcpy(front_ + offset, back_ + offset, rect.w * sizeof(Pixel));
+    }
+  }
+
+  // 描画区間 [renderStart, renderEnd) と前フレームの転送区間 [transferStart, transferEnd) の重なりを計上する。
+  // 転送の完了時刻は完了通知（遅れたときは service() / フェンス）で最後の転送が空いたのを見た時点。
+  void recordFrameTiming(uint32_t renderEndUs, uint32_t fenceEndUs)
+  {
+    FramePipelineStats frame = {};
+    frame.frames = 1;
+    frame.renderUs = renderEndUs - renderStartUs_;
+    frame.fenceWaitUs = fenceEndUs - renderEndUs;
+    if (transferStartUs_ != transferEndUs_)
+    {
+      // uint32 の折り返しを考慮して renderStart からの相対時間で比べる
+      int64_t start = static_cast<int32_t>(transferStartUs_ - renderStartUs_);
+      int64_t end = static_cast<int32_t>(transferEndUs_ - renderStartUs_);
+      int64_t overlap = std::min<int64_t>(end, frame.renderUs) - std::max<int64_t>(start, 0);
+      frame.overlapUs = static_cast<uint64_t>(std::max<int64_t>(overlap, 0));
+    }
+    transferStartUs_ = transferEndUs_;
+
+    lastFrame_ = frame;
+    stats_.frames++;
+    stats_.renderUs += frame.renderUs;
+    stats_.overlapUs += frame.overlapUs;
+    stats_.fenceWaitUs += frame.fenceWaitUs;
+  }
+
+  Canvas &canvas_;
+  Display &display_;
+  Pixel *back_ = nullptr;
+  Pixel *front_ = nullptr;
+  int width_ = 0;
+  int height_ = 0;
+  bool active_ = false;
+
+  Pixel *staging_ = nullptr;
+  size_t chunkPixels_ = 0;  // staging の半分
+  uint32_t chunkHalf_ = 0;  // 次に詰める半分
+
+  Transfer transfers_[DamageTracker::MAX_RECTS] = {};
+  size_t transferCount_ = 0;
+  size_t nextTransfer_ = 0;
+  int nextRow_ = 0;  // nextTransfer_ のうち次に詰める行
+  Chunk chunk_ = {};
+  bool chunkReady_ = false;
+  std::atomic<bool> transferActive_{false};
+  std::atomic<bool> kicking_{false};
+
+  uint32_t renderStartUs_ = 0;
+  uint32_t transferStartUs_ = 0;
+  uint32_t transferEndUs_ = 0;
+  FramePipelineStats stats_ = {};
+  FramePipelineStats lastFrame_ = {};
+};
+
+#endif  // FRAME_PIPELINE_H
@@ -0,0 +1,35 @@
+#include "gauge_background.h"
+
+#include "config.h"
+#include "hal/hal.h"
+
+// ────────────────────── 背景画像 ──────────────────────
+static GaugePixel *backgroundImage = nullptr;
+
+auto beginGaugeBackground(void (*render)(GaugeCanvas &canvas)) -> bool
+{
+  size_t bytes = static_cast<size_t>(LCD_WIDTH) * LCD_HEIGHT * sizeof(GaugePixel);
+  backgroundImage = static_cast<GaugePixel *>(halAllocLargeBuffer(bytes));
+  if (backgroundImage == nullptr)
+  {
+    return false;
+  }
+
+  // LCD へは送らないので親ディスプレイ無しのキャンバスで描く
+  static GaugeCanvas backgroundCanvas(nullptr);
+  backgroundCanvas.setColorDepth(DISPLAY_COLOR_DEPTH);
+  backgroundCanvas.attachBuffer(backgroundImage, LCD_WIDTH, LCD_HEIGHT);
+  backgroundCanvas.fillScreen(COLOR_BLACK);
+  render(backgroundCanvas);
+  return true;
+}
+
+void restoreGaugeBackground(GaugeCanvas &canvas, int x, int y, int w, int h)
+{
+  if (backgroundImage == nullptr)
+  {
+    canvas.fillRect(x, y, w, h, COLOR_BLACK);
+    return;
+  }
+  canvas.restoreRect(backgroundImage, x, y, w, h);
+}
@@ -0,0 +1,17 @@
+#ifndef GAUGE_BACKGROUND_H
+#define GAUGE_BACKGROUND_H
+
+#include "hal/gauge_canvas.h"
+
+// ────────────────────── 静的背景レイヤー ──────────────────────
+// 目盛・目盛ラベル・レッドゾーン・単位表記など値で変わらない部分を、
+// 起動時に画面と同じ大きさの画像へ 1 度だけ描いておく。
+// 動的な描画は該当矩形をこの画像から復元してから値の部分だけを描く。
+
+// 背景画像を確保し、render で静的部分を描く。確保できなければ false
+auto beginGaugeBackground(void (*render)(GaugeCanvas &canvas)) -> bool;
+
+// 矩形を背景画像から復元する（背景が無ければ黒で塗る）
+void restoreGaugeBackground(GaugeCanvas &canvas, int x, int y, int w, int h);
+
+#endif  // GAUGE_BACKGROUND_H
@@ -0,0 +1,145 @@
+#include "gauge_benchmarks.h"
+
+#include <cstdio>
+
+#include "config.h"
+#include "digit_atlas.h"
+#include "display.h"
+#include "hal/hal.h"
+#include "sensor.h"
+#include "sensor_conversion.h"
+#include "signal_filters.h"
+#include "thermistor_lut.h"
+
+constexpr uint32_t CONVERSION_ITERATIONS = 20000;
+constexpr uint32_t DRAW_ITERATIONS = 500;
+// 計測に使うゲージ（配置表の添字）
+constexpr size_t PRESSURE_GAUGE = findGauge(GaugeKind::Arc, GaugeSource::OilPressure);
+constexpr size_t OIL_TOP_BAR = findGauge(GaugeKind::TopBar, GaugeSource::OilTemp);
+static_assert(PRESSURE_GAUGE < GAUGE_COUNT && OIL_TOP_BAR < GAUGE_COUNT, "benchmarked gauges must be in the layout");
+constexpr float PRESSURE_RED_ZONE_BAR = GAUGE_LAYOUT[PRESSURE_GAUGE].threshold;
+
+// ────────────────────── 換算・フィルタ ──────────────────────
+void runConversionBenchmarks(MicroBench &bench)
+{
+  bench.run("voltage_to_temp", CONVERSION_ITERATIONS,
+            [](uint32_t i) -> uint32_t
+            {
+              benchSink = static_cast<int32_t>(convertVoltageToTemp(0.2F + static_cast<float>(i & 1023) * 0.003F));
+              return 0;
+            });
+  bench.run("voltage_to_oil_pressure", CONVERSION_ITERATIONS,
+            [](uint32_t i) -> uint32_t
+            {
+              benchSink = static_cast<int32_t>(convertVoltageToOilPressure(0.5F + static_cast<float>(i & 1023) * 0.004F));
+              return 0;
+            });
+  bench.run("adc_to_pressure_q16", CONVERSION_ITERATIONS,
+            [](uint32_t i) -> uint32_t
+            {
+              benchSink = convertAdcToPressureQ16(static_cast<int16_t>(i & 2047));
+              return 0;
+            });
+  bench.run("adc_to_temp_lut", CONVERSION_ITERATIONS,
+            [](uint32_t i) -> uint32_t
+            {
+              benchSink = lookupTemperatureCenti(static_cast<int16_t>(i & 2047));
+              return 0;
+            });
+
+  float window[10] = {};
+  bench.run("calculate_average_10", CONVERSION_ITERATIONS,
+            [&](uint32_t i) -> uint32_t
+            {
+              window[i % 10] = static_cast<float>(i & 255);
+              benchSink = static_cast<int32_t>(calculateAverage(window));
+              return 0;
+            });
+
+  static ChannelFilter<OIL_PRESSURE_FILTER.window> pressureFilter(OIL_PRESSURE_FILTER, OIL_PRESSURE_SAMPLE_RATE_HZ);
+  bench.run("oil_pressure_filter", CONVERSION_ITERATIONS,
+            [](uint32_t i) -> uint32_t
+            {
+              benchSink = pressureFilter.update(convertAdcToPressureQ16(static_cast<int16_t>(400 + (i & 63))));
+              return 0;
+            });
+}
+
+// ────────────────────── 描画 ──────────────────────
+// 1 回の描画で更新領域に記録された画素数を返し、記録は転送せずに捨てる
+static auto takeDamagePixels(GaugeCanvas &canvas) -> uint32_t
+{
+  uint32_t pixels = canvas.damage().area();
+  canvas.discardDamage();
+  return pixels;
+}
+
+void runGaugeBenchmarks(MicroBench &bench, GaugeCanvas &canvas)
+{
+  canvas.discardDamage();
+
+  // 油圧メーター。前回値は計測項目ごとに持ち越す
+  GaugeDrawState pressureState;
+  auto drawPressure = [&](float value) -> uint32_t
+  {
+    drawGaugeValue(canvas, PRESSURE_GAUGE, value, 0.0F, pressureState);
+    return takeDamagePixels(canvas);
+  };
+  // 0 と最大値を往復する（毎回レッドゾーンもまたぐ）
+  bench.run("arc_full_sweep", DRAW_ITERATIONS,
+            [&](uint32_t i) { return drawPressure((i & 1) ? MAX_OIL_PRESSURE_METER : 0.0F); });
+  // 表示の更新しきい値ちょうどの小さな変化
+  bench.run("arc_small_delta", DRAW_ITERATIONS, [&](uint32_t i) { return drawPressure((i & 1) ? 3.05F : 3.0F); });
+  // レッドゾーンの境界を行き来する（バー全体の塗り替えが起きる）
+  bench.run("arc_redzone_cross", DRAW_ITERATIONS,
+            [&](uint32_t i) { return drawPressure(PRESSURE_RED_ZONE_BAR + ((i & 1) ? 0.1F : -0.1F)); });
+
+  // 油温バー。前回描いた幅と数値は計測項目ごとに持ち越す
+  GaugeDrawState topBarState;
+  auto drawTopBar = [&](float oilTemp, int maxOilTemp) -> uint32_t
+  {
+    drawGaugeValue(canvas, OIL_TOP_BAR, oilTemp, static_cast<float>(maxOilTemp), topBarState);
+    return takeDamagePixels(canvas);
+  };
+  bench.run("top_bar_small_delta", DRAW_ITERATIONS,
+            [&](uint32_t i) { return drawTopBar((i & 1) ? 100.5F : 100.0F, 110); });
+  bench.run("top_bar_alert_cross", DRAW_ITERATIONS,
+            [&](uint32_t i) { return drawTopBar((i & 1) ? 121.0F : 119.0F, 121); });
+  bench.run("top_bar_full_sweep", DRAW_ITERATIONS,
+            [&](uint32_t i) { return drawTopBar((i & 1) ? 130.0F : 80.0F, 130); });
+
+  // 大きな数値 1 つ分。printf と GFX フォントで描く従来の経路と、整数整形とアトラスの経路を比べる
+  constexpr int VALUE_RIGHT = LCD_WIDTH - 1;
+  constexpr int VALUE_TOP = 2;
+  auto valueFor = [](uint32_t i) { return 2.0F + static_cast<float>(i % 80) * 0.1F; };
+  bench.run("value_text_font", DRAW_ITERATIONS,
+            [&](uint32_t i) -> uint32_t
+            {
+              char text[16];
+              snprintf(text, sizeof(text), "%.1f", valueFor(i));
+              canvas.setFont(&FreeSansBold24pt7b);
+              canvas.setTextColor(COLOR_WHITE);
+              canvas.drawRightString(text, VALUE_RIGHT, VALUE_TOP);
+              return takeDamagePixels(canvas);
+            });
+  bench.run("value_text_atlas", DRAW_ITERATIONS,
+            [&](uint32_t i) -> uint32_t
+            {
+              char text[DECIMAL_TEXT_SIZE];
+              size_t length = formatDecimal(scaleToDecimal(valueFor(i), 1), 1, text);
+              drawValueText(canvas, text, length, VALUE_RIGHT, VALUE_TOP, COLOR_WHITE);
+              return takeDamagePixels(canvas);
+            });
+}
+
+// ────────────────────── 一括実行 ──────────────────────
+void runAllBenchmarks()
+{
+  static MicroBench bench;
+  static char json[2048];
+  bench.reset();
+  runConversionBenchmarks(bench);
+  runDisplayBenchmarks(bench);
+  bench.writeJson(json, sizeof(json));
+  halLogf("%s", json);
+}
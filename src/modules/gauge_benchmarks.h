@@ -0,0 +1,16 @@
+#ifndef GAUGE_BENCHMARKS_H
+#define GAUGE_BENCHMARKS_H
+
+#include "hal/gauge_canvas.h"
+#include "microbench.h"
+
+// ────────────────────── 描画・換算の計測項目 ──────────────────────
+// 換算とフィルタ（1 サンプルあたり）
+void runConversionBenchmarks(MicroBench &bench);
+// 円弧メーターと油温バーの描画。canvas は背景レイヤーを初期化済みのもの。
+// 描いた範囲は転送せずに捨てるので、呼び出し後は画面全体を描き直すこと
+void runGaugeBenchmarks(MicroBench &bench, GaugeCanvas &canvas);
+// 全項目を回して結果の JSON を halLogf で出す。描画系は画面用キャンバスで測る
+void runAllBenchmarks();
+
+#endif  // GAUGE_BENCHMARKS_H
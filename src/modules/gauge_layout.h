@@ -0,0 +1,188 @@
+#ifndef GAUGE_LAYOUT_H
+#define GAUGE_LAYOUT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "sensor_conversion.h"
+#include "stage_timing.h"
+
+// ────────────────────── ゲージ配置表 ──────────────────────
+// 画面上のゲージを 1 行 1 つの定数表で宣言する。描画側は表の添字をテンプレート引数にして
+// ゲージごとに展開するので、範囲・しきい値・位置・エラー表示の選び方はすべてコンパイル時に決まる。
+// ゲージを増やすときは GaugeSource に出どころを足し、表に 1 行足すだけでよい
+// （ADC チャンネルからの値の取り出し・背景・差分描画・計測・統計は表から作られる）。
+
+enum class GaugeKind : uint8_t
+{
+  TopBar,  // 画面上部の横バー（右上に現在値、キャプションの後ろに最高値）
+  Arc      // 270° の円弧メーター（右下に現在値）
+};
+
+// 表示する値の出どころ。updateGauges() がこの順に並べて渡す
+enum class GaugeSource : uint8_t
+{
+  OilPressure,  // [bar]
+  WaterTemp,    // [℃]
+  OilTemp,      // [℃]
+  Count
+};
+
+constexpr size_t GAUGE_SOURCE_COUNT = static_cast<size_t>(GaugeSource::Count);
+
+// errorAbove 以上の値を数値の代わりに出す 2 行のエラー表示
+enum class GaugeError : uint8_t
+{
+  None,
+  ShortCircuit,  // "Short circuit" / "Error"
+  Disconnection  // "Disconnection" / "Error"
+};
+
+struct GaugeRegion
+{
+  int x;
+  int y;
+  int w;
+  int h;
+};
+
+// 取得タスクの整数値（油圧は Q16 mbar、温度は 0.01℃）を表示単位へ換算する
+using GaugeConverter = float (*)(int32_t value);
+
+// 出どころの値をどの ADC チャンネルから読み、どう換算するか
+struct GaugeInput
+{
+  uint8_t adcChannel;
+  bool present;  // センサーが無ければ常に 0 を表示する
+  GaugeConverter toDisplay;
+};
+
+// 油圧は表示上限で頭打ちにする（上限を超える値はどのみち短絡のエラー表示になる）
+inline auto pressureQ16ToGaugeBar(int32_t pressureQ16) -> float
+{
+  constexpr int32_t MAX_PRESSURE_Q16 = static_cast<int32_t>(MAX_OIL_PRESSURE_DISPLAY * 1000.0F) * PRESSURE_Q16_PER_MBAR;
+  return pressureQ16ToBar((pressureQ16 < MAX_PRESSURE_Q16) ? pressureQ16 : MAX_PRESSURE_Q16);
+}
+
+struct GaugeSpec
+{
+  GaugeKind kind;
+  GaugeSource source;
+  GaugeInput input;
+  const char *label;
+  const char *unit;
+  float minValue;
+  float maxValue;
+  float threshold;      // レッドゾーン（バーは警告色）の開始値
+  uint16_t alertColor;  // threshold 以上のバーの色
+  float tickStep;       // 細かい目盛の間隔
+  float majorTickStep;  // 数字を出す目盛の間隔（負なら整数の目盛すべて）
+  float labelStart;     // 数字を出し始める値
+  float redrawDelta;    // 前回描画からこれ以上変わったら描き直す
+  float decimalBelow;   // この値未満は小数 1 桁で出す（0 なら常に整数）
+  GaugeError error;
+  float errorAbove;
+  GaugeRegion region;
+  TimingStage stage;
+};
+
+inline constexpr GaugeSpec GAUGE_LAYOUT[] = {
+    {GaugeKind::TopBar, GaugeSource::OilTemp, {ADC_CH_OIL_TEMP, SENSOR_OIL_TEMP_PRESENT, centiToCelsius}, "OIL.T",
+     "Celsius", 80.0F, 130.0F, 120.0F, COLOR_RED, 10.0F, 10.0F, 80.0F, 0.1F, 0.0F, GaugeError::Disconnection, 199.0F,
+     {20, 15, 210, 20}, TimingStage::OilTopBar},
+    {GaugeKind::Arc, GaugeSource::OilPressure, {ADC_CH_OIL_PRESSURE, SENSOR_OIL_PRESSURE_PRESENT, pressureQ16ToGaugeBar},
+     "OIL.P", "x100kPa", 0.0F, MAX_OIL_PRESSURE_METER, 8.0F, COLOR_RED, 0.5F, -1.0F, 0.0F, 0.05F, 9.95F,
+     GaugeError::ShortCircuit, 11.0F, {0, 60, 160, 170}, TimingStage::PressureGauge},
+    {GaugeKind::Arc, GaugeSource::WaterTemp, {ADC_CH_WATER_TEMP, SENSOR_WATER_TEMP_PRESENT, centiToCelsius}, "WATER.T",
+     "Celsius", WATER_TEMP_METER_MIN, WATER_TEMP_METER_MAX, 98.0F, COLOR_RED, 1.0F, 5.0F, WATER_TEMP_METER_MIN, 0.1F,
+     0.0F, GaugeError::Disconnection, 199.0F, {160, 60, 160, 170}, TimingStage::WaterGauge},
+};
+
+constexpr size_t GAUGE_COUNT = sizeof(GAUGE_LAYOUT) / sizeof(GAUGE_LAYOUT[0]);
+
+// 指定した種類・出どころの最初のゲージの添字（無ければ GAUGE_COUNT）
+constexpr auto findGauge(GaugeKind kind, GaugeSource source) -> size_t
+{
+  for (size_t i = 0; i < GAUGE_COUNT; ++i)
+  {
+    if (GAUGE_LAYOUT[i].kind == kind && GAUGE_LAYOUT[i].source == source) return i;
+  }
+  return GAUGE_COUNT;
+}
+
+// 出どころを表示する最初のゲージの添字（無ければ GAUGE_COUNT）
+constexpr auto findGaugeForSource(GaugeSource source) -> size_t
+{
+  for (size_t i = 0; i < GAUGE_COUNT; ++i)
+  {
+    if (GAUGE_LAYOUT[i].source == source) return i;
+  }
+  return GAUGE_COUNT;
+}
+
+// 出どころはどれも表に行を持ち、同じ ADC チャンネルを 2 つの出どころが取り合わないこと
+constexpr auto gaugeSourcesAreMapped() -> bool
+{
+  for (size_t i = 0; i < GAUGE_COUNT; ++i)
+  {
+    const GaugeSpec &first = GAUGE_LAYOUT[findGaugeForSource(GAUGE_LAYOUT[i].source)];
+    if (first.input.adcChannel != GAUGE_LAYOUT[i].input.adcChannel) return false;
+    for (size_t j = 0; j < GAUGE_COUNT; ++j)
+    {
+      if (GAUGE_LAYOUT[j].input.adcChannel == first.input.adcChannel && GAUGE_LAYOUT[j].source != first.source)
+      {
+        return false;
+      }
+    }
+  }
+  for (size_t s = 0; s < GAUGE_SOURCE_COUNT; ++s)
+  {
+    if (findGaugeForSource(static_cast<GaugeSource>(s)) == GAUGE_COUNT) return false;
+  }
+  return true;
+}
+static_assert(gaugeSourcesAreMapped(), "every GaugeSource needs a GAUGE_LAYOUT row with its own ADC channel");
+
+// 出どころを表示する最初のゲージの設定（入力・レッドゾーン・エラーの判定に使う）
+constexpr auto gaugeSpecFor(GaugeSource source) -> const GaugeSpec &
+{
+  return GAUGE_LAYOUT[findGaugeForSource(source)];
+}
+
+// ADC チャンネルを表示する出どころ（どのゲージにも使われないチャンネルなら GaugeSource::Count）
+constexpr auto gaugeSourceForChannel(uint8_t adcChannel) -> GaugeSource
+{
+  for (size_t i = 0; i < GAUGE_COUNT; ++i)
+  {
+    if (GAUGE_LAYOUT[i].input.adcChannel == adcChannel) return GAUGE_LAYOUT[i].source;
+  }
+  return GaugeSource::Count;
+}
+
+// 取得タスクの整数値を表示単位へ（センサーが無ければ 0）
+inline auto gaugeInputValue(const GaugeInput &input, int32_t value) -> float
+{
+  return input.present ? input.toDisplay(value) : 0.0F;
+}
+
+// 値が数値の代わりにエラー表示になるか
+constexpr auto isGaugeErrorValue(const GaugeSpec &spec, float value) -> bool
+{
+  return spec.error != GaugeError::None && value >= spec.errorAbove;
+}
+
+// エラー表示の 1 行目（2 行目は常に "Error"）
+constexpr auto gaugeErrorText(GaugeError error) -> const char *
+{
+  return (error == GaugeError::ShortCircuit) ? "Short circuit" : "Disconnection";
+}
+
+// 描画 1 回分の入力。出どころごとの現在値と最高値
+struct GaugeValues
+{
+  float current[GAUGE_SOURCE_COUNT];
+  float peak[GAUGE_SOURCE_COUNT];
+};
+
+#endif  // GAUGE_LAYOUT_H
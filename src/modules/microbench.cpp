@@ -0,0 +1,45 @@
+#include "microbench.h"
+
+#include <cstdio>
+#include <cstring>
+
+volatile int32_t benchSink = 0;
+
+auto MicroBench::find(const char *name) const -> const BenchResult *
+{
+  for (size_t i = 0; i < count_; ++i)
+  {
+    if (std::strcmp(results_[i].name, name) == 0) return &results_[i];
+  }
+  return nullptr;
+}
+
+// ────────────────────── JSON 出力 ──────────────────────
+auto MicroBench::writeJson(char *out, size_t size) const -> size_t
+{
+  size_t length = 0;
+  // 収まらない分は数えるだけにして、必要な長さを返す
+  auto append = [&](const char *format, auto... args)
+  {
+    char *cursor = (length < size) ? out + length : nullptr;
+    size_t room = (length < size) ? size - length : 0;
+    int written = std::snprintf(cursor, room, format, args...);
+    if (written > 0) length += static_cast<size_t>(written);
+  };
+
+  append("{\"target\":\"%s\",\"results\":[", HAL_TICKS_ARE_CYCLES ? "device" : "host");
+  for (size_t i = 0; i < count_; ++i)
+  {
+    const BenchResult &r = results_[i];
+    // 1 項目 1 行にして、コミット間の差分を行単位で見られるようにする
+    append("%s\n{\"name\":\"%s\",\"iterations\":%lu,\"ns\":%.1f", (i == 0) ? "" : ",", r.name,
+           static_cast<unsigned long>(r.iterations), r.nsPerOp);
+    if (HAL_TICKS_ARE_CYCLES)
+    {
+      append(",\"cycles\":%.0f", r.cyclesPerOp);
+    }
+    append(",\"pixels\":%.0f}", r.pixelsPerOp);
+  }
+  append("\n]}\n");
+  return length;
+}
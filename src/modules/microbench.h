@@ -0,0 +1,74 @@
+#ifndef MICROBENCH_H
+#define MICROBENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hal/hal.h"
+
+// ────────────────────── マイクロベンチマーク ──────────────────────
+// 本体を iterations 回まわす計測を ROUNDS 回行い、最も速かった回の 1 回あたりの時間を採る。
+// 時間は halTicks() で測るので、実機では CPU サイクルも併せて残る。
+// 本体は描画で触れた画素数（描画以外は 0）を返し、その平均も結果に含める。
+// 結果は JSON にまとめて出力し、コミット間で比べられるようにする。
+
+struct BenchResult
+{
+  const char *name;
+  uint32_t iterations;
+  double nsPerOp;
+  double cyclesPerOp;  // 実機のみ（ホストは 0）
+  double pixelsPerOp;
+};
+
+class MicroBench
+{
+ public:
+  static constexpr size_t MAX_RESULTS = 24;
+  static constexpr int ROUNDS = 5;
+
+  template <typename F>
+  auto run(const char *name, uint32_t iterations, F body) -> const BenchResult &
+  {
+    HalTicks best = 0;
+    uint64_t pixels = 0;
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+      uint64_t roundPixels = 0;
+      HalTicks start = halTicks();
+      for (uint32_t i = 0; i < iterations; ++i)
+      {
+        roundPixels += body(i);
+      }
+      HalTicks elapsed = halTicks() - start;
+      if (round == 0 || elapsed < best) best = elapsed;
+      pixels = roundPixels;
+    }
+
+    BenchResult &result = (count_ < MAX_RESULTS) ? results_[count_++] : results_[MAX_RESULTS - 1];
+    result.name = name;
+    result.iterations = iterations;
+    result.nsPerOp = halTicksToNs(best) / iterations;
+    result.cyclesPerOp = HAL_TICKS_ARE_CYCLES ? static_cast<double>(best) / iterations : 0.0;
+    result.pixelsPerOp = static_cast<double>(pixels) / iterations;
+    return result;
+  }
+
+  void reset() { count_ = 0; }
+  auto count() const -> size_t { return count_; }
+  auto operator[](size_t index) const -> const BenchResult & { return results_[index]; }
+  auto find(const char *name) const -> const BenchResult *;
+
+  // {"target":..., "results":[{"name":..., "iterations":..., "ns":..., "cycles":..., "pixels":...}, ...]}
+  // を out に書き、必要な長さを返す（snprintf と同じく収まらなければ切り詰める）
+  auto writeJson(char *out, size_t size) const -> size_t;
+
+ private:
+  BenchResult results_[MAX_RESULTS] = {};
+  size_t count_ = 0;
+};
+
+// 最適化で計算が消えないよう、結果をここへ書き込む
+extern volatile int32_t benchSink;
+
+#endif  // MICROBENCH_H
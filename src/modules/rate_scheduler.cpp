@@ -0,0 +1,107 @@
+#include "rate_scheduler.h"
+
+#include "hal/hal.h"
+
+// uint32 の折り返しを考慮した「a は b より前か」
+static auto before(uint32_t a, uint32_t b) -> bool { return static_cast<int32_t>(a - b) < 0; }
+
+// ────────────────────── 登録 ──────────────────────
+auto RateScheduler::addTask(const char *name, uint32_t periodUs, ScheduledTaskFn run, uint32_t firstDeadlineUs) -> int
+{
+  if (taskCount_ >= MAX_TASKS || periodUs == 0 || run == nullptr)
+  {
+    return -1;
+  }
+  tasks_[taskCount_] = {name, periodUs, run, firstDeadlineUs, {}};
+  return static_cast<int>(taskCount_++);
+}
+
+void RateScheduler::resetStats()
+{
+  for (size_t i = 0; i < taskCount_; ++i)
+  {
+    tasks_[i].stats = {};
+  }
+}
+
+// ────────────────────── 実行 ──────────────────────
+auto RateScheduler::earliestDue(uint32_t nowUs, uint32_t doneMask) const -> int
+{
+  int earliest = -1;
+  for (size_t i = 0; i < taskCount_; ++i)
+  {
+    if ((doneMask & (1U << i)) != 0 || before(nowUs, tasks_[i].deadlineUs))
+    {
+      continue;
+    }
+    if (earliest < 0 || before(tasks_[i].deadlineUs, tasks_[earliest].deadlineUs))
+    {
+      earliest = static_cast<int>(i);
+    }
+  }
+  return earliest;
+}
+
+auto RateScheduler::runDue() -> size_t
+{
+  size_t executed = 0;
+  uint32_t doneMask = 0;
+  for (;;)
+  {
+    // 前のタスクの実行で時間が進むので、毎回時刻を取り直して遅れを測る
+    uint32_t startUs = halMicros();
+    int index = earliestDue(startUs, doneMask);
+    if (index < 0)
+    {
+      break;
+    }
+    Task &task = tasks_[index];
+    doneMask |= 1U << index;
+
+    // 飛ばした周期を除き、実際に実行する周期の締め切りからの遅れを揺らぎとする
+    uint32_t skipped = (startUs - task.deadlineUs) / task.periodUs;
+    task.deadlineUs += skipped * task.periodUs;
+    uint32_t lateUs = startUs - task.deadlineUs;
+    task.deadlineUs += task.periodUs;
+
+    task.run();
+    uint32_t runUs = halMicros() - startUs;
+
+    ScheduledTaskStats &stats = task.stats;
+    stats.runs++;
+    stats.misses += skipped;
+    stats.totalJitterUs += lateUs;
+    if (lateUs > stats.maxJitterUs) stats.maxJitterUs = lateUs;
+    if (runUs > stats.maxRunUs) stats.maxRunUs = runUs;
+    executed++;
+  }
+  return executed;
+}
+
+auto RateScheduler::untilNextDeadlineUs(uint32_t nowUs) const -> uint32_t
+{
+  if (taskCount_ == 0)
+  {
+    return UINT32_MAX;
+  }
+  uint32_t next = tasks_[0].deadlineUs;
+  for (size_t i = 1; i < taskCount_; ++i)
+  {
+    if (before(tasks_[i].deadlineUs, next)) next = tasks_[i].deadlineUs;
+  }
+  return before(nowUs, next) ? next - nowUs : 0;
+}
+
+// ────────────────────── 統計出力 ──────────────────────
+void RateScheduler::dump() const
+{
+  halLogf("task       period_us     runs  misses  jit_avg  jit_max  run_max\n");
+  for (size_t i = 0; i < taskCount_; ++i)
+  {
+    const Task &task = tasks_[i];
+    halLogf("%-10s %9lu %8lu %7lu %8lu %8lu %8lu\n", task.name, static_cast<unsigned long>(task.periodUs),
+            static_cast<unsigned long>(task.stats.runs), static_cast<unsigned long>(task.stats.misses),
+            static_cast<unsigned long>(task.stats.meanJitterUs()), static_cast<unsigned long>(task.stats.maxJitterUs),
+            static_cast<unsigned long>(task.stats.maxRunUs));
+  }
+}
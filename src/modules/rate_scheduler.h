@@ -0,0 +1,66 @@
+#ifndef RATE_SCHEDULER_H
+#define RATE_SCHEDULER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ────────────────────── 周期タスクのスケジューラ ──────────────────────
+// 宣言した周期ごとの締め切りを持ち、runDue() で締め切りの早い順に実行する協調型スケジューラ。
+// 締め切りは「前回の締め切り＋周期」で進めるので、実行が遅れても周期はずれない。
+// 1 周期以上遅れた場合は飛ばした回数を取りこぼしとして数え、次の締め切りを現在以降に揃える。
+// 時刻は halMicros() から取るため、ホストでは仮想時計でそのまま動く。
+
+using ScheduledTaskFn = void (*)();
+
+struct ScheduledTaskStats
+{
+  uint32_t runs;
+  uint32_t misses;       // 実行できずに飛ばした周期の数
+  uint32_t maxJitterUs;  // 実行した周期の締め切りから実行開始までの遅れの最大
+  uint64_t totalJitterUs;
+  uint32_t maxRunUs;  // 1 回の実行時間の最大
+
+  auto meanJitterUs() const -> uint32_t { return (runs == 0) ? 0 : static_cast<uint32_t>(totalJitterUs / runs); }
+};
+
+class RateScheduler
+{
+ public:
+  static constexpr size_t MAX_TASKS = 8;
+
+  // 最初の締め切りは firstDeadlineUs。登録できなければ -1 を返す
+  auto addTask(const char *name, uint32_t periodUs, ScheduledTaskFn run, uint32_t firstDeadlineUs) -> int;
+
+  // 締め切りを過ぎたタスクを早い順に実行し、実行した数を返す。
+  // 1 回の呼び出しで同じタスクは 1 度しか実行しない
+  auto runDue() -> size_t;
+
+  // 次の締め切りまでの時間 [us]（過ぎていれば 0）
+  auto untilNextDeadlineUs(uint32_t nowUs) const -> uint32_t;
+
+  auto taskCount() const -> size_t { return taskCount_; }
+  auto taskName(size_t index) const -> const char * { return tasks_[index].name; }
+  auto taskPeriodUs(size_t index) const -> uint32_t { return tasks_[index].periodUs; }
+  auto stats(size_t index) const -> const ScheduledTaskStats & { return tasks_[index].stats; }
+  void resetStats();
+  // タスクごとの実行回数・取りこぼし・遅れを halLogf で出力する
+  void dump() const;
+
+ private:
+  struct Task
+  {
+    const char *name;
+    uint32_t periodUs;
+    ScheduledTaskFn run;
+    uint32_t deadlineUs;
+    ScheduledTaskStats stats;
+  };
+
+  // 締め切りを過ぎていて、まだ今回実行していないタスクのうち最も早いもの
+  auto earliestDue(uint32_t nowUs, uint32_t doneMask) const -> int;
+
+  Task tasks_[MAX_TASKS] = {};
+  size_t taskCount_ = 0;
+};
+
+#endif  // RATE_SCHEDULER_H
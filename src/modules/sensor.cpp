@@ -1,114 +1,114 @@
 #include "sensor.h"
 
-#include <Wire.h>
-
 #include <algorithm>
 #include <cmath>
 #include <numeric>
 
+#ifdef ARDUINO
+#include <esp_timer.h>
+#endif
+
+#include "ads_acquisition.h"
+#include "burst_capture.h"
+#include "hal/hal.h"
+#include "hal/hal_ads.h"
+#include "sensor_conversion.h"
+#include "session_log.h"
+#include "session_stats.h"
+#include "signal_filters.h"
+#include "stage_timing.h"
+#include "telemetry.h"
+#include "thermistor_lut.h"
+
 // ────────────────────── グローバル変数 ──────────────────────
-Adafruit_ADS1015 adsConverter;
-
-float oilPressureSamples[PRESSURE_SAMPLE_SIZE] = {};
-float waterTemperatureSamples[WATER_TEMP_SAMPLE_SIZE] = {};
-float oilTemperatureSamples[OIL_TEMP_SAMPLE_SIZE] = {};
-static int oilPressureIndex = 0;
-static int waterTempIndex = 0;
-static int oilTempIndex = 0;
-
-// 最初の水温・油温取得かどうかのフラグ
-static bool isFirstWaterTempSample = true;
-static bool isFirstOilTempSample = true;
-
-// ADC セトリング待ち時間 [us]
-constexpr uint16_t ADC_SETTLING_US = 50;
-
-// 温度サンプリング間隔 [ms]
-// 500msごとに取得し、10サンプルで約5秒平均となる
-constexpr uint16_t TEMP_SAMPLE_INTERVAL_MS = 500;
-constexpr float SUPPLY_VOLTAGE = 5.0f;
-// 電圧降下は config で設定
-constexpr float CORRECTION_FACTOR = SUPPLY_VOLTAGE / (SUPPLY_VOLTAGE - VOLTAGE_DROP);
-constexpr float THERMISTOR_R25 = 10000.0f;
-constexpr float THERMISTOR_B_CONSTANT = 3380.0f;
-constexpr float ABSOLUTE_TEMPERATURE_25 = 298.16f;  // 273.16 + 25
-constexpr float SERIES_REFERENCE_RES = 10000.0f;
-
-// ────────────────────── ユーティリティ ──────────────────────
-static auto convertAdcToVoltage(int16_t rawAdc) -> float { return (rawAdc * 6.144F) / 2047.0F; }
-
-static auto convertVoltageToOilPressure(float voltage) -> float
-{
-  voltage *= CORRECTION_FACTOR;
-  // 電源電圧近くまで上昇してもそのまま変換し、
-  // 12bar 以上かどうかは呼び出し側で判断する
+static AdsAcquisition adsAcquisition(halAdsBus());
 
-  // センサー実測式に基づき圧力へ変換
-  return (voltage > 0.5F) ? 2.5F * (voltage - 0.5F) : 0.0F;
-}
+// センサタスク（コア0）→描画ループ（コア1）の受け渡しリング
+SpscRing<SensorSample, SENSOR_RING_CAPACITY> sensorSampleRing;
+#ifdef ARDUINO
+static TaskHandle_t sensorTaskHandle = nullptr;
+// ALERT/RDY の割り込みか、次に状態が進む時刻の esp_timer で取得タスクを起こす
+static SemaphoreHandle_t sensorWake = nullptr;
+static esp_timer_handle_t sensorWakeTimer = nullptr;
+#endif
+
+// チャンネルごとのフィルタ。取得タスクだけが更新する。
+// 温度の断線の印は平滑化せずに通し、記録や表示がエラーとして扱えるようにする
+static ChannelFilter<OIL_PRESSURE_FILTER.window> oilPressureFilter(OIL_PRESSURE_FILTER, OIL_PRESSURE_SAMPLE_RATE_HZ);
+static ChannelFilter<WATER_TEMP_FILTER.window> waterTempFilter(WATER_TEMP_FILTER, TEMP_SAMPLE_RATE_HZ,
+                                                               THERMISTOR_DISCONNECT_CENTI);
+static ChannelFilter<OIL_TEMP_FILTER.window> oilTempFilter(OIL_TEMP_FILTER, TEMP_SAMPLE_RATE_HZ,
+                                                           THERMISTOR_DISCONNECT_CENTI);
+
+// 描画側だけが drainSensorSamples() で更新する
+SensorReadings sensorReadings = {};
 
-static auto convertVoltageToTemp(float voltage) -> float
+// デモモードでサンプルを生成する間隔 [ms]
+constexpr uint16_t DEMO_SAMPLE_INTERVAL_MS = 16;
+static unsigned long lastDemoSampleMs = 0;
+// 取得タスクが眠る最短時間 [us]。変換が予定より遅れたときに I2C を回し続けないための下限
+constexpr uint32_t SENSOR_TASK_MIN_WAIT_US = ADS1015_MUX_SETTLE_US;
+
+// ────────────────────── ADC 初期化 ──────────────────────
+auto beginSensorAcquisition() -> bool
 {
-  voltage *= CORRECTION_FACTOR;
-  // 電源電圧より高い/等しい電圧は異常値として捨てる
-  if (voltage <= 0.0F || voltage >= SUPPLY_VOLTAGE)
+  if (!halAdsBegin())
   {
-    return 200.0F;
+    return false;
   }
 
-  // 分圧式よりサーミスタ抵抗値を算出
-  // R = Rref * (V / (Vcc - V))  (サーミスタがGND側の場合)
-  float resistance = SERIES_REFERENCE_RES * (voltage / (SUPPLY_VOLTAGE - voltage));
-
-  // Steinhart–Hart の簡易形 (β式)
-  float kelvin =
-      THERMISTOR_B_CONSTANT / (log(resistance / THERMISTOR_R25) + THERMISTOR_B_CONSTANT / ABSOLUTE_TEMPERATURE_25);
-
-  return std::isnan(kelvin) ? 200.0F : kelvin - 273.16F;
+  // 油圧を主チャンネルとして締め切りどおりに変換し、温度は油圧の隙間で MUX を整定させてから取得する。
+  // 温度の分圧抵抗は高インピーダンスなので、温度から油圧へ戻すときも整定させる
+  constexpr uint32_t PRESSURE_INTERVAL_US = 1000000UL / OIL_PRESSURE_SAMPLE_RATE_HZ;
+  constexpr uint32_t TEMP_INTERVAL_US = 1000000UL / TEMP_SAMPLE_RATE_HZ;
+  if (SENSOR_OIL_PRESSURE_PRESENT)
+  {
+    adsAcquisition.addChannel(ADC_CH_OIL_PRESSURE, PRESSURE_INTERVAL_US, false);
+  }
+  if (SENSOR_WATER_TEMP_PRESENT)
+  {
+    adsAcquisition.addChannel(ADC_CH_WATER_TEMP, TEMP_INTERVAL_US, true);
+  }
+  if (SENSOR_OIL_TEMP_PRESENT)
+  {
+    adsAcquisition.addChannel(ADC_CH_OIL_TEMP, TEMP_INTERVAL_US, true);
+  }
+  return adsAcquisition.begin(ADC_SCAN_PRIMARY_RUN);
 }
 
-// ────────────────────── ADC 読み取り ──────────────────────
-static auto readAdcWithSettling(uint8_t ch) -> int16_t
-{
-  adsConverter.readADC_SingleEnded(ch);  // ダミー変換
-  delayMicroseconds(ADC_SETTLING_US);    // セトリング待ち
-  return adsConverter.readADC_SingleEnded(ch);
-}
+auto sensorAcquisition() -> const AdsAcquisition & { return adsAcquisition; }
 
-// ────────────────────── 温度読み取り ──────────────────────
-// 指定チャンネルから温度を取得して摂氏に変換
-static auto readTemperatureChannel(uint8_t ch) -> float
+void dumpAcquisitionRates()
 {
-  int16_t raw = readAdcWithSettling(ch);
-  return convertVoltageToTemp(convertAdcToVoltage(raw));
+  halLogf("ADC sps P:%.1f W:%.1f O:%.1f (P min %.1f) miss:%lu err:%lu\n",
+          adsAcquisition.samplesPerSecond(ADC_CH_OIL_PRESSURE), adsAcquisition.samplesPerSecond(ADC_CH_WATER_TEMP),
+          adsAcquisition.samplesPerSecond(ADC_CH_OIL_TEMP), adsAcquisition.guaranteedPrimarySps(),
+          static_cast<unsigned long>(adsAcquisition.primaryMissCount()),
+          static_cast<unsigned long>(adsAcquisition.busErrorCount()));
 }
 
-// ────────────────────── サンプルバッファ更新 ──────────────────────
-// 初回は全要素を同じ値で埋め、その後はリングバッファ更新
-template <size_t N>
-static void updateSampleBuffer(float value, float (&buffer)[N], int &index, bool &first)
+// ────────────────────── フィルタ ──────────────────────
+// フィルタ前の値で走行統計を更新し、油圧はバーストキャプチャにも渡す
+static auto filterSample(uint8_t channel, int32_t value, uint32_t timestampUs, int16_t raw) -> int32_t
 {
-  if (first)
+  if (SESSION_STATS_ENABLED)
   {
-    for (float &v : buffer)
-    {
-      v = value;
-    }
-    index = 1 % N;  // 初期化後は 1 番目から開始
-    first = false;
+    sessionStats().addSensorSample(channel, value);
   }
-  else
+  if (BURST_CAPTURE_ENABLED && channel == ADC_CH_OIL_PRESSURE)
   {
-    buffer[index] = value;
-    index = (index + 1) % N;
+    burstCapture().record(timestampUs, raw, value);
   }
+  if (channel == ADC_CH_OIL_PRESSURE) return oilPressureFilter.update(value);
+  if (channel == ADC_CH_WATER_TEMP) return waterTempFilter.update(value);
+  if (channel == ADC_CH_OIL_TEMP) return oilTempFilter.update(value);
+  return value;
 }
 
 // ────────────────────── センサ取得 ──────────────────────
 void acquireSensorData()
 {
-  static unsigned long lastWaterTempSampleTime = 0;
-  static unsigned long lastOilTempSampleTime = 0;
+  ScopedStageTimer timer(TimingStage::Acquire);
 
   // デモモード用の変数
   // デモ用電圧とシーケンス管理変数
@@ -121,11 +121,17 @@ void acquireSensorData()
   constexpr float patternSeq[] = {5.0F, 0.0F, 5.0F, 4.0F, 3.0F, 2.0F, 1.0F, 0.0F,
                                   1.0F, 2.0F, 3.0F, 4.0F, 5.0F, 0.0F, 0.0F, 2.5F};
 
-  unsigned long now = millis();
+  unsigned long now = halMillis();
 
   // デモモード処理
   if (DEMO_MODE_ENABLED)
   {
+    if (now - lastDemoSampleMs < DEMO_SAMPLE_INTERVAL_MS)
+    {
+      return;
+    }
+    lastDemoSampleMs = now;
+
     // 上昇フェーズ
     if (!inPattern)
     {
@@ -161,43 +167,118 @@ void acquireSensorData()
     float demoPressure = convertVoltageToOilPressure(demoVoltage);
     // 温度センサは電圧変化と逆の振る舞いにする
     float demoTemp = convertVoltageToTemp(SUPPLY_VOLTAGE - demoVoltage);
+    int32_t demoTempCenti = celsiusToCenti(demoTemp);
 
-    oilPressureSamples[oilPressureIndex] = demoPressure;
-    updateSampleBuffer(demoTemp, waterTemperatureSamples, waterTempIndex, isFirstWaterTempSample);
-    updateSampleBuffer(demoTemp, oilTemperatureSamples, oilTempIndex, isFirstOilTempSample);
-
-    Serial.printf("[DEMO] V:%.2f P:%.2f T:%.1f\n", demoVoltage, demoPressure, demoTemp);
+    uint32_t timestampUs = halMicros();
+    int16_t demoRaw = static_cast<int16_t>(demoVoltage * 2047.0F / 6.144F);
+    int32_t demoPressureQ16 = filterSample(ADC_CH_OIL_PRESSURE, barToPressureQ16(demoPressure), timestampUs, demoRaw);
+    sensorSampleRing.push({timestampUs, ADC_CH_OIL_PRESSURE, demoRaw, demoPressureQ16});
+    sensorSampleRing.push(
+        {timestampUs, ADC_CH_WATER_TEMP, demoRaw, filterSample(ADC_CH_WATER_TEMP, demoTempCenti, timestampUs, demoRaw)});
+    sensorSampleRing.push(
+        {timestampUs, ADC_CH_OIL_TEMP, demoRaw, filterSample(ADC_CH_OIL_TEMP, demoTempCenti, timestampUs, demoRaw)});
+    logSensorSample(timestampUs, ADC_CH_OIL_PRESSURE, demoRaw);
+    logSensorSample(timestampUs, ADC_CH_WATER_TEMP, demoRaw);
+    logSensorSample(timestampUs, ADC_CH_OIL_TEMP, demoRaw);
 
-    oilPressureIndex = (oilPressureIndex + 1) % PRESSURE_SAMPLE_SIZE;
+    // テレメトリ送信中はテキストを混ぜない（サンプルはテレメトリ側に全件載る）
+    if (!telemetryActive())
+    {
+      halLogf("[DEMO] V:%.2f P:%.2f T:%.1f\n", demoVoltage, demoPressure, demoTemp);
+    }
     return;
   }
 
   // ── 通常センサ読み取り ──
-  if (SENSOR_OIL_PRESSURE_PRESENT)
+  // 変換完了待ちはせず、結果が揃ったチャンネルだけを反映する
+  AdsSample sample;
+  if (!adsAcquisition.poll(halMicros(), sample))
+  {
+    return;
+  }
+
+  // 取得側は整数だけで換算する。温度はコンパイル時に生成した表から 1 回の参照で得る
+  int32_t value = (sample.channel == ADC_CH_OIL_PRESSURE) ? convertAdcToPressureQ16(sample.raw)
+                                                           : lookupTemperatureCenti(sample.raw);
+  // フィルタもここで通し、描画側は結果を読むだけにする
+  value = filterSample(sample.channel, value, sample.timestampUs, sample.raw);
+  // 描画側が詰まっている場合は古いデータを優先して新しいサンプルを捨てる
+  sensorSampleRing.push({sample.timestampUs, sample.channel, sample.raw, value});
+  // 生コードはセッションログにも積む（フラッシュへの書き込みはログタスクが行う）
+  logSensorSample(sample.timestampUs, sample.channel, sample.raw);
+}
+
+// ────────────────────── センサタスク ──────────────────────
+// 整定明け・変換完了予定・油圧の締め切りのうち次の時刻まで眠る。1tick ごとに起きないので、
+// 待ちの間はコア0 も電源管理の対象になる
+auto sensorTaskWaitUs(uint32_t nowUs) -> uint32_t
+{
+  uint32_t wakeUs = DEMO_MODE_ENABLED ? static_cast<uint32_t>((lastDemoSampleMs + DEMO_SAMPLE_INTERVAL_MS) * 1000UL)
+                                      : adsAcquisition.nextPollUs(nowUs);
+  int32_t waitUs = static_cast<int32_t>(wakeUs - nowUs);
+  return (waitUs > static_cast<int32_t>(SENSOR_TASK_MIN_WAIT_US)) ? static_cast<uint32_t>(waitUs)
+                                                                   : SENSOR_TASK_MIN_WAIT_US;
+}
+
+// ホストビルドではタスクを作らず、呼び出し側が sensorTaskWaitUs() の間隔で acquireSensorData() を回す
+#ifdef ARDUINO
+static void wakeSensorTaskFromTimer(void * /*unused*/) { xSemaphoreGive(sensorWake); }
+
+static void IRAM_ATTR wakeSensorTaskFromAlert()
+{
+  BaseType_t woken = pdFALSE;
+  xSemaphoreGiveFromISR(sensorWake, &woken);
+  if (woken == pdTRUE)
   {
-    int16_t rawAdc = readAdcWithSettling(ADC_CH_OIL_PRESSURE);  // CH1: 油圧
-    float pressureValue = convertVoltageToOilPressure(convertAdcToVoltage(rawAdc));
-    oilPressureSamples[oilPressureIndex] = pressureValue;
+    portYIELD_FROM_ISR();
   }
-  else
+}
+
+static void sensorTask(void * /*unused*/)
+{
+  for (;;)
   {
-    oilPressureSamples[oilPressureIndex] = 0.0F;
+    acquireSensorData();
+    // 変換完了は ALERT/RDY が先に知らせることがある。その場合は残ったタイマを止める
+    esp_timer_start_once(sensorWakeTimer, sensorTaskWaitUs(halMicros()));
+    xSemaphoreTake(sensorWake, portMAX_DELAY);
+    esp_timer_stop(sensorWakeTimer);
   }
-  oilPressureIndex = (oilPressureIndex + 1) % PRESSURE_SAMPLE_SIZE;
+}
 
-  // 水温
-  if (now - lastWaterTempSampleTime >= TEMP_SAMPLE_INTERVAL_MS)
+void startSensorTask()
+{
+  if (sensorTaskHandle != nullptr)
   {
-    float value = SENSOR_WATER_TEMP_PRESENT ? readTemperatureChannel(ADC_CH_WATER_TEMP) : 0.0f;
-    updateSampleBuffer(value, waterTemperatureSamples, waterTempIndex, isFirstWaterTempSample);
-    lastWaterTempSampleTime = now;
+    return;
   }
+  sensorWake = xSemaphoreCreateBinary();
+  const esp_timer_create_args_t timerArgs = {wakeSensorTaskFromTimer, nullptr, ESP_TIMER_TASK, "sensor", false};
+  if (sensorWake == nullptr || esp_timer_create(&timerArgs, &sensorWakeTimer) != ESP_OK)
+  {
+    halLogf("[Sensor] wake timer unavailable\n");
+    return;
+  }
+  halAdsAttachAlertInterrupt(wakeSensorTaskFromAlert);
+  xTaskCreatePinnedToCore(sensorTask, "sensor", SENSOR_TASK_STACK_SIZE, nullptr, SENSOR_TASK_PRIORITY,
+                          &sensorTaskHandle, SENSOR_TASK_CORE);
+}
+#else
+void startSensorTask() {}
+#endif
 
-  // 油温
-  if (now - lastOilTempSampleTime >= TEMP_SAMPLE_INTERVAL_MS)
+// ────────────────────── サンプル受信 ──────────────────────
+// リングに溜まったサンプルからチャンネルごとの最新値を取り出す
+void drainSensorSamples()
+{
+  SensorSample sample;
+  while (sensorSampleRing.pop(sample))
   {
-    float value = SENSOR_OIL_TEMP_PRESENT ? readTemperatureChannel(ADC_CH_OIL_TEMP) : 0.0f;
-    updateSampleBuffer(value, oilTemperatureSamples, oilTempIndex, isFirstOilTempSample);
-    lastOilTempSampleTime = now;
+    // 生サンプルは間引かずにテレメトリへ流す（無効時は何もしない）
+    sendTelemetrySample({sample.timestampUs, sample.channel, sample.raw, sample.value});
+    if (sample.channel < AdsAcquisition::MAX_CHANNELS)
+    {
+      sensorReadings.value[sample.channel] = sample.value;
+    }
   }
 }
@@ -1,20 +1,50 @@
 #ifndef SENSOR_H
 #define SENSOR_H
 
-#include <Adafruit_ADS1X15.h>
+#include <stddef.h>
 #include <stdint.h>
 
+#include "ads_acquisition.h"
 #include "config.h"
+#include "spsc_ring.h"
 
-extern Adafruit_ADS1015 adsConverter;
+// センサタスクから描画ループへ渡すサンプル
+struct SensorSample
+{
+  uint32_t timestampUs;
+  uint8_t channel;  // ADS1015 のチャンネル番号
+  int16_t raw;
+  int32_t value;  // 換算・フィルタ済みの値（油圧は Q16 mbar、温度は 0.01℃）
+};
+
+extern SpscRing<SensorSample, SENSOR_RING_CAPACITY> sensorSampleRing;
+
+// 描画側だけが drainSensorSamples() で更新する、ADS1015 のチャンネルごとのフィルタ済み最新値
+// （油圧は Q16 mbar、温度は 0.01℃。表示単位への換算はゲージ配置表の GaugeInput が持つ）
+struct SensorReadings
+{
+  int32_t value[AdsAcquisition::MAX_CHANNELS];
 
-extern float oilPressureSamples[PRESSURE_SAMPLE_SIZE];
-extern float waterTemperatureSamples[WATER_TEMP_SAMPLE_SIZE];
-extern float oilTemperatureSamples[OIL_TEMP_SAMPLE_SIZE];
+  auto operator[](uint8_t adcChannel) const -> int32_t { return value[adcChannel]; }
+};
+extern SensorReadings sensorReadings;
 
+// ADS1015 を初期化して取得チャンネルを登録する
+auto beginSensorAcquisition() -> bool;
+// 変換スケジュールの状態（チャンネルごとの実測 SPS など）
+auto sensorAcquisition() -> const AdsAcquisition &;
+// チャンネルごとの実測 SPS と油圧の最低保証レートを 1 行で出力する
+void dumpAcquisitionRates();
+// 待ち時間なしで ADS1015 の変換を 1 段進める（センサタスク側）
 void acquireSensorData();
+// 取得タスクが次に acquireSensorData() を呼ぶまで眠ってよい時間 [us]（ALERT/RDY があればそれより早く起きる）
+auto sensorTaskWaitUs(uint32_t nowUs) -> uint32_t;
+// acquireSensorData() を回すタスクを SENSOR_TASK_CORE で起動する
+void startSensorTask();
+// リングのサンプルを描画側バッファへ取り込む（描画ループ側）
+void drainSensorSamples();
 
-// 平均計算テンプレート
+// 平均計算テンプレート（float の配列用。取得経路は signal_filters.h のフィルタを使う）
 template <size_t N>
 inline auto calculateAverage(const float (&values)[N]) -> float
 {
@@ -0,0 +1,82 @@
+#ifndef SENSOR_CONVERSION_H
+#define SENSOR_CONVERSION_H
+
+#include <stdint.h>
+
+#include <cmath>
+
+#include "config.h"
+
+// ────────────────────── 換算定数 ──────────────────────
+constexpr float SUPPLY_VOLTAGE = 5.0f;
+// 電圧降下は config で設定
+constexpr float CORRECTION_FACTOR = SUPPLY_VOLTAGE / (SUPPLY_VOLTAGE - VOLTAGE_DROP);
+constexpr float THERMISTOR_R25 = 10000.0f;
+constexpr float THERMISTOR_B_CONSTANT = 3380.0f;
+constexpr float ABSOLUTE_TEMPERATURE_25 = 298.16f;  // 273.16 + 25
+constexpr float SERIES_REFERENCE_RES = 10000.0f;
+
+// ────────────────────── ユーティリティ ──────────────────────
+inline auto convertAdcToVoltage(int16_t rawAdc) -> float { return (rawAdc * 6.144F) / 2047.0F; }
+
+inline auto convertVoltageToOilPressure(float voltage) -> float
+{
+  voltage *= CORRECTION_FACTOR;
+  // 電源電圧近くまで上昇してもそのまま変換し、
+  // 12bar 以上かどうかは呼び出し側で判断する
+
+  // センサー実測式に基づき圧力へ変換
+  return (voltage > 0.5F) ? 2.5F * (voltage - 0.5F) : 0.0F;
+}
+
+inline auto convertVoltageToTemp(float voltage) -> float
+{
+  voltage *= CORRECTION_FACTOR;
+  // 電源電圧より高い/等しい電圧は異常値として捨てる
+  if (voltage <= 0.0F || voltage >= SUPPLY_VOLTAGE)
+  {
+    return 200.0F;
+  }
+
+  // 分圧式よりサーミスタ抵抗値を算出
+  // R = Rref * (V / (Vcc - V))  (サーミスタがGND側の場合)
+  float resistance = SERIES_REFERENCE_RES * (voltage / (SUPPLY_VOLTAGE - voltage));
+
+  // Steinhart–Hart の簡易形 (β式)
+  float kelvin =
+      THERMISTOR_B_CONSTANT / (log(resistance / THERMISTOR_R25) + THERMISTOR_B_CONSTANT / ABSOLUTE_TEMPERATURE_25);
+
+  return std::isnan(kelvin) ? 200.0F : kelvin - 273.16F;
+}
+
+// ────────────────────── 整数換算 ──────────────────────
+// 取得側は浮動小数点を使わず、油圧を Q16 のミリバールで扱う（温度は thermistor_lut.h の 0.01℃）。
+// 係数はコンパイル時に上の float 式と同じ定数から求める。
+constexpr int PRESSURE_Q16_SHIFT = 16;
+constexpr int32_t PRESSURE_Q16_PER_MBAR = int32_t{1} << PRESSURE_Q16_SHIFT;
+// 1 コードあたりの油圧 2.5bar/V × 6.144V/2047 × 補正 [mbar, Q16]
+constexpr int32_t PRESSURE_Q16_PER_CODE =
+    static_cast<int32_t>(2500.0 * 6.144 / 2047.0 * static_cast<double>(CORRECTION_FACTOR) * PRESSURE_Q16_PER_MBAR + 0.5);
+// センサーのゼロ点 0.5V 分 (1250mbar)
+constexpr int32_t PRESSURE_Q16_OFFSET = 1250 * PRESSURE_Q16_PER_MBAR;
+
+// 生コードから油圧 [mbar, Q16] を得る。0.5V 以下は 0 とする
+inline auto convertAdcToPressureQ16(int16_t rawAdc) -> int32_t
+{
+  int32_t pressure = rawAdc * PRESSURE_Q16_PER_CODE - PRESSURE_Q16_OFFSET;
+  return (pressure > 0) ? pressure : 0;
+}
+
+// ── 表示側の境界でだけ使う float 変換 ──
+inline auto pressureQ16ToBar(int32_t pressureQ16) -> float
+{
+  return static_cast<float>(pressureQ16) * (1.0F / (1000.0F * PRESSURE_Q16_PER_MBAR));
+}
+inline auto barToPressureQ16(float bar) -> int32_t
+{
+  return static_cast<int32_t>(std::lround(bar * 1000.0F * PRESSURE_Q16_PER_MBAR));
+}
+inline auto centiToCelsius(int32_t centi) -> float { return static_cast<float>(centi) * 0.01F; }
+inline auto celsiusToCenti(float celsius) -> int32_t { return static_cast<int32_t>(std::lround(celsius * 100.0F)); }
+
+#endif  // SENSOR_CONVERSION_H
@@ -0,0 +1,225 @@
+#include "session_log.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "hal/hal.h"
+
+// ────────────────────── 書き込み ──────────────────────
+auto SessionLogWriter::begin(const char *path, uint32_t startUs) -> bool
+{
+  if (!sink_.open(path))
+  {
+    return false;
+  }
+
+  // ヘッダーは最初のページの先頭に置き、以降の書き込みもページ単位に揃える
+  SessionLogHeader header = {};
+  std::memcpy(header.magic, SESSION_LOG_MAGIC, sizeof(header.magic));
+  header.version = SESSION_LOG_VERSION;
+  header.headerSize = sizeof(SessionLogHeader);
+  header.recordSize = sizeof(uint32_t);
+  header.startUs = startUs;
+  std::memcpy(page_, &header, sizeof(header));
+  pageFill_ = sizeof(header);
+
+  lastTimestampUs_ = startUs;
+  stopped_ = false;
+  active_.store(true, std::memory_order_release);
+  return true;
+}
+
+void SessionLogWriter::record(uint32_t timestampUs, uint8_t channel, int16_t raw)
+{
+  if (!active())
+  {
+    return;
+  }
+
+  // 時刻が戻った場合は経過 0 として扱う
+  int32_t elapsed = static_cast<int32_t>(timestampUs - lastTimestampUs_);
+  uint32_t delta = (elapsed > 0) ? static_cast<uint32_t>(elapsed) : 0;
+  while (delta > SESSION_LOG_MAX_DELTA_US)
+  {
+    uint32_t gap = (delta > SESSION_LOG_MAX_GAP_US) ? SESSION_LOG_MAX_GAP_US : delta;
+    // ギャップを積めなければ基準時刻を進めず、次のサンプルで改めて差分を取る
+    if (!ring_.push(encodeSessionGap(gap)))
+    {
+      return;
+    }
+    lastTimestampUs_ += gap;
+    delta -= gap;
+  }
+
+  if (ring_.push(encodeSessionRecord(static_cast<uint16_t>(delta), channel, raw)))
+  {
+    lastTimestampUs_ += delta;
+    recordCount_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void SessionLogWriter::service()
+{
+  ringHighWater_ = std::max(ringHighWater_, ring_.size());
+  uint32_t record;
+  while (ring_.pop(record))
+  {
+    if (stopped_)
+    {
+      discardedCount_++;
+      continue;
+    }
+    std::memcpy(page_ + pageFill_, &record, sizeof(record));
+    pageFill_ += sizeof(record);
+    if (pageFill_ == SESSION_LOG_PAGE_SIZE)
+    {
+      writePage(pageFill_);
+    }
+  }
+}
+
+void SessionLogWriter::writePage(size_t length)
+{
+  uint32_t startUs = halMicros();
+  size_t written = sink_.write(page_, length);
+  uint32_t elapsedUs = halMicros() - startUs;
+  maxWriteUs_ = std::max(maxWriteUs_, elapsedUs);
+  pageFill_ = 0;
+
+  bytesWritten_ += written;
+  pageWrites_++;
+  // 書けなかった・容量上限に達したら以降のレコードは捨てる
+  if (written != length || bytesWritten_ + SESSION_LOG_PAGE_SIZE > SESSION_LOG_MAX_BYTES)
+  {
+    stopped_ = true;
+  }
+}
+
+void SessionLogWriter::end()
+{
+  if (!active())
+  {
+    return;
+  }
+  active_.store(false, std::memory_order_release);
+  service();
+  if (pageFill_ > 0 && !stopped_)
+  {
+    writePage(pageFill_);
+  }
+  sink_.flush();
+  sink_.close();
+}
+
+// ────────────────────── 読み出し ──────────────────────
+auto SessionLogReader::open(const uint8_t *data, size_t size) -> bool
+{
+  if (size < sizeof(SessionLogHeader))
+  {
+    return false;
+  }
+  std::memcpy(&header_, data, sizeof(header_));
+  if (std::memcmp(header_.magic, SESSION_LOG_MAGIC, sizeof(header_.magic)) != 0 ||
+      header_.version != SESSION_LOG_VERSION || header_.recordSize != sizeof(uint32_t) ||
+      header_.headerSize < sizeof(SessionLogHeader) || header_.headerSize > size)
+  {
+    return false;
+  }
+  data_ = data;
+  size_ = size;
+  offset_ = header_.headerSize;
+  timestampUs_ = header_.startUs;
+  return true;
+}
+
+auto SessionLogReader::next(SessionLogEntry &entry) -> bool
+{
+  while (offset_ + sizeof(uint32_t) <= size_)
+  {
+    uint32_t record;
+    std::memcpy(&record, data_ + offset_, sizeof(record));
+    offset_ += sizeof(record);
+
+    uint8_t channel = static_cast<uint8_t>(record >> 28);
+    if (channel == SESSION_LOG_GAP_CHANNEL)
+    {
+      timestampUs_ += record & SESSION_LOG_MAX_GAP_US;
+      continue;
+    }
+    timestampUs_ += record & SESSION_LOG_MAX_DELTA_US;
+    // 12bit の符号を 16bit へ広げる
+    int16_t raw = static_cast<int16_t>((record >> 16) & 0x0FFF);
+    if (raw & 0x0800)
+    {
+      raw = static_cast<int16_t>(raw - 0x1000);
+    }
+    entry = {timestampUs_, channel, raw};
+    return true;
+  }
+  return false;
+}
+
+// ────────────────────── セッション ──────────────────────
+static SessionLogWriter sessionLog(halLogFs());
+#ifdef ARDUINO
+static TaskHandle_t sessionLogTaskHandle = nullptr;
+#endif
+
+auto beginSessionLog() -> bool
+{
+  if (!SESSION_LOG_ENABLED || !halLogFsBegin())
+  {
+    return false;
+  }
+
+  // 既存のセッションを上書きしないよう空き番号を探す
+  LogFileSink &fs = halLogFs();
+  char path[24];
+  for (unsigned index = 0; index < 10000; ++index)
+  {
+    snprintf(path, sizeof(path), "/session_%04u.bin", index);
+    if (!fs.exists(path))
+    {
+      return sessionLog.begin(path, halMicros());
+    }
+  }
+  return false;
+}
+
+void logSensorSample(uint32_t timestampUs, uint8_t channel, int16_t raw)
+{
+  sessionLog.record(timestampUs, channel, raw);
+}
+
+void serviceSessionLog() { sessionLog.service(); }
+
+void endSessionLog() { sessionLog.end(); }
+
+auto sessionLogWriter() -> const SessionLogWriter & { return sessionLog; }
+
+// ────────────────────── ログタスク ──────────────────────
+// ホストビルドではタスクを作らず、呼び出し側が serviceSessionLog() を回す
+#ifdef ARDUINO
+static void sessionLogTask(void * /*unused*/)
+{
+  for (;;)
+  {
+    serviceSessionLog();
+    vTaskDelay(pdMS_TO_TICKS(SESSION_LOG_SERVICE_INTERVAL_MS));
+  }
+}
+
+void startSessionLogTask()
+{
+  if (sessionLogTaskHandle != nullptr || !sessionLog.active())
+  {
+    return;
+  }
+  // 取得タスクと同じコアで、より低い優先度で動かす
+  xTaskCreatePinnedToCore(sessionLogTask, "session_log", SESSION_LOG_TASK_STACK_SIZE, nullptr,
+                          SESSION_LOG_TASK_PRIORITY, &sessionLogTaskHandle, SENSOR_TASK_CORE);
+}
+#else
+void startSessionLogTask() {}
+#endif
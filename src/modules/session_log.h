@@ -0,0 +1,134 @@
+#ifndef SESSION_LOG_H
+#define SESSION_LOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#include "config.h"
+#include "hal/hal_log_fs.h"
+#include "spsc_ring.h"
+
+// ────────────────────── セッションログのファイル形式 ──────────────────────
+// [ヘッダー 16B][レコード 4B]... をリトルエンディアンで並べる。
+// レコードは 32bit に
+//   bit 0-15  : 前のレコードからの経過時間 [us]
+//   bit 16-27 : ADS1015 の 12bit 符号付きコード
+//   bit 28-31 : チャンネル番号
+// を詰めたもの。チャンネル 0xF はギャップで、bit 0-27 の経過時間だけ基準時刻を進める。
+
+constexpr char SESSION_LOG_MAGIC[4] = {'R', 'G', 'S', 'L'};
+constexpr uint16_t SESSION_LOG_VERSION = 1;
+constexpr uint8_t SESSION_LOG_GAP_CHANNEL = 0xF;
+constexpr uint32_t SESSION_LOG_MAX_DELTA_US = 0xFFFF;
+constexpr uint32_t SESSION_LOG_MAX_GAP_US = 0x0FFFFFFF;
+
+struct SessionLogHeader
+{
+  char magic[4];
+  uint16_t version;
+  uint16_t headerSize;
+  uint16_t recordSize;
+  uint16_t reserved;
+  uint32_t startUs;  // 最初のレコードの経過時間の基準
+};
+static_assert(sizeof(SessionLogHeader) == 16, "session log header must stay 16 bytes");
+static_assert(SESSION_LOG_PAGE_SIZE % sizeof(uint32_t) == 0, "page must hold whole records");
+
+constexpr auto encodeSessionRecord(uint16_t deltaUs, uint8_t channel, int16_t raw) -> uint32_t
+{
+  return (static_cast<uint32_t>(channel & 0xF) << 28) | (static_cast<uint32_t>(raw & 0x0FFF) << 16) | deltaUs;
+}
+
+constexpr auto encodeSessionGap(uint32_t elapsedUs) -> uint32_t
+{
+  return (static_cast<uint32_t>(SESSION_LOG_GAP_CHANNEL) << 28) | (elapsedUs & SESSION_LOG_MAX_GAP_US);
+}
+
+// 復号済みのサンプル 1 件
+struct SessionLogEntry
+{
+  uint32_t timestampUs;
+  uint8_t channel;
+  int16_t raw;
+};
+
+// ────────────────────── 書き込み ──────────────────────
+// record() は取得タスクから呼ばれ、レコードをリングへ積むだけで戻る。
+// service() は低優先度のログタスクから呼ばれ、リングをページバッファへ移して
+// SESSION_LOG_PAGE_SIZE 単位でまとめて書き出す。フラッシュ書き込みを待つのはログタスクだけになる。
+class SessionLogWriter
+{
+ public:
+  explicit SessionLogWriter(LogFileSink &sink) : sink_(sink) {}
+
+  auto begin(const char *path, uint32_t startUs) -> bool;
+  void record(uint32_t timestampUs, uint8_t channel, int16_t raw);
+  void service();
+  // 残りのレコードと書きかけのページを書き出して閉じる
+  void end();
+
+  auto active() const -> bool { return active_.load(std::memory_order_acquire); }
+  auto recordCount() const -> uint32_t { return recordCount_.load(std::memory_order_relaxed); }
+  // リングが一杯で捨てたレコード数
+  auto droppedCount() const -> uint32_t { return ring_.droppedCount(); }
+  // 容量上限・書き込み失敗の後に捨てたレコード数
+  auto discardedCount() const -> uint32_t { return discardedCount_; }
+  auto bytesWritten() const -> uint32_t { return bytesWritten_; }
+  auto pageWrites() const -> uint32_t { return pageWrites_; }
+  auto maxWriteUs() const -> uint32_t { return maxWriteUs_; }
+  auto ringHighWater() const -> size_t { return ringHighWater_; }
+
+ private:
+  void writePage(size_t length);
+
+  LogFileSink &sink_;
+  SpscRing<uint32_t, SESSION_LOG_RING_CAPACITY> ring_;
+  std::atomic<bool> active_{false};
+
+  // 取得タスク側
+  uint32_t lastTimestampUs_ = 0;
+  std::atomic<uint32_t> recordCount_{0};
+
+  // ログタスク側
+  alignas(4) uint8_t page_[SESSION_LOG_PAGE_SIZE] = {};
+  size_t pageFill_ = 0;
+  bool stopped_ = false;
+  uint32_t discardedCount_ = 0;
+  uint32_t bytesWritten_ = 0;
+  uint32_t pageWrites_ = 0;
+  uint32_t maxWriteUs_ = 0;
+  size_t ringHighWater_ = 0;
+};
+
+// ────────────────────── 読み出し ──────────────────────
+// ヘッダーを検証し、ギャップを畳み込んで絶対時刻付きのサンプルを順に返す
+class SessionLogReader
+{
+ public:
+  auto open(const uint8_t *data, size_t size) -> bool;
+  auto next(SessionLogEntry &entry) -> bool;
+  auto header() const -> const SessionLogHeader & { return header_; }
+
+ private:
+  const uint8_t *data_ = nullptr;
+  size_t size_ = 0;
+  size_t offset_ = 0;
+  uint32_t timestampUs_ = 0;
+  SessionLogHeader header_ = {};
+};
+
+// ────────────────────── セッション ──────────────────────
+// LittleFS をマウントし、空いている /session_NNNN.bin に記録を始める
+auto beginSessionLog() -> bool;
+// 取得タスクから生サンプルを 1 件渡す（ログ無効時は何もしない）
+void logSensorSample(uint32_t timestampUs, uint8_t channel, int16_t raw);
+// 溜まったレコードをファイルへ移す（ログタスク側）
+void serviceSessionLog();
+// serviceSessionLog() を回す低優先度タスクを起動する
+void startSessionLogTask();
+void endSessionLog();
+auto sessionLogWriter() -> const SessionLogWriter &;
+
+#endif  // SESSION_LOG_H
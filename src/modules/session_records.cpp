@@ -0,0 +1,172 @@
+#include "session_records.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "hal/hal.h"
+
+// ────────────────────── 読み込み・更新 ──────────────────────
+void SessionRecords::clearSession()
+{
+  for (size_t i = 0; i < GAUGE_SOURCE_COUNT; ++i)
+  {
+    sessionPeak_[i] = 0.0F;
+    sessionRedZoneMs_[i] = 0;
+  }
+}
+
+void SessionRecords::begin(uint32_t nowMs)
+{
+  StoredRecords loaded = {};
+  if (store_.read(RECORDS_NVS_KEY, &loaded, sizeof(loaded)) && loaded.version == RECORDS_VERSION)
+  {
+    base_ = loaded;
+    previous_ = loaded.session;
+    written_ = loaded;
+  }
+  else
+  {
+    base_ = {};
+    previous_ = {};
+    written_ = {};
+  }
+  clearSession();
+  hasUpdate_ = false;
+  lastFlushMs_ = nowMs;
+  stats_ = {};
+}
+
+void SessionRecords::update(const GaugeValues &values, uint32_t nowMs)
+{
+  uint32_t elapsedMs = hasUpdate_ ? std::min(nowMs - lastUpdateMs_, RECORDS_MAX_UPDATE_GAP_MS) : 0;
+  lastUpdateMs_ = nowMs;
+  hasUpdate_ = true;
+  stats_.updates++;
+
+  for (size_t i = 0; i < GAUGE_SOURCE_COUNT; ++i)
+  {
+    const GaugeSpec &spec = gaugeSpecFor(static_cast<GaugeSource>(i));
+    float value = values.current[i];
+    if (isGaugeErrorValue(spec, value))
+    {
+      continue;
+    }
+    sessionPeak_[i] = std::max(sessionPeak_[i], value);
+    if (value >= spec.threshold)
+    {
+      sessionRedZoneMs_[i] += elapsedMs;
+    }
+  }
+}
+
+auto SessionRecords::snapshot() const -> StoredRecords
+{
+  StoredRecords records = {};
+  records.version = RECORDS_VERSION;
+  records.sessions = base_.sessions + 1;
+  for (size_t i = 0; i < GAUGE_SOURCE_COUNT; ++i)
+  {
+    uint32_t seconds = sessionRedZoneMs_[i] / 1000U;
+    records.session.peak[i] = sessionPeak_[i];
+    records.session.redZoneSeconds[i] = seconds;
+    records.allTime.peak[i] = std::max(base_.allTime.peak[i], sessionPeak_[i]);
+    records.allTime.redZoneSeconds[i] = base_.allTime.redZoneSeconds[i] + seconds;
+  }
+  return records;
+}
+
+// ────────────────────── 書き込み ──────────────────────
+auto SessionRecords::service(uint32_t nowMs, uint32_t supplyMv) -> bool
+{
+  StoredRecords next = snapshot();
+  if (std::memcmp(&next, &written_, sizeof(next)) == 0)
+  {
+    return false;
+  }
+
+  bool brownout = supplyMv != 0 && supplyMv < RECORDS_BROWNOUT_MV;
+  uint32_t sinceFlushMs = nowMs - lastFlushMs_;
+  bool due = sinceFlushMs >= RECORDS_FLUSH_INTERVAL_MS;
+  bool peakJumped = false;
+  if (sinceFlushMs >= RECORDS_MIN_FLUSH_INTERVAL_MS)
+  {
+    for (size_t i = 0; i < GAUGE_SOURCE_COUNT; ++i)
+    {
+      peakJumped = peakJumped || next.session.peak[i] >= written_.session.peak[i] + RECORDS_FLUSH_PEAK_DELTA[i];
+    }
+  }
+  if (!brownout && !due && !peakJumped)
+  {
+    return false;
+  }
+  if (brownout)
+  {
+    stats_.brownoutFlushes++;
+  }
+  return write(next, nowMs);
+}
+
+auto SessionRecords::flush(uint32_t nowMs) -> bool
+{
+  StoredRecords next = snapshot();
+  if (std::memcmp(&next, &written_, sizeof(next)) == 0)
+  {
+    return false;
+  }
+  return write(next, nowMs);
+}
+
+auto SessionRecords::write(const StoredRecords &records, uint32_t nowMs) -> bool
+{
+  // 失敗しても次の試行までは通常の間隔を空ける
+  lastFlushMs_ = nowMs;
+  if (!store_.write(RECORDS_NVS_KEY, &records, sizeof(records)))
+  {
+    stats_.failedWrites++;
+    return false;
+  }
+  written_ = records;
+  stats_.flushes++;
+  return true;
+}
+
+// ────────────────────── リセット ──────────────────────
+void SessionRecords::resetSession(uint32_t nowMs)
+{
+  // ここまでの分を通算へ繰り入れてから今回の分を消す
+  StoredRecords current = snapshot();
+  base_.allTime = current.allTime;
+  clearSession();
+  flush(nowMs);
+}
+
+void SessionRecords::resetAllTime(uint32_t nowMs)
+{
+  base_ = {};
+  previous_ = {};
+  clearSession();
+  flush(nowMs);
+}
+
+// ────────────────────── 出力 ──────────────────────
+void SessionRecords::dump() const
+{
+  StoredRecords records = snapshot();
+  halLogf("records sessions=%lu flushes=%lu brownout=%lu failed=%lu updates=%lu\n",
+          static_cast<unsigned long>(records.sessions), static_cast<unsigned long>(stats_.flushes),
+          static_cast<unsigned long>(stats_.brownoutFlushes), static_cast<unsigned long>(stats_.failedWrites),
+          static_cast<unsigned long>(stats_.updates));
+  halLogf("source      session  red_min   previous  all_time  red_min\n");
+  for (size_t i = 0; i < GAUGE_SOURCE_COUNT; ++i)
+  {
+    halLogf("%-8s %10.1f %8.1f %10.1f %9.1f %8.1f\n", gaugeSpecFor(static_cast<GaugeSource>(i)).label,
+            records.session.peak[i], records.session.redZoneSeconds[i] / 60.0F, previous_.peak[i],
+            records.allTime.peak[i], records.allTime.redZoneSeconds[i] / 60.0F);
+  }
+}
+
+auto sessionRecords() -> SessionRecords &
+{
+  static SessionRecords records(halNvs());
+  return records;
+}
@@ -0,0 +1,98 @@
+#ifndef SESSION_RECORDS_H
+#define SESSION_RECORDS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "gauge_layout.h"
+#include "hal/hal_nvs.h"
+
+// ────────────────────── 走行記録 ──────────────────────
+// 出どころごとの最高値と、配置表の threshold 以上（レッドゾーン）にいた時間を、
+// 今回のセッション（起動から）と通算の 2 組で持ち、NVS の 1 つの blob に残す。
+// 描画ごとの update() は RAM だけを書き換え、service() が次のときだけ NVS へ書く。
+//   ・前回の書き込みから RECORDS_FLUSH_INTERVAL_MS 経った
+//   ・最高値が RECORDS_FLUSH_PEAK_DELTA 以上伸びた（RECORDS_MIN_FLUSH_INTERVAL_MS は空ける）
+//   ・電源電圧が RECORDS_BROWNOUT_MV を下回った（間隔によらず書く）
+// 書く内容が前回と同じなら、どの条件でも書かない。
+
+struct RecordSet
+{
+  float peak[GAUGE_SOURCE_COUNT];
+  uint32_t redZoneSeconds[GAUGE_SOURCE_COUNT];
+};
+
+// NVS に書く blob。版が違えば読み捨てて 0 から始める
+struct StoredRecords
+{
+  uint16_t version;
+  uint16_t reserved;
+  uint32_t sessions;  // 起動の回数（このセッションを含む）
+  RecordSet session;  // 最後のセッション
+  RecordSet allTime;
+};
+static_assert(sizeof(StoredRecords) == 56, "stored records layout must stay fixed");
+
+constexpr uint16_t RECORDS_VERSION = 1;
+constexpr char RECORDS_NVS_KEY[] = "records";
+// この幅以上に最高値が伸びたら、定期の書き込みを待たずに書く（油圧 [bar]・水温・油温 [℃]）
+constexpr float RECORDS_FLUSH_PEAK_DELTA[GAUGE_SOURCE_COUNT] = {0.5F, 1.0F, 1.0F};
+// 描画が止まっていた間をレッドゾーンの時間に数えすぎないよう、1 回の更新で足す時間の上限 [ms]
+constexpr uint32_t RECORDS_MAX_UPDATE_GAP_MS = 1000;
+
+struct RecordsStats
+{
+  uint32_t updates;          // update() の回数
+  uint32_t flushes;          // NVS へ書いた回数
+  uint32_t brownoutFlushes;  // そのうち電圧低下で書いた回数
+  uint32_t failedWrites;
+};
+
+class SessionRecords
+{
+ public:
+  explicit SessionRecords(NvsStore &store) : store_(store) {}
+
+  // 前回までの記録を読んで新しいセッションを始める。前回のセッションは previousSession() に残る
+  void begin(uint32_t nowMs);
+  // 1 フレーム分の現在値で最高値とレッドゾーンの時間を更新する（RAM のみ。エラー表示の値は数えない）
+  void update(const GaugeValues &values, uint32_t nowMs);
+  // 書き込みの条件を満たしていれば NVS へ書き、書いたら true
+  auto service(uint32_t nowMs, uint32_t supplyMv) -> bool;
+  // 条件によらず、内容が変わっていれば書く
+  auto flush(uint32_t nowMs) -> bool;
+
+  // 今回のセッションを 0 に戻す（それまでの分は通算に残す）。すぐに書く
+  void resetSession(uint32_t nowMs);
+  // 通算と今回のセッションを 0 に戻す。すぐに書く
+  void resetAllTime(uint32_t nowMs);
+
+  auto sessionPeak(GaugeSource source) const -> float { return sessionPeak_[static_cast<size_t>(source)]; }
+  // 今書くとしたら書く内容
+  auto snapshot() const -> StoredRecords;
+  auto previousSession() const -> const RecordSet & { return previous_; }
+  auto stats() const -> const RecordsStats & { return stats_; }
+  // セッション・通算の記録と書き込み回数を halLogf で出力する
+  void dump() const;
+
+ private:
+  void clearSession();
+  auto write(const StoredRecords &records, uint32_t nowMs) -> bool;
+
+  NvsStore &store_;
+  StoredRecords base_ = {};  // 今回のセッションより前の通算
+  RecordSet previous_ = {};
+  float sessionPeak_[GAUGE_SOURCE_COUNT] = {};
+  uint32_t sessionRedZoneMs_[GAUGE_SOURCE_COUNT] = {};
+  uint32_t lastUpdateMs_ = 0;
+  bool hasUpdate_ = false;
+  StoredRecords written_ = {};  // 最後に NVS にある（書いた・読んだ）内容
+  uint32_t lastFlushMs_ = 0;
+  RecordsStats stats_ = {};
+};
+
+// 描画と loop() が共有する記録（保存先は halNvs()）
+auto sessionRecords() -> SessionRecords &;
+
+#endif  // SESSION_RECORDS_H
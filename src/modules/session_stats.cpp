@@ -0,0 +1,310 @@
+#include "session_stats.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "hal/hal.h"
+
+// ────────────────────── Welford ──────────────────────
+void RunningStats::add(float x)
+{
+  count_++;
+  if (count_ == 1)
+  {
+    min_ = x;
+    max_ = x;
+  }
+  else
+  {
+    min_ = std::min(min_, x);
+    max_ = std::max(max_, x);
+  }
+  double delta = x - mean_;
+  mean_ += delta / count_;
+  m2_ += delta * (x - mean_);
+}
+
+auto RunningStats::variance() const -> float
+{
+  return (count_ < 2) ? 0.0F : static_cast<float>(m2_ / (count_ - 1));
+}
+
+auto RunningStats::stddev() const -> float { return std::sqrt(variance()); }
+
+// ────────────────────── P² ──────────────────────
+void P2Quantile::add(float x)
+{
+  // 最初の 5 件はそのまま目印にする
+  if (count_ < MARKERS)
+  {
+    height_[count_++] = x;
+    if (count_ == MARKERS)
+    {
+      std::sort(height_, height_ + MARKERS);
+      for (int i = 0; i < MARKERS; ++i)
+      {
+        position_[i] = i;
+      }
+    }
+    return;
+  }
+
+  // x が入る区間を探し、それより上の目印の順位を 1 つ下げる（両端の目印は最小・最大を追う）
+  int k = 0;
+  if (x < height_[0])
+  {
+    height_[0] = x;
+  }
+  else if (x >= height_[MARKERS - 1])
+  {
+    height_[MARKERS - 1] = x;
+    k = MARKERS - 2;
+  }
+  else
+  {
+    while (x >= height_[k + 1])
+    {
+      k++;
+    }
+  }
+  for (int i = k + 1; i < MARKERS; ++i)
+  {
+    position_[i]++;
+  }
+  count_++;
+
+  // 内側の目印を理想の位置へ 1 つずつ寄せる
+  for (int i = 1; i < MARKERS - 1; ++i)
+  {
+    float offset = desiredPosition(i) - static_cast<float>(position_[i]);
+    int step = 0;
+    if (offset >= 1.0F && position_[i + 1] - position_[i] > 1)
+    {
+      step = 1;
+    }
+    else if (offset <= -1.0F && position_[i - 1] - position_[i] < -1)
+    {
+      step = -1;
+    }
+    if (step == 0)
+    {
+      continue;
+    }
+    float height = parabolic(i, step);
+    if (!(height_[i - 1] < height && height < height_[i + 1]))
+    {
+      height = linear(i, step);
+    }
+    height_[i] = height;
+    position_[i] += step;
+  }
+}
+
+auto P2Quantile::desiredPosition(int marker) const -> float
+{
+  const float fraction[MARKERS] = {0.0F, p_ * 0.5F, p_, (1.0F + p_) * 0.5F, 1.0F};
+  return static_cast<float>(count_ - 1) * fraction[marker];
+}
+
+auto P2Quantile::parabolic(int i, int d) const -> float
+{
+  float below = static_cast<float>(position_[i] - position_[i - 1]);
+  float above = static_cast<float>(position_[i + 1] - position_[i]);
+  float step = static_cast<float>(d);
+  return height_[i] + step / (below + above) *
+                          ((below + step) * (height_[i + 1] - height_[i]) / above +
+                           (above - step) * (height_[i] - height_[i - 1]) / below);
+}
+
+auto P2Quantile::linear(int i, int d) const -> float
+{
+  return height_[i] + static_cast<float>(d) * (height_[i + d] - height_[i]) /
+                          static_cast<float>(position_[i + d] - position_[i]);
+}
+
+auto P2Quantile::value() const -> float
+{
+  if (count_ == 0)
+  {
+    return 0.0F;
+  }
+  if (count_ < MARKERS)
+  {
+    float sorted[MARKERS];
+    std::copy(height_, height_ + count_, sorted);
+    std::sort(sorted, sorted + count_);
+    return sorted[static_cast<size_t>(std::lround(p_ * static_cast<float>(count_ - 1)))];
+  }
+  return height_[2];
+}
+
+// ────────────────────── 出どころごとの集計 ──────────────────────
+void ChannelStats::add(float x)
+{
+  moments.add(x);
+  p1.add(x);
+  p50.add(x);
+  p99.add(x);
+}
+
+void ChannelStats::reset()
+{
+  moments.reset();
+  p1.reset();
+  p50.reset();
+  p99.reset();
+}
+
+// ────────────────────── ヒストグラム ──────────────────────
+auto PressureTempHistogram::pressureBin(float pressureBar) -> int
+{
+  int bin = static_cast<int>(std::floor(pressureBar / STATS_PRESSURE_BIN_BAR));
+  return std::min(std::max(bin, 0), PRESSURE_BINS - 1);
+}
+
+auto PressureTempHistogram::tempBin(float oilTempC) -> int
+{
+  int bin = static_cast<int>(std::floor((oilTempC - STATS_OIL_TEMP_MIN_C) / STATS_OIL_TEMP_BIN_C));
+  return std::min(std::max(bin, 0), TEMP_BINS - 1);
+}
+
+void PressureTempHistogram::add(float pressureBar, float oilTempC)
+{
+  uint32_t count = ++counts_[tempBin(oilTempC)][pressureBin(pressureBar)];
+  maxCount_ = std::max(maxCount_, count);
+  total_++;
+}
+
+// ────────────────────── 走行統計 ──────────────────────
+// チャンネルから出どころと換算はゲージ配置表で引く
+void SessionStats::addSensorSample(uint8_t adcChannel, int32_t value)
+{
+  GaugeSource source = gaugeSourceForChannel(adcChannel);
+  if (source == GaugeSource::Count)
+  {
+    return;
+  }
+  add(source, gaugeInputValue(gaugeSpecFor(source).input, value));
+}
+
+void SessionStats::add(GaugeSource source, float value)
+{
+  if (isGaugeErrorValue(gaugeSpecFor(source), value))
+  {
+    // 油温が断線している間はヒストグラムに数えない
+    if (source == GaugeSource::OilTemp) hasOilTemp_ = false;
+    return;
+  }
+  channels_[static_cast<size_t>(source)].add(value);
+  if (source == GaugeSource::OilTemp)
+  {
+    lastOilTemp_ = value;
+    hasOilTemp_ = true;
+  }
+  else if (source == GaugeSource::OilPressure && hasOilTemp_)
+  {
+    histogram_.add(value, lastOilTemp_);
+  }
+}
+
+void SessionStats::reset()
+{
+  for (ChannelStats &channel : channels_)
+  {
+    channel.reset();
+  }
+  histogram_.reset();
+  hasOilTemp_ = false;
+}
+
+void SessionStats::dump() const
+{
+  halLogf("stats          n     min      p1     p50     p99     max    mean      sd\n");
+  for (size_t i = 0; i < GAUGE_SOURCE_COUNT; ++i)
+  {
+    const ChannelStats &stats = channels_[i];
+    const RunningStats &m = stats.moments;
+    halLogf("%-8s %7lu %7.2f %7.2f %7.2f %7.2f %7.2f %7.2f %7.2f\n",
+            gaugeSpecFor(static_cast<GaugeSource>(i)).label, static_cast<unsigned long>(m.count()), m.min(),
+            stats.p1.value(), stats.p50.value(), stats.p99.value(), m.max(), m.mean(), m.stddev());
+  }
+
+  // 行は油温の区間の下限 [℃]、列は油圧の区間の下限 [bar]
+  halLogf("oil.t\\oil.p");
+  for (int p = 0; p < PressureTempHistogram::PRESSURE_BINS; ++p)
+  {
+    halLogf(" %6.1f", p * STATS_PRESSURE_BIN_BAR);
+  }
+  halLogf("\n");
+  for (int t = 0; t < PressureTempHistogram::TEMP_BINS; ++t)
+  {
+    halLogf("%11.0f", STATS_OIL_TEMP_MIN_C + t * STATS_OIL_TEMP_BIN_C);
+    for (int p = 0; p < PressureTempHistogram::PRESSURE_BINS; ++p)
+    {
+      halLogf(" %6lu", static_cast<unsigned long>(histogram_.count(p, t)));
+    }
+    halLogf("\n");
+  }
+}
+
+// ────────────────────── コア間の受け渡し ──────────────────────
+void SharedSessionStats::addSensorSample(uint8_t adcChannel, int32_t value)
+{
+  if (resetRequested_.exchange(false, std::memory_order_acquire))
+  {
+    live_.reset();
+    unpublished_ = STATS_PUBLISH_SAMPLES;  // 消したことをすぐ写しにも反映する
+  }
+  live_.addSensorSample(adcChannel, value);
+  if (++unpublished_ >= STATS_PUBLISH_SAMPLES)
+  {
+    publish();
+  }
+}
+
+void SharedSessionStats::publish()
+{
+  uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+  sequence_.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  snapshot_ = live_;
+  sequence_.store(sequence + 2, std::memory_order_release);
+  unpublished_ = 0;
+}
+
+auto SharedSessionStats::readSnapshot(SessionStats &out) const -> bool
+{
+  for (int attempt = 0; attempt < READ_ATTEMPTS; ++attempt)
+  {
+    uint32_t before = sequence_.load(std::memory_order_acquire);
+    if ((before & 1U) != 0)
+    {
+      continue;
+    }
+    out = snapshot_;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence_.load(std::memory_order_relaxed) == before)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void SharedSessionStats::dumpSnapshot() const
+{
+  // 約 2KB あるのでスタックには置かない（読むのは描画側だけ）
+  static SessionStats view;
+  if (!readSnapshot(view))
+  {
+    halLogf("stats busy, try again\n");
+    return;
+  }
+  view.dump();
+}
+
+auto sessionStats() -> SharedSessionStats &
+{
+  static SharedSessionStats stats;
+  return stats;
+}
@@ -0,0 +1,159 @@
+#ifndef SESSION_STATS_H
+#define SESSION_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#include "config.h"
+#include "gauge_layout.h"
+
+// ────────────────────── 逐次統計 ──────────────────────
+// サンプルを保持せず、1 件ごとに O(1) で更新する統計量。
+
+// 件数・最小・最大・平均・分散（Welford 法。大きな値でも桁落ちしない）
+class RunningStats
+{
+ public:
+  void add(float x);
+  void reset() { *this = RunningStats(); }
+
+  auto count() const -> uint32_t { return count_; }
+  auto min() const -> float { return min_; }
+  auto max() const -> float { return max_; }
+  auto mean() const -> float { return static_cast<float>(mean_); }
+  // 不偏分散（2 件未満なら 0）
+  auto variance() const -> float;
+  auto stddev() const -> float;
+
+ private:
+  uint32_t count_ = 0;
+  float min_ = 0.0F;
+  float max_ = 0.0F;
+  // 平均と偏差の二乗和は double で持つ（float では数百万件を超えると 1 件の寄与が丸めで消える）
+  double mean_ = 0.0;
+  double m2_ = 0.0;
+};
+
+// P² 法による分位点の推定（Jain & Chlamtac）。5 つの目印の高さだけを持ち、
+// 目印の位置が理想の位置から 1 以上ずれたら放物線（だめなら直線）補間で高さを動かす。
+// 目印の理想の位置は件数から毎回求め、長時間でも増分の丸め誤差を溜めない
+class P2Quantile
+{
+ public:
+  explicit P2Quantile(float quantile) : p_(quantile) {}
+
+  void add(float x);
+  void reset() { *this = P2Quantile(p_); }
+
+  auto quantile() const -> float { return p_; }
+  auto count() const -> uint32_t { return count_; }
+  // 推定値（5 件未満なら手元の値の該当順位、0 件なら 0）
+  auto value() const -> float;
+
+ private:
+  static constexpr int MARKERS = 5;
+
+  auto desiredPosition(int marker) const -> float;
+  auto parabolic(int i, int d) const -> float;
+  auto linear(int i, int d) const -> float;
+
+  float p_;
+  uint32_t count_ = 0;
+  float height_[MARKERS] = {};
+  int32_t position_[MARKERS] = {};  // 0 始まりの順位
+};
+
+// ────────────────────── 走行統計 ──────────────────────
+// 取得タスクが換算したフィルタ前の全サンプルを出どころごとに集計する。
+//   ・最小・最大・平均・標準偏差と p1/p50/p99
+//   ・油圧×油温のヒストグラム（油圧サンプル 1 件を直前の油温の区間に数える。油圧の取得間隔ごとの滞在時間）
+// エラー表示になる値（短絡・断線）は数えない。全体で約 2KB の固定領域に収まる。
+
+struct ChannelStats
+{
+  RunningStats moments;
+  P2Quantile p1{0.01F};
+  P2Quantile p50{0.50F};
+  P2Quantile p99{0.99F};
+
+  void add(float x);
+  void reset();
+};
+
+class PressureTempHistogram
+{
+ public:
+  static constexpr int PRESSURE_BINS = STATS_PRESSURE_BINS;
+  static constexpr int TEMP_BINS = STATS_OIL_TEMP_BINS;
+
+  void add(float pressureBar, float oilTempC);
+  void reset() { *this = PressureTempHistogram(); }
+
+  static auto pressureBin(float pressureBar) -> int;
+  static auto tempBin(float oilTempC) -> int;
+  auto count(int pressureBin, int tempBin) const -> uint32_t { return counts_[tempBin][pressureBin]; }
+  auto total() const -> uint32_t { return total_; }
+  auto maxCount() const -> uint32_t { return maxCount_; }
+
+ private:
+  uint32_t counts_[TEMP_BINS][PRESSURE_BINS] = {};
+  uint32_t total_ = 0;
+  uint32_t maxCount_ = 0;
+};
+
+class SessionStats
+{
+ public:
+  // ADS1015 のチャンネルと換算済みの値（油圧は Q16 mbar、温度は 0.01℃）を 1 件加える
+  void addSensorSample(uint8_t adcChannel, int32_t value);
+  // 出どころと物理量で 1 件加える
+  void add(GaugeSource source, float value);
+  void reset();
+
+  auto channel(GaugeSource source) const -> const ChannelStats & { return channels_[static_cast<size_t>(source)]; }
+  auto histogram() const -> const PressureTempHistogram & { return histogram_; }
+  // 出どころごとの表とヒストグラムを halLogf で出力する
+  void dump() const;
+
+ private:
+  ChannelStats channels_[GAUGE_SOURCE_COUNT];
+  PressureTempHistogram histogram_;
+  float lastOilTemp_ = 0.0F;
+  bool hasOilTemp_ = false;
+};
+
+// ────────────────────── コア間の受け渡し ──────────────────────
+// 取得タスク（コア0）だけが live を更新し、STATS_PUBLISH_SAMPLES 件ごとに公開用の写しへコピーする。
+// 写しはシーケンスロックで守り、描画側（コア1）はコピーしている間に書き換えがあれば読み直すので、
+// 更新途中の Welford / P² の状態を読むことはない。取得タスクは描画側を待たない。
+class SharedSessionStats
+{
+ public:
+  // 取得タスク側。1 件加え、件数が溜まっていれば写しを更新する
+  void addSensorSample(uint8_t adcChannel, int32_t value);
+  // どちらの側からでもよい。次に取得タスクが 1 件加えるときに集計を消す
+  void requestReset() { resetRequested_.store(true, std::memory_order_release); }
+
+  // 描画側。最新の写しを out へコピーする（書き換えが続いて読めなければ false で out は不定）
+  auto readSnapshot(SessionStats &out) const -> bool;
+  // 描画側。最新の写しを halLogf で出力する
+  void dumpSnapshot() const;
+
+ private:
+  static constexpr int READ_ATTEMPTS = 4;
+
+  void publish();
+
+  SessionStats live_;
+  SessionStats snapshot_;
+  uint32_t unpublished_ = 0;
+  std::atomic<uint32_t> sequence_{0};  // 奇数の間は写しを書き換え中
+  std::atomic<bool> resetRequested_{false};
+};
+
+// 取得タスクが更新し、統計ページとシリアル出力は写しを読む
+auto sessionStats() -> SharedSessionStats &;
+
+#endif  // SESSION_STATS_H
@@ -0,0 +1,335 @@
+#ifndef SIGNAL_FILTERS_H
+#define SIGNAL_FILTERS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cmath>
+#include <limits>
+
+#include "config.h"
+
+// ────────────────────── 整数の信号処理 ──────────────────────
+// 取得から平滑化までを整数だけで行い、浮動小数点への変換は表示の直前に限る。
+// 値の単位は呼び出し側が決める（油圧は Q16 mbar、温度は 0.01℃）。
+// どのフィルタもサンプルごとの処理量は窓長で決まる上限を超えず、ヒープを使わない。
+
+// 直近 N 件の移動和。追加ごとに最古の値を引くので平均は O(1) で得られる
+template <typename T, size_t N>
+class MovingSum
+{
+  static_assert(N > 0, "window must not be empty");
+
+ public:
+  // fillOnFirst = true なら最初の値で窓全体を埋め、起動直後の平均を 0 に引きずらせない
+  explicit MovingSum(bool fillOnFirst = false) : fillOnFirst_(fillOnFirst) {}
+
+  void push(T value)
+  {
+    if (fillOnFirst_ && !filled_)
+    {
+      for (T &v : values_) v = value;
+      sum_ = static_cast<int64_t>(value) * static_cast<int64_t>(N);
+      index_ = 1 % N;
+      filled_ = true;
+      return;
+    }
+    sum_ += static_cast<int64_t>(value) - values_[index_];
+    values_[index_] = value;
+    index_ = (index_ + 1) % N;
+    filled_ = true;
+  }
+
+  // 次の値から窓を作り直す
+  void reset()
+  {
+    sum_ = 0;
+    index_ = 0;
+    filled_ = false;
+    for (T &v : values_) v = 0;
+  }
+
+  auto sum() const -> int64_t { return sum_; }
+  // 0 方向ではなく最近接へ丸めた平均
+  auto average() const -> T
+  {
+    int64_t half = (sum_ >= 0) ? static_cast<int64_t>(N / 2) : -static_cast<int64_t>(N / 2);
+    return static_cast<T>((sum_ + half) / static_cast<int64_t>(N));
+  }
+
+ private:
+  T values_[N] = {};
+  int64_t sum_ = 0;
+  size_t index_ = 0;
+  bool fillOnFirst_;
+  bool filled_ = false;
+};
+
+// 係数 alpha (Q16) の指数移動平均。内部は 16bit の小数部を持ち、小さな差でも収束しきる
+class FixedEma
+{
+ public:
+  static constexpr int FRACTION_BITS = 16;
+
+  explicit constexpr FixedEma(uint32_t alphaQ16) : alphaQ16_(alphaQ16) {}
+
+  // 最初の値はそのまま採用する
+  auto update(int32_t target) -> int32_t
+  {
+    int64_t scaled = static_cast<int64_t>(target) * (int64_t{1} << FRACTION_BITS);
+    if (!initialized_)
+    {
+      state_ = scaled;
+      initialized_ = true;
+    }
+    else
+    {
+      state_ += ((scaled - state_) * static_cast<int64_t>(alphaQ16_)) / (int64_t{1} << 16);
+    }
+    return value();
+  }
+
+  auto value() const -> int32_t
+  {
+    return static_cast<int32_t>((state_ + (int64_t{1} << (FRACTION_BITS - 1))) >> FRACTION_BITS);
+  }
+  auto initialized() const -> bool { return initialized_; }
+  // 次の値をそのまま採用し直す
+  void reset() { initialized_ = false; }
+
+ private:
+  uint32_t alphaQ16_;
+  int64_t state_ = 0;
+  bool initialized_ = false;
+};
+
+// 0〜1 の係数を Q16 へ（コンパイル時に使う）
+constexpr auto alphaToQ16(float alpha) -> uint32_t { return static_cast<uint32_t>(alpha * 65536.0F + 0.5F); }
+
+// 時定数 τ とサンプル周期から 1 次 IIR の係数を求める（起動時に 1 度だけ呼ぶ）
+inline auto singlePoleAlphaQ16(float timeConstantMs, float sampleRateHz) -> uint32_t
+{
+  if (timeConstantMs <= 0.0F || sampleRateHz <= 0.0F) return 1U << 16;
+  float periodMs = 1000.0F / sampleRateHz;
+  return alphaToQ16(1.0F - std::exp(-periodMs / timeConstantMs));
+}
+
+// 直近 N 件の中央値。挿入順のリングと整列済みの配列を並べて持ち、
+// 1 件ごとに最古の値を抜いて新しい値を差し込むので、更新は O(N)（比較・移動は高々 N 回）。
+// 小さな窓ではヒープ 2 本の O(log N) より速いが、窓を広げると線形に重くなるので MAX_WINDOW までに限る
+template <size_t N>
+class SlidingMedian
+{
+ public:
+  static constexpr size_t MAX_WINDOW = 16;
+  static_assert(N > 0, "window must not be empty");
+  static_assert(N <= MAX_WINDOW, "insertion is O(N); use a wider structure for long windows");
+
+  // 最初の値で窓を埋め、起動直後に 0 側へ引きずられないようにする
+  auto update(int32_t value) -> int32_t
+  {
+    if (!filled_)
+    {
+      for (size_t i = 0; i < N; ++i)
+      {
+        history_[i] = value;
+        sorted_[i] = value;
+      }
+      filled_ = true;
+      return value;
+    }
+
+    int32_t oldest = history_[index_];
+    history_[index_] = value;
+    index_ = (index_ + 1) % N;
+
+    // 最古の値の位置に新しい値を置き、整列が崩れた向きへ隣と入れ替えていく
+    size_t pos = 0;
+    while (sorted_[pos] != oldest) ++pos;
+    sorted_[pos] = value;
+    while (pos > 0 && sorted_[pos - 1] > sorted_[pos])
+    {
+      int32_t tmp = sorted_[pos - 1];
+      sorted_[pos - 1] = sorted_[pos];
+      sorted_[pos] = tmp;
+      --pos;
+    }
+    while (pos + 1 < N && sorted_[pos + 1] < sorted_[pos])
+    {
+      int32_t tmp = sorted_[pos + 1];
+      sorted_[pos + 1] = sorted_[pos];
+      sorted_[pos] = tmp;
+      ++pos;
+    }
+    return middle();
+  }
+
+  auto value() const -> int32_t { return middle(); }
+  // 次の値で窓を埋め直す
+  void reset()
+  {
+    index_ = 0;
+    filled_ = false;
+  }
+
+ private:
+  // 偶数長は中央 2 件の平均
+  auto middle() const -> int32_t
+  {
+    if (N % 2 == 1) return sorted_[N / 2];
+    return static_cast<int32_t>((static_cast<int64_t>(sorted_[N / 2 - 1]) + sorted_[N / 2]) / 2);
+  }
+
+  int32_t history_[N] = {};
+  int32_t sorted_[N] = {};
+  size_t index_ = 0;
+  bool filled_ = false;
+};
+
+// 2 次バターワース低域通過（RBJ の双一次変換）。係数は Q28、直接形 I で積和は int64 で行う。
+// 入力が Q16 mbar（最大約 1e9）でも積和は 2^62 未満に収まる
+class BiquadLowPass
+{
+ public:
+  static constexpr int COEFF_BITS = 28;
+
+  // 係数の計算だけ浮動小数点を使う（起動時に 1 度だけ）。
+  // 分子は丸めた分母から決め、直流ゲインをちょうど 1 にする
+  BiquadLowPass(float cutoffHz, float sampleRateHz)
+  {
+    if (cutoffHz <= 0.0F || sampleRateHz <= 0.0F) return;
+    // ナイキスト周波数に近すぎる指定は手前に丸める
+    double normalized = std::fmin(static_cast<double>(cutoffHz) / sampleRateHz, 0.45);
+    double omega = 2.0 * M_PI * normalized;
+    double alpha = std::sin(omega) / (2.0 * M_SQRT1_2);
+    double cosw = std::cos(omega);
+    double scale = static_cast<double>(int64_t{1} << COEFF_BITS) / (1.0 + alpha);
+    a1_ = std::llround(-2.0 * cosw * scale);
+    a2_ = std::llround((1.0 - alpha) * scale);
+    // 1 + a1 + a2 が 4 で割り切れるよう a2 を最下位で詰め、b0 + b1 + b2 と厳密に一致させる
+    a2_ -= ((int64_t{1} << COEFF_BITS) + a1_ + a2_) % 4;
+    b0_ = ((int64_t{1} << COEFF_BITS) + a1_ + a2_) / 4;
+    b1_ = b0_ * 2;
+    b2_ = b0_;
+  }
+
+  // 最初の値で定常状態から始める
+  auto update(int32_t value) -> int32_t
+  {
+    if (!initialized_)
+    {
+      x1_ = x2_ = y1_ = y2_ = value;
+      initialized_ = true;
+      return value;
+    }
+    // 切り捨てた端数を次の積和へ持ち越し、低い遮断周波数でも直流の不感帯を作らない
+    int64_t acc = b0_ * value + b1_ * x1_ + b2_ * x2_ - a1_ * y1_ - a2_ * y2_ + error_;
+    auto y = static_cast<int32_t>(acc >> COEFF_BITS);
+    error_ = acc - (static_cast<int64_t>(y) << COEFF_BITS);
+    x2_ = x1_;
+    x1_ = value;
+    y2_ = y1_;
+    y1_ = y;
+    return y;
+  }
+
+  auto value() const -> int32_t { return y1_; }
+  // 次の値で定常状態から始め直す
+  void reset()
+  {
+    error_ = 0;
+    initialized_ = false;
+  }
+
+ private:
+  int64_t b0_ = int64_t{1} << COEFF_BITS;  // 未設定なら素通し
+  int64_t b1_ = 0;
+  int64_t b2_ = 0;
+  int64_t a1_ = 0;
+  int64_t a2_ = 0;
+  int64_t x1_ = 0;
+  int64_t x2_ = 0;
+  int64_t y1_ = 0;
+  int64_t y2_ = 0;
+  int64_t error_ = 0;
+  bool initialized_ = false;
+};
+
+// ────────────────────── チャンネルごとのフィルタ ──────────────────────
+// config.h の ChannelFilterConfig に従い「前段（平均/中央値）→後段（平滑化）」を通す。
+// 窓長はテンプレート引数で固定し、種類の分岐は 1 サンプルにつき各段 1 回だけ。
+// faultValue 以上の値（サーミスタ断線の印など）はどの段にも通さずそのまま返す。
+// 正常な値に戻ったら各段をその値から起こし直すので、印が平均や中央値の窓に混ざった値は出てこない
+template <size_t WINDOW>
+class ChannelFilter
+{
+ public:
+  ChannelFilter(const ChannelFilterConfig &config, float sampleRateHz,
+                int32_t faultValue = std::numeric_limits<int32_t>::max())
+      : faultValue_(faultValue),
+        prefilter_(config.prefilter),
+        smoothing_(config.smoothing),
+        average_(true),
+        singlePole_(singlePoleAlphaQ16(config.timeConstantMs, sampleRateHz)),
+        biquad_(config.cutoffHz, sampleRateHz)
+  {
+  }
+
+  auto update(int32_t value) -> int32_t
+  {
+    if (value >= faultValue_)
+    {
+      faulted_ = true;
+      value_ = value;
+      return value;
+    }
+    if (faulted_)
+    {
+      faulted_ = false;
+      average_.reset();
+      median_.reset();
+      singlePole_.reset();
+      biquad_.reset();
+    }
+    switch (prefilter_)
+    {
+      case FilterKind::MovingAverage:
+        average_.push(value);
+        value = average_.average();
+        break;
+      case FilterKind::Median:
+        value = median_.update(value);
+        break;
+      default:
+        break;
+    }
+    switch (smoothing_)
+    {
+      case FilterKind::SinglePole:
+        value = singlePole_.update(value);
+        break;
+      case FilterKind::BiquadLowPass:
+        value = biquad_.update(value);
+        break;
+      default:
+        break;
+    }
+    value_ = value;
+    return value;
+  }
+
+  auto value() const -> int32_t { return value_; }
+
+ private:
+  int32_t faultValue_;
+  bool faulted_ = false;
+  FilterKind prefilter_;
+  FilterKind smoothing_;
+  MovingSum<int32_t, WINDOW> average_;
+  SlidingMedian<WINDOW> median_;
+  FixedEma singlePole_;
+  BiquadLowPass biquad_;
+  int32_t value_ = 0;
+};
+
+#endif  // SIGNAL_FILTERS_H
@@ -0,0 +1,66 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+// ────────────────────── 単一生産者・単一消費者リング ──────────────────────
+// push はセンサタスク、pop は描画ループのみから呼ぶ前提でロックを持たない。
+// N は 2 のべき乗とし、インデックスは単調増加させてマスクで位置を求める。
+template <typename T, size_t N>
+class SpscRing
+{
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of two");
+
+ public:
+  // 満杯なら書き込まずに false を返す（生産者側）
+  auto push(const T &item) -> bool
+  {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) >= N)
+    {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    buffer_[head & MASK] = item;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // 空なら false を返す（消費者側）
+  auto pop(T &item) -> bool
+  {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire))
+    {
+      return false;
+    }
+    item = buffer_[tail & MASK];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  auto size() const -> size_t
+  {
+    // tail を先に読めば head との差が負になることはない
+    size_t tail = tail_.load(std::memory_order_acquire);
+    return head_.load(std::memory_order_acquire) - tail;
+  }
+  auto empty() const -> bool { return size() == 0; }
+  static constexpr auto capacity() -> size_t { return N; }
+  auto droppedCount() const -> uint32_t { return dropped_.load(std::memory_order_relaxed); }
+
+ private:
+  static constexpr size_t MASK = N - 1;
+  // 生産者と消費者のインデックスを別キャッシュラインに置く
+  static constexpr size_t CACHE_LINE = 64;
+
+  alignas(CACHE_LINE) std::atomic<size_t> head_{0};
+  std::atomic<uint32_t> dropped_{0};
+  alignas(CACHE_LINE) std::atomic<size_t> tail_{0};
+  alignas(CACHE_LINE) T buffer_[N];
+};
+
+#endif  // SPSC_RING_H
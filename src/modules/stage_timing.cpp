@@ -0,0 +1,55 @@
+#include "stage_timing.h"
+
+// ────────────────────── ヒストグラム ──────────────────────
+auto LogHistogram::percentile(float percent) const -> uint32_t
+{
+  if (count_ == 0)
+  {
+    return 0;
+  }
+  // 順位 ceil(count * percent / 100) のサンプルが入るバケットを探す
+  uint32_t rank = static_cast<uint32_t>(static_cast<float>(count_) * percent / 100.0F + 0.999F);
+  if (rank == 0) rank = 1;
+  uint32_t seen = 0;
+  for (size_t i = 0; i < BUCKETS; ++i)
+  {
+    seen += counts_[i];
+    if (seen >= rank)
+    {
+      uint32_t upper = (i + 1 < BUCKETS) ? bucketLowerBound(i + 1) - 1 : max_;
+      return (upper < max_) ? upper : max_;
+    }
+  }
+  return max_;
+}
+
+// ────────────────────── 区間ごとの集計 ──────────────────────
+static LogHistogram stageHistograms[TIMING_STAGE_COUNT];
+
+auto stageHistogram(TimingStage stage) -> LogHistogram & { return stageHistograms[static_cast<size_t>(stage)]; }
+
+auto stageName(TimingStage stage) -> const char *
+{
+  static const char *const NAMES[TIMING_STAGE_COUNT] = {"acquire", "oil_bar", "pressure", "water", "push", "frame"};
+  return NAMES[static_cast<size_t>(stage)];
+}
+
+void resetStageTimings()
+{
+  for (LogHistogram &histogram : stageHistograms)
+  {
+    histogram.reset();
+  }
+}
+
+void dumpStageTimings()
+{
+  halLogf("stage       count     p50us   p99us   maxus\n");
+  for (size_t i = 0; i < TIMING_STAGE_COUNT; ++i)
+  {
+    const LogHistogram &h = stageHistograms[i];
+    halLogf("%-10s %7lu %8lu %7lu %7lu\n", stageName(static_cast<TimingStage>(i)), static_cast<unsigned long>(h.count()),
+            static_cast<unsigned long>(h.percentile(50.0F)), static_cast<unsigned long>(h.percentile(99.0F)),
+            static_cast<unsigned long>(h.max()));
+  }
+}
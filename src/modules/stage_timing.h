@@ -0,0 +1,97 @@
+#ifndef STAGE_TIMING_H
+#define STAGE_TIMING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hal/hal.h"
+
+// ────────────────────── 対数バケットのヒストグラム ──────────────────────
+// 0〜7us はそのまま、それ以上は 2 倍ごとの区間を 8 分割したバケットで数える。
+// 相対誤差は 12.5% 以内で、約 67 秒までを固定 768B で保持する。
+class LogHistogram
+{
+ public:
+  static constexpr int SUB_BUCKET_BITS = 3;
+  static constexpr uint32_t SUB_BUCKETS = 1U << SUB_BUCKET_BITS;
+  static constexpr int MAX_MSB = 25;
+  static constexpr size_t BUCKETS = (MAX_MSB - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+  void record(uint32_t valueUs)
+  {
+    counts_[bucketIndex(valueUs)]++;
+    count_++;
+    if (valueUs > max_) max_ = valueUs;
+  }
+
+  void reset()
+  {
+    for (uint32_t &c : counts_) c = 0;
+    count_ = 0;
+    max_ = 0;
+  }
+
+  auto count() const -> uint32_t { return count_; }
+  auto max() const -> uint32_t { return max_; }
+  // percent [%] 以下に収まる値の上限（バケットの上端、ただし最大値を超えない）
+  auto percentile(float percent) const -> uint32_t;
+
+  static auto bucketIndex(uint32_t value) -> size_t
+  {
+    if (value < SUB_BUCKETS) return value;
+    int msb = 31 - __builtin_clz(value);
+    if (msb > MAX_MSB) return BUCKETS - 1;
+    uint32_t sub = (value >> (msb - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+    return (msb - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+  }
+  static auto bucketLowerBound(size_t index) -> uint32_t
+  {
+    if (index < SUB_BUCKETS) return static_cast<uint32_t>(index);
+    int msb = static_cast<int>(index / SUB_BUCKETS) + SUB_BUCKET_BITS - 1;
+    uint32_t sub = index % SUB_BUCKETS;
+    return (SUB_BUCKETS + sub) << (msb - SUB_BUCKET_BITS);
+  }
+
+ private:
+  uint32_t counts_[BUCKETS] = {};
+  uint32_t count_ = 0;
+  uint32_t max_ = 0;
+};
+
+// ────────────────────── 区間計測 ──────────────────────
+enum class TimingStage : uint8_t
+{
+  Acquire,        // acquireSensorData()（センサタスク）
+  OilTopBar,      // 油温の横バー
+  PressureGauge,  // 油圧の円弧メーター
+  WaterGauge,     // 水温の円弧メーター
+  Push,           // 転送（DMA 起動・フェンス待ち込み）
+  Frame,          // updateGauges() 全体
+  Count
+};
+
+constexpr size_t TIMING_STAGE_COUNT = static_cast<size_t>(TimingStage::Count);
+
+auto stageHistogram(TimingStage stage) -> LogHistogram &;
+auto stageName(TimingStage stage) -> const char *;
+void resetStageTimings();
+// 全区間の回数・p50・p99・最大を halLogf で出力する
+void dumpStageTimings();
+
+// スコープの開始から終了までの時間 [us] を区間のヒストグラムへ記録する。
+// 1 つのヒストグラムには 1 つのタスクからしか記録しない（Acquire はセンサタスク、他は描画ループ）
+class ScopedStageTimer
+{
+ public:
+  explicit ScopedStageTimer(TimingStage stage) : histogram_(stageHistogram(stage)), startUs_(halMicros()) {}
+  ~ScopedStageTimer() { histogram_.record(halMicros() - startUs_); }
+
+  ScopedStageTimer(const ScopedStageTimer &) = delete;
+  auto operator=(const ScopedStageTimer &) -> ScopedStageTimer & = delete;
+
+ private:
+  LogHistogram &histogram_;
+  uint32_t startUs_;
+};
+
+#endif  // STAGE_TIMING_H
@@ -0,0 +1,354 @@
+#include "telemetry.h"
+
+#include <cstring>
+
+// ────────────────────── CRC16 ──────────────────────
+struct Crc16Table
+{
+  uint16_t entry[256];
+};
+
+// CRC-16/CCITT-FALSE の 1 バイト分の表をコンパイル時に作る
+constexpr auto makeCrc16Table() -> Crc16Table
+{
+  Crc16Table table = {};
+  for (unsigned byte = 0; byte < 256; ++byte)
+  {
+    uint16_t crc = static_cast<uint16_t>(byte << 8);
+    for (int bit = 0; bit < 8; ++bit)
+    {
+      crc = static_cast<uint16_t>((crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1);
+    }
+    table.entry[byte] = crc;
+  }
+  return table;
+}
+
+static constexpr Crc16Table CRC16_TABLE = makeCrc16Table();
+
+auto telemetryCrc16(const uint8_t *data, size_t length) -> uint16_t
+{
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < length; ++i)
+  {
+    crc = static_cast<uint16_t>((crc << 8) ^ CRC16_TABLE.entry[((crc >> 8) ^ data[i]) & 0xFF]);
+  }
+  return crc;
+}
+
+// ────────────────────── COBS ──────────────────────
+auto cobsEncode(const uint8_t *in, size_t length, uint8_t *out) -> size_t
+{
+  size_t codeIndex = 0;
+  size_t write = 1;
+  uint8_t code = 1;
+  for (size_t read = 0; read < length; ++read)
+  {
+    if (in[read] == 0)
+    {
+      out[codeIndex] = code;
+      code = 1;
+      codeIndex = write++;
+      continue;
+    }
+    out[write++] = in[read];
+    // 0 を含まない 254B ごとにブロックを閉じる
+    if (++code == 0xFF)
+    {
+      out[codeIndex] = code;
+      code = 1;
+      codeIndex = write++;
+    }
+  }
+  out[codeIndex] = code;
+  return write;
+}
+
+auto cobsDecode(const uint8_t *in, size_t length, uint8_t *out, size_t &outLength) -> bool
+{
+  size_t read = 0;
+  size_t write = 0;
+  while (read < length)
+  {
+    uint8_t code = in[read];
+    if (code == 0 || read + code > length)
+    {
+      return false;
+    }
+    read++;
+    for (uint8_t i = 1; i < code; ++i)
+    {
+      if (in[read] == 0)
+      {
+        return false;
+      }
+      out[write++] = in[read++];
+    }
+    // 最大長のブロックと末尾のブロックの後ろには 0 を戻さない
+    if (code != 0xFF && read != length)
+    {
+      out[write++] = 0;
+    }
+  }
+  outLength = write;
+  return true;
+}
+
+// ────────────────────── バイト列の読み書き ──────────────────────
+static void putU16(uint8_t *out, uint16_t value)
+{
+  out[0] = static_cast<uint8_t>(value);
+  out[1] = static_cast<uint8_t>(value >> 8);
+}
+
+static void putU32(uint8_t *out, uint32_t value)
+{
+  putU16(out, static_cast<uint16_t>(value));
+  putU16(out + 2, static_cast<uint16_t>(value >> 16));
+}
+
+static auto getU16(const uint8_t *in) -> uint16_t
+{
+  return static_cast<uint16_t>(in[0] | (in[1] << 8));
+}
+
+static auto getU32(const uint8_t *in) -> uint32_t
+{
+  return getU16(in) | (static_cast<uint32_t>(getU16(in + 2)) << 16);
+}
+
+// ────────────────────── 送信 ──────────────────────
+auto TelemetryEncoder::sample(const TelemetrySample &sample) -> bool
+{
+  uint8_t body[TELEMETRY_SAMPLE_BODY_SIZE];
+  putU32(body, sample.timestampUs);
+  body[4] = sample.channel;
+  putU16(body + 5, static_cast<uint16_t>(sample.raw));
+  putU32(body + 7, static_cast<uint32_t>(sample.value));
+  return enqueue(TelemetryType::Sample, body, sizeof(body));
+}
+
+auto TelemetryEncoder::frame(const TelemetryFrame &frame) -> bool
+{
+  uint8_t body[TELEMETRY_FRAME_BODY_SIZE];
+  putU32(body, frame.index);
+  putU32(body + 4, frame.startUs);
+  putU32(body + 8, frame.frameUs);
+  putU32(body + 12, frame.fenceWaitUs);
+  putU32(body + 16, frame.pushBytes);
+  return enqueue(TelemetryType::Frame, body, sizeof(body));
+}
+
+auto TelemetryEncoder::enqueue(TelemetryType type, const uint8_t *body, size_t length) -> bool
+{
+  uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+  payload[0] = static_cast<uint8_t>(type);
+  putU16(payload + 1, sequence_++);
+  std::memcpy(payload + TELEMETRY_HEADER_SIZE, body, length);
+  size_t payloadLength = TELEMETRY_HEADER_SIZE + length;
+  putU16(payload + payloadLength, telemetryCrc16(payload, payloadLength));
+  payloadLength += TELEMETRY_CRC_SIZE;
+
+  // 送り始めは区切りを先に置き、受信側が最初のレコードから同期できるようにする
+  uint8_t frame[TELEMETRY_MAX_FRAME + 1];
+  size_t frameLength = 0;
+  if (recordCount_ == 0 && droppedCount_ == 0)
+  {
+    frame[frameLength++] = 0;
+  }
+  frameLength += cobsEncode(payload, payloadLength, frame + frameLength);
+  frame[frameLength++] = 0;
+
+  if (TELEMETRY_TX_RING_CAPACITY - queuedBytes() < frameLength)
+  {
+    droppedCount_++;
+    return false;
+  }
+  for (size_t i = 0; i < frameLength; ++i)
+  {
+    ring_[(head_ + i) & (TELEMETRY_TX_RING_CAPACITY - 1)] = frame[i];
+  }
+  head_ += frameLength;
+  recordCount_++;
+  if (queuedBytes() > ringHighWater_)
+  {
+    ringHighWater_ = queuedBytes();
+  }
+  return true;
+}
+
+auto TelemetryEncoder::service() -> size_t
+{
+  size_t sent = 0;
+  while (head_ != tail_)
+  {
+    // 折り返し位置で 2 回に分け、連続した領域だけをポートへ渡す
+    size_t offset = tail_ & (TELEMETRY_TX_RING_CAPACITY - 1);
+    size_t chunk = TELEMETRY_TX_RING_CAPACITY - offset;
+    if (chunk > queuedBytes())
+    {
+      chunk = queuedBytes();
+    }
+    size_t written = port_.write(ring_ + offset, chunk);
+    tail_ += written;
+    sent += written;
+    if (written < chunk)
+    {
+      break;
+    }
+  }
+  bytesSent_ += static_cast<uint32_t>(sent);
+  return sent;
+}
+
+void TelemetryEncoder::reset()
+{
+  head_ = 0;
+  tail_ = 0;
+  sequence_ = 0;
+  recordCount_ = 0;
+  droppedCount_ = 0;
+  bytesSent_ = 0;
+  ringHighWater_ = 0;
+}
+
+// ────────────────────── 受信 ──────────────────────
+auto TelemetryDecoder::push(uint8_t byte, TelemetryRecord &record) -> bool
+{
+  if (byte != 0)
+  {
+    if (!synced_)
+    {
+      return false;
+    }
+    if (fill_ >= sizeof(frame_))
+    {
+      overflow_ = true;
+      return false;
+    }
+    frame_[fill_++] = byte;
+    return false;
+  }
+
+  // 区切りでフレームを閉じる。連続した区切り（空のフレーム）は読み飛ばす
+  bool complete = false;
+  if (!synced_)
+  {
+    synced_ = true;
+  }
+  else if (overflow_)
+  {
+    framingErrorCount_++;
+  }
+  else if (fill_ > 0)
+  {
+    complete = parse(fill_, record);
+  }
+  fill_ = 0;
+  overflow_ = false;
+  return complete;
+}
+
+auto TelemetryDecoder::parse(size_t length, TelemetryRecord &record) -> bool
+{
+  size_t payloadLength = 0;
+  if (!cobsDecode(frame_, length, payload_, payloadLength) ||
+      payloadLength < TELEMETRY_HEADER_SIZE + TELEMETRY_CRC_SIZE)
+  {
+    framingErrorCount_++;
+    return false;
+  }
+  size_t crcOffset = payloadLength - TELEMETRY_CRC_SIZE;
+  if (telemetryCrc16(payload_, crcOffset) != getU16(payload_ + crcOffset))
+  {
+    crcErrorCount_++;
+    return false;
+  }
+
+  const uint8_t *body = payload_ + TELEMETRY_HEADER_SIZE;
+  size_t bodyLength = crcOffset - TELEMETRY_HEADER_SIZE;
+  record.type = static_cast<TelemetryType>(payload_[0]);
+  record.sequence = getU16(payload_ + 1);
+  if (record.type == TelemetryType::Sample && bodyLength == TELEMETRY_SAMPLE_BODY_SIZE)
+  {
+    record.sample.timestampUs = getU32(body);
+    record.sample.channel = body[4];
+    record.sample.raw = static_cast<int16_t>(getU16(body + 5));
+    record.sample.value = static_cast<int32_t>(getU32(body + 7));
+  }
+  else if (record.type == TelemetryType::Frame && bodyLength == TELEMETRY_FRAME_BODY_SIZE)
+  {
+    record.frame.index = getU32(body);
+    record.frame.startUs = getU32(body + 4);
+    record.frame.frameUs = getU32(body + 8);
+    record.frame.fenceWaitUs = getU32(body + 12);
+    record.frame.pushBytes = getU32(body + 16);
+  }
+  else
+  {
+    framingErrorCount_++;
+    return false;
+  }
+
+  // 通番は 16bit で折り返すので差分で欠落を数える
+  if (haveSequence_)
+  {
+    lostCount_ += static_cast<uint16_t>(record.sequence - nextSequence_);
+  }
+  haveSequence_ = true;
+  nextSequence_ = static_cast<uint16_t>(record.sequence + 1);
+  recordCount_++;
+  return true;
+}
+
+void TelemetryDecoder::reset() { *this = TelemetryDecoder(); }
+
+// ────────────────────── 送信の窓口 ──────────────────────
+static TelemetryEncoder telemetryEncoder(halTelemetryPort());
+static bool telemetryOn = false;
+
+void beginTelemetry()
+{
+  if (!TELEMETRY_ENABLED)
+  {
+    return;
+  }
+  setTelemetryActive(true);
+}
+
+void setTelemetryActive(bool active)
+{
+  if (active && !telemetryOn)
+  {
+    telemetryEncoder.reset();
+  }
+  telemetryOn = active;
+}
+
+auto telemetryActive() -> bool { return telemetryOn; }
+
+void sendTelemetrySample(const TelemetrySample &sample)
+{
+  if (telemetryOn)
+  {
+    telemetryEncoder.sample(sample);
+  }
+}
+
+void sendTelemetryFrame(const TelemetryFrame &frame)
+{
+  if (telemetryOn)
+  {
+    telemetryEncoder.frame(frame);
+  }
+}
+
+void serviceTelemetry()
+{
+  if (telemetryOn)
+  {
+    telemetryEncoder.service();
+  }
+}
+
+auto telemetry() -> TelemetryEncoder & { return telemetryEncoder; }
@@ -0,0 +1,150 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "hal/hal_telemetry.h"
+
+// ────────────────────── テレメトリのフレーム形式 ──────────────────────
+// 1 レコードは [種別 1B][通番 2B][本体][CRC16 2B] をリトルエンディアンで並べたもの。
+// これを COBS で 0x00 を含まない列にし、区切りの 0x00 を付けて送る。
+// CRC は種別から本体までの CRC-16/CCITT-FALSE（多項式 0x1021、初期値 0xFFFF）。
+// 受信側は 0x00 ごとに区切って復号するので、途中から読み始めても次の区切りで同期できる。
+// 通番はレコードごとに 1 ずつ進む。送信リングが一杯で捨てたレコードも番号を消費するので、
+// 受信側は通番の飛びから欠落数を数えられる。
+
+enum class TelemetryType : uint8_t
+{
+  Sample = 1,  // 生サンプル 1 件
+  Frame = 2    // 描画 1 フレームの所要時間
+};
+
+// 本体 11B: 時刻 u32, チャンネル u8, 生コード i16, 換算値 i32
+struct TelemetrySample
+{
+  uint32_t timestampUs;
+  uint8_t channel;
+  int16_t raw;    // ADS1015 の 12bit 符号付きコード
+  int32_t value;  // 換算・フィルタ済みの値（油圧は Q16 mbar、温度は 0.01℃）
+};
+
+// 本体 20B: すべて u32
+struct TelemetryFrame
+{
+  uint32_t index;
+  uint32_t startUs;      // updateGauges() の開始時刻
+  uint32_t frameUs;      // updateGauges() 全体の所要時間
+  uint32_t fenceWaitUs;  // 前フレームの転送完了待ち（転送しなかったフレームは 0）
+  uint32_t pushBytes;    // このフレームで LCD へ送ったバイト数
+};
+
+constexpr size_t TELEMETRY_HEADER_SIZE = 3;
+constexpr size_t TELEMETRY_CRC_SIZE = 2;
+constexpr size_t TELEMETRY_SAMPLE_BODY_SIZE = 11;
+constexpr size_t TELEMETRY_FRAME_BODY_SIZE = 20;
+constexpr size_t TELEMETRY_MAX_PAYLOAD = TELEMETRY_HEADER_SIZE + TELEMETRY_FRAME_BODY_SIZE + TELEMETRY_CRC_SIZE;
+// COBS の符号化後の最大長（区切りの 0x00 を含む）
+constexpr size_t TELEMETRY_MAX_FRAME = TELEMETRY_MAX_PAYLOAD + TELEMETRY_MAX_PAYLOAD / 254 + 2;
+static_assert((TELEMETRY_TX_RING_CAPACITY & (TELEMETRY_TX_RING_CAPACITY - 1)) == 0,
+              "telemetry ring capacity must be a power of two");
+
+auto telemetryCrc16(const uint8_t *data, size_t length) -> uint16_t;
+// COBS 符号化。out には length + length / 254 + 1 バイト必要。区切りの 0x00 は付けない
+auto cobsEncode(const uint8_t *in, size_t length, uint8_t *out) -> size_t;
+// COBS 復号。out には length バイト必要。符号列の途中に 0x00 がある・長さが合わないなら false
+auto cobsDecode(const uint8_t *in, size_t length, uint8_t *out, size_t &outLength) -> bool;
+
+// ────────────────────── 送信 ──────────────────────
+// sample() / frame() はレコードを符号化して送信リングへ積むだけで戻る。
+// service() はポートが今受け付けられる分だけを送り、USB の転送完了は待たない。
+// リングに 1 フレーム分の空きが無ければそのレコードを捨てる（書きかけのフレームは積まない）。
+// 積む側と送る側はどちらも描画ループから呼ぶ前提で、排他はしない。
+class TelemetryEncoder
+{
+ public:
+  explicit TelemetryEncoder(TelemetryPort &port) : port_(port) {}
+
+  auto sample(const TelemetrySample &sample) -> bool;
+  auto frame(const TelemetryFrame &frame) -> bool;
+  // 送ったバイト数を返す
+  auto service() -> size_t;
+  void reset();
+
+  auto queuedBytes() const -> size_t { return head_ - tail_; }
+  auto recordCount() const -> uint32_t { return recordCount_; }
+  // リングが一杯で捨てたレコード数
+  auto droppedCount() const -> uint32_t { return droppedCount_; }
+  auto bytesSent() const -> uint32_t { return bytesSent_; }
+  auto ringHighWater() const -> size_t { return ringHighWater_; }
+
+ private:
+  auto enqueue(TelemetryType type, const uint8_t *body, size_t length) -> bool;
+
+  TelemetryPort &port_;
+  uint8_t ring_[TELEMETRY_TX_RING_CAPACITY] = {};
+  // 折り返さずに増やし、添字は容量で丸める
+  size_t head_ = 0;
+  size_t tail_ = 0;
+  uint16_t sequence_ = 0;
+  uint32_t recordCount_ = 0;
+  uint32_t droppedCount_ = 0;
+  uint32_t bytesSent_ = 0;
+  size_t ringHighWater_ = 0;
+};
+
+// ────────────────────── 受信 ──────────────────────
+struct TelemetryRecord
+{
+  TelemetryType type;
+  uint16_t sequence;
+  TelemetrySample sample;  // type == Sample のときだけ有効
+  TelemetryFrame frame;    // type == Frame のときだけ有効
+};
+
+// 受信したバイト列を区切り・COBS・CRC の順に検査してレコードへ戻す。
+// 最初の区切りより前は途中から読んだフレームとみなし、エラーに数えずに捨てる。
+class TelemetryDecoder
+{
+ public:
+  // 1 バイト渡し、レコードが 1 件揃ったら record に入れて true を返す
+  auto push(uint8_t byte, TelemetryRecord &record) -> bool;
+  void reset();
+
+  auto recordCount() const -> uint32_t { return recordCount_; }
+  auto crcErrorCount() const -> uint32_t { return crcErrorCount_; }
+  // COBS の不正・長さ超過・未知の種別
+  auto framingErrorCount() const -> uint32_t { return framingErrorCount_; }
+  // 通番の飛びから数えた欠落レコード数
+  auto lostCount() const -> uint32_t { return lostCount_; }
+
+ private:
+  auto parse(size_t length, TelemetryRecord &record) -> bool;
+
+  uint8_t frame_[TELEMETRY_MAX_FRAME] = {};
+  uint8_t payload_[TELEMETRY_MAX_FRAME] = {};
+  size_t fill_ = 0;
+  bool synced_ = false;
+  bool overflow_ = false;
+  bool haveSequence_ = false;
+  uint16_t nextSequence_ = 0;
+  uint32_t recordCount_ = 0;
+  uint32_t crcErrorCount_ = 0;
+  uint32_t framingErrorCount_ = 0;
+  uint32_t lostCount_ = 0;
+};
+
+// ────────────────────── 送信の窓口 ──────────────────────
+// halTelemetryPort() へ送るエンコーダを有効にする（TELEMETRY_ENABLED でなければ何もしない）
+void beginTelemetry();
+// beginTelemetry() を経ずに有効・無効を切り替える（ホストの --telemetry やテスト用）
+void setTelemetryActive(bool active);
+auto telemetryActive() -> bool;
+// 無効時は何もしない
+void sendTelemetrySample(const TelemetrySample &sample);
+void sendTelemetryFrame(const TelemetryFrame &frame);
+void serviceTelemetry();
+auto telemetry() -> TelemetryEncoder &;
+
+#endif  // TELEMETRY_H
@@ -0,0 +1,93 @@
+#ifndef THERMISTOR_LUT_H
+#define THERMISTOR_LUT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sensor_conversion.h"
+
+// ────────────────────── サーミスタ換算テーブル ──────────────────────
+// ADS1015 の正のコード 0〜2047 を 0.01℃単位の温度へ対応付ける。
+// convertVoltageToTemp() と同じ β 式をコンパイル時に評価するため、
+// 実行時の換算は配列参照 1 回になる。constexpr の配列は .rodata (フラッシュ) に置かれる。
+
+constexpr size_t THERMISTOR_LUT_SIZE = 2048;
+// 断線・異常値を表す 200℃
+constexpr int16_t THERMISTOR_DISCONNECT_CENTI = 20000;
+
+namespace thermistor_lut_detail
+{
+// std::log は constexpr でないため atanh 級数で自然対数を求める
+constexpr auto constexprLog(double x) -> double
+{
+  constexpr double LN2 = 0.69314718055994530942;
+  int exponent = 0;
+  while (x >= 2.0)
+  {
+    x /= 2.0;
+    ++exponent;
+  }
+  while (x < 1.0)
+  {
+    x *= 2.0;
+    --exponent;
+  }
+  // ln(m) = 2 * atanh((m - 1) / (m + 1))、m ∈ [1, 2) なら 30 項で倍精度に収束する
+  double y = (x - 1.0) / (x + 1.0);
+  double y2 = y * y;
+  double term = y;
+  double sum = 0.0;
+  for (int n = 1; n < 60; n += 2)
+  {
+    sum += term / n;
+    term *= y2;
+  }
+  return 2.0 * sum + exponent * LN2;
+}
+
+// convertVoltageToTemp(convertAdcToVoltage(code)) と同じ計算を 0.01℃単位で行う
+constexpr auto codeToCentiCelsius(int code) -> int16_t
+{
+  double voltage = (code * 6.144) / 2047.0 * CORRECTION_FACTOR;
+  if (voltage <= 0.0 || voltage >= SUPPLY_VOLTAGE)
+  {
+    return THERMISTOR_DISCONNECT_CENTI;
+  }
+  double resistance = SERIES_REFERENCE_RES * (voltage / (SUPPLY_VOLTAGE - voltage));
+  double kelvin = THERMISTOR_B_CONSTANT /
+                  (constexprLog(resistance / THERMISTOR_R25) + THERMISTOR_B_CONSTANT / ABSOLUTE_TEMPERATURE_25);
+  double celsius = kelvin - 273.16;
+  // 200℃以上は表示上すべて断線扱いなので int16 に収まるよう飽和させる
+  if (celsius >= 200.0)
+  {
+    return THERMISTOR_DISCONNECT_CENTI;
+  }
+  double centi = celsius * 100.0;
+  return static_cast<int16_t>(centi >= 0.0 ? centi + 0.5 : centi - 0.5);
+}
+}  // namespace thermistor_lut_detail
+
+struct ThermistorLut
+{
+  int16_t centiCelsius[THERMISTOR_LUT_SIZE];
+
+  constexpr ThermistorLut() : centiCelsius()
+  {
+    for (size_t code = 0; code < THERMISTOR_LUT_SIZE; ++code)
+    {
+      centiCelsius[code] = thermistor_lut_detail::codeToCentiCelsius(static_cast<int>(code));
+    }
+  }
+};
+
+inline constexpr ThermistorLut THERMISTOR_LUT{};
+
+// 生コードから 0.01℃単位の温度を得る（負のコードは断線扱い）
+inline auto lookupTemperatureCenti(int16_t rawAdc) -> int16_t
+{
+  return (rawAdc <= 0) ? THERMISTOR_DISCONNECT_CENTI : THERMISTOR_LUT.centiCelsius[rawAdc & (THERMISTOR_LUT_SIZE - 1)];
+}
+
+inline auto convertAdcToTemp(int16_t rawAdc) -> float { return lookupTemperatureCenti(rawAdc) * 0.01F; }
+
+#endif  // THERMISTOR_LUT_H
@@ -0,0 +1,389 @@
+#include <unity.h>
+
+#include "hal/hal.h"
+#include "hal/host/host_ads1015.h"
+#include "modules/ads_acquisition.h"
+
+constexpr uint8_t CH_PRESSURE = 2;
+constexpr uint8_t CH_WATER = 1;
+constexpr uint8_t CH_OIL = 0;
+
+static uint32_t nowUs = 0;
+
+// 仮想時計を合わせてから時刻を返す
+static auto at(uint32_t us) -> uint32_t
+{
+  hostClockSetUs(us);
+  return us;
+}
+
+void setUp()
+{
+  nowUs = 0;
+  hostClockSetUs(0);
+}
+
+// 変換時間が経過するまで結果を返さないこと
+void test_poll_waits_for_conversion_time()
+{
+  HostAds1015 ads;
+  ads.channelCode[CH_PRESSURE] = 700;
+  AdsAcquisition acq(ads);
+  acq.addChannel(CH_PRESSURE, 0, false);
+  TEST_ASSERT_TRUE(acq.begin());
+
+  AdsSample sample{};
+  TEST_ASSERT_FALSE(acq.poll(at(nowUs), sample));  // 変換開始
+  TEST_ASSERT_TRUE(acq.isConverting());
+
+  nowUs = 300;
+  TEST_ASSERT_FALSE(acq.poll(at(nowUs), sample));
+  // 変換時間前は I2C を読みに行かない
+  TEST_ASSERT_EQUAL_UINT32(0, ads.configReads);
+
+  nowUs = ADS1015_CONVERSION_TIME_US;
+  TEST_ASSERT_TRUE(acq.poll(at(nowUs), sample));
+  TEST_ASSERT_EQUAL_UINT8(CH_PRESSURE, sample.channel);
+  TEST_ASSERT_EQUAL_INT16(700, sample.raw);
+  TEST_ASSERT_EQUAL_UINT32(0, sample.timestampUs);
+  // 読出し直後に次の変換が始まっている
+  TEST_ASSERT_TRUE(acq.isConverting());
+  TEST_ASSERT_EQUAL_UINT32(2, ads.conversionsStarted);
+}
+
+// 変換が遅れた場合は OS ビットが立つまで待つこと
+void test_poll_rechecks_busy_converter()
+{
+  HostAds1015 ads;
+  ads.conversionTimeUs = ADS1015_CONVERSION_TIME_US + 100;
+  AdsAcquisition acq(ads);
+  acq.addChannel(CH_PRESSURE, 0, false);
+  acq.begin();
+
+  AdsSample sample{};
+  acq.poll(at(nowUs), sample);
+  nowUs = ADS1015_CONVERSION_TIME_US;
+  TEST_ASSERT_FALSE(acq.poll(at(nowUs), sample));
+  nowUs += 100;
+  TEST_ASSERT_TRUE(acq.poll(at(nowUs), sample));
+}
+
+// 負のコードが符号付きで復元されること
+void test_negative_code_is_sign_extended()
+{
+  HostAds1015 ads;
+  ads.channelCode[CH_PRESSURE] = -5;
+  AdsAcquisition acq(ads);
+  acq.addChannel(CH_PRESSURE, 0, false);
+  acq.begin();
+
+  AdsSample sample{};
+  acq.poll(at(nowUs), sample);
+  nowUs = ADS1015_CONVERSION_TIME_US;
+  TEST_ASSERT_TRUE(acq.poll(at(nowUs), sample));
+  TEST_ASSERT_EQUAL_INT16(-5, sample.raw);
+}
+
+// 周期チャンネルは捨て変換なしで、MUX を整定させてから 1 回だけ変換されること
+void test_periodic_channel_settles_without_dummy_conversion()
+{
+  HostAds1015 ads;
+  ads.channelCode[CH_PRESSURE] = 100;
+  ads.channelCode[CH_WATER] = 900;
+  AdsAcquisition acq(ads);
+  acq.addChannel(CH_PRESSURE, 0, false);
+  acq.addChannel(CH_WATER, 500000, true);
+  acq.begin();
+
+  int pressureCount = 0;
+  int waterCount = 0;
+  AdsSample sample{};
+  for (nowUs = 0; nowUs < 1000000; nowUs += 100)
+  {
+    if (acq.poll(at(nowUs), sample))
+    {
+      if (sample.channel == CH_PRESSURE)
+      {
+        TEST_ASSERT_EQUAL_INT16(100, sample.raw);
+        pressureCount++;
+      }
+      else
+      {
+        TEST_ASSERT_EQUAL_INT16(900, sample.raw);
+        waterCount++;
+      }
+    }
+  }
+
+  // 0ms と 500ms 付近の 2 回だけ水温を取得
+  TEST_ASSERT_EQUAL_INT(2, waterCount);
+  // 100us 刻みのポーリングでも 1 秒あたり 1200 回以上の油圧を取得できる
+  TEST_ASSERT_GREATER_THAN(1200, pressureCount);
+  // 変換はすべて結果として使われている
+  TEST_ASSERT_EQUAL_UINT32(static_cast<uint32_t>(pressureCount + waterCount), acq.conversionCount());
+  TEST_ASSERT_EQUAL_UINT32(acq.conversionCount() + 1, ads.conversionsStarted);
+}
+
+// MUX の整定を poll() の中で待たず、整定時間が過ぎた後の poll() で変換を始めること
+void test_settling_does_not_block_poll()
+{
+  HostAds1015 ads;
+  ads.channelCode[CH_WATER] = 900;
+  AdsAcquisition acq(ads);
+  acq.addChannel(CH_WATER, 0, true);
+  acq.begin();
+
+  AdsSample sample{};
+  TEST_ASSERT_FALSE(acq.poll(at(nowUs), sample));  // MUX だけ切り替える
+  TEST_ASSERT_TRUE(acq.isSettling());
+  TEST_ASSERT_EQUAL_UINT32(0, ads.conversionsStarted);
+  // poll() の中で仮想時計が進んでいない
+  TEST_ASSERT_EQUAL_UINT32(0, hostClockNowUs());
+  TEST_ASSERT_EQUAL_UINT32(ADS1015_MUX_SETTLE_US, acq.nextPollUs(nowUs));
+
+  nowUs = ADS1015_MUX_SETTLE_US - 1;
+  TEST_ASSERT_FALSE(acq.poll(at(nowUs), sample));
+  TEST_ASSERT_EQUAL_UINT32(0, ads.conversionsStarted);
+
+  nowUs = ADS1015_MUX_SETTLE_US + 20;  // ポーリングが遅れても、実際に変換を始めた時刻を記録する
+  TEST_ASSERT_FALSE(acq.poll(at(nowUs), sample));
+  TEST_ASSERT_TRUE(acq.isConverting());
+  TEST_ASSERT_EQUAL_UINT32(1, ads.conversionsStarted);
+
+  nowUs += ADS1015_CONVERSION_TIME_US;
+  TEST_ASSERT_TRUE(acq.poll(at(nowUs), sample));
+  TEST_ASSERT_EQUAL_INT16(900, sample.raw);
+  TEST_ASSERT_EQUAL_UINT32(ADS1015_MUX_SETTLE_US + 20, sample.timestampUs);
+  // 同じチャンネルが続くなら整定を挟まずにすぐ次の変換を始める
+  TEST_ASSERT_TRUE(acq.isConverting());
+}
+
+// 整定明けのポーリングが遅れて隙間が足りなければ、副チャンネルを見送って主チャンネルの締め切りを守ること
+void test_late_settle_yields_to_primary()
+{
+  HostAds1015 ads;
+  AdsAcquisition acq(ads);
+  acq.addChannel(CH_PRESSURE, 2000, false);
+  acq.addChannel(CH_WATER, 500000, true);
+  acq.begin(1);
+
+  AdsSample sample{};
+  acq.poll(at(nowUs), sample);  // 油圧の変換開始（次の締め切りは 2000us）
+  nowUs = ADS1015_CONVERSION_TIME_US;
+  TEST_ASSERT_TRUE(acq.poll(at(nowUs), sample));
+  TEST_ASSERT_TRUE(acq.isSettling());  // 読出し直後に水温の MUX へ切り替えた
+
+  // 整定明けの poll が締め切り直前まで遅れると、水温の変換は締め切りに間に合わない
+  nowUs = 2000 - ADS1015_CONVERSION_TIME_US + 1;
+  TEST_ASSERT_FALSE(acq.poll(at(nowUs), sample));
+  TEST_ASSERT_FALSE(acq.isSettling());
+  TEST_ASSERT_FALSE(acq.isConverting());
+  TEST_ASSERT_EQUAL_UINT32(2000, acq.nextPollUs(nowUs));
+
+  nowUs = 2000;
+  TEST_ASSERT_FALSE(acq.poll(at(nowUs), sample));
+  TEST_ASSERT_TRUE(acq.isConverting());
+  nowUs += ADS1015_CONVERSION_TIME_US;
+  TEST_ASSERT_TRUE(acq.poll(at(nowUs), sample));
+  TEST_ASSERT_EQUAL_UINT8(CH_PRESSURE, sample.channel);
+  TEST_ASSERT_EQUAL_UINT32(2000, sample.timestampUs);
+  TEST_ASSERT_EQUAL_UINT32(0, acq.primaryMissCount());
+}
+
+// 温度を読み出したら油圧の締め切りを待つ間に MUX だけ油圧へ戻し、整定を済ませてから締め切りどおりに変換すること
+void test_return_to_primary_settles()
+{
+  HostAds1015 ads;
+  ads.channelCode[CH_PRESSURE] = 300;
+  AdsAcquisition acq(ads);
+  acq.addChannel(CH_PRESSURE, 2000, false);
+  acq.addChannel(CH_WATER, 500000, true);
+  acq.begin(1);
+
+  AdsSample sample{};
+  acq.poll(at(nowUs), sample);  // 油圧の変換開始（次の締め切りは 2000us）
+  nowUs = ADS1015_CONVERSION_TIME_US;
+  TEST_ASSERT_TRUE(acq.poll(at(nowUs), sample));
+  TEST_ASSERT_TRUE(acq.isSettling());  // 水温へ切り替えて整定中
+  nowUs += ADS1015_MUX_SETTLE_US;
+  acq.poll(at(nowUs), sample);
+  TEST_ASSERT_TRUE(acq.isConverting());
+  nowUs += ADS1015_CONVERSION_TIME_US;
+  TEST_ASSERT_TRUE(acq.poll(at(nowUs), sample));
+  TEST_ASSERT_EQUAL_UINT8(CH_WATER, sample.channel);
+
+  // 読出し直後に MUX を油圧へ戻すが、変換は締め切りまで始めない
+  uint32_t started = ads.conversionsStarted;
+  TEST_ASSERT_FALSE(acq.isSettling());
+  TEST_ASSERT_FALSE(acq.isConverting());
+  TEST_ASSERT_EQUAL_UINT16(ADS1015_CONFIG_MUX_SINGLE_0 + (CH_PRESSURE << 12), ads.config & 0x7000);
+  TEST_ASSERT_EQUAL_UINT32(2000, acq.nextPollUs(nowUs));
+
+  nowUs = 2000;
+  TEST_ASSERT_FALSE(acq.poll(at(nowUs), sample));
+  TEST_ASSERT_TRUE(acq.isConverting());
+  TEST_ASSERT_EQUAL_UINT32(started + 1, ads.conversionsStarted);
+  nowUs += ADS1015_CONVERSION_TIME_US;
+  TEST_ASSERT_TRUE(acq.poll(at(nowUs), sample));
+  TEST_ASSERT_EQUAL_UINT8(CH_PRESSURE, sample.channel);
+  TEST_ASSERT_EQUAL_INT16(300, sample.raw);
+  TEST_ASSERT_EQUAL_UINT32(2000, sample.timestampUs);
+
+  // 油圧への切替も含め、MUX を切り替えた変換はすべて整定時間を置いてから始めている
+  TEST_ASSERT_TRUE(ads.shortestSettleUs >= ADS1015_MUX_SETTLE_US);
+}
+
+// スキャン表が油圧 3 回ごとに温度を 1 チャンネルずつ挟むこと
+void test_scan_table_interleaves_by_priority()
+{
+  HostAds1015 ads;
+  AdsAcquisition acq(ads);
+  acq.addChannel(CH_PRESSURE, 0, false);
+  acq.addChannel(CH_WATER, 0, true);
+  acq.addChannel(CH_OIL, 0, true);
+  acq.begin(3);
+
+  const uint8_t expected[] = {CH_PRESSURE, CH_PRESSURE, CH_PRESSURE, CH_WATER,
+                              CH_PRESSURE, CH_PRESSURE, CH_PRESSURE, CH_OIL};
+  TEST_ASSERT_EQUAL_size_t(sizeof(expected), acq.scanLength());
+  for (size_t i = 0; i < sizeof(expected); ++i)
+  {
+    TEST_ASSERT_EQUAL_UINT8(expected[i], acq.scanChannel(i));
+  }
+
+  // 実際の変換順も表のとおりに 2 周する
+  AdsSample sample{};
+  size_t received = 0;
+  for (nowUs = 0; received < 2 * sizeof(expected); nowUs += 100)
+  {
+    if (acq.poll(at(nowUs), sample))
+    {
+      TEST_ASSERT_EQUAL_UINT8(expected[received % sizeof(expected)], sample.channel);
+      received++;
+    }
+  }
+}
+
+// 温度の取得が入っても油圧は締め切りどおりに変換され、実測 SPS が保証レートに届くこと
+void test_pressure_rate_is_guaranteed()
+{
+  HostAds1015 ads;
+  AdsAcquisition acq(ads);
+  acq.addChannel(CH_PRESSURE, 2000, false);
+  acq.addChannel(CH_WATER, 500000, true);
+  acq.addChannel(CH_OIL, 500000, true);
+  acq.begin(3);
+  TEST_ASSERT_FLOAT_WITHIN(0.01F, 500.0F, acq.guaranteedPrimarySps());
+
+  AdsSample sample{};
+  int pressureCount = 0;
+  int tempCount = 0;
+  uint32_t lastPressureUs = 0;
+  uint32_t maxGapUs = 0;
+  for (nowUs = 0; nowUs < 3000000; nowUs += 100)
+  {
+    if (!acq.poll(at(nowUs), sample)) continue;
+    if (sample.channel != CH_PRESSURE)
+    {
+      tempCount++;
+      continue;
+    }
+    if (pressureCount > 0 && sample.timestampUs - lastPressureUs > maxGapUs)
+    {
+      maxGapUs = sample.timestampUs - lastPressureUs;
+    }
+    lastPressureUs = sample.timestampUs;
+    pressureCount++;
+  }
+
+  // 温度の整定と変換は油圧の隙間に収まり、油圧の間隔は一度も延びない
+  TEST_ASSERT_EQUAL_UINT32(2000, maxGapUs);
+  TEST_ASSERT_EQUAL_INT(1500, pressureCount);
+  TEST_ASSERT_EQUAL_INT(12, tempCount);
+  TEST_ASSERT_EQUAL_UINT32(0, acq.primaryMissCount());
+  TEST_ASSERT_TRUE(ads.shortestSettleUs >= ADS1015_MUX_SETTLE_US);
+
+  TEST_ASSERT_FLOAT_WITHIN(1.0F, 500.0F, acq.samplesPerSecond(CH_PRESSURE));
+  TEST_ASSERT_FLOAT_WITHIN(0.1F, 2.0F, acq.samplesPerSecond(CH_WATER));
+  TEST_ASSERT_FLOAT_WITHIN(0.1F, 2.0F, acq.samplesPerSecond(CH_OIL));
+  TEST_ASSERT_TRUE(acq.samplesPerSecond(3) == 0.0F);
+}
+
+// ALERT/RDY ピンがあれば Config レジスタをポーリングしないこと
+void test_alert_pin_completion()
+{
+  HostAds1015 ads(true);
+  ads.channelCode[CH_PRESSURE] = 321;
+  AdsAcquisition acq(ads);
+  acq.addChannel(CH_PRESSURE, 0, false);
+  TEST_ASSERT_TRUE(acq.begin());
+  TEST_ASSERT_EQUAL_HEX16(0x8000, ads.hiThresh);
+  TEST_ASSERT_EQUAL_HEX16(0x0000, ads.loThresh);
+
+  AdsSample sample{};
+  acq.poll(at(nowUs), sample);
+  nowUs = 400;
+  TEST_ASSERT_FALSE(acq.poll(at(nowUs), sample));
+  nowUs = 625;  // 実デバイスが早く終われば待たずに読む
+  TEST_ASSERT_TRUE(acq.poll(at(nowUs), sample));
+  TEST_ASSERT_EQUAL_INT16(321, sample.raw);
+  TEST_ASSERT_EQUAL_UINT32(0, ads.configReads);
+}
+
+// バスエラー後も次のポーリングで復帰すること
+void test_bus_error_recovers()
+{
+  HostAds1015 ads;
+  ads.channelCode[CH_PRESSURE] = 55;
+  AdsAcquisition acq(ads);
+  acq.addChannel(CH_PRESSURE, 0, false);
+  acq.begin();
+
+  AdsSample sample{};
+  ads.failNext = true;
+  TEST_ASSERT_FALSE(acq.poll(at(nowUs), sample));
+  TEST_ASSERT_FALSE(acq.isConverting());
+  TEST_ASSERT_EQUAL_UINT32(1, acq.busErrorCount());
+
+  acq.poll(at(nowUs), sample);
+  nowUs = ADS1015_CONVERSION_TIME_US;
+  TEST_ASSERT_TRUE(acq.poll(at(nowUs), sample));
+  TEST_ASSERT_EQUAL_INT16(55, sample.raw);
+}
+
+// 1 回の poll で行う I2C トランザクションが上限内であること
+void test_poll_transaction_budget()
+{
+  HostAds1015 ads;
+  AdsAcquisition acq(ads);
+  acq.addChannel(CH_PRESSURE, 0, false);
+  acq.addChannel(CH_WATER, 5000, true);
+  acq.begin();
+
+  AdsSample sample{};
+  for (nowUs = 0; nowUs < 100000; nowUs += 37)
+  {
+    uint32_t before = ads.transactions;
+    acq.poll(at(nowUs), sample);
+    // 完了確認・読出し・次の MUX 切替または変換開始の 3 回まで
+    TEST_ASSERT_LESS_OR_EQUAL(3, ads.transactions - before);
+  }
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_poll_waits_for_conversion_time);
+  RUN_TEST(test_poll_rechecks_busy_converter);
+  RUN_TEST(test_negative_code_is_sign_extended);
+  RUN_TEST(test_periodic_channel_settles_without_dummy_conversion);
+  RUN_TEST(test_settling_does_not_block_poll);
+  RUN_TEST(test_late_settle_yields_to_primary);
+  RUN_TEST(test_return_to_primary_settles);
+  RUN_TEST(test_scan_table_interleaves_by_priority);
+  RUN_TEST(test_pressure_rate_is_guaranteed);
+  RUN_TEST(test_alert_pin_completion);
+  RUN_TEST(test_bus_error_recovers);
+  RUN_TEST(test_poll_transaction_budget);
+  return UNITY_END();
+}
@@ -0,0 +1,149 @@
+#include <unity.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "hal/gauge_canvas.h"
+#include "modules/arc_span_cache.h"
+
+constexpr int INNER = 60;
+constexpr int OUTER = 70;
+constexpr int CX = 71;
+constexpr int CY = 140;
+constexpr size_t FRAME_BYTES = 320 * 240 * sizeof(uint16_t);
+
+using TestCache = ArcSpanCache<INNER, OUTER>;
+static TestCache cache;
+
+static auto countDiff(const uint16_t *a, const uint16_t *b) -> int
+{
+  int diff = 0;
+  for (size_t i = 0; i < FRAME_BYTES / sizeof(uint16_t); ++i)
+  {
+    diff += (a[i] != b[i]) ? 1 : 0;
+  }
+  return diff;
+}
+
+void setUp()
+{
+  if (!cache.built()) cache.build();
+}
+
+// 全ステップを塗ると fillArc(-270°〜0°) と同じ画素になること
+void test_full_sweep_matches_fill_arc()
+{
+  HostDisplay lcd;
+  GaugeCanvas reference(&lcd);
+  GaugeCanvas cached(&lcd);
+  reference.createSprite(320, 240);
+  cached.createSprite(320, 240);
+
+  reference.fillArc(CX, CY, INNER, OUTER, -270.0F, 0.0F, 0xFFFF);
+  cache.fill(cached, CX, CY, 0, TestCache::STEPS, 0xFFFF);
+  TEST_ASSERT_EQUAL_INT(0, countDiff(reference.getBuffer(), cached.getBuffer()));
+  TEST_ASSERT_LESS_OR_EQUAL(TestCache::MAX_SPANS, cache.spanCount());
+}
+
+// 差分を積み重ねた結果が一度に塗った結果と一致し、隙間や重なりが無いこと
+void test_deltas_compose()
+{
+  HostDisplay lcd;
+  GaugeCanvas stepped(&lcd);
+  GaugeCanvas direct(&lcd);
+  stepped.createSprite(320, 240);
+  direct.createSprite(320, 240);
+
+  const int steps[] = {0, 37, 38, 200, 120, 539, 540, 311};
+  for (size_t i = 1; i < sizeof(steps) / sizeof(steps[0]); ++i)
+  {
+    int prev = steps[i - 1];
+    int curr = steps[i];
+    if (curr > prev) cache.fill(stepped, CX, CY, prev, curr, 0xFFFF);
+    if (curr < prev) cache.fill(stepped, CX, CY, curr, prev, 0x18E3);
+  }
+  cache.fill(direct, CX, CY, 0, TestCache::STEPS, 0x18E3);
+  cache.fill(direct, CX, CY, 0, 311, 0xFFFF);
+  // 初回の 0x18E3 塗りが無い分、一度も塗られていない画素（0）は差分に含めない
+  const uint16_t *a = stepped.getBuffer();
+  const uint16_t *b = direct.getBuffer();
+  for (size_t i = 0; i < FRAME_BYTES / sizeof(uint16_t); ++i)
+  {
+    if (a[i] != 0) TEST_ASSERT_EQUAL_HEX16(b[i], a[i]);
+  }
+}
+
+// 角度からステップへの丸めと、塗った範囲が更新領域に記録されること
+void test_step_mapping_and_damage()
+{
+  TEST_ASSERT_EQUAL_INT(0, TestCache::stepForAngle(-270.0F));
+  TEST_ASSERT_EQUAL_INT(TestCache::STEPS, TestCache::stepForAngle(0.0F));
+  TEST_ASSERT_EQUAL_INT(180, TestCache::stepForAngle(-180.0F));
+  TEST_ASSERT_EQUAL_INT(0, TestCache::stepForAngle(-400.0F));
+
+  HostDisplay lcd;
+  GaugeCanvas canvas(&lcd);
+  canvas.createSprite(320, 240);
+  canvas.pushDamage();
+  // -270°〜-180° は中心の左下 1/4 に収まる
+  cache.fill(canvas, CX, CY, 0, 180, 0xFFFF);
+  TEST_ASSERT_EQUAL_size_t(1, canvas.damage().count());
+  const DamageRect &rect = canvas.damage()[0];
+  TEST_ASSERT_GREATER_OR_EQUAL(CX - OUTER, rect.x);
+  TEST_ASSERT_LESS_OR_EQUAL(CX + 1, rect.x + rect.w);
+  TEST_ASSERT_GREATER_OR_EQUAL(CY - 1, rect.y);
+  TEST_ASSERT_LESS_OR_EQUAL(CY + OUTER + 1, rect.y + rect.h);
+}
+
+template <typename F>
+static auto measureUs(F draw) -> double
+{
+  constexpr int ROUNDS = 200;
+  auto begin = std::chrono::steady_clock::now();
+  for (int round = 0; round < ROUNDS; ++round)
+  {
+    draw(round);
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(end - begin).count() / ROUNDS;
+}
+
+// メーターの小刻みな増減（約 5° ずつ往復）でキャッシュ経路が fillArc より 5 倍以上速いこと
+void test_benchmark_cache_vs_fill_arc()
+{
+  HostDisplay lcd;
+  GaugeCanvas canvas(&lcd);
+  canvas.createSprite(320, 240);
+
+  auto angleAt = [](int round) { return -270.0F + static_cast<float>((round * 7) % 54) * 5.0F; };
+  double arcUs = measureUs(
+      [&](int round)
+      {
+        float prev = angleAt(round);
+        float curr = angleAt(round + 1);
+        canvas.fillArc(CX, CY, INNER, OUTER, std::min(prev, curr), std::max(prev, curr), 0xFFFF);
+      });
+  double cacheUs = measureUs(
+      [&](int round)
+      {
+        int prev = TestCache::stepForAngle(angleAt(round));
+        int curr = TestCache::stepForAngle(angleAt(round + 1));
+        cache.fill(canvas, CX, CY, std::min(prev, curr), std::max(prev, curr), 0xFFFF);
+      });
+
+  char message[96];
+  snprintf(message, sizeof(message), "fillArc %.2f us, span cache %.2f us (x%.1f)", arcUs, cacheUs, arcUs / cacheUs);
+  TEST_MESSAGE(message);
+  TEST_ASSERT_GREATER_THAN(5.0, arcUs / cacheUs);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_full_sweep_matches_fill_arc);
+  RUN_TEST(test_deltas_compose);
+  RUN_TEST(test_step_mapping_and_damage);
+  RUN_TEST(test_benchmark_cache_vs_fill_arc);
+  return UNITY_END();
+}
@@ -0,0 +1,141 @@
+#include <unity.h>
+
+#include "config.h"
+#include "hal/hal.h"
+#include "modules/backlight_control.h"
+#include "modules/rate_scheduler.h"
+
+// フェードの曲線は 0 から 256 まで単調に増え、両端がなだらかなこと
+void test_fade_curve_is_monotonic()
+{
+  TEST_ASSERT_EQUAL_UINT16(0, BACKLIGHT_FADE_CURVE[0]);
+  TEST_ASSERT_EQUAL_UINT16(256, BACKLIGHT_FADE_CURVE[BACKLIGHT_FADE_STEPS]);
+  TEST_ASSERT_EQUAL_UINT16(128, BACKLIGHT_FADE_CURVE[BACKLIGHT_FADE_STEPS / 2]);
+  for (int i = 1; i <= BACKLIGHT_FADE_STEPS; ++i)
+  {
+    TEST_ASSERT_TRUE(BACKLIGHT_FADE_CURVE[i] >= BACKLIGHT_FADE_CURVE[i - 1]);
+  }
+  // 中央の 1 段は端の 1 段より大きく動く
+  TEST_ASSERT_TRUE(BACKLIGHT_FADE_CURVE[1] < BACKLIGHT_FADE_CURVE[9] - BACKLIGHT_FADE_CURVE[8]);
+}
+
+// 昼から夜へは表の段数で単調に暗くなって目標で止まり、途中で向きを変えるとその輝度から戻ること
+void test_fade_ramps_between_levels()
+{
+  BacklightFade fade(BACKLIGHT_DAY);
+  TEST_ASSERT_FALSE(fade.active());
+  TEST_ASSERT_FALSE(fade.step());
+
+  fade.start(BACKLIGHT_NIGHT);
+  int steps = 0;
+  uint8_t previous = fade.level();
+  while (fade.active())
+  {
+    fade.step();
+    TEST_ASSERT_TRUE(fade.level() <= previous);
+    previous = fade.level();
+    steps++;
+  }
+  TEST_ASSERT_EQUAL_INT(BACKLIGHT_FADE_STEPS, steps);
+  TEST_ASSERT_EQUAL_UINT8(BACKLIGHT_NIGHT, fade.level());
+
+  fade.start(BACKLIGHT_DAY);
+  for (int i = 0; i < BACKLIGHT_FADE_STEPS / 2; ++i)
+  {
+    fade.step();
+  }
+  uint8_t midway = fade.level();
+  TEST_ASSERT_TRUE(midway > BACKLIGHT_NIGHT && midway < BACKLIGHT_DAY);
+  fade.start(BACKLIGHT_DUSK);
+  TEST_ASSERT_TRUE(fade.active());
+  TEST_ASSERT_EQUAL_UINT8(midway, fade.level());
+  while (fade.active())
+  {
+    fade.step();
+  }
+  TEST_ASSERT_EQUAL_UINT8(BACKLIGHT_DUSK, fade.level());
+
+  // 同じ目標を指示し直してもやり直さない
+  fade.start(BACKLIGHT_DUSK);
+  TEST_ASSERT_FALSE(fade.active());
+}
+
+// 測定値の中央値で輝度モードが決まり、1 回の外れ値では切り替わらないこと
+void test_mode_follows_median_lux()
+{
+  LuxMedian median;
+  uint16_t lux = 0;
+  for (int i = 0; i < MEDIAN_BUFFER_SIZE; ++i)
+  {
+    lux = median.add(LUX_THRESHOLD_DAY + 5);
+  }
+  TEST_ASSERT_EQUAL(BrightnessMode::Day, brightnessModeForLux(lux));
+  TEST_ASSERT_EQUAL(BrightnessMode::Day, brightnessModeForLux(median.add(0)));
+  for (int i = 0; i < MEDIAN_BUFFER_SIZE; ++i)
+  {
+    lux = median.add(LUX_THRESHOLD_DUSK);
+  }
+  TEST_ASSERT_EQUAL(BrightnessMode::Dusk, brightnessModeForLux(lux));
+  TEST_ASSERT_EQUAL(BrightnessMode::Night, brightnessModeForLux(LUX_THRESHOLD_DUSK - 1));
+  TEST_ASSERT_EQUAL_UINT8(BACKLIGHT_NIGHT, backlightLevelFor(BrightnessMode::Night));
+}
+
+// ── 実機の loop() と同じ登録で、消灯が常にフレームの合間に収まることを確かめる ──
+constexpr uint32_t RENDER_BUSY_US = 6000;
+static uint64_t lastRenderEndUs = 0;
+static uint64_t blankStartUs = 0;
+static int measurements = 0;
+static int blanksOutsideGap = 0;
+
+static void renderTask()
+{
+  hostClockAdvanceUs(RENDER_BUSY_US);
+  lastRenderEndUs = hostClockNowUs();
+}
+
+static void alsStartTask() { blankStartUs = hostClockNowUs(); }
+
+static void alsReadTask()
+{
+  uint64_t nowUs = hostClockNowUs();
+  // 描画が終わった後に消し、次の描画の締め切りより前に点け直す
+  uint64_t nextRenderUs = (nowUs / RENDER_PERIOD_US + 1) * RENDER_PERIOD_US;
+  if (blankStartUs < lastRenderEndUs || nowUs + 1 >= nextRenderUs || nowUs - blankStartUs < ALS_BLANK_US)
+  {
+    blanksOutsideGap++;
+  }
+  measurements++;
+}
+
+// 測定周期は描画の整数倍で、10 分回しても消灯から読み出しまでが毎回フレームの合間に収まること
+void test_blanking_stays_in_frame_gap()
+{
+  hostClockSetUs(0);
+  RateScheduler scheduler;
+  scheduler.addTask("render", RENDER_PERIOD_US, renderTask, 0);
+  uint32_t alsStart = alsBlankDeadlineUs(0);
+  scheduler.addTask("als_start", ALS_MEASUREMENT_PERIOD_US, alsStartTask, alsStart);
+  scheduler.addTask("als_read", ALS_MEASUREMENT_PERIOD_US, alsReadTask, alsStart + ALS_BLANK_US);
+
+  constexpr uint64_t DURATION_US = 600ULL * 1000000ULL;
+  while (hostClockNowUs() < DURATION_US)
+  {
+    hostClockAdvanceUs(scheduler.untilNextDeadlineUs(halMicros()));
+    scheduler.runDue();
+  }
+
+  TEST_ASSERT_EQUAL_INT(DURATION_US / ALS_MEASUREMENT_PERIOD_US + 1, measurements);
+  TEST_ASSERT_EQUAL_INT(0, blanksOutsideGap);
+  TEST_ASSERT_EQUAL_UINT32(0, scheduler.stats(0).misses + scheduler.stats(1).misses + scheduler.stats(2).misses);
+  TEST_ASSERT_UINT32_WITHIN(RENDER_PERIOD_US, ALS_MEASUREMENT_INTERVAL_MS * 1000UL, ALS_MEASUREMENT_PERIOD_US);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_fade_curve_is_monotonic);
+  RUN_TEST(test_fade_ramps_between_levels);
+  RUN_TEST(test_mode_follows_median_lux);
+  RUN_TEST(test_blanking_stays_in_frame_gap);
+  return UNITY_END();
+}
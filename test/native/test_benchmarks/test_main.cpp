@@ -0,0 +1,95 @@
+#include <unity.h>
+
+#include <cstdio>
+#include <cstring>
+
+#include "config.h"
+#include "modules/display.h"
+#include "modules/gauge_benchmarks.h"
+#include "modules/microbench.h"
+
+static MicroBench bench;
+
+// 計測結果は 1 回あたりの時間に直り、最も速い回を採ること
+void test_microbench_reports_per_iteration()
+{
+  MicroBench local;
+  const BenchResult &result = local.run("count", 1000,
+                                        [](uint32_t i) -> uint32_t
+                                        {
+                                          benchSink = static_cast<int32_t>(i);
+                                          return 3;
+                                        });
+  TEST_ASSERT_EQUAL_UINT32(1000, result.iterations);
+  TEST_ASSERT_TRUE(result.nsPerOp > 0.0);
+  TEST_ASSERT_FLOAT_WITHIN(0.001F, 3.0F, static_cast<float>(result.pixelsPerOp));
+  // ホストにはサイクル数が無い
+  TEST_ASSERT_FLOAT_WITHIN(0.001F, 0.0F, static_cast<float>(result.cyclesPerOp));
+  TEST_ASSERT_EQUAL_size_t(1, local.count());
+  TEST_ASSERT_NOT_NULL(local.find("count"));
+  TEST_ASSERT_NULL(local.find("missing"));
+}
+
+// 換算と描画の全項目が計測され、描画は触れた画素数も残ること
+void test_suite_covers_hot_paths()
+{
+  display.init();
+  TEST_ASSERT_TRUE(beginFramePipeline());
+  TEST_ASSERT_TRUE(beginDisplayLayers());
+
+  runConversionBenchmarks(bench);
+  runDisplayBenchmarks(bench);
+
+  const char *const conversions[] = {"voltage_to_temp",     "voltage_to_oil_pressure", "adc_to_pressure_q16",
+                                     "adc_to_temp_lut",     "calculate_average_10",    "oil_pressure_filter"};
+  for (const char *name : conversions)
+  {
+    const BenchResult *result = bench.find(name);
+    TEST_ASSERT_TRUE_MESSAGE(result != nullptr, name);
+    TEST_ASSERT_TRUE(result->nsPerOp > 0.0);
+  }
+
+  const char *const draws[] = {"arc_full_sweep",      "arc_small_delta",     "arc_redzone_cross",
+                               "top_bar_small_delta", "top_bar_alert_cross", "top_bar_full_sweep",
+                               "value_text_font",     "value_text_atlas"};
+  for (const char *name : draws)
+  {
+    const BenchResult *result = bench.find(name);
+    TEST_ASSERT_TRUE_MESSAGE(result != nullptr, name);
+    TEST_ASSERT_TRUE(result->pixelsPerOp > 0.0);
+  }
+  // 差分描画なので、小さな変化は全域の振り切りより触れる画素が少ない
+  TEST_ASSERT_TRUE(bench.find("arc_small_delta")->pixelsPerOp < bench.find("arc_full_sweep")->pixelsPerOp);
+}
+
+// JSON は全項目を 1 行ずつ含み、バッファが足りなければ必要な長さを返すこと
+void test_json_output()
+{
+  char json[2048];
+  size_t length = bench.writeJson(json, sizeof(json));
+  TEST_ASSERT_LESS_THAN(sizeof(json), length);
+  const char prefix[] = "{\"target\":\"host\",\"results\":[";
+  TEST_ASSERT_EQUAL_MEMORY(prefix, json, sizeof(prefix) - 1);
+  TEST_ASSERT_EQUAL_STRING("]}\n", json + length - 3);
+  for (size_t i = 0; i < bench.count(); ++i)
+  {
+    char key[48];
+    snprintf(key, sizeof(key), "\n{\"name\":\"%s\"", bench[i].name);
+    TEST_ASSERT_TRUE_MESSAGE(std::strstr(json, key) != nullptr, bench[i].name);
+  }
+
+  char small[16];
+  TEST_ASSERT_EQUAL_size_t(length, bench.writeJson(small, sizeof(small)));
+  TEST_ASSERT_EQUAL_size_t(sizeof(small) - 1, std::strlen(small));
+
+  TEST_MESSAGE(json);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_microbench_reports_per_iteration);
+  RUN_TEST(test_suite_covers_hot_paths);
+  RUN_TEST(test_json_output);
+  return UNITY_END();
+}
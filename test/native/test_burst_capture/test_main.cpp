@@ -0,0 +1,167 @@
+#include <unity.h>
+
+#include <chrono>
+#include <cstdio>
+
+#include "config.h"
+#include "modules/burst_capture.h"
+#include "modules/sensor_conversion.h"
+
+// 500Hz 相当の周期で流す
+constexpr uint32_t PERIOD_US = 2000;
+// 約 2.5bar と約 0.25bar の生コード
+constexpr int16_t RAW_RUNNING = 500;
+constexpr int16_t RAW_STARVED = 200;
+
+static auto testConfig() -> BurstCaptureConfig
+{
+  BurstCaptureConfig config = {};
+  config.lowPressureQ16 = barToPressureQ16(1.0F);
+  config.lowHoldUs = 50000;
+  config.armUs = 1000000;
+  config.slopeLimitQ16PerSecond = int64_t{100000} * PRESSURE_Q16_PER_MBAR;  // 100bar/s
+  config.preUs = 2000000;
+  config.postUs = 2000000;
+  return config;
+}
+
+// [startUs, startUs + durationUs) の間、raw を一定周期で記録し、次の時刻を返す
+static auto feed(BurstCapture &capture, uint32_t startUs, uint32_t durationUs, int16_t raw) -> uint32_t
+{
+  uint32_t t = startUs;
+  for (; t - startUs < durationUs; t += PERIOD_US)
+  {
+    capture.record(t, raw, convertAdcToPressureQ16(raw));
+  }
+  return t;
+}
+
+// 油圧の低い状態（エンジン停止中）からはトリガが掛からないこと
+void test_no_trigger_before_armed()
+{
+  BurstCapture capture(testConfig());
+  uint32_t t = feed(capture, 0, 3000000, RAW_STARVED);
+  // 立ち上がりの急変も arm 前なので無視される
+  t = feed(capture, t, 500000, RAW_RUNNING);
+  feed(capture, t, 500000, RAW_STARVED);
+  TEST_ASSERT_TRUE(capture.state() == BurstCapture::State::Recording);
+  TEST_ASSERT_EQUAL_UINT32(0, capture.captureCount());
+}
+
+// 低油圧が保持時間続くとトリガが掛かり、前後 2 秒ずつ残して凍結すること
+void test_low_pressure_trigger_keeps_pre_and_post()
+{
+  BurstCapture capture(testConfig());
+  uint32_t t = feed(capture, 0, 4000000, RAW_RUNNING);
+  // 1 コードずつ下げて変化率トリガを避け、閾値をわずかに下回ったところで保つ
+  int16_t raw = RAW_RUNNING;
+  while (convertAdcToPressureQ16(raw) >= testConfig().lowPressureQ16)
+  {
+    capture.record(t, raw, convertAdcToPressureQ16(raw));
+    raw--;
+    t += PERIOD_US;
+  }
+  t = feed(capture, t, 40000, raw);
+  TEST_ASSERT_TRUE(capture.state() == BurstCapture::State::Recording);
+  feed(capture, t, 3000000, raw);
+
+  TEST_ASSERT_TRUE(capture.frozen());
+  TEST_ASSERT_TRUE(capture.trigger() == BurstTrigger::LowPressure);
+  TEST_ASSERT_EQUAL_UINT32(1, capture.captureCount());
+
+  int32_t firstOffsetUs = 0;
+  int32_t lastOffsetUs = 0;
+  int32_t triggerOffsetUs = -1;
+  size_t index = 0;
+  capture.forEachSample(
+      [&](int32_t offsetUs, int16_t)
+      {
+        if (index == 0) firstOffsetUs = offsetUs;
+        if (index == capture.triggerIndex()) triggerOffsetUs = offsetUs;
+        lastOffsetUs = offsetUs;
+        index++;
+      });
+  TEST_ASSERT_EQUAL_UINT32(capture.count(), index);
+  TEST_ASSERT_EQUAL_INT32(0, triggerOffsetUs);
+  TEST_ASSERT_EQUAL_INT32(-2000000, firstOffsetUs);
+  TEST_ASSERT_EQUAL_INT32(2000000, lastOffsetUs);
+  TEST_ASSERT_EQUAL_UINT32(2001, capture.count());
+  TEST_ASSERT_EQUAL_UINT32(1000, capture.triggerIndex());
+
+  TEST_ASSERT_EQUAL_INT32(convertAdcToPressureQ16(raw), capture.minPressureQ16());
+  TEST_ASSERT_EQUAL_INT32(convertAdcToPressureQ16(RAW_RUNNING), capture.maxPressureQ16());
+}
+
+// 油圧の急変で変化率トリガが掛かること
+void test_slope_trigger_on_step()
+{
+  BurstCapture capture(testConfig());
+  uint32_t t = feed(capture, 0, 2000000, RAW_RUNNING);
+  // 16ms で約 0.7bar の上昇 ≒ 45bar/s はしきい値未満
+  t = feed(capture, t, 500000, RAW_RUNNING + 100);
+  TEST_ASSERT_TRUE(capture.state() == BurstCapture::State::Recording);
+  // 約 1.9bar の急低下は 16ms で見ても ≒ 117bar/s
+  feed(capture, t, 2500000, RAW_RUNNING - 150);
+  TEST_ASSERT_TRUE(capture.frozen());
+  TEST_ASSERT_TRUE(capture.trigger() == BurstTrigger::PressureSlope);
+}
+
+// 凍結中は上書きされず、rearm() 後は新しいキャプチャを取り直すこと
+void test_frozen_capture_is_kept_until_rearm()
+{
+  BurstCapture capture(testConfig());
+  uint32_t t = feed(capture, 0, 2000000, RAW_RUNNING);
+  t = feed(capture, t, 3000000, RAW_STARVED);
+  TEST_ASSERT_TRUE(capture.frozen());
+  size_t count = capture.count();
+  int32_t minPressure = capture.minPressureQ16();
+
+  // 凍結後の別の低下は記録されない
+  t = feed(capture, t, 2000000, RAW_RUNNING);
+  t = feed(capture, t, 3000000, 100);
+  TEST_ASSERT_TRUE(capture.frozen());
+  TEST_ASSERT_EQUAL_UINT32(count, capture.count());
+  TEST_ASSERT_EQUAL_INT32(minPressure, capture.minPressureQ16());
+  TEST_ASSERT_EQUAL_UINT32(1, capture.captureCount());
+
+  capture.rearm();
+  t = feed(capture, t, 2000000, RAW_RUNNING);
+  TEST_ASSERT_TRUE(capture.state() == BurstCapture::State::Recording);
+  feed(capture, t, 3000000, 100);
+  TEST_ASSERT_TRUE(capture.frozen());
+  TEST_ASSERT_EQUAL_UINT32(2, capture.captureCount());
+  TEST_ASSERT_EQUAL_INT32(convertAdcToPressureQ16(100), capture.minPressureQ16());
+}
+
+// record() 1 回の処理時間を計測する（取得タスクの周期に対して十分小さいこと）
+void test_record_cost()
+{
+  constexpr int SAMPLES = 1000000;
+  static BurstCapture capture(testConfig());
+  int32_t pressure = convertAdcToPressureQ16(RAW_RUNNING);
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < SAMPLES; ++i)
+  {
+    // arm 済み・トリガ無しの定常状態（変化率の判定まで通る）
+    capture.record(static_cast<uint32_t>(i) * PERIOD_US, static_cast<int16_t>(RAW_RUNNING + (i & 1)),
+                   pressure + (i & 1));
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  TEST_ASSERT_TRUE(capture.state() == BurstCapture::State::Recording);
+
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / SAMPLES;
+  char message[64];
+  snprintf(message, sizeof(message), "record: %.1f ns/sample", ns);
+  TEST_MESSAGE(message);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_no_trigger_before_armed);
+  RUN_TEST(test_low_pressure_trigger_keeps_pre_and_post);
+  RUN_TEST(test_slope_trigger_on_step);
+  RUN_TEST(test_frozen_capture_is_kept_until_rearm);
+  RUN_TEST(test_record_cost);
+  return UNITY_END();
+}
@@ -0,0 +1,86 @@
+#include <unity.h>
+
+#include "hal/gauge_canvas.h"
+#include "modules/damage_tracker.h"
+
+// キャンバス外は切り捨てられること
+void test_clip_to_bounds()
+{
+  DamageTracker tracker;
+  tracker.setBounds(320, 240);
+  tracker.add(-10, -10, 20, 20);
+  TEST_ASSERT_EQUAL_size_t(1, tracker.count());
+  TEST_ASSERT_EQUAL_INT(0, tracker[0].x);
+  TEST_ASSERT_EQUAL_INT(10, tracker[0].w);
+
+  tracker.add(400, 10, 10, 10);
+  TEST_ASSERT_EQUAL_size_t(1, tracker.count());
+}
+
+// 重なる矩形・近い矩形はまとめられ、離れた矩形は別に残ること
+void test_merge_policy()
+{
+  DamageTracker tracker;
+  tracker.setBounds(320, 240);
+  tracker.add(10, 10, 20, 20);
+  tracker.add(20, 20, 20, 20);
+  TEST_ASSERT_EQUAL_size_t(1, tracker.count());
+  TEST_ASSERT_EQUAL_UINT32(30 * 30, tracker.area());
+
+  tracker.add(250, 200, 30, 30);
+  TEST_ASSERT_EQUAL_size_t(2, tracker.count());
+}
+
+// 上限を超えても全ての更新範囲を含むこと
+void test_capacity_overflow_keeps_coverage()
+{
+  DamageTracker tracker;
+  tracker.setBounds(320, 240);
+  for (int i = 0; i < 12; ++i)
+  {
+    tracker.add((i % 4) * 80, (i / 4) * 80, 4, 4);
+  }
+  TEST_ASSERT_LESS_OR_EQUAL(DamageTracker::MAX_RECTS, tracker.count());
+  for (int i = 0; i < 12; ++i)
+  {
+    int x = (i % 4) * 80;
+    int y = (i / 4) * 80;
+    bool covered = false;
+    for (size_t r = 0; r < tracker.count(); ++r)
+    {
+      const DamageRect &rect = tracker[r];
+      covered |= (x >= rect.x && y >= rect.y && x + 4 <= rect.x + rect.w && y + 4 <= rect.y + rect.h);
+    }
+    TEST_ASSERT_TRUE(covered);
+  }
+}
+
+// 部分転送後も LCD とキャンバスの内容が一致し、転送量が減ること
+void test_canvas_pushes_only_damage()
+{
+  HostDisplay lcd;
+  GaugeCanvas canvas(&lcd);
+  canvas.createSprite(320, 240);
+  canvas.fillScreen(0);
+  canvas.pushDamage();
+  TEST_ASSERT_EQUAL_UINT32(320 * 240 * 2, canvas.lastPushBytes());
+
+  canvas.fillArc(71, 140, 60, 70, -270.0F, -200.0F, 0xFFFF);
+  canvas.setFont(&fonts::Font0);
+  canvas.setCursor(5, 232);
+  canvas.printf("%d", 59);
+  canvas.pushDamage();
+
+  TEST_ASSERT_LESS_THAN(320 * 240 * 2 / 4, canvas.lastPushBytes());
+  TEST_ASSERT_EQUAL_MEMORY(canvas.getBuffer(), lcd.framebuffer(), 320 * 240 * sizeof(uint16_t));
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_clip_to_bounds);
+  RUN_TEST(test_merge_policy);
+  RUN_TEST(test_capacity_overflow_keeps_coverage);
+  RUN_TEST(test_canvas_pushes_only_damage);
+  return UNITY_END();
+}
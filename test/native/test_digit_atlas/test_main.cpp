@@ -0,0 +1,124 @@
+#include <unity.h>
+
+#include <cstring>
+
+#include "config.h"
+#include "hal/gauge_canvas.h"
+#include "modules/digit_atlas.h"
+
+constexpr int CANVAS_W = 160;
+constexpr int CANVAS_H = 64;
+
+static auto formatted(int32_t scaled, int decimals) -> const char *
+{
+  static char text[DECIMAL_TEXT_SIZE];
+  formatDecimal(scaled, decimals, text);
+  return text;
+}
+
+// 整数演算の整形が printf の "%.1f" / "%d" と同じ文字列になること
+void test_format_decimal()
+{
+  TEST_ASSERT_EQUAL_STRING("0", formatted(0, 0));
+  TEST_ASSERT_EQUAL_STRING("0.5", formatted(5, 1));
+  TEST_ASSERT_EQUAL_STRING("-0.3", formatted(-3, 1));
+  TEST_ASSERT_EQUAL_STRING("123.4", formatted(1234, 1));
+  TEST_ASSERT_EQUAL_STRING("-120", formatted(-120, 0));
+  TEST_ASSERT_EQUAL_STRING("1.00", formatted(100, 2));
+  TEST_ASSERT_EQUAL_STRING("-2147483648", formatted(INT32_MIN, 0));
+  char text[DECIMAL_TEXT_SIZE];
+  TEST_ASSERT_EQUAL_size_t(5, formatDecimal(-105, 1, text));
+
+  TEST_ASSERT_EQUAL_INT32(30, scaleToDecimal(2.96F, 1));
+  TEST_ASSERT_EQUAL_INT32(-30, scaleToDecimal(-2.96F, 1));
+  TEST_ASSERT_EQUAL_INT32(100, scaleToDecimal(99.5F, 0));
+  TEST_ASSERT_EQUAL_INT32(99, scaleToDecimal(99.49F, 0));
+}
+
+// アトラスから描いた数値がフォントで描いた数値と画素単位で一致すること
+void test_atlas_matches_font_rendering()
+{
+  DigitAtlas atlas;
+  TEST_ASSERT_TRUE(atlas.build(&FreeSansBold24pt7b));
+  TEST_ASSERT_EQUAL_INT(FreeSansBold24pt7b.height, atlas.height());
+
+  static GaugeCanvas viaFont(nullptr);
+  static GaugeCanvas viaAtlas(nullptr);
+  viaFont.createSprite(CANVAS_W, CANVAS_H);
+  viaAtlas.createSprite(CANVAS_W, CANVAS_H);
+  const char *const texts[] = {"0", "-12.5", "9.9", "1087", "-"};
+  for (const char *text : texts)
+  {
+    viaFont.fillScreen(COLOR_BLACK);
+    viaAtlas.fillScreen(COLOR_BLACK);
+    viaFont.discardDamage();
+    viaAtlas.discardDamage();
+
+    viaFont.setFont(&FreeSansBold24pt7b);
+    viaFont.setTextColor(COLOR_YELLOW);
+    viaFont.drawRightString(text, CANVAS_W - 3, 4);
+    TEST_ASSERT_TRUE(atlas.drawRight(viaAtlas, text, std::strlen(text), CANVAS_W - 3, 4, COLOR_YELLOW));
+    TEST_ASSERT_EQUAL_MEMORY(viaFont.getBuffer(), viaAtlas.getBuffer(), CANVAS_W * CANVAS_H * sizeof(uint16_t));
+
+    // 更新領域は描いた画素だけを囲み、フォントの文字箱より広がらない
+    TEST_ASSERT_EQUAL_size_t(1, viaAtlas.damage().count());
+    TEST_ASSERT_TRUE(viaAtlas.damage().area() <= viaFont.damage().area());
+  }
+}
+
+// アトラスに無い文字は描かずに知らせ、drawValueText() はフォントで描き直すこと
+void test_unknown_glyph_falls_back_to_font()
+{
+  static GaugeCanvas viaFont(nullptr);
+  static GaugeCanvas viaValue(nullptr);
+  viaFont.createSprite(CANVAS_W, CANVAS_H);
+  viaValue.createSprite(CANVAS_W, CANVAS_H);
+  viaFont.fillScreen(COLOR_BLACK);
+  viaValue.fillScreen(COLOR_BLACK);
+
+  const DigitAtlas &atlas = valueDigitAtlas();
+  TEST_ASSERT_TRUE(atlas.built());
+  TEST_ASSERT_EQUAL_INT(-1, atlas.textWidth("1e3", 3));
+  TEST_ASSERT_FALSE(atlas.drawRight(viaValue, "1e3", 3, CANVAS_W - 1, 0, COLOR_WHITE));
+  TEST_ASSERT_EQUAL_UINT16(COLOR_BLACK, viaValue.readPixel(CANVAS_W - 10, 10));
+
+  viaFont.setFont(&FreeSansBold24pt7b);
+  viaFont.setTextColor(COLOR_WHITE);
+  viaFont.drawRightString("1e3", CANVAS_W - 1, 0);
+  drawValueText(viaValue, "1e3", 3, CANVAS_W - 1, 0, COLOR_WHITE);
+  TEST_ASSERT_EQUAL_MEMORY(viaFont.getBuffer(), viaValue.getBuffer(), CANVAS_W * CANVAS_H * sizeof(uint16_t));
+}
+
+// キャンバスの端からはみ出す数値も、フォントで描いた場合と同じ画素だけが書かれること
+void test_atlas_clips_at_canvas_edges()
+{
+  DigitAtlas atlas;
+  TEST_ASSERT_TRUE(atlas.build(&FreeSansBold24pt7b));
+  static GaugeCanvas viaFont(nullptr);
+  static GaugeCanvas viaAtlas(nullptr);
+  viaFont.createSprite(CANVAS_W, CANVAS_H);
+  viaAtlas.createSprite(CANVAS_W, CANVAS_H);
+
+  // 左上・右下へはみ出す位置と、完全に外れる位置
+  const int positions[][2] = {{20, -10}, {CANVAS_W + 15, CANVAS_H - 20}, {-200, 0}};
+  for (const auto &position : positions)
+  {
+    viaFont.fillScreen(COLOR_BLACK);
+    viaAtlas.fillScreen(COLOR_BLACK);
+    viaFont.setFont(&FreeSansBold24pt7b);
+    viaFont.setTextColor(COLOR_YELLOW);
+    viaFont.drawRightString("-88.8", position[0], position[1]);
+    TEST_ASSERT_TRUE(atlas.drawRight(viaAtlas, "-88.8", 5, position[0], position[1], COLOR_YELLOW));
+    TEST_ASSERT_EQUAL_MEMORY(viaFont.getBuffer(), viaAtlas.getBuffer(), CANVAS_W * CANVAS_H * sizeof(uint16_t));
+  }
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_format_decimal);
+  RUN_TEST(test_atlas_matches_font_rendering);
+  RUN_TEST(test_unknown_glyph_falls_back_to_font);
+  RUN_TEST(test_atlas_clips_at_canvas_edges);
+  return UNITY_END();
+}
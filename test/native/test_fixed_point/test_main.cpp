@@ -0,0 +1,156 @@
+#include <unity.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+#include "config.h"
+#include "modules/sensor.h"
+#include "modules/sensor_conversion.h"
+#include "modules/signal_filters.h"
+#include "modules/thermistor_lut.h"
+
+// 置き換え前の油圧の窓長と EMA 係数
+constexpr size_t WINDOW = 5;
+constexpr float ALPHA = 0.3F;
+
+// 再現性のある擬似乱数（線形合同法）
+static uint32_t lcgState = 12345;
+static auto nextRandom() -> uint32_t
+{
+  lcgState = lcgState * 1664525U + 1013904223U;
+  return lcgState >> 8;
+}
+
+// 全コードで整数の油圧換算が float 式と 1mbar 以内で一致すること
+void test_pressure_matches_float_formula()
+{
+  float worst = 0.0F;
+  for (int code = -2048; code <= 2047; ++code)
+  {
+    auto raw = static_cast<int16_t>(code);
+    float expected = convertVoltageToOilPressure(convertAdcToVoltage(raw));
+    float actual = pressureQ16ToBar(convertAdcToPressureQ16(raw));
+    worst = std::max(worst, std::fabs(actual - expected));
+    TEST_ASSERT_FLOAT_WITHIN(0.001F, expected, actual);
+  }
+  char message[48];
+  std::snprintf(message, sizeof(message), "max error %.5f bar", worst);
+  TEST_MESSAGE(message);
+
+  // 0.5V 以下と負のコードは 0bar
+  TEST_ASSERT_EQUAL_INT32(0, convertAdcToPressureQ16(0));
+  TEST_ASSERT_EQUAL_INT32(0, convertAdcToPressureQ16(-2048));
+  TEST_ASSERT_TRUE(convertAdcToPressureQ16(2047) > 0);
+}
+
+// 移動和の平均が float の calculateAverage と丸め誤差の範囲で一致すること
+void test_moving_sum_matches_float_average()
+{
+  MovingSum<int32_t, WINDOW> window;
+  float floatWindow[WINDOW] = {};
+  size_t index = 0;
+  for (int i = 0; i < 10000; ++i)
+  {
+    auto raw = static_cast<int16_t>(nextRandom() % 2048);
+    int32_t q16 = convertAdcToPressureQ16(raw);
+    window.push(q16);
+    floatWindow[index] = convertVoltageToOilPressure(convertAdcToVoltage(raw));
+    index = (index + 1) % WINDOW;
+    TEST_ASSERT_FLOAT_WITHIN(0.001F, calculateAverage(floatWindow), pressureQ16ToBar(window.average()));
+  }
+}
+
+// 温度の窓は最初の値で埋まり、負の値の平均も最近接へ丸めること
+void test_moving_sum_fill_and_rounding()
+{
+  MovingSum<int32_t, 2> temperature(true);
+  temperature.push(8512);
+  TEST_ASSERT_EQUAL_INT32(8512, temperature.average());
+  temperature.push(8515);
+  TEST_ASSERT_EQUAL_INT32(8514, temperature.average());  // 8513.5 → 8514
+
+  MovingSum<int32_t, 4> negative;
+  for (int32_t v : {-3, -3, -3, -2})
+  {
+    negative.push(v);
+  }
+  TEST_ASSERT_TRUE(negative.sum() == -11);
+  TEST_ASSERT_EQUAL_INT32(-3, negative.average());  // -2.75 → -3
+}
+
+// 整数 EMA が float の EMA に追従し、一定入力では誤差なく収束すること
+void test_fixed_ema_tracks_float_ema()
+{
+  FixedEma fixed(alphaToQ16(ALPHA));
+  float reference = std::numeric_limits<float>::quiet_NaN();
+  for (int i = 0; i < 5000; ++i)
+  {
+    auto raw = static_cast<int16_t>(500 + nextRandom() % 1000);
+    int32_t q16 = convertAdcToPressureQ16(raw);
+    float bar = pressureQ16ToBar(q16);
+    reference = std::isnan(reference) ? bar : reference + ALPHA * (bar - reference);
+    TEST_ASSERT_FLOAT_WITHIN(0.001F, reference, pressureQ16ToBar(fixed.update(q16)));
+  }
+
+  FixedEma temperature(alphaToQ16(0.1F));
+  temperature.update(8000);
+  for (int i = 0; i < 300; ++i)
+  {
+    temperature.update(8003);
+  }
+  TEST_ASSERT_EQUAL_INT32(8003, temperature.value());
+}
+
+// 1 サンプルあたりの換算＋移動平均＋EMA の処理時間を float 版と比べる
+void test_benchmark_float_vs_fixed()
+{
+  constexpr int SAMPLES = 1000000;
+  static int16_t codes[4096];
+  for (int16_t &code : codes)
+  {
+    code = static_cast<int16_t>(nextRandom() % 2048);
+  }
+
+  float floatWindow[WINDOW] = {};
+  size_t index = 0;
+  float smooth = 0.0F;
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < SAMPLES; ++i)
+  {
+    floatWindow[index] = convertVoltageToOilPressure(convertAdcToVoltage(codes[i & 4095]));
+    index = (index + 1) % WINDOW;
+    smooth += ALPHA * (calculateAverage(floatWindow) - smooth);
+  }
+  auto middle = std::chrono::steady_clock::now();
+
+  MovingSum<int32_t, WINDOW> window;
+  FixedEma fixed(alphaToQ16(ALPHA));
+  for (int i = 0; i < SAMPLES; ++i)
+  {
+    window.push(convertAdcToPressureQ16(codes[i & 4095]));
+    fixed.update(window.average());
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  double floatNs = std::chrono::duration<double, std::nano>(middle - begin).count() / SAMPLES;
+  double fixedNs = std::chrono::duration<double, std::nano>(end - middle).count() / SAMPLES;
+  char message[80];
+  std::snprintf(message, sizeof(message), "float %.2f ns/sample, fixed %.2f ns/sample", floatNs, fixedNs);
+  TEST_MESSAGE(message);
+  // 最適化で消されないよう結果を使う
+  TEST_ASSERT_FLOAT_WITHIN(0.01F, smooth, pressureQ16ToBar(fixed.value()));
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_pressure_matches_float_formula);
+  RUN_TEST(test_moving_sum_matches_float_average);
+  RUN_TEST(test_moving_sum_fill_and_rounding);
+  RUN_TEST(test_fixed_ema_tracks_float_ema);
+  RUN_TEST(test_benchmark_float_vs_fixed);
+  return UNITY_END();
+}
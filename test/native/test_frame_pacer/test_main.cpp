@@ -0,0 +1,154 @@
+#include <unity.h>
+
+#include "config.h"
+#include "hal/hal.h"
+#include "hal/host/host_power.h"
+#include "modules/frame_pacer.h"
+#include "modules/rate_scheduler.h"
+
+static uint32_t taskBusyUs = 0;
+static int taskRuns = 0;
+static int boostedRuns = 0;
+
+// 実行のたびに taskBusyUs だけ仮想時計を進め、最高周波数で動いていたかを数える
+static void busyTask()
+{
+  taskRuns++;
+  if (hostPowerState().boosted) boostedRuns++;
+  hostClockAdvanceUs(taskBusyUs);
+}
+
+static void resetTask(uint32_t busyUs)
+{
+  taskBusyUs = busyUs;
+  taskRuns = 0;
+  boostedRuns = 0;
+}
+
+// 終了時刻ちょうどの締め切りまで回す
+static void runFor(FramePacer &pacer, RateScheduler &scheduler, uint64_t durationUs)
+{
+  uint64_t end = hostClockNowUs() + durationUs;
+  while (hostClockNowUs() <= end)
+  {
+    pacer.runOnce(scheduler);
+  }
+}
+
+// 60fps の描画が 4ms かかるとき、残りの時間は最低周波数で眠り、起きていた割合が約 24% になること
+void test_sleeps_between_frames()
+{
+  hostClockSetUs(0);
+  resetTask(4000);
+  RateScheduler scheduler;
+  scheduler.addTask("render", 1000000 / 60, busyTask, 1000000 / 60);
+  FramePacer pacer;
+  TEST_ASSERT_TRUE(pacer.begin(true));
+  TEST_ASSERT_EQUAL_UINT32(CPU_FREQ_MIN_MHZ, hostPowerState().minMhz);
+  TEST_ASSERT_EQUAL(POWER_LIGHT_SLEEP_ENABLED, hostPowerState().lightSleep);
+
+  runFor(pacer, scheduler, 1000000);
+
+  const PacingStats &stats = pacer.stats();
+  TEST_ASSERT_EQUAL_INT(60, taskRuns);
+  TEST_ASSERT_EQUAL_INT(taskRuns, boostedRuns);
+  TEST_ASSERT_FALSE(hostPowerState().boosted);
+  // 最初の締め切りまでの 1 回と、各フレームの後の 60 回
+  TEST_ASSERT_EQUAL_UINT32(61, stats.sleeps);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.shortWaits);
+  TEST_ASSERT_EQUAL_UINT64(60 * 4000, stats.busyUs);
+  TEST_ASSERT_EQUAL_UINT64(hostPowerState().idleUs, stats.idleUs);
+  TEST_ASSERT_FLOAT_WITHIN(0.5F, 24.0F, stats.busyPercent());
+  // 消費電力の見積もりは起きていた割合で 2 つの目安を按分した値になる
+  float busy = stats.busyPercent() / 100.0F;
+  TEST_ASSERT_FLOAT_WITHIN(0.1F, busy * POWER_BUSY_MW + (1.0F - busy) * POWER_IDLE_MW, stats.estimatedPowerMw());
+  TEST_ASSERT_TRUE(stats.estimatedPowerMw() < POWER_BUSY_MW * 0.6F);
+}
+
+// 次の締め切りが PACING_MIN_SLEEP_US より近いときは眠らずに待ち、締め切りどおりに実行されること
+void test_short_waits_do_not_sleep()
+{
+  hostClockSetUs(0);
+  resetTask(0);
+  RateScheduler scheduler;
+  scheduler.addTask("acquire", 500, busyTask, 500);
+  FramePacer pacer;
+  pacer.begin(false);
+
+  runFor(pacer, scheduler, 100000);
+
+  TEST_ASSERT_EQUAL_INT(200, taskRuns);
+  TEST_ASSERT_EQUAL_UINT32(0, pacer.stats().sleeps);
+  TEST_ASSERT_EQUAL_UINT32(0, hostPowerState().idleCount);
+  TEST_ASSERT_EQUAL_UINT32(1, hostPowerState().boostCount);
+  TEST_ASSERT_FLOAT_WITHIN(0.01F, 100.0F, pacer.stats().busyPercent());
+  TEST_ASSERT_EQUAL_UINT32(0, scheduler.stats(0).misses);
+  TEST_ASSERT_EQUAL_UINT32(0, scheduler.stats(0).maxJitterUs);
+}
+
+// 電源管理が無いときは、フレームごとではなく描画が止まった・再開したときだけ周波数を切り替えること
+void test_direct_switching_follows_frame_state()
+{
+  hostClockSetUs(0);
+  resetTask(4000);
+  hostSetPowerManagementAvailable(false);
+  RateScheduler scheduler;
+  scheduler.addTask("render", 1000000 / 60, busyTask, 1000000 / 60);
+  FramePacer pacer;
+  TEST_ASSERT_FALSE(pacer.begin(true));
+  TEST_ASSERT_TRUE(hostPowerState().boosted);
+
+  // 描画が続く間は 1 回も切り替えず、フレームの合間も眠る
+  runFor(pacer, scheduler, 1000000);
+  for (int i = 0; i < 60; ++i)
+  {
+    pacer.countFrame(true);
+  }
+  TEST_ASSERT_EQUAL_INT(60, boostedRuns);
+  TEST_ASSERT_EQUAL_UINT32(1, hostPowerState().boostCount);
+  TEST_ASSERT_EQUAL_UINT32(0, pacer.stats().cpuSwitches);
+  TEST_ASSERT_EQUAL_UINT32(61, pacer.stats().sleeps);
+
+  // 飛ばしたフレームが続いたら 1 回だけ落とし、描画を再開したら 1 回だけ戻す
+  for (uint32_t i = 0; i < PACING_IDLE_AFTER_SKIPPED_FRAMES * 2; ++i)
+  {
+    pacer.countFrame(false);
+  }
+  TEST_ASSERT_FALSE(pacer.isActive());
+  TEST_ASSERT_FALSE(hostPowerState().boosted);
+  pacer.countFrame(true);
+  pacer.countFrame(false);
+  TEST_ASSERT_TRUE(hostPowerState().boosted);
+  TEST_ASSERT_EQUAL_UINT32(2, pacer.stats().cpuSwitches);
+  TEST_ASSERT_EQUAL_UINT32(2, hostPowerState().boostCount);
+  hostSetPowerManagementAvailable(true);
+}
+
+// 眠る長さは PACING_MIN_SLEEP_US 以上の待ちだけで、描画を飛ばした割合はフレーム数から出ること
+void test_sleep_budget_and_frame_counts()
+{
+  TEST_ASSERT_EQUAL_UINT32(0, FramePacer::sleepBudgetUs(0));
+  TEST_ASSERT_EQUAL_UINT32(0, FramePacer::sleepBudgetUs(PACING_MIN_SLEEP_US - 1));
+  TEST_ASSERT_EQUAL_UINT32(PACING_MIN_SLEEP_US, FramePacer::sleepBudgetUs(PACING_MIN_SLEEP_US));
+
+  FramePacer pacer;
+  for (int i = 0; i < 8; ++i)
+  {
+    pacer.countFrame(i % 4 == 0);
+  }
+  TEST_ASSERT_EQUAL_UINT32(2, pacer.stats().renderedFrames);
+  TEST_ASSERT_EQUAL_UINT32(6, pacer.stats().skippedFrames);
+  TEST_ASSERT_FLOAT_WITHIN(0.01F, 75.0F, pacer.stats().skippedPercent());
+  pacer.resetStats();
+  TEST_ASSERT_FLOAT_WITHIN(0.01F, 0.0F, pacer.stats().skippedPercent());
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_sleeps_between_frames);
+  RUN_TEST(test_short_waits_do_not_sleep);
+  RUN_TEST(test_direct_switching_follows_frame_state);
+  RUN_TEST(test_sleep_budget_and_frame_counts);
+  return UNITY_END();
+}
@@ -0,0 +1,236 @@
+#include <unity.h>
+
+#include <vector>
+
+#include "hal/gauge_canvas.h"
+#include "hal/hal.h"
+#include "hal/hal_lcd.h"
+#include "hal/host/host_power.h"
+#include "modules/frame_pipeline.h"
+
+constexpr int W = 320;
+constexpr int H = 240;
+constexpr size_t FRAME_PIXELS = static_cast<size_t>(W) * H;
+constexpr size_t STAGING_PIXELS = FRAME_PIXELS / 4;
+
+using TestPipeline = FramePipeline<GaugeCanvas, HostDisplay, GaugePixel>;
+
+struct Fixture;
+// 完了通知を受け取る試験中のパイプライン
+static Fixture *activeFixture = nullptr;
+
+struct Fixture
+{
+  HostDisplay lcd;
+  GaugeCanvas canvas{&lcd};
+  std::vector<GaugePixel> bufferA = std::vector<GaugePixel>(FRAME_PIXELS, 0);
+  std::vector<GaugePixel> bufferB = std::vector<GaugePixel>(FRAME_PIXELS, 0);
+  std::vector<GaugePixel> staging = std::vector<GaugePixel>(STAGING_PIXELS, 0);
+  TestPipeline pipeline{canvas, lcd};
+
+  explicit Fixture(size_t stagingPixels = STAGING_PIXELS)
+  {
+    hostClockSetUs(0);
+    canvas.attachBuffer(bufferA.data(), W, H);
+    pipeline.begin(bufferA.data(), bufferB.data(), W, H, staging.data(), stagingPixels);
+    activeFixture = this;
+    halLcdSetTransferDoneHandler([] { activeFixture->pipeline.onTransferDone(); });
+  }
+
+  ~Fixture()
+  {
+    halLcdSetTransferDoneHandler(nullptr);
+    activeFixture = nullptr;
+  }
+};
+
+// 転送中に次フレームを描いても、送り終えた LCD は描いた内容と一致すること
+void test_render_during_transfer_keeps_lcd_consistent()
+{
+  Fixture f;
+  f.pipeline.beginFrame();
+  f.canvas.fillScreen(0x1234);
+  f.pipeline.present();
+
+  // 1 フレーム目の転送が終わる前に 2 フレーム目を描く
+  f.pipeline.beginFrame();
+  f.canvas.fillRect(10, 10, 50, 20, 0xFFFF);
+  f.canvas.fillArc(200, 150, 40, 60, 0.0F, 120.0F, 0xF800);
+  TEST_ASSERT_TRUE(f.lcd.dmaBusy());
+  f.pipeline.present();
+
+  // 3 フレーム目は 2 フレーム目と同じ内容から描き始められること
+  TEST_ASSERT_EQUAL_MEMORY(f.bufferA.data(), f.bufferB.data(), FRAME_PIXELS * sizeof(GaugePixel));
+
+  f.pipeline.finish();
+  TEST_ASSERT_EQUAL_MEMORY(f.canvas.getBuffer(), f.lcd.framebuffer(), FRAME_PIXELS * sizeof(uint16_t));
+}
+
+// 離れた小さな更新矩形は全幅の帯に広げず、矩形のまま送ること
+void test_transfers_clipped_rects()
+{
+  Fixture f;
+  f.pipeline.beginFrame();
+  f.canvas.fillScreen(0);
+  f.pipeline.present();
+  f.pipeline.finish();
+
+  f.pipeline.beginFrame();
+  f.canvas.fillRect(0, 10, 20, 10, 0xFFFF);
+  f.canvas.fillRect(300, 15, 20, 10, 0xFFFF);
+  f.canvas.fillRect(100, 200, 10, 10, 0xFFFF);
+  f.pipeline.present();
+  TEST_ASSERT_EQUAL_UINT32((200 + 200 + 100) * sizeof(uint16_t), f.canvas.lastPushBytes());
+  f.pipeline.finish();
+  TEST_ASSERT_EQUAL_MEMORY(f.canvas.getBuffer(), f.lcd.framebuffer(), FRAME_PIXELS * sizeof(uint16_t));
+}
+
+// 詰め替え領域が足りなければ、縦に重なる矩形の組を全幅の帯で送ること
+void test_falls_back_to_bands_without_staging()
+{
+  Fixture f(0);
+  f.pipeline.beginFrame();
+  f.canvas.fillScreen(0);
+  f.pipeline.present();
+  f.pipeline.finish();
+
+  f.pipeline.beginFrame();
+  f.canvas.fillRect(0, 10, 20, 10, 0xFFFF);
+  f.canvas.fillRect(300, 15, 20, 10, 0xFFFF);
+  f.canvas.fillRect(100, 200, 10, 10, 0xFFFF);
+  f.pipeline.present();
+  TEST_ASSERT_EQUAL_UINT32((15 + 10) * W * sizeof(uint16_t), f.canvas.lastPushBytes());
+  f.pipeline.finish();
+  TEST_ASSERT_EQUAL_MEMORY(f.canvas.getBuffer(), f.lcd.framebuffer(), FRAME_PIXELS * sizeof(uint16_t));
+}
+
+// バスとライトスリープの禁止は転送中だけ持ち、送り終えたら手放すこと
+void test_bus_is_released_between_frames()
+{
+  Fixture f;
+  TEST_ASSERT_EQUAL_INT(0, f.lcd.writeDepth());
+  f.pipeline.beginFrame();
+  f.canvas.fillRect(0, 0, 100, 100, 0xFFFF);
+  f.canvas.fillRect(200, 150, 100, 80, 0xF800);
+  f.pipeline.present();
+  TEST_ASSERT_EQUAL_INT(1, f.lcd.writeDepth());
+  TEST_ASSERT_TRUE(hostPowerState().awakeHeld);
+
+  // 描画の合間に service() で残りを積み、最後の転送が終われば手放す
+  while (f.lcd.writeDepth() > 0)
+  {
+    hostClockAdvanceUs(1000);
+    f.pipeline.service();
+  }
+  TEST_ASSERT_FALSE(f.lcd.dmaBusy());
+  TEST_ASSERT_FALSE(hostPowerState().awakeHeld);
+
+  // 変化の無いフレームではバスを握らない
+  f.pipeline.beginFrame();
+  f.pipeline.present();
+  TEST_ASSERT_EQUAL_INT(0, f.lcd.writeDepth());
+  TEST_ASSERT_FALSE(hostPowerState().awakeHeld);
+}
+
+// 描画中に前フレームの転送が進んだ時間が重なりとして計上され、待ちが無いこと
+void test_overlap_is_measured()
+{
+  Fixture f;
+  f.pipeline.beginFrame();
+  f.canvas.fillScreen(0);
+  f.pipeline.present();
+  // 全画面 153600B は HOST_DMA_BYTES_PER_US で 30720us かかる
+  uint32_t transferUs = FRAME_PIXELS * sizeof(uint16_t) / HOST_DMA_BYTES_PER_US;
+
+  // 描画に 10ms かかった場合は 10ms すべてが転送と重なり、残りはフェンスで待つ
+  f.pipeline.beginFrame();
+  f.canvas.fillRect(0, 0, 10, 10, 0xFFFF);
+  hostClockAdvanceUs(10000);
+  f.pipeline.present();
+  TEST_ASSERT_EQUAL_UINT64(10000, f.pipeline.lastFrame().overlapUs);
+  TEST_ASSERT_EQUAL_UINT64(transferUs - 10000, f.pipeline.lastFrame().fenceWaitUs);
+
+  // 小さな転送は描画の途中で終わり、重なりは転送時間（10×10 画素 200B で 40us）になる
+  f.pipeline.beginFrame();
+  hostClockAdvanceUs(10000);
+  f.pipeline.present();
+  TEST_ASSERT_EQUAL_UINT64(40, f.pipeline.lastFrame().overlapUs);
+  TEST_ASSERT_EQUAL_UINT64(0, f.pipeline.lastFrame().fenceWaitUs);
+  TEST_ASSERT_EQUAL_UINT32(3, f.pipeline.stats().frames);
+}
+
+// 複数の矩形は描画側が service() を呼ばなくても完了通知で続けて送られ、次フレームの描画と重なること
+void test_rects_are_chained_without_polling()
+{
+  Fixture f;
+  f.pipeline.beginFrame();
+  f.canvas.fillScreen(0);
+  f.pipeline.present();
+  f.pipeline.finish();
+
+  // 400B + 400B + 200B の 3 回に分かれ、合わせて 200us かかる
+  f.pipeline.beginFrame();
+  f.canvas.fillRect(0, 10, 20, 10, 0xFFFF);
+  f.canvas.fillRect(300, 15, 20, 10, 0xFFFF);
+  f.canvas.fillRect(100, 200, 10, 10, 0xFFFF);
+  f.pipeline.present();
+
+  // 次のフレームの描画中は一度も転送を確かめない
+  f.pipeline.beginFrame();
+  hostClockAdvanceUs(1000);
+  TEST_ASSERT_EQUAL_INT(0, f.lcd.writeDepth());
+  f.pipeline.present();
+  TEST_ASSERT_EQUAL_UINT64(200, f.pipeline.lastFrame().overlapUs);
+  TEST_ASSERT_EQUAL_UINT64(0, f.pipeline.lastFrame().fenceWaitUs);
+  TEST_ASSERT_EQUAL_MEMORY(f.canvas.getBuffer(), f.lcd.framebuffer(), FRAME_PIXELS * sizeof(uint16_t));
+}
+
+// DMA は staging だけを読み、staging より大きな転送も行の束に分けて送り切ること
+void test_transfers_read_only_staging()
+{
+  Fixture f;
+  f.lcd.restrictDmaSource(f.staging.data(), f.staging.size());
+  f.pipeline.beginFrame();
+  f.canvas.fillScreen(0x1234);
+  f.pipeline.present();
+
+  // 200×100 = 20000 画素の矩形は staging の半分 (9600 画素) に収まらない
+  f.pipeline.beginFrame();
+  f.canvas.fillRect(60, 70, 200, 100, 0xFFFF);
+  f.canvas.fillRect(5, 5, 10, 10, 0xF800);
+  f.pipeline.present();
+  TEST_ASSERT_EQUAL_UINT32((20000 + 100) * sizeof(uint16_t), f.canvas.lastPushBytes());
+  f.pipeline.finish();
+  TEST_ASSERT_EQUAL_UINT32(0, f.lcd.invalidDmaSources());
+  TEST_ASSERT_EQUAL_MEMORY(f.canvas.getBuffer(), f.lcd.framebuffer(), FRAME_PIXELS * sizeof(uint16_t));
+}
+
+// 2 枚目が無ければ同期転送のまま動くこと
+void test_falls_back_to_synchronous_push()
+{
+  HostDisplay lcd;
+  GaugeCanvas canvas(&lcd);
+  canvas.createSprite(W, H);
+  TestPipeline pipeline(canvas, lcd);
+  TEST_ASSERT_FALSE(pipeline.begin(canvas.getBuffer(), nullptr, W, H));
+
+  pipeline.beginFrame();
+  canvas.fillRect(5, 5, 10, 10, 0xFFFF);
+  pipeline.present();
+  TEST_ASSERT_FALSE(lcd.dmaBusy());
+  TEST_ASSERT_EQUAL_MEMORY(canvas.getBuffer(), lcd.framebuffer(), FRAME_PIXELS * sizeof(uint16_t));
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_render_during_transfer_keeps_lcd_consistent);
+  RUN_TEST(test_transfers_clipped_rects);
+  RUN_TEST(test_falls_back_to_bands_without_staging);
+  RUN_TEST(test_bus_is_released_between_frames);
+  RUN_TEST(test_overlap_is_measured);
+  RUN_TEST(test_rects_are_chained_without_polling);
+  RUN_TEST(test_transfers_read_only_staging);
+  RUN_TEST(test_falls_back_to_synchronous_push);
+  return UNITY_END();
+}
@@ -0,0 +1,126 @@
+#include <unity.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "config.h"
+#include "modules/display.h"
+#include "modules/gauge_layout.h"
+#include "modules/stage_timing.h"
+
+static auto makeValues(float pressure, float water, float oil) -> GaugeValues
+{
+  GaugeValues values = {};
+  values.current[static_cast<size_t>(GaugeSource::OilPressure)] = pressure;
+  values.current[static_cast<size_t>(GaugeSource::WaterTemp)] = water;
+  values.current[static_cast<size_t>(GaugeSource::OilTemp)] = oil;
+  return values;
+}
+
+// 配置表の各ゲージが画面内に収まり、範囲と目盛が正しく宣言されていること
+void test_layout_is_consistent()
+{
+  for (size_t i = 0; i < GAUGE_COUNT; ++i)
+  {
+    const GaugeSpec &spec = GAUGE_LAYOUT[i];
+    TEST_ASSERT_TRUE(spec.maxValue > spec.minValue);
+    TEST_ASSERT_TRUE(spec.threshold >= spec.minValue && spec.threshold <= spec.maxValue);
+    TEST_ASSERT_TRUE(spec.tickStep > 0.0F);
+    TEST_ASSERT_TRUE(spec.redrawDelta > 0.0F);
+    TEST_ASSERT_TRUE(spec.region.x >= 0 && spec.region.x + spec.region.w <= LCD_WIDTH);
+    TEST_ASSERT_TRUE(spec.region.y >= 0 && spec.region.y + spec.region.h <= LCD_HEIGHT);
+  }
+  TEST_ASSERT_EQUAL_size_t(0, findGauge(GaugeKind::TopBar, GaugeSource::OilTemp));
+  TEST_ASSERT_EQUAL_size_t(1, findGauge(GaugeKind::Arc, GaugeSource::OilPressure));
+  TEST_ASSERT_EQUAL_size_t(GAUGE_COUNT, findGauge(GaugeKind::Arc, GaugeSource::OilTemp));
+}
+
+// ADC チャンネルから出どころと表示単位の値が表で引けること
+void test_inputs_map_channels_to_sources()
+{
+  TEST_ASSERT_TRUE(gaugeSourceForChannel(ADC_CH_OIL_PRESSURE) == GaugeSource::OilPressure);
+  TEST_ASSERT_TRUE(gaugeSourceForChannel(ADC_CH_WATER_TEMP) == GaugeSource::WaterTemp);
+  TEST_ASSERT_TRUE(gaugeSourceForChannel(ADC_CH_OIL_TEMP) == GaugeSource::OilTemp);
+  TEST_ASSERT_TRUE(gaugeSourceForChannel(3) == GaugeSource::Count);
+
+  const GaugeInput &pressure = gaugeSpecFor(GaugeSource::OilPressure).input;
+  TEST_ASSERT_FLOAT_WITHIN(0.001F, 4.5F, gaugeInputValue(pressure, barToPressureQ16(4.5F)));
+  // 表示上限で頭打ちになる
+  TEST_ASSERT_FLOAT_WITHIN(0.001F, MAX_OIL_PRESSURE_DISPLAY, gaugeInputValue(pressure, barToPressureQ16(20.0F)));
+  const GaugeInput &water = gaugeSpecFor(GaugeSource::WaterTemp).input;
+  TEST_ASSERT_FLOAT_WITHIN(0.001F, 92.5F, gaugeInputValue(water, 9250));
+  // センサーが無い入力は常に 0
+  GaugeInput absent = {ADC_CH_OIL_TEMP, false, centiToCelsius};
+  TEST_ASSERT_TRUE(gaugeInputValue(absent, 9250) == 0.0F);
+}
+
+// 表の更新幅未満の変化では描き直さず、描いた値は出どころごとに残ること
+void test_render_skips_small_changes()
+{
+  display.init();
+  TEST_ASSERT_TRUE(beginFramePipeline());
+  TEST_ASSERT_TRUE(beginDisplayLayers());
+  resetStageTimings();
+
+  TEST_ASSERT_TRUE(renderDisplayAndLog(makeValues(3.0F, 90.0F, 100.0F)));
+  TEST_ASSERT_EQUAL_UINT32(1, stageHistogram(TimingStage::PressureGauge).count());
+  TEST_ASSERT_EQUAL_UINT32(1, stageHistogram(TimingStage::WaterGauge).count());
+  TEST_ASSERT_EQUAL_UINT32(1, stageHistogram(TimingStage::OilTopBar).count());
+
+  // 油圧だけが更新幅 0.05 を超える
+  TEST_ASSERT_TRUE(renderDisplayAndLog(makeValues(3.06F, 90.05F, 100.05F)));
+  TEST_ASSERT_EQUAL_UINT32(2, stageHistogram(TimingStage::PressureGauge).count());
+  TEST_ASSERT_EQUAL_UINT32(1, stageHistogram(TimingStage::WaterGauge).count());
+  TEST_ASSERT_EQUAL_UINT32(1, stageHistogram(TimingStage::OilTopBar).count());
+  TEST_ASSERT_FLOAT_WITHIN(0.001F, 3.06F, displayCache[GaugeSource::OilPressure]);
+  TEST_ASSERT_FLOAT_WITHIN(0.001F, 90.0F, displayCache[GaugeSource::WaterTemp]);
+  finishFrameTransfer();
+}
+
+// 断線表示のまま値が変わらなければ横バーを毎フレーム描き直さず、フレームごと飛ばすこと
+void test_error_value_is_drawn_once()
+{
+  resetStageTimings();
+  for (int frame = 0; frame < 5; ++frame)
+  {
+    TEST_ASSERT_EQUAL(frame == 0, renderDisplayAndLog(makeValues(3.06F, 90.0F, 200.0F)));
+  }
+  TEST_ASSERT_EQUAL_UINT32(1, stageHistogram(TimingStage::OilTopBar).count());
+  TEST_ASSERT_FLOAT_WITHIN(0.001F, 200.0F, displayCache[GaugeSource::OilTemp]);
+  finishFrameTransfer();
+}
+
+// 横バーを差分だけで描き続けても、毎回全体を描き直した画面と画素単位で一致すること
+void test_incremental_top_bar_matches_full_redraw()
+{
+  constexpr size_t TOP_BAR = findGauge(GaugeKind::TopBar, GaugeSource::OilTemp);
+  constexpr size_t BUFFER_BYTES = static_cast<size_t>(LCD_WIDTH) * LCD_HEIGHT * sizeof(uint16_t);
+  // 伸びる・縮む・警告値をまたぐ・整数部だけ変わる・断線・範囲外を順に通る
+  const float temps[] = {80.0F, 100.0F, 100.5F, 101.2F, 121.0F, 125.3F, 119.0F, 95.0F, 200.0F, 130.0F, 79.0F, 122.0F};
+  GaugeDrawState incremental;
+  int peak = 0;
+  std::vector<uint8_t> drawn(BUFFER_BYTES);
+  for (float temp : temps)
+  {
+    peak = std::max(peak, static_cast<int>(temp));
+    drawGaugeValue(mainCanvas, TOP_BAR, temp, static_cast<float>(peak), incremental);
+    const auto *pixels = static_cast<const uint8_t *>(static_cast<const void *>(mainCanvas.getBuffer()));
+    drawn.assign(pixels, pixels + BUFFER_BYTES);
+
+    GaugeDrawState fresh;
+    drawGaugeValue(mainCanvas, TOP_BAR, temp, static_cast<float>(peak), fresh);
+    TEST_ASSERT_EQUAL_MEMORY(drawn.data(), mainCanvas.getBuffer(), BUFFER_BYTES);
+  }
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_layout_is_consistent);
+  RUN_TEST(test_inputs_map_channels_to_sources);
+  RUN_TEST(test_render_skips_small_changes);
+  RUN_TEST(test_error_value_is_drawn_once);
+  RUN_TEST(test_incremental_top_bar_matches_full_redraw);
+  return UNITY_END();
+}
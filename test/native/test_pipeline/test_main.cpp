@@ -0,0 +1,115 @@
+#include <unity.h>
+
+#include <cstring>
+
+#include "config.h"
+#include "hal/hal.h"
+#include "hal/host/host_ads1015.h"
+#include "modules/display.h"
+#include "modules/sensor.h"
+#include "modules/sensor_conversion.h"
+#include "modules/session_records.h"
+
+// 部分転送で LCD とキャンバスの内容がずれていないか
+static bool lcdMatchesCanvas = true;
+
+// 仮想時計を進めながら 1 フレーム分の取得と描画を行う
+static void runFrame()
+{
+  for (int i = 0; i < 167; ++i)
+  {
+    hostClockAdvanceUs(100);
+    acquireSensorData();
+  }
+  updateGauges();
+  // 非同期転送を送り切ってから比べる
+  finishFrameTransfer();
+  lcdMatchesCanvas &= std::memcmp(display.framebuffer(), mainCanvas.getBuffer(),
+                                  static_cast<size_t>(LCD_WIDTH) * LCD_HEIGHT * sizeof(uint16_t)) == 0;
+}
+
+// 取得から描画までホスト上で一通り動くこと
+void test_pipeline_acquires_and_renders()
+{
+  display.init();
+  TEST_ASSERT_TRUE(beginFramePipeline());
+  TEST_ASSERT_TRUE(beginDisplayLayers());
+  TEST_ASSERT_TRUE(beginSensorAcquisition());
+
+  HostAds1015 &ads = hostAds1015();
+  ads.setChannelVoltage(ADC_CH_OIL_PRESSURE, 2.5F);
+  ads.setChannelVoltage(ADC_CH_WATER_TEMP, 1.0F);
+  ads.setChannelVoltage(ADC_CH_OIL_TEMP, 1.0F);
+
+  for (int frame = 0; frame < 120; ++frame)
+  {
+    runFrame();
+  }
+
+  float expectedPressure = convertVoltageToOilPressure(convertAdcToVoltage(ads.channelCode[ADC_CH_OIL_PRESSURE]));
+  float expectedTemp = convertVoltageToTemp(convertAdcToVoltage(ads.channelCode[ADC_CH_WATER_TEMP]));
+  TEST_ASSERT_FLOAT_WITHIN(0.01F, expectedPressure, pressureQ16ToBar(sensorReadings[ADC_CH_OIL_PRESSURE]));
+  TEST_ASSERT_FLOAT_WITHIN(0.1F, expectedTemp, centiToCelsius(sensorReadings[ADC_CH_WATER_TEMP]));
+  TEST_ASSERT_FLOAT_WITHIN(0.1F, expectedTemp, centiToCelsius(sensorReadings[ADC_CH_OIL_TEMP]));
+
+  // 描画結果が LCD 側のフレームバッファまで転送されていること
+  uint32_t hash = display.frameHash();
+  TEST_ASSERT_NOT_EQUAL(HostDisplay().frameHash(), hash);
+
+  // 油圧が変われば画面も変わること
+  ads.setChannelVoltage(ADC_CH_OIL_PRESSURE, 4.0F);
+  for (int frame = 0; frame < 60; ++frame)
+  {
+    runFrame();
+  }
+  TEST_ASSERT_NOT_EQUAL(hash, display.frameHash());
+
+  // 更新範囲だけの転送でも描画内容の取りこぼしが無いこと
+  TEST_ASSERT_TRUE(lcdMatchesCanvas);
+  // 全画面転送を毎フレーム行うより転送量が少ないこと
+  TEST_ASSERT_LESS_THAN(static_cast<uint64_t>(LCD_WIDTH) * LCD_HEIGHT * 2 * 180, mainCanvas.totalPushBytes());
+}
+
+// 温度の断線が続いた後に復帰しても、印と正常値の平均が最高値やレッドゾーンに数えられないこと
+void test_disconnect_burst_does_not_reach_records()
+{
+  HostAds1015 &ads = hostAds1015();
+  ads.setChannelVoltage(ADC_CH_WATER_TEMP, 1.0F);
+  ads.setChannelVoltage(ADC_CH_OIL_TEMP, 1.0F);
+  for (int frame = 0; frame < 60; ++frame)
+  {
+    runFrame();
+  }
+  sessionRecords().resetSession(halMillis());
+  float expectedTemp = convertVoltageToTemp(convertAdcToVoltage(ads.channelCode[ADC_CH_WATER_TEMP]));
+
+  // 約 1.5 秒の断線（コード 0 で 200℃ の印）の後、正常値へ戻す
+  ads.setChannelVoltage(ADC_CH_WATER_TEMP, 0.0F);
+  ads.setChannelVoltage(ADC_CH_OIL_TEMP, 0.0F);
+  for (int frame = 0; frame < 90; ++frame)
+  {
+    runFrame();
+  }
+  ads.setChannelVoltage(ADC_CH_WATER_TEMP, 1.0F);
+  ads.setChannelVoltage(ADC_CH_OIL_TEMP, 1.0F);
+  for (int frame = 0; frame < 120; ++frame)
+  {
+    runFrame();
+  }
+
+  SessionRecords &records = sessionRecords();
+  TEST_ASSERT_FLOAT_WITHIN(0.1F, expectedTemp, records.sessionPeak(GaugeSource::WaterTemp));
+  TEST_ASSERT_FLOAT_WITHIN(0.1F, expectedTemp, records.sessionPeak(GaugeSource::OilTemp));
+  StoredRecords snapshot = records.snapshot();
+  TEST_ASSERT_EQUAL_UINT32(0, snapshot.session.redZoneSeconds[static_cast<size_t>(GaugeSource::WaterTemp)]);
+  TEST_ASSERT_EQUAL_UINT32(0, snapshot.session.redZoneSeconds[static_cast<size_t>(GaugeSource::OilTemp)]);
+  TEST_ASSERT_FLOAT_WITHIN(0.1F, expectedTemp, centiToCelsius(sensorReadings[ADC_CH_WATER_TEMP]));
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_pipeline_acquires_and_renders);
+  RUN_TEST(test_disconnect_burst_does_not_reach_records);
+  return UNITY_END();
+}
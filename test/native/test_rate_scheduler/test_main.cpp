@@ -0,0 +1,128 @@
+#include <unity.h>
+
+#include <cstring>
+
+#include "hal/hal.h"
+#include "modules/rate_scheduler.h"
+
+static int fastRuns = 0;
+static int slowRuns = 0;
+static char order[8];
+static size_t orderLength = 0;
+static uint32_t busyUs = 0;
+
+static void fastTask()
+{
+  fastRuns++;
+  if (orderLength < sizeof(order) - 1) order[orderLength++] = 'f';
+}
+
+static void slowTask()
+{
+  slowRuns++;
+  if (orderLength < sizeof(order) - 1) order[orderLength++] = 's';
+  hostClockAdvanceUs(busyUs);
+}
+
+static void resetCounters()
+{
+  fastRuns = 0;
+  slowRuns = 0;
+  orderLength = 0;
+  std::memset(order, 0, sizeof(order));
+  busyUs = 0;
+}
+
+// 次の締め切りまで時計を進めて回す
+static void runFor(RateScheduler &scheduler, uint32_t durationUs)
+{
+  uint64_t end = hostClockNowUs() + durationUs;
+  while (hostClockNowUs() < end)
+  {
+    hostClockAdvanceUs(scheduler.untilNextDeadlineUs(halMicros()));
+    if (hostClockNowUs() > end) break;
+    scheduler.runDue();
+  }
+}
+
+// 1 秒間で宣言した周期どおりの回数だけ実行され、遅れも取りこぼしも無いこと
+void test_runs_at_declared_rates()
+{
+  resetCounters();
+  hostClockSetUs(0);
+  RateScheduler scheduler;
+  scheduler.addTask("pressure", 2000, fastTask, 2000);
+  scheduler.addTask("render", 1000000 / 60, slowTask, 1000000 / 60);
+
+  runFor(scheduler, 1000000);
+
+  TEST_ASSERT_EQUAL_INT(500, fastRuns);
+  TEST_ASSERT_EQUAL_INT(60, slowRuns);
+  TEST_ASSERT_EQUAL_UINT32(0, scheduler.stats(0).misses);
+  TEST_ASSERT_EQUAL_UINT32(0, scheduler.stats(0).maxJitterUs);
+  TEST_ASSERT_EQUAL_UINT32(0, scheduler.stats(1).misses);
+}
+
+// 同時に締め切りを迎えたタスクは締め切りの早い順に実行されること
+void test_earliest_deadline_first()
+{
+  resetCounters();
+  hostClockSetUs(0);
+  RateScheduler scheduler;
+  scheduler.addTask("slow", 1000, slowTask, 300);
+  scheduler.addTask("fast", 1000, fastTask, 100);
+
+  hostClockSetUs(500);
+  TEST_ASSERT_EQUAL_UINT32(2, scheduler.runDue());
+  TEST_ASSERT_EQUAL_STRING("fs", order);
+  TEST_ASSERT_EQUAL_UINT32(400, scheduler.stats(1).maxJitterUs);
+  TEST_ASSERT_EQUAL_UINT32(200, scheduler.stats(0).maxJitterUs);
+  // 次の締め切りは 1100us（fast）
+  TEST_ASSERT_EQUAL_UINT32(600, scheduler.untilNextDeadlineUs(halMicros()));
+}
+
+// 重いタスクで遅れた周期は取りこぼしとして数え、まとめて追いかけ実行しないこと
+void test_overrun_counts_misses_without_burst()
+{
+  resetCounters();
+  hostClockSetUs(0);
+  RateScheduler scheduler;
+  scheduler.addTask("fast", 1000, fastTask, 1000);
+  scheduler.addTask("slow", 10000, slowTask, 10000);
+
+  busyUs = 4500;  // slow が 4.5 周期分 fast を止める
+  runFor(scheduler, 25000);
+
+  const ScheduledTaskStats &fast = scheduler.stats(0);
+  // 25 周期のうち、slow の 2 回の実行中に 3 周期ずつ飛び、4 周期目を 500us 遅れで実行する
+  TEST_ASSERT_EQUAL_INT(2, slowRuns);
+  TEST_ASSERT_EQUAL_UINT32(6, fast.misses);
+  TEST_ASSERT_EQUAL_INT(25 - 6, fastRuns);
+  TEST_ASSERT_EQUAL_UINT32(fastRuns, fast.runs);
+  TEST_ASSERT_EQUAL_UINT32(500, fast.maxJitterUs);
+  TEST_ASSERT_EQUAL_UINT32(4500, scheduler.stats(1).maxRunUs);
+}
+
+// 登録数の上限と不正な周期を拒否すること
+void test_rejects_invalid_tasks()
+{
+  RateScheduler scheduler;
+  TEST_ASSERT_EQUAL_INT(-1, scheduler.addTask("zero", 0, fastTask, 0));
+  TEST_ASSERT_EQUAL_INT(-1, scheduler.addTask("null", 1000, nullptr, 0));
+  for (size_t i = 0; i < RateScheduler::MAX_TASKS; ++i)
+  {
+    TEST_ASSERT_EQUAL_INT(static_cast<int>(i), scheduler.addTask("t", 1000, fastTask, 0));
+  }
+  TEST_ASSERT_EQUAL_INT(-1, scheduler.addTask("over", 1000, fastTask, 0));
+  scheduler.dump();
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_runs_at_declared_rates);
+  RUN_TEST(test_earliest_deadline_first);
+  RUN_TEST(test_overrun_counts_misses_without_burst);
+  RUN_TEST(test_rejects_invalid_tasks);
+  return UNITY_END();
+}
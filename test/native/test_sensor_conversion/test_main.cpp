@@ -1,7 +1,7 @@
 #include <unity.h>
 
-// sensor.cppを直接インクルードして静的関数を利用
-#include "../src/modules/sensor.cpp"
+#include "modules/sensor.h"
+#include "modules/sensor_conversion.h"
 
 // ADC値から電圧への変換をテスト
 void test_convert_adc_to_voltage()
@@ -45,17 +45,12 @@ void test_calculate_average()
 }
 
 // テスト実行
-void setup()
+int main()
 {
   UNITY_BEGIN();
   RUN_TEST(test_convert_adc_to_voltage);
   RUN_TEST(test_convert_voltage_to_oil_pressure);
   RUN_TEST(test_convert_voltage_to_temp);
   RUN_TEST(test_calculate_average);
-  UNITY_END();
-}
-
-void loop()
-{
-  // ループは使用しない
+  return UNITY_END();
 }
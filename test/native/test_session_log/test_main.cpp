@@ -0,0 +1,199 @@
+#include <unity.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "config.h"
+#include "hal/hal.h"
+#include "hal/host/host_log_fs.h"
+#include "modules/session_log.h"
+
+// 負荷試験のレート。ADS1015 の最高データレートで、実際の取得レート（RAW_SAMPLE_RATE_HZ）より十分高い
+constexpr uint32_t STRESS_SAMPLE_RATE_HZ = 1600;
+
+static auto readBack(HostLogFs &fs, const char *path, std::vector<SessionLogEntry> &entries) -> bool
+{
+  const std::vector<uint8_t> &file = fs.files[path];
+  SessionLogReader reader;
+  if (!reader.open(file.data(), file.size())) return false;
+  SessionLogEntry entry;
+  while (reader.next(entry))
+  {
+    entries.push_back(entry);
+  }
+  return true;
+}
+
+// 時刻・チャンネル・負のコード・長い空白がそのまま復元できること
+void test_round_trip()
+{
+  HostLogFs fs;
+  SessionLogWriter writer(fs);
+  TEST_ASSERT_TRUE(writer.begin("/a.bin", 1000));
+  writer.record(1000, 2, 0);
+  writer.record(1713, 2, 2047);
+  writer.record(1713, 1, -2048);
+  writer.record(501713, 0, -1);       // 0xFFFF を超える間隔はギャップで表す
+  writer.record(400000000, 2, 1234);  // 2^28 を超える間隔
+  writer.record(399999000, 2, 5);     // 時刻の逆行は経過 0 とする
+  writer.end();
+
+  std::vector<SessionLogEntry> entries;
+  TEST_ASSERT_TRUE(readBack(fs, "/a.bin", entries));
+  TEST_ASSERT_EQUAL_size_t(6, entries.size());
+  const SessionLogEntry expected[] = {{1000, 2, 0},        {1713, 2, 2047},      {1713, 1, -2048},
+                                      {501713, 0, -1},     {400000000, 2, 1234}, {400000000, 2, 5}};
+  for (size_t i = 0; i < entries.size(); ++i)
+  {
+    TEST_ASSERT_EQUAL_UINT32(expected[i].timestampUs, entries[i].timestampUs);
+    TEST_ASSERT_EQUAL_UINT8(expected[i].channel, entries[i].channel);
+    TEST_ASSERT_EQUAL_INT16(expected[i].raw, entries[i].raw);
+  }
+}
+
+// ヘッダーに形式とバージョンが入り、異なるバージョンは読み込まないこと
+void test_versioned_header()
+{
+  HostLogFs fs;
+  SessionLogWriter writer(fs);
+  writer.begin("/h.bin", 42);
+  writer.end();
+
+  std::vector<uint8_t> &file = fs.files["/h.bin"];
+  TEST_ASSERT_EQUAL_size_t(sizeof(SessionLogHeader), file.size());
+  TEST_ASSERT_EQUAL_MEMORY("RGSL", file.data(), 4);
+  SessionLogReader reader;
+  TEST_ASSERT_TRUE(reader.open(file.data(), file.size()));
+  TEST_ASSERT_EQUAL_UINT16(SESSION_LOG_VERSION, reader.header().version);
+  TEST_ASSERT_EQUAL_UINT32(42, reader.header().startUs);
+
+  file[4] = SESSION_LOG_VERSION + 1;
+  TEST_ASSERT_FALSE(reader.open(file.data(), file.size()));
+}
+
+// 書き込みはページ単位にまとめられ、端数は終了時の 1 回だけであること
+void test_writes_whole_pages()
+{
+  HostLogFs fs;
+  SessionLogWriter writer(fs);
+  writer.begin("/p.bin", 0);
+  constexpr size_t RECORDS = 3000;
+  for (size_t i = 0; i < RECORDS; ++i)
+  {
+    writer.record(static_cast<uint32_t>(i * 625), 2, static_cast<int16_t>(i & 0x7FF));
+    if (i % 100 == 0) writer.service();
+  }
+  writer.end();
+
+  TEST_ASSERT_EQUAL_size_t(sizeof(SessionLogHeader) + RECORDS * 4, fs.files["/p.bin"].size());
+  for (size_t i = 0; i + 1 < fs.writeSizes.size(); ++i)
+  {
+    TEST_ASSERT_EQUAL_size_t(SESSION_LOG_PAGE_SIZE, fs.writeSizes[i]);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, writer.droppedCount());
+}
+
+// 負荷試験として ADS1015 の上限 1600SPS（実際の取得レート RAW_SAMPLE_RATE_HZ の約 3 倍）で油圧と温度を流し、
+// 1 ページ 250ms かかるフラッシュ（GC 込みの最悪値）でも取りこぼさないこと
+void test_keeps_up_with_full_rate_under_slow_flash()
+{
+  HostLogFs fs;
+  fs.writeLatencyUs = 250000;
+  SessionLogWriter writer(fs);
+  hostClockSetUs(0);
+  writer.begin("/rate.bin", 0);
+
+  constexpr uint64_t DURATION_US = 30ULL * 1000 * 1000;
+  constexpr uint32_t SAMPLE_US = 1000000 / STRESS_SAMPLE_RATE_HZ;
+  static_assert(STRESS_SAMPLE_RATE_HZ > RAW_SAMPLE_RATE_HZ, "stress rate must exceed the configured rate");
+  uint64_t nextSampleUs = 0;
+  uint64_t nextServiceUs = 0;
+  uint32_t samples = 0;
+  while (hostClockNowUs() < DURATION_US)
+  {
+    // ログタスクが書き込みで止まっていた間の分もまとめて取得側が積む
+    while (nextSampleUs <= hostClockNowUs())
+    {
+      uint8_t channel = (samples % 100 == 99) ? 1 : 2;
+      writer.record(static_cast<uint32_t>(nextSampleUs), channel, static_cast<int16_t>(samples & 0x3FF));
+      nextSampleUs += SAMPLE_US;
+      samples++;
+    }
+    if (hostClockNowUs() >= nextServiceUs)
+    {
+      writer.service();
+      nextServiceUs = hostClockNowUs() + SESSION_LOG_SERVICE_INTERVAL_MS * 1000;
+    }
+    hostClockAdvanceUs(SAMPLE_US);
+  }
+  writer.end();
+
+  char message[96];
+  snprintf(message, sizeof(message), "%u samples, ring high water %u / %u", static_cast<unsigned>(samples),
+           static_cast<unsigned>(writer.ringHighWater()), static_cast<unsigned>(SESSION_LOG_RING_CAPACITY));
+  TEST_MESSAGE(message);
+  TEST_ASSERT_EQUAL_UINT32(0, writer.droppedCount());
+  TEST_ASSERT_EQUAL_UINT32(samples, writer.recordCount());
+
+  std::vector<SessionLogEntry> entries;
+  TEST_ASSERT_TRUE(readBack(fs, "/rate.bin", entries));
+  TEST_ASSERT_EQUAL_size_t(samples, entries.size());
+  TEST_ASSERT_EQUAL_UINT32(static_cast<uint32_t>(nextSampleUs - SAMPLE_US), entries.back().timestampUs);
+}
+
+// 取得側とログタスク側の CPU コストが、負荷試験の 1600SPS に対しても十分小さいこと
+void test_benchmark_record_and_service()
+{
+  HostLogFs fs;
+  SessionLogWriter writer(fs);
+  writer.begin("/bench.bin", 0);
+  constexpr uint32_t RECORDS = 200000;
+  auto begin = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < RECORDS; ++i)
+  {
+    writer.record(i * 625, 2, static_cast<int16_t>(i & 0x7FF));
+    if ((i & 255) == 255) writer.service();
+  }
+  writer.end();
+  auto end = std::chrono::steady_clock::now();
+  double nsPerRecord = std::chrono::duration<double, std::nano>(end - begin).count() / RECORDS;
+
+  char message[64];
+  snprintf(message, sizeof(message), "%.1f ns/record", nsPerRecord);
+  TEST_MESSAGE(message);
+  // 1600SPS の 1 サンプル周期 625us に対して 1% 未満（実際の 504SPS ではさらに余裕がある）
+  TEST_ASSERT_LESS_THAN(6250.0, nsPerRecord);
+  TEST_ASSERT_EQUAL_UINT32(0, writer.droppedCount());
+}
+
+// 容量上限や書き込み失敗の後は記録を捨て、書きかけのファイルを壊さないこと
+void test_stops_when_flash_is_full()
+{
+  HostLogFs fs;
+  fs.capacityBytes = SESSION_LOG_PAGE_SIZE * 2;
+  SessionLogWriter writer(fs);
+  writer.begin("/full.bin", 0);
+  for (uint32_t i = 0; i < 4000; ++i)
+  {
+    writer.record(i * 625, 2, 1);
+    writer.service();
+  }
+  writer.end();
+
+  TEST_ASSERT_EQUAL_size_t(SESSION_LOG_PAGE_SIZE * 2, fs.files["/full.bin"].size());
+  TEST_ASSERT_GREATER_THAN(0, writer.discardedCount());
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_round_trip);
+  RUN_TEST(test_versioned_header);
+  RUN_TEST(test_writes_whole_pages);
+  RUN_TEST(test_keeps_up_with_full_rate_under_slow_flash);
+  RUN_TEST(test_benchmark_record_and_service);
+  RUN_TEST(test_stops_when_flash_is_full);
+  return UNITY_END();
+}
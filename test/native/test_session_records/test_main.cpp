@@ -0,0 +1,206 @@
+#include <unity.h>
+
+#include <algorithm>
+
+#include "config.h"
+#include "hal/host/host_nvs_store.h"
+#include "modules/session_records.h"
+
+constexpr uint32_t FRAME_MS = RENDER_PERIOD_US / 1000;
+constexpr uint32_t SUPPLY_MV = 5000;
+
+static auto makeValues(float pressure, float water, float oil) -> GaugeValues
+{
+  GaugeValues values = {};
+  values.current[static_cast<size_t>(GaugeSource::OilPressure)] = pressure;
+  values.current[static_cast<size_t>(GaugeSource::WaterTemp)] = water;
+  values.current[static_cast<size_t>(GaugeSource::OilTemp)] = oil;
+  return values;
+}
+
+// durationMs の間フレームごとに更新し、100ms ごとに書き込みを判定する。now は進めた後の時刻になる
+static void runFor(SessionRecords &records, uint32_t &now, uint32_t durationMs, const GaugeValues &values)
+{
+  for (uint32_t end = now + durationMs; now < end;)
+  {
+    now = std::min(now + FRAME_MS, end);
+    records.update(values, now);
+    if (now % RECORDS_SERVICE_INTERVAL_MS < FRAME_MS)
+    {
+      records.service(now, SUPPLY_MV);
+    }
+  }
+}
+
+// 1 時間走り続けても書き込みは定期の間隔と最高値の伸びの分だけに収まること
+void test_hour_of_updates_coalesces_writes()
+{
+  HostNvsStore store;
+  SessionRecords records(store);
+  uint32_t now = 0;
+  records.begin(now);
+
+  constexpr uint32_t MINUTES = 60;
+  for (uint32_t minute = 0; minute < MINUTES; ++minute)
+  {
+    // 油圧は 1 分ごとに上下し、水温はゆっくり上がり続ける
+    float pressure = (minute % 2 == 0) ? 3.0F : 6.0F;
+    runFor(records, now, 60000, makeValues(pressure, 80.0F + minute * 0.25F, 100.0F));
+  }
+
+  const RecordsStats &stats = records.stats();
+  TEST_ASSERT_TRUE(stats.updates >= MINUTES * 60 * RENDER_RATE_HZ);
+  TEST_ASSERT_EQUAL_UINT32(store.writeCount, stats.flushes);
+  // 定期の書き込みは 1 分に 1 回まで。最高値の伸びによる書き込みは 6bar への 1 回と水温の 1℃ ごと
+  TEST_ASSERT_TRUE(stats.flushes >= MINUTES - 1);
+  TEST_ASSERT_TRUE(stats.flushes <= MINUTES + 1 + MINUTES / 4);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.brownoutFlushes);
+  TEST_ASSERT_EQUAL_UINT64(HostNvsStore::flashBytesFor(sizeof(StoredRecords)) * stats.flushes, store.flashBytes);
+  TEST_ASSERT_TRUE(store.writeAmplification() < 2.5F);
+}
+
+// 最高値が大きく伸びたら最短間隔を空けて書き、小さな伸びは定期の書き込みまで待つこと
+void test_peak_jump_flushes_after_min_interval()
+{
+  HostNvsStore store;
+  SessionRecords records(store);
+  uint32_t now = 0;
+  records.begin(now);
+
+  runFor(records, now, 1000, makeValues(2.0F, 85.0F, 100.0F));
+  TEST_ASSERT_EQUAL_UINT32(0, store.writeCount);
+  // 1 秒後に 2bar 伸びても、前回の書き込み（起動）から RECORDS_MIN_FLUSH_INTERVAL_MS は待つ
+  runFor(records, now, 1000, makeValues(4.0F, 85.0F, 100.0F));
+  TEST_ASSERT_EQUAL_UINT32(0, store.writeCount);
+  runFor(records, now, RECORDS_MIN_FLUSH_INTERVAL_MS, makeValues(4.0F, 85.0F, 100.0F));
+  TEST_ASSERT_EQUAL_UINT32(1, store.writeCount);
+
+  // 0.2bar の伸びは定期の書き込みまで待つ
+  runFor(records, now, 10000, makeValues(4.2F, 85.0F, 100.0F));
+  TEST_ASSERT_EQUAL_UINT32(1, store.writeCount);
+  runFor(records, now, RECORDS_FLUSH_INTERVAL_MS, makeValues(4.2F, 85.0F, 100.0F));
+  TEST_ASSERT_EQUAL_UINT32(2, store.writeCount);
+  // 変化が無ければ定期の間隔が来ても書かない
+  runFor(records, now, 2 * RECORDS_FLUSH_INTERVAL_MS, makeValues(1.0F, 85.0F, 90.0F));
+  TEST_ASSERT_EQUAL_UINT32(2, store.writeCount);
+}
+
+// 電源電圧が落ちたら間隔によらずすぐ書き、同じ内容は 2 度書かないこと
+void test_brownout_flushes_immediately()
+{
+  HostNvsStore store;
+  SessionRecords records(store);
+  records.begin(0);
+  records.update(makeValues(5.0F, 90.0F, 110.0F), 10);
+
+  TEST_ASSERT_FALSE(records.service(20, SUPPLY_MV));
+  TEST_ASSERT_TRUE(records.service(30, RECORDS_BROWNOUT_MV - 1));
+  TEST_ASSERT_FALSE(records.service(40, RECORDS_BROWNOUT_MV - 1));
+  TEST_ASSERT_EQUAL_UINT32(1, store.writeCount);
+  TEST_ASSERT_EQUAL_UINT32(1, records.stats().brownoutFlushes);
+  // 電圧が読めない（0）ときは低下とみなさない
+  records.update(makeValues(6.0F, 90.0F, 110.0F), 50);
+  TEST_ASSERT_FALSE(records.service(60, 0));
+}
+
+// 書いた記録が次の起動で読めて、前回のセッション・通算・起動回数が引き継がれること
+void test_records_survive_restart()
+{
+  HostNvsStore store;
+  {
+    SessionRecords first(store);
+    first.begin(0);
+    first.update(makeValues(7.5F, 99.0F, 121.0F), 0);
+    // 水温 98℃・油温 120℃ 以上（レッドゾーン）に 90 秒いる
+    uint32_t now = 0;
+    runFor(first, now, 90000, makeValues(7.5F, 99.0F, 121.0F));
+    // 断線・短絡のエラー表示の値は記録しない
+    first.update(makeValues(12.0F, 199.0F, 199.0F), now + FRAME_MS);
+    TEST_ASSERT_TRUE(first.flush(now + FRAME_MS));
+  }
+
+  SessionRecords second(store);
+  second.begin(200000);
+  StoredRecords next = second.snapshot();
+  const RecordSet &previous = second.previousSession();
+  size_t pressure = static_cast<size_t>(GaugeSource::OilPressure);
+  size_t water = static_cast<size_t>(GaugeSource::WaterTemp);
+  size_t oil = static_cast<size_t>(GaugeSource::OilTemp);
+  TEST_ASSERT_EQUAL_UINT32(2, next.sessions);
+  TEST_ASSERT_TRUE(previous.peak[pressure] == 7.5F);
+  TEST_ASSERT_TRUE(previous.peak[water] == 99.0F);
+  TEST_ASSERT_TRUE(previous.peak[oil] == 121.0F);
+  TEST_ASSERT_EQUAL_UINT32(0, previous.redZoneSeconds[pressure]);
+  TEST_ASSERT_EQUAL_UINT32(90, previous.redZoneSeconds[water]);
+  TEST_ASSERT_EQUAL_UINT32(90, previous.redZoneSeconds[oil]);
+  TEST_ASSERT_TRUE(next.allTime.peak[pressure] == 7.5F);
+  TEST_ASSERT_EQUAL_UINT32(90, next.allTime.redZoneSeconds[water]);
+  TEST_ASSERT_TRUE(second.sessionPeak(GaugeSource::OilPressure) == 0.0F);
+
+  // 版の違う blob は読み捨てる
+  HostNvsStore foreign;
+  StoredRecords stale = next;
+  stale.version = RECORDS_VERSION + 1;
+  foreign.write(RECORDS_NVS_KEY, &stale, sizeof(stale));
+  SessionRecords third(foreign);
+  third.begin(0);
+  TEST_ASSERT_EQUAL_UINT32(1, third.snapshot().sessions);
+  TEST_ASSERT_TRUE(third.snapshot().allTime.peak[pressure] == 0.0F);
+}
+
+// セッションのリセットは通算へ繰り入れてから消し、通算のリセットはすべて消してすぐ書くこと
+void test_resets_keep_or_clear_all_time()
+{
+  HostNvsStore store;
+  SessionRecords records(store);
+  uint32_t now = 0;
+  records.begin(now);
+  records.update(makeValues(8.5F, 90.0F, 100.0F), now);
+  runFor(records, now, 30000, makeValues(8.5F, 90.0F, 100.0F));
+
+  size_t pressure = static_cast<size_t>(GaugeSource::OilPressure);
+  uint32_t writes = store.writeCount;
+  records.resetSession(now);
+  TEST_ASSERT_EQUAL_UINT32(writes + 1, store.writeCount);
+  TEST_ASSERT_TRUE(records.sessionPeak(GaugeSource::OilPressure) == 0.0F);
+  StoredRecords afterSession = records.snapshot();
+  TEST_ASSERT_TRUE(afterSession.allTime.peak[pressure] == 8.5F);
+  TEST_ASSERT_EQUAL_UINT32(30, afterSession.allTime.redZoneSeconds[pressure]);
+  TEST_ASSERT_EQUAL_UINT32(0, afterSession.session.redZoneSeconds[pressure]);
+
+  records.resetAllTime(now);
+  TEST_ASSERT_EQUAL_UINT32(writes + 2, store.writeCount);
+  StoredRecords stored = {};
+  TEST_ASSERT_TRUE(store.read(RECORDS_NVS_KEY, &stored, sizeof(stored)));
+  TEST_ASSERT_TRUE(stored.allTime.peak[pressure] == 0.0F);
+  TEST_ASSERT_EQUAL_UINT32(0, stored.allTime.redZoneSeconds[pressure]);
+  TEST_ASSERT_EQUAL_UINT32(1, stored.sessions);
+}
+
+// 書き込みに失敗したら失敗を数え、次の試行まで通常の間隔を空けること
+void test_failed_write_is_retried_later()
+{
+  HostNvsStore store;
+  store.failWrites = true;
+  SessionRecords records(store);
+  records.begin(0);
+  records.update(makeValues(3.0F, 85.0F, 100.0F), 10);
+  TEST_ASSERT_FALSE(records.service(RECORDS_FLUSH_INTERVAL_MS, SUPPLY_MV));
+  TEST_ASSERT_EQUAL_UINT32(1, records.stats().failedWrites);
+  store.failWrites = false;
+  TEST_ASSERT_FALSE(records.service(RECORDS_FLUSH_INTERVAL_MS + 100, SUPPLY_MV));
+  TEST_ASSERT_TRUE(records.service(2 * RECORDS_FLUSH_INTERVAL_MS, SUPPLY_MV));
+  TEST_ASSERT_EQUAL_UINT32(1, records.stats().flushes);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_hour_of_updates_coalesces_writes);
+  RUN_TEST(test_peak_jump_flushes_after_min_interval);
+  RUN_TEST(test_brownout_flushes_immediately);
+  RUN_TEST(test_records_survive_restart);
+  RUN_TEST(test_resets_keep_or_clear_all_time);
+  RUN_TEST(test_failed_write_is_retried_later);
+  return UNITY_END();
+}
@@ -0,0 +1,237 @@
+#include <unity.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "config.h"
+#include "modules/sensor_conversion.h"
+#include "modules/session_stats.h"
+
+// 再現できる一様乱数 [0, 1)
+static auto nextUniform(uint32_t &state) -> float
+{
+  state = state * 1664525U + 1013904223U;
+  return static_cast<float>(state >> 8) / 16777216.0F;
+}
+
+static auto exactQuantile(std::vector<float> values, float p) -> float
+{
+  std::sort(values.begin(), values.end());
+  return values[static_cast<size_t>(p * static_cast<float>(values.size() - 1))];
+}
+
+// 大きな下駄を履いた値でも、Welford の平均・分散が 2 パスの計算と一致すること
+void test_running_stats_matches_two_pass()
+{
+  RunningStats stats;
+  std::vector<float> values;
+  uint32_t state = 1;
+  for (int i = 0; i < 100000; ++i)
+  {
+    float x = 1000.0F + nextUniform(state) * 4.0F;
+    values.push_back(x);
+    stats.add(x);
+  }
+  double sum = 0.0;
+  for (float x : values) sum += x;
+  double mean = sum / values.size();
+  double squares = 0.0;
+  for (float x : values) squares += (x - mean) * (x - mean);
+  double variance = squares / (values.size() - 1);
+
+  TEST_ASSERT_EQUAL_UINT32(100000, stats.count());
+  TEST_ASSERT_TRUE(std::fabs(stats.mean() - mean) < 1e-3);
+  TEST_ASSERT_TRUE(std::fabs(stats.variance() - variance) < variance * 1e-4);
+  TEST_ASSERT_TRUE(stats.min() == *std::min_element(values.begin(), values.end()));
+  TEST_ASSERT_TRUE(stats.max() == *std::max_element(values.begin(), values.end()));
+
+  RunningStats single;
+  single.add(3.0F);
+  TEST_ASSERT_TRUE(single.variance() == 0.0F);
+}
+
+// P² の推定が一様分布・偏った分布とも、全件を並べた分位点に近いこと
+void test_p2_tracks_exact_quantiles()
+{
+  const float quantiles[] = {0.01F, 0.50F, 0.99F};
+  for (int shape = 0; shape < 2; ++shape)
+  {
+    P2Quantile estimators[] = {P2Quantile(0.01F), P2Quantile(0.50F), P2Quantile(0.99F)};
+    std::vector<float> values;
+    uint32_t state = 7;
+    for (int i = 0; i < 50000; ++i)
+    {
+      // 一様 0〜10、または指数分布（裾の長い油圧の落ち込みを想定）
+      float u = nextUniform(state);
+      float x = (shape == 0) ? u * 10.0F : -std::log(1.0F - u);
+      values.push_back(x);
+      for (P2Quantile &estimator : estimators) estimator.add(x);
+    }
+    for (int q = 0; q < 3; ++q)
+    {
+      float exact = exactQuantile(values, quantiles[q]);
+      float tolerance = (shape == 0) ? 0.1F : 0.05F + exact * 0.03F;
+      TEST_ASSERT_TRUE(std::fabs(estimators[q].value() - exact) < tolerance);
+    }
+  }
+}
+
+// 5 件未満は手元の値の順位で答え、0 件なら 0 を返すこと
+void test_p2_small_counts()
+{
+  P2Quantile median(0.5F);
+  TEST_ASSERT_TRUE(median.value() == 0.0F);
+  median.add(9.0F);
+  median.add(1.0F);
+  median.add(5.0F);
+  TEST_ASSERT_TRUE(median.value() == 5.0F);
+  P2Quantile high(0.99F);
+  high.add(2.0F);
+  high.add(8.0F);
+  TEST_ASSERT_TRUE(high.value() == 8.0F);
+}
+
+// 油圧は直前の油温の区間に数え、範囲外は端の区間へ入れ、油温が無い・断線中は数えないこと
+void test_histogram_bins_pressure_against_oil_temp()
+{
+  static SessionStats stats;
+  stats.reset();
+  stats.add(GaugeSource::OilPressure, 3.0F);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.histogram().total());
+
+  stats.add(GaugeSource::OilTemp, 101.0F);
+  stats.add(GaugeSource::OilPressure, 3.2F);
+  stats.add(GaugeSource::OilPressure, 3.4F);
+  stats.add(GaugeSource::OilPressure, 42.0F);  // 短絡（エラー表示）なので数えない
+  stats.add(GaugeSource::OilPressure, 10.7F);  // 上端の区間へ
+  const PressureTempHistogram &histogram = stats.histogram();
+  int tempBin = PressureTempHistogram::tempBin(101.0F);
+  TEST_ASSERT_EQUAL_INT(8, tempBin);
+  TEST_ASSERT_EQUAL_UINT32(2, histogram.count(PressureTempHistogram::pressureBin(3.2F), tempBin));
+  TEST_ASSERT_EQUAL_UINT32(1, histogram.count(PressureTempHistogram::PRESSURE_BINS - 1, tempBin));
+  TEST_ASSERT_EQUAL_UINT32(3, histogram.total());
+  TEST_ASSERT_EQUAL_UINT32(2, histogram.maxCount());
+  TEST_ASSERT_EQUAL_INT(0, PressureTempHistogram::pressureBin(-0.3F));
+  TEST_ASSERT_EQUAL_INT(0, PressureTempHistogram::tempBin(20.0F));
+
+  // 油温が断線したら次の正常な油温までヒストグラムを止める
+  stats.add(GaugeSource::OilTemp, 199.0F);
+  stats.add(GaugeSource::OilPressure, 3.0F);
+  TEST_ASSERT_EQUAL_UINT32(3, histogram.total());
+  TEST_ASSERT_EQUAL_UINT32(1, stats.channel(GaugeSource::OilTemp).moments.count());
+  TEST_ASSERT_EQUAL_UINT32(5, stats.channel(GaugeSource::OilPressure).moments.count());
+  TEST_ASSERT_TRUE(stats.channel(GaugeSource::OilPressure).moments.max() < 11.0F);
+}
+
+// 取得経路の整数値（Q16 mbar・0.01℃）をチャンネルごとに物理量へ直して集計すること
+void test_sensor_samples_are_converted()
+{
+  static SessionStats stats;
+  stats.reset();
+  stats.addSensorSample(ADC_CH_OIL_TEMP, 11050);
+  stats.addSensorSample(ADC_CH_WATER_TEMP, 9025);
+  stats.addSensorSample(ADC_CH_OIL_PRESSURE, barToPressureQ16(4.5F));
+  TEST_ASSERT_TRUE(std::fabs(stats.channel(GaugeSource::OilTemp).moments.mean() - 110.5F) < 1e-3F);
+  TEST_ASSERT_TRUE(std::fabs(stats.channel(GaugeSource::WaterTemp).moments.mean() - 90.25F) < 1e-3F);
+  TEST_ASSERT_TRUE(std::fabs(stats.channel(GaugeSource::OilPressure).moments.mean() - 4.5F) < 1e-3F);
+  TEST_ASSERT_EQUAL_UINT32(1, stats.histogram().count(PressureTempHistogram::pressureBin(4.5F),
+                                                      PressureTempHistogram::tempBin(110.5F)));
+}
+
+// 写しは STATS_PUBLISH_SAMPLES 件ごとに更新され、リセットの依頼は次の 1 件で写しにも反映されること
+void test_snapshot_is_published_in_batches()
+{
+  static SharedSessionStats shared;
+  static SessionStats view;
+  for (uint32_t i = 0; i + 1 < STATS_PUBLISH_SAMPLES; ++i)
+  {
+    shared.addSensorSample(ADC_CH_OIL_PRESSURE, barToPressureQ16(3.0F));
+  }
+  TEST_ASSERT_TRUE(shared.readSnapshot(view));
+  TEST_ASSERT_EQUAL_UINT32(0, view.channel(GaugeSource::OilPressure).moments.count());
+  shared.addSensorSample(ADC_CH_OIL_PRESSURE, barToPressureQ16(3.0F));
+  TEST_ASSERT_TRUE(shared.readSnapshot(view));
+  TEST_ASSERT_EQUAL_UINT32(STATS_PUBLISH_SAMPLES, view.channel(GaugeSource::OilPressure).moments.count());
+
+  shared.requestReset();
+  shared.addSensorSample(ADC_CH_WATER_TEMP, 9000);
+  TEST_ASSERT_TRUE(shared.readSnapshot(view));
+  TEST_ASSERT_EQUAL_UINT32(0, view.channel(GaugeSource::OilPressure).moments.count());
+  TEST_ASSERT_EQUAL_UINT32(1, view.channel(GaugeSource::WaterTemp).moments.count());
+}
+
+// 取得側が別スレッドで更新し続けても、読めた写しは常に 1 回の公開分そろった状態であること
+void test_snapshot_is_never_torn()
+{
+  static SharedSessionStats shared;
+  static SessionStats view;
+  constexpr uint32_t SAMPLES = 200000;
+  std::atomic<bool> done{false};
+  std::thread writer([&] {
+    shared.addSensorSample(ADC_CH_OIL_TEMP, 10000);
+    for (uint32_t i = 0; i < SAMPLES; ++i)
+    {
+      shared.addSensorSample(ADC_CH_OIL_PRESSURE, barToPressureQ16(1.0F + static_cast<float>(i % 16) * 0.5F));
+    }
+    done.store(true);
+  });
+
+  // 失敗してもスレッドを残さないよう、判定は書き手が終わってからまとめて行う
+  uint32_t reads = 0;
+  uint32_t torn = 0;
+  uint32_t lastCount = 0;
+  while (!done.load())
+  {
+    if (!shared.readSnapshot(view)) continue;
+    reads++;
+    // 油温が先に 1 件入るので、油圧の件数・ヒストグラムの合計・P² の件数はそろって進む
+    const ChannelStats &pressure = view.channel(GaugeSource::OilPressure);
+    uint32_t count = pressure.moments.count();
+    bool consistent = count == view.histogram().total() && count == pressure.p50.count() && count >= lastCount &&
+                      (count == 0 || (count + 1) % STATS_PUBLISH_SAMPLES == 0);
+    if (!consistent) torn++;
+    lastCount = count;
+  }
+  writer.join();
+  TEST_ASSERT_TRUE(reads > 0);
+  TEST_ASSERT_EQUAL_UINT32(0, torn);
+}
+
+// 1 時間分（500SPS）を流しても固定の数 KB に収まり、件数が数え落ちないこと
+void test_hour_of_samples_in_fixed_memory()
+{
+  TEST_ASSERT_TRUE(sizeof(SessionStats) <= 4096);
+  static SessionStats stats;
+  stats.reset();
+  constexpr uint32_t SAMPLES = 3600 * OIL_PRESSURE_SAMPLE_RATE_HZ;
+  uint32_t state = 3;
+  stats.add(GaugeSource::OilTemp, 105.0F);
+  for (uint32_t i = 0; i < SAMPLES; ++i)
+  {
+    stats.add(GaugeSource::OilPressure, 2.0F + nextUniform(state) * 4.0F);
+  }
+  const ChannelStats &pressure = stats.channel(GaugeSource::OilPressure);
+  TEST_ASSERT_EQUAL_UINT32(SAMPLES, pressure.moments.count());
+  TEST_ASSERT_EQUAL_UINT32(SAMPLES, stats.histogram().total());
+  TEST_ASSERT_TRUE(std::fabs(pressure.moments.mean() - 4.0F) < 0.01F);
+  TEST_ASSERT_TRUE(std::fabs(pressure.p1.value() - 2.04F) < 0.05F);
+  TEST_ASSERT_TRUE(std::fabs(pressure.p50.value() - 4.0F) < 0.05F);
+  TEST_ASSERT_TRUE(std::fabs(pressure.p99.value() - 5.96F) < 0.05F);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_running_stats_matches_two_pass);
+  RUN_TEST(test_p2_tracks_exact_quantiles);
+  RUN_TEST(test_p2_small_counts);
+  RUN_TEST(test_histogram_bins_pressure_against_oil_temp);
+  RUN_TEST(test_sensor_samples_are_converted);
+  RUN_TEST(test_snapshot_is_published_in_batches);
+  RUN_TEST(test_snapshot_is_never_torn);
+  RUN_TEST(test_hour_of_samples_in_fixed_memory);
+  return UNITY_END();
+}
@@ -0,0 +1,223 @@
+#include <unity.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include "config.h"
+#include "modules/signal_filters.h"
+#include "modules/thermistor_lut.h"
+
+// 再現性のある擬似乱数（線形合同法）
+static uint32_t lcgState = 98765;
+static auto nextRandom() -> uint32_t
+{
+  lcgState = lcgState * 1664525U + 1013904223U;
+  return lcgState >> 8;
+}
+
+// 窓を整列し直す素朴な実装と同じ中央値になること
+template <size_t N>
+static void checkMedianAgainstSort()
+{
+  SlidingMedian<N> median;
+  int32_t history[N];
+  for (int i = 0; i < 5000; ++i)
+  {
+    // 重複も出るよう値の範囲を狭くする
+    auto value = static_cast<int32_t>(nextRandom() % 50) - 25;
+    int32_t actual = median.update(value);
+    if (i == 0)
+    {
+      std::fill(history, history + N, value);
+    }
+    else
+    {
+      history[i % N] = value;
+    }
+    int32_t sorted[N];
+    std::copy(history, history + N, sorted);
+    std::sort(sorted, sorted + N);
+    int32_t expected = (N % 2 == 1) ? sorted[N / 2] : (sorted[N / 2 - 1] + sorted[N / 2]) / 2;
+    TEST_ASSERT_EQUAL_INT32(expected, actual);
+  }
+}
+
+void test_sliding_median_matches_sort()
+{
+  checkMedianAgainstSort<1>();
+  checkMedianAgainstSort<4>();
+  checkMedianAgainstSort<5>();
+  checkMedianAgainstSort<9>();
+  // 許される最長の窓でも同じ
+  checkMedianAgainstSort<SlidingMedian<1>::MAX_WINDOW>();
+}
+
+// 単発のスパイクが中央値の出力に現れないこと
+void test_median_rejects_spike()
+{
+  SlidingMedian<5> median;
+  for (int i = 0; i < 5; ++i) median.update(1000);
+  TEST_ASSERT_EQUAL_INT32(1000, median.update(900000));
+  TEST_ASSERT_EQUAL_INT32(1000, median.update(1000));
+  TEST_ASSERT_EQUAL_INT32(1000, median.update(-900000));
+}
+
+// 時定数で指定した 1 次 IIR が τ 経過時点で 63% 応答すること
+void test_single_pole_time_constant()
+{
+  constexpr float RATE_HZ = 500.0F;
+  constexpr float TAU_MS = 50.0F;
+  FixedEma filter(singlePoleAlphaQ16(TAU_MS, RATE_HZ));
+  filter.update(0);
+  int32_t value = 0;
+  for (int i = 0; i < static_cast<int>(TAU_MS * RATE_HZ / 1000.0F); ++i)
+  {
+    value = filter.update(100000);
+  }
+  TEST_ASSERT_INT32_WITHIN(1000, 63212, value);
+  // 時定数 0 は素通し
+  FixedEma passthrough(singlePoleAlphaQ16(0.0F, RATE_HZ));
+  passthrough.update(5);
+  TEST_ASSERT_EQUAL_INT32(77, passthrough.update(77));
+}
+
+// 2 次低域通過の直流ゲインがちょうど 1 で、高い周波数を強く減衰させること
+void test_biquad_dc_gain_and_attenuation()
+{
+  BiquadLowPass dc(10.0F, 500.0F);
+  dc.update(0);
+  int32_t value = 0;
+  for (int i = 0; i < 2000; ++i)
+  {
+    value = dc.update(1000000000);  // Q16 mbar で約 15bar
+  }
+  TEST_ASSERT_INT32_WITHIN(2, 1000000000, value);
+
+  // 遮断周波数が低くても 0.01℃単位の小さな段差に追いつくこと
+  BiquadLowPass slow(0.05F, 2.0F);
+  slow.update(8000);
+  for (int i = 0; i < 2000; ++i)
+  {
+    value = slow.update(8003);
+  }
+  TEST_ASSERT_EQUAL_INT32(8003, value);
+
+  // ナイキスト周波数の交互入力は 1% 未満まで落ちる
+  BiquadLowPass hf(10.0F, 500.0F);
+  hf.update(0);
+  int32_t peak = 0;
+  for (int i = 0; i < 2000; ++i)
+  {
+    value = hf.update((i % 2 == 0) ? 100000 : -100000);
+    if (i > 500) peak = std::max(peak, std::abs(value));
+  }
+  TEST_ASSERT_TRUE(peak < 1000);
+
+  // 遮断周波数の正弦波は約 -3dB になる
+  BiquadLowPass cutoff(10.0F, 500.0F);
+  peak = 0;
+  for (int i = 0; i < 5000; ++i)
+  {
+    auto input = static_cast<int32_t>(100000.0 * std::sin(2.0 * M_PI * 10.0 * i / 500.0));
+    value = cutoff.update(input);
+    if (i > 2500) peak = std::max(peak, std::abs(value));
+  }
+  TEST_ASSERT_INT32_WITHIN(2000, 70711, peak);
+}
+
+// 設定どおりに前段→後段を通し、None はそのまま通すこと
+void test_channel_filter_follows_config()
+{
+  constexpr ChannelFilterConfig CONFIG = {FilterKind::Median, 5, FilterKind::SinglePole, 20.0f, 0.0f};
+  ChannelFilter<CONFIG.window> channel(CONFIG, 500.0F);
+  SlidingMedian<5> median;
+  FixedEma ema(singlePoleAlphaQ16(20.0F, 500.0F));
+  for (int i = 0; i < 1000; ++i)
+  {
+    auto value = static_cast<int32_t>(nextRandom() % 100000);
+    TEST_ASSERT_EQUAL_INT32(ema.update(median.update(value)), channel.update(value));
+  }
+  TEST_ASSERT_EQUAL_INT32(ema.value(), channel.value());
+
+  constexpr ChannelFilterConfig NONE = {FilterKind::None, 1, FilterKind::None, 0.0f, 0.0f};
+  ChannelFilter<NONE.window> passthrough(NONE, 500.0F);
+  TEST_ASSERT_EQUAL_INT32(-1234, passthrough.update(-1234));
+
+  constexpr ChannelFilterConfig AVERAGE = {FilterKind::MovingAverage, 2, FilterKind::BiquadLowPass, 0.0f, 100.0f};
+  ChannelFilter<AVERAGE.window> averaged(AVERAGE, 500.0F);
+  averaged.update(1000);
+  averaged.update(3000);
+  TEST_ASSERT_TRUE(averaged.value() > 1000 && averaged.value() < 2000);
+}
+
+// 断線の印は平滑化せずに通し、復帰後は印も故障前の値も混ざらない値から出し直すこと
+void test_channel_filter_passes_fault_and_reseeds()
+{
+  ChannelFilter<WATER_TEMP_FILTER.window> water(WATER_TEMP_FILTER, TEMP_SAMPLE_RATE_HZ, THERMISTOR_DISCONNECT_CENTI);
+  for (int i = 0; i < 10; ++i)
+  {
+    water.update(7000);
+  }
+  for (int i = 0; i < 3; ++i)
+  {
+    TEST_ASSERT_EQUAL_INT32(THERMISTOR_DISCONNECT_CENTI, water.update(THERMISTOR_DISCONNECT_CENTI));
+  }
+  // 復帰した値から始め直し、印との平均（約 135℃）や断線前の 70℃ へ引きずられない
+  TEST_ASSERT_EQUAL_INT32(9000, water.update(9000));
+  for (int i = 0; i < 10; ++i)
+  {
+    TEST_ASSERT_EQUAL_INT32(9000, water.update(9000));
+  }
+
+  // 印を指定しなければ従来どおり平滑化する
+  ChannelFilter<WATER_TEMP_FILTER.window> plain(WATER_TEMP_FILTER, TEMP_SAMPLE_RATE_HZ);
+  plain.update(7000);
+  TEST_ASSERT_TRUE(plain.update(THERMISTOR_DISCONNECT_CENTI) < THERMISTOR_DISCONNECT_CENTI);
+}
+
+// 1 サンプルあたりの処理時間を測る（窓長に比例しないこと）
+void test_update_cost()
+{
+  constexpr int SAMPLES = 1000000;
+  static int32_t input[4096];
+  for (int32_t &v : input) v = static_cast<int32_t>(nextRandom() % 1000000);
+
+  ChannelFilter<OIL_PRESSURE_FILTER.window> pressure(OIL_PRESSURE_FILTER, OIL_PRESSURE_SAMPLE_RATE_HZ);
+  MovingSum<int32_t, 64> wideAverage;
+  BiquadLowPass biquad(10.0F, 500.0F);
+  int64_t checksum = 0;
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < SAMPLES; ++i) checksum += pressure.update(input[i & 4095]);
+  auto t1 = std::chrono::steady_clock::now();
+  for (int i = 0; i < SAMPLES; ++i)
+  {
+    wideAverage.push(input[i & 4095]);
+    checksum += wideAverage.average();
+  }
+  auto t2 = std::chrono::steady_clock::now();
+  for (int i = 0; i < SAMPLES; ++i) checksum += biquad.update(input[i & 4095]);
+  auto t3 = std::chrono::steady_clock::now();
+
+  auto ns = [](auto a, auto b) { return std::chrono::duration<double, std::nano>(b - a).count() / SAMPLES; };
+  char message[96];
+  std::snprintf(message, sizeof(message), "pressure chain %.1f ns, average(64) %.1f ns, biquad %.1f ns", ns(t0, t1),
+                ns(t1, t2), ns(t2, t3));
+  TEST_MESSAGE(message);
+  TEST_ASSERT_TRUE(checksum != 0);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_sliding_median_matches_sort);
+  RUN_TEST(test_median_rejects_spike);
+  RUN_TEST(test_single_pole_time_constant);
+  RUN_TEST(test_biquad_dc_gain_and_attenuation);
+  RUN_TEST(test_channel_filter_follows_config);
+  RUN_TEST(test_channel_filter_passes_fault_and_reseeds);
+  RUN_TEST(test_update_cost);
+  return UNITY_END();
+}
@@ -0,0 +1,110 @@
+#include <unity.h>
+
+#include <thread>
+
+#include "modules/spsc_ring.h"
+
+// タイムスタンプ付きサンプルを模した要素
+struct StampedValue
+{
+  uint32_t timestampUs;
+  uint32_t sequence;
+  uint32_t check;
+};
+
+// 単一スレッドでの FIFO 順序と満杯判定
+void test_push_pop_order_and_full()
+{
+  SpscRing<int, 4> ring;
+  TEST_ASSERT_TRUE(ring.empty());
+  for (int i = 0; i < 4; ++i)
+  {
+    TEST_ASSERT_TRUE(ring.push(i));
+  }
+  TEST_ASSERT_FALSE(ring.push(99));
+  TEST_ASSERT_EQUAL_UINT32(1, ring.droppedCount());
+  TEST_ASSERT_EQUAL_size_t(4, ring.size());
+
+  int value = -1;
+  for (int i = 0; i < 4; ++i)
+  {
+    TEST_ASSERT_TRUE(ring.pop(value));
+    TEST_ASSERT_EQUAL_INT(i, value);
+  }
+  TEST_ASSERT_FALSE(ring.pop(value));
+}
+
+// インデックスが一周してもデータが崩れないこと
+void test_wraparound()
+{
+  SpscRing<int, 8> ring;
+  int value = 0;
+  for (int i = 0; i < 1000; ++i)
+  {
+    TEST_ASSERT_TRUE(ring.push(i));
+    TEST_ASSERT_TRUE(ring.push(i + 1));
+    TEST_ASSERT_TRUE(ring.pop(value));
+    TEST_ASSERT_EQUAL_INT(i, value);
+    TEST_ASSERT_TRUE(ring.pop(value));
+    TEST_ASSERT_EQUAL_INT(i + 1, value);
+  }
+}
+
+// 2 スレッドで欠落・重複・破損なく受け渡せること
+void test_two_thread_stress()
+{
+  constexpr uint32_t COUNT = 500000;
+  static SpscRing<StampedValue, 256> ring;
+
+  std::thread producer(
+      []
+      {
+        for (uint32_t i = 0; i < COUNT;)
+        {
+          StampedValue v{i * 625U, i, i ^ 0xA5A5A5A5U};
+          if (ring.push(v))
+          {
+            ++i;
+          }
+          else
+          {
+            // 単一コアのホストでも消費側に実行機会を渡す
+            std::this_thread::yield();
+          }
+        }
+      });
+
+  uint32_t expected = 0;
+  bool ok = true;
+  while (expected < COUNT)
+  {
+    StampedValue v{};
+    if (ring.pop(v))
+    {
+      if (v.sequence != expected || v.check != (expected ^ 0xA5A5A5A5U) || v.timestampUs != expected * 625U)
+      {
+        ok = false;
+        break;
+      }
+      ++expected;
+    }
+    else
+    {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+
+  TEST_ASSERT_TRUE(ok);
+  TEST_ASSERT_EQUAL_UINT32(COUNT, expected);
+  TEST_ASSERT_TRUE(ring.empty());
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_push_pop_order_and_full);
+  RUN_TEST(test_wraparound);
+  RUN_TEST(test_two_thread_stress);
+  return UNITY_END();
+}
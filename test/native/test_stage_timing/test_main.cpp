@@ -0,0 +1,99 @@
+#include <unity.h>
+
+#include <chrono>
+#include <cstdio>
+
+#include "hal/hal.h"
+#include "modules/stage_timing.h"
+
+// 8 未満はそのまま、それ以上は 2 倍ごとの区間が 8 等分されること
+void test_bucket_boundaries()
+{
+  for (uint32_t v = 0; v < 8; ++v)
+  {
+    TEST_ASSERT_EQUAL_UINT32(v, LogHistogram::bucketIndex(v));
+  }
+  TEST_ASSERT_EQUAL_UINT32(8, LogHistogram::bucketIndex(8));
+  TEST_ASSERT_EQUAL_UINT32(15, LogHistogram::bucketIndex(15));
+  TEST_ASSERT_EQUAL_UINT32(16, LogHistogram::bucketIndex(16));
+  TEST_ASSERT_EQUAL_UINT32(16, LogHistogram::bucketIndex(17));
+  TEST_ASSERT_EQUAL_UINT32(17, LogHistogram::bucketIndex(18));
+  TEST_ASSERT_EQUAL_UINT32(LogHistogram::BUCKETS - 1, LogHistogram::bucketIndex(UINT32_MAX));
+
+  // 下端の値は自分のバケットに入り、1 つ手前の値は前のバケットに入る
+  for (size_t i = 1; i < LogHistogram::BUCKETS; ++i)
+  {
+    uint32_t lower = LogHistogram::bucketLowerBound(i);
+    TEST_ASSERT_EQUAL_UINT32(i, LogHistogram::bucketIndex(lower));
+    TEST_ASSERT_EQUAL_UINT32(i - 1, LogHistogram::bucketIndex(lower - 1));
+  }
+}
+
+// 一様な値の p50/p99 が真値から 12.5% 以内に収まり、最大値は正確なこと
+void test_percentile_accuracy()
+{
+  LogHistogram histogram;
+  for (uint32_t v = 1; v <= 10000; ++v)
+  {
+    histogram.record(v);
+  }
+  TEST_ASSERT_EQUAL_UINT32(10000, histogram.count());
+  TEST_ASSERT_EQUAL_UINT32(10000, histogram.max());
+
+  uint32_t p50 = histogram.percentile(50.0F);
+  uint32_t p99 = histogram.percentile(99.0F);
+  TEST_ASSERT_UINT32_WITHIN(5000 / 8, 5000, p50);
+  TEST_ASSERT_UINT32_WITHIN(9900 / 8, 9900, p99);
+  TEST_ASSERT_TRUE(p50 >= 5000);  // バケットの上端を返すので過小評価はしない
+  TEST_ASSERT_EQUAL_UINT32(10000, histogram.percentile(100.0F));
+
+  histogram.reset();
+  TEST_ASSERT_EQUAL_UINT32(0, histogram.count());
+  TEST_ASSERT_EQUAL_UINT32(0, histogram.percentile(50.0F));
+}
+
+// スコープを抜けたときに経過時間が区間へ記録されること
+void test_scoped_timer_records_elapsed()
+{
+  resetStageTimings();
+  hostClockSetUs(1000);
+  {
+    ScopedStageTimer timer(TimingStage::PressureGauge);
+    hostClockAdvanceUs(1234);
+  }
+  const LogHistogram &histogram = stageHistogram(TimingStage::PressureGauge);
+  TEST_ASSERT_EQUAL_UINT32(1, histogram.count());
+  TEST_ASSERT_EQUAL_UINT32(1234, histogram.max());
+  TEST_ASSERT_EQUAL_UINT32(0, stageHistogram(TimingStage::WaterGauge).count());
+  dumpStageTimings();
+}
+
+// 計測そのものの負荷が 1 回あたり 1us 未満であること
+void test_timer_overhead()
+{
+  resetStageTimings();
+  constexpr int ITERATIONS = 1000000;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < ITERATIONS; ++i)
+  {
+    ScopedStageTimer timer(TimingStage::Push);
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  double nsPerTimer = std::chrono::duration<double, std::nano>(elapsed).count() / ITERATIONS;
+
+  char message[64];
+  std::snprintf(message, sizeof(message), "ScopedStageTimer: %.1f ns", nsPerTimer);
+  TEST_MESSAGE(message);
+  TEST_ASSERT_EQUAL_UINT32(ITERATIONS, stageHistogram(TimingStage::Push).count());
+  TEST_ASSERT_TRUE(nsPerTimer < 1000.0);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_bucket_boundaries);
+  RUN_TEST(test_percentile_accuracy);
+  RUN_TEST(test_scoped_timer_records_elapsed);
+  RUN_TEST(test_timer_overhead);
+  return UNITY_END();
+}
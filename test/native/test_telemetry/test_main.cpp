@@ -0,0 +1,228 @@
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <unity.h>
+
+#include <cstring>
+#include <vector>
+
+#include "config.h"
+#include "hal/host/host_telemetry_decoder.h"
+#include "hal/host/host_telemetry_port.h"
+#include "modules/telemetry.h"
+
+// 書かれたバイトをメモリに溜める送信先。accept で 1 回に受け付ける上限を絞れる
+class MemoryPort : public TelemetryPort
+{
+ public:
+  auto write(const uint8_t *data, size_t length) -> size_t override
+  {
+    size_t n = (length < accept) ? length : accept;
+    bytes.insert(bytes.end(), data, data + n);
+    return n;
+  }
+
+  std::vector<uint8_t> bytes;
+  size_t accept = static_cast<size_t>(-1);
+};
+
+static auto makeSample(uint32_t i) -> TelemetrySample
+{
+  return {1000 + i * 2000, static_cast<uint8_t>(i % 3), static_cast<int16_t>(static_cast<int>(i % 4096) - 2048),
+          static_cast<int32_t>(i * 7919) - 500000};
+}
+
+// CRC-16/CCITT-FALSE の参照値と一致すること
+void test_crc16_matches_reference()
+{
+  const char *text = "123456789";
+  TEST_ASSERT_EQUAL_HEX16(0x29B1, telemetryCrc16(reinterpret_cast<const uint8_t *>(text), std::strlen(text)));
+}
+
+// 0 を含む列も 254B を超える列も、0 を含まない符号列を経て元に戻ること
+void test_cobs_round_trip()
+{
+  std::vector<uint8_t> inputs[3] = {{0x00}, {0x11, 0x00, 0x00, 0x22, 0x00}, std::vector<uint8_t>(600)};
+  for (size_t i = 0; i < inputs[2].size(); ++i)
+  {
+    inputs[2][i] = static_cast<uint8_t>((i % 300 == 299) ? 0 : i % 255 + 1);
+  }
+  for (const std::vector<uint8_t> &input : inputs)
+  {
+    std::vector<uint8_t> encoded(input.size() + input.size() / 254 + 1);
+    size_t encodedLength = cobsEncode(input.data(), input.size(), encoded.data());
+    TEST_ASSERT_TRUE(encodedLength <= encoded.size());
+    TEST_ASSERT_NULL(std::memchr(encoded.data(), 0, encodedLength));
+
+    std::vector<uint8_t> decoded(encodedLength);
+    size_t decodedLength = 0;
+    TEST_ASSERT_TRUE(cobsDecode(encoded.data(), encodedLength, decoded.data(), decodedLength));
+    TEST_ASSERT_EQUAL_size_t(input.size(), decodedLength);
+    TEST_ASSERT_EQUAL_MEMORY(input.data(), decoded.data(), input.size());
+  }
+  const uint8_t broken[] = {0x05, 0x11, 0x22};
+  uint8_t out[4];
+  size_t outLength = 0;
+  TEST_ASSERT_FALSE(cobsDecode(broken, sizeof(broken), out, outLength));
+}
+
+// サンプルとフレームの全フィールドが通番付きで復元されること
+void test_records_round_trip()
+{
+  static MemoryPort port;
+  static TelemetryEncoder encoder(port);
+  encoder.reset();
+  TEST_ASSERT_TRUE(encoder.sample({0xFFFFFFF0U, 2, -2048, -123456}));
+  TEST_ASSERT_TRUE(encoder.frame({7, 16000, 4321, 250, 153600}));
+  TEST_ASSERT_TRUE(encoder.sample({5, 0, 2047, 0}));
+  size_t queued = encoder.queuedBytes();
+  TEST_ASSERT_EQUAL_size_t(queued, encoder.service());
+  TEST_ASSERT_EQUAL_size_t(0, encoder.queuedBytes());
+
+  TelemetryCapture capture;
+  capture.feed(port.bytes.data(), port.bytes.size());
+  TEST_ASSERT_EQUAL_size_t(2, capture.samples.size());
+  TEST_ASSERT_EQUAL_size_t(1, capture.frames.size());
+  const TelemetrySample &first = capture.samples[0].sample;
+  TEST_ASSERT_EQUAL_UINT32(0xFFFFFFF0U, first.timestampUs);
+  TEST_ASSERT_EQUAL_UINT8(2, first.channel);
+  TEST_ASSERT_EQUAL_INT16(-2048, first.raw);
+  TEST_ASSERT_EQUAL_INT32(-123456, first.value);
+  TEST_ASSERT_EQUAL_UINT16(0, capture.samples[0].sequence);
+  TEST_ASSERT_EQUAL_UINT16(2, capture.samples[1].sequence);
+  TEST_ASSERT_EQUAL_INT16(2047, capture.samples[1].sample.raw);
+  const TelemetryFrame &frame = capture.frames[0].frame;
+  TEST_ASSERT_EQUAL_UINT16(1, capture.frames[0].sequence);
+  TEST_ASSERT_EQUAL_UINT32(7, frame.index);
+  TEST_ASSERT_EQUAL_UINT32(16000, frame.startUs);
+  TEST_ASSERT_EQUAL_UINT32(4321, frame.frameUs);
+  TEST_ASSERT_EQUAL_UINT32(250, frame.fenceWaitUs);
+  TEST_ASSERT_EQUAL_UINT32(153600, frame.pushBytes);
+  TEST_ASSERT_EQUAL_UINT32(0, capture.decoder().lostCount());
+}
+
+// 壊れたレコードだけを捨てて次の区切りで同期し直し、途中から読み始めても誤りに数えないこと
+void test_decoder_resyncs_after_corruption()
+{
+  static MemoryPort port;
+  static TelemetryEncoder encoder(port);
+  encoder.reset();
+  port.bytes.clear();
+  for (uint32_t i = 0; i < 3; ++i)
+  {
+    encoder.sample(makeSample(i));
+  }
+  encoder.service();
+
+  // 2 件目（先頭の区切りの後の 2 番目のフレーム）の本体を 1 ビット反転する
+  std::vector<uint8_t> stream = port.bytes;
+  const uint8_t *second = static_cast<const uint8_t *>(std::memchr(stream.data() + 1, 0, stream.size() - 1));
+  stream[(second - stream.data()) + 6] ^= 0x01;
+  TelemetryCapture corrupted;
+  corrupted.feed(stream.data(), stream.size());
+  TEST_ASSERT_EQUAL_size_t(2, corrupted.samples.size());
+  TEST_ASSERT_EQUAL_UINT16(2, corrupted.samples[1].sequence);
+  TEST_ASSERT_EQUAL_UINT32(1, corrupted.decoder().crcErrorCount() + corrupted.decoder().framingErrorCount());
+  TEST_ASSERT_EQUAL_UINT32(1, corrupted.decoder().lostCount());
+
+  // 1 件目の途中から読み始める
+  TelemetryCapture lateStart;
+  lateStart.feed(port.bytes.data() + 5, port.bytes.size() - 5);
+  TEST_ASSERT_EQUAL_size_t(2, lateStart.samples.size());
+  TEST_ASSERT_EQUAL_UINT32(0, lateStart.decoder().crcErrorCount() + lateStart.decoder().framingErrorCount());
+}
+
+// リングが一杯ならレコード単位で捨て、受信側が通番の飛びから同じ数を数えること
+void test_full_ring_drops_whole_records()
+{
+  static MemoryPort port;
+  static TelemetryEncoder encoder(port);
+  encoder.reset();
+  port.bytes.clear();
+  port.accept = 0;
+  uint32_t produced = 0;
+  while (encoder.droppedCount() < 10)
+  {
+    encoder.sample(makeSample(produced++));
+  }
+  TEST_ASSERT_TRUE(encoder.ringHighWater() <= TELEMETRY_TX_RING_CAPACITY);
+  TEST_ASSERT_EQUAL_size_t(0, encoder.service());
+
+  // 送信先が少しずつしか受け付けなくても、空いた分から送り直して続きを積める
+  port.accept = 7;
+  while (encoder.queuedBytes() > 0)
+  {
+    encoder.service();
+  }
+  port.accept = static_cast<size_t>(-1);
+  encoder.sample(makeSample(produced++));
+  encoder.service();
+
+  TelemetryCapture capture;
+  capture.feed(port.bytes.data(), port.bytes.size());
+  TEST_ASSERT_EQUAL_UINT32(encoder.recordCount(), capture.samples.size());
+  TEST_ASSERT_EQUAL_UINT32(encoder.droppedCount(), capture.decoder().lostCount());
+  TEST_ASSERT_EQUAL_UINT32(produced, capture.samples.size() + capture.decoder().lostCount());
+  TEST_ASSERT_EQUAL_UINT32(0, capture.decoder().crcErrorCount() + capture.decoder().framingErrorCount());
+}
+
+// 実機を繋がずに pty の両端で送受信し、非ブロッキング送信でも全件が順に届くこと
+void test_pty_loopback()
+{
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  TEST_ASSERT_TRUE(master >= 0);
+  TEST_ASSERT_EQUAL_INT(0, grantpt(master));
+  TEST_ASSERT_EQUAL_INT(0, unlockpt(master));
+  int slave = openTelemetryInput(ptsname(master));
+  TEST_ASSERT_TRUE(slave >= 0);
+
+  static HostTelemetryPort port;
+  static TelemetryEncoder encoder(port);
+  encoder.reset();
+  port.setFd(master);
+
+  constexpr uint32_t SAMPLES = 5000;
+  TelemetryCapture capture;
+  for (uint32_t i = 0; i < SAMPLES; ++i)
+  {
+    encoder.sample(makeSample(i));
+    if (i % 10 == 9)
+    {
+      encoder.frame({i / 10, i * 2000, 1500, 100, 4096});
+      encoder.service();
+      capture.read(slave, 0);
+    }
+  }
+  for (int idle = 0; idle < 3;)
+  {
+    encoder.service();
+    idle = (capture.read(slave, 20) > 0 || encoder.queuedBytes() > 0) ? 0 : idle + 1;
+  }
+  close(slave);
+  close(master);
+
+  TEST_ASSERT_EQUAL_UINT32(0, encoder.droppedCount());
+  TEST_ASSERT_EQUAL_size_t(SAMPLES, capture.samples.size());
+  TEST_ASSERT_EQUAL_size_t(SAMPLES / 10, capture.frames.size());
+  TEST_ASSERT_EQUAL_UINT32(0, capture.decoder().lostCount());
+  TEST_ASSERT_EQUAL_UINT32(0, capture.decoder().crcErrorCount() + capture.decoder().framingErrorCount());
+  for (uint32_t i = 0; i < SAMPLES; i += 997)
+  {
+    TelemetrySample expected = makeSample(i);
+    TEST_ASSERT_EQUAL_UINT32(expected.timestampUs, capture.samples[i].sample.timestampUs);
+    TEST_ASSERT_EQUAL_INT16(expected.raw, capture.samples[i].sample.raw);
+    TEST_ASSERT_EQUAL_INT32(expected.value, capture.samples[i].sample.value);
+  }
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_crc16_matches_reference);
+  RUN_TEST(test_cobs_round_trip);
+  RUN_TEST(test_records_round_trip);
+  RUN_TEST(test_decoder_resyncs_after_corruption);
+  RUN_TEST(test_full_ring_drops_whole_records);
+  RUN_TEST(test_pty_loopback);
+  return UNITY_END();
+}
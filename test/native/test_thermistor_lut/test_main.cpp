@@ -0,0 +1,84 @@
+#include <unity.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#include "modules/sensor_conversion.h"
+#include "modules/thermistor_lut.h"
+
+// 全コードで β 式との差が 0.05℃以内であること
+void test_lut_matches_beta_formula()
+{
+  float worst = 0.0F;
+  for (int code = 0; code < static_cast<int>(THERMISTOR_LUT_SIZE); ++code)
+  {
+    float expected = convertVoltageToTemp(convertAdcToVoltage(static_cast<int16_t>(code)));
+    // 200℃以上は断線扱いで 200℃に飽和させている
+    expected = std::min(expected, 200.0F);
+    float actual = convertAdcToTemp(static_cast<int16_t>(code));
+    worst = std::max(worst, std::fabs(actual - expected));
+    TEST_ASSERT_FLOAT_WITHIN(0.05F, expected, actual);
+  }
+  char message[48];
+  snprintf(message, sizeof(message), "max error %.4f C", worst);
+  TEST_MESSAGE(message);
+}
+
+// 断線・異常値の扱いが従来と同じであること
+void test_lut_disconnect_sentinel()
+{
+  TEST_ASSERT_EQUAL_INT16(THERMISTOR_DISCONNECT_CENTI, lookupTemperatureCenti(0));
+  TEST_ASSERT_EQUAL_INT16(THERMISTOR_DISCONNECT_CENTI, lookupTemperatureCenti(-100));
+  TEST_ASSERT_EQUAL_INT16(THERMISTOR_DISCONNECT_CENTI, lookupTemperatureCenti(2047));
+  TEST_ASSERT_FLOAT_WITHIN(0.01F, 200.0F, convertAdcToTemp(2047));
+}
+
+// 表は実行時ではなくコンパイル時に生成されていること
+void test_lut_is_compile_time()
+{
+  static_assert(THERMISTOR_LUT.centiCelsius[0] == THERMISTOR_DISCONNECT_CENTI, "code 0 must be a disconnect");
+  static_assert(THERMISTOR_LUT.centiCelsius[333] > THERMISTOR_LUT.centiCelsius[334], "NTC must be monotonic");
+  TEST_ASSERT_TRUE(true);
+}
+
+// ────────────────────── ベンチマーク ──────────────────────
+template <typename F>
+static auto measureNsPerSample(F convert) -> double
+{
+  constexpr int ROUNDS = 200;
+  volatile float sink = 0.0F;
+  auto begin = std::chrono::steady_clock::now();
+  for (int round = 0; round < ROUNDS; ++round)
+  {
+    for (int code = 0; code < static_cast<int>(THERMISTOR_LUT_SIZE); ++code)
+    {
+      sink = sink + convert(static_cast<int16_t>(code));
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - begin).count() / (ROUNDS * THERMISTOR_LUT_SIZE);
+}
+
+// 表引きが β 式より速いこと
+void test_benchmark_lut_vs_formula()
+{
+  double formulaNs = measureNsPerSample([](int16_t code)
+                                        { return convertVoltageToTemp(convertAdcToVoltage(code)); });
+  double lutNs = measureNsPerSample([](int16_t code) { return convertAdcToTemp(code); });
+
+  char message[80];
+  snprintf(message, sizeof(message), "formula %.2f ns, lut %.2f ns (x%.1f)", formulaNs, lutNs, formulaNs / lutNs);
+  TEST_MESSAGE(message);
+  TEST_ASSERT_LESS_THAN(formulaNs, lutNs);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_lut_matches_beta_formula);
+  RUN_TEST(test_lut_disconnect_sentinel);
+  RUN_TEST(test_lut_is_compile_time);
+  RUN_TEST(test_benchmark_lut_vs_formula);
+  return UNITY_END();
+}
@@ -0,0 +1,136 @@
+#include <unity.h>
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "config.h"
+#include "hal/hal.h"
+#include "hal/host/host_ads1015.h"
+#include "hal/host/host_log_fs.h"
+#include "hal/host/host_trace_replay.h"
+#include "modules/display.h"
+#include "modules/sensor.h"
+#include "modules/sensor_conversion.h"
+#include "modules/session_log.h"
+#include "modules/thermistor_lut.h"
+
+// 見出し・コメントを読み飛ばし、時刻順に並べて先頭を 0 に揃えること
+void test_parse_csv()
+{
+  const char text[] =
+      "# recorded on track\n"
+      "t_us,channel,raw\n"
+      "5000,2,300\n"
+      "3000,1,-12\n"
+      "7000,0,2047";
+  std::vector<TraceSample> samples;
+  TEST_ASSERT_TRUE(parseTraceCsv(text, std::strlen(text), samples));
+  TEST_ASSERT_EQUAL_size_t(3, samples.size());
+  TEST_ASSERT_TRUE(samples[0].timeUs == 0);
+  TEST_ASSERT_EQUAL_UINT8(1, samples[0].channel);
+  TEST_ASSERT_EQUAL_INT16(-12, samples[0].raw);
+  TEST_ASSERT_TRUE(samples[1].timeUs == 2000);
+  TEST_ASSERT_EQUAL_INT16(300, samples[1].raw);
+  TEST_ASSERT_TRUE(samples[2].timeUs == 4000);
+  TEST_ASSERT_EQUAL_INT16(2047, samples[2].raw);
+
+  // 欠けた列や範囲外のチャンネルは不正として扱う
+  const char broken[] = "1000,2\n";
+  TEST_ASSERT_FALSE(parseTraceCsv(broken, std::strlen(broken), samples));
+  const char badChannel[] = "1000,7,5\n";
+  TEST_ASSERT_FALSE(parseTraceCsv(badChannel, std::strlen(badChannel), samples));
+}
+
+// セッションログを読み込み、uint32 の時刻の折り返しをまたいでも経過時間が進み続けること
+void test_parse_session_log_across_wrap()
+{
+  HostLogFs fs;
+  SessionLogWriter writer(fs);
+  uint32_t startUs = 0xFFFFFFFFU - 5000;
+  TEST_ASSERT_TRUE(writer.begin("/trace.bin", startUs));
+  for (uint32_t i = 0; i < 10; ++i)
+  {
+    writer.record(startUs + i * 2000, ADC_CH_OIL_PRESSURE, static_cast<int16_t>(100 + i));
+  }
+  writer.end();
+
+  std::vector<TraceSample> samples;
+  const std::vector<uint8_t> &file = fs.files["/trace.bin"];
+  TEST_ASSERT_TRUE(parseTraceLog(file.data(), file.size(), samples));
+  TEST_ASSERT_EQUAL_size_t(10, samples.size());
+  for (size_t i = 0; i < samples.size(); ++i)
+  {
+    TEST_ASSERT_TRUE(samples[i].timeUs == i * 2000);
+    TEST_ASSERT_EQUAL_UINT8(ADC_CH_OIL_PRESSURE, samples[i].channel);
+    TEST_ASSERT_EQUAL_INT16(100 + i, samples[i].raw);
+  }
+}
+
+static uint32_t framesSeen = 0;
+static uint32_t lastFrameIndex = 0;
+static float pressureAtStep = 0.0F;
+
+static void countFrame(const ReplayFrame &frame)
+{
+  framesSeen++;
+  lastFrameIndex = frame.index;
+  // 油圧を切り替える直前（9.9 秒）の表示値
+  if (frame.timeUs <= 9900000) pressureAtStep = frame.pressure;
+}
+
+// トレースの時刻どおりに実際の取得・描画経路を回し、表示値がトレースの値に追従すること
+void test_replay_drives_pipeline()
+{
+  display.init();
+  TEST_ASSERT_TRUE(beginFramePipeline());
+  TEST_ASSERT_TRUE(beginDisplayLayers());
+  TEST_ASSERT_TRUE(beginSensorAcquisition());
+
+  // 20 秒間、油圧は 500Hz・温度は 2Hz。10 秒で油圧を 2.5bar 付近から 5bar 付近へ上げる
+  constexpr int16_t LOW_RAW = 500;
+  constexpr int16_t HIGH_RAW = 833;
+  std::vector<TraceSample> samples;
+  for (uint64_t t = 0; t <= 20000000; t += 2000)
+  {
+    samples.push_back({t, ADC_CH_OIL_PRESSURE, (t < 10000000) ? LOW_RAW : HIGH_RAW});
+    if (t % 500000 == 0)
+    {
+      samples.push_back({t, ADC_CH_WATER_TEMP, 300});
+      samples.push_back({t, ADC_CH_OIL_TEMP, 250});
+    }
+  }
+
+  TraceReplayOptions options = defaultTraceReplayOptions();
+  options.onFrame = countFrame;
+  TraceReplayResult result = runTraceReplay(samples, options, hostAds1015());
+
+  TEST_ASSERT_TRUE(result.traceUs == 20000000);
+  TEST_ASSERT_UINT32_WITHIN(1, 20 * RENDER_RATE_HZ, result.frames);
+  TEST_ASSERT_EQUAL_UINT32(result.frames, framesSeen);
+  TEST_ASSERT_EQUAL_UINT32(result.frames - 1, lastFrameIndex);
+  TEST_ASSERT_EQUAL_UINT32(result.frames, result.frameNs.count());
+  TEST_ASSERT_EQUAL_UINT32(display.frameHash(), result.frameHash);
+
+  float lowBar = pressureQ16ToBar(convertAdcToPressureQ16(LOW_RAW));
+  float highBar = pressureQ16ToBar(convertAdcToPressureQ16(HIGH_RAW));
+  float waterC = centiToCelsius(lookupTemperatureCenti(300));
+  TEST_ASSERT_FLOAT_WITHIN(0.05F, lowBar, pressureAtStep);
+  TEST_ASSERT_FLOAT_WITHIN(0.05F, highBar, displayCache[GaugeSource::OilPressure]);
+  TEST_ASSERT_FLOAT_WITHIN(0.1F, waterC, displayCache[GaugeSource::WaterTemp]);
+
+  // 仮想時計なので実時間より速く回る
+  char message[80];
+  snprintf(message, sizeof(message), "20s trace in %.3fs (x%.0f)", result.wallSeconds, result.speedup());
+  TEST_MESSAGE(message);
+  TEST_ASSERT_TRUE(result.speedup() > 1.0);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_parse_csv);
+  RUN_TEST(test_parse_session_log_across_wrap);
+  RUN_TEST(test_replay_drives_pipeline);
+  return UNITY_END();
+}